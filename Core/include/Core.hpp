@@ -31,7 +31,12 @@
 #include "BasicTypes.hpp"
 #include "StringUtils.hpp"
 #include "FileUtils.hpp"
+#include "JobSystem.hpp"
+#include "LogArguments.hpp"
 #include "Logger.hpp"
+#include "LogSinks.hpp"
+#include "MappedFile.hpp"
+#include "RingBuffer.hpp"
 #include "Testing.hpp"
 
 #endif //___BIO_CORE_CORE_HPP__2015___
\ No newline at end of file
@@ -0,0 +1,584 @@
+/**
+* @file JobSystem.hpp
+* @author Spencer Hoffa
+*
+* A work stealing job scheduler.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_CORE_JOBSYSTEM_HPP__2015___
+#define ___BIO_CORE_JOBSYSTEM_HPP__2015___
+
+#include "Config.h"
+#include "BasicTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+namespace BIO
+{
+	namespace CORE
+	{
+		/**
+		* A function run as a job.
+		*
+		* @param data The data given when the job was submitted.
+		*/
+		typedef void (*JobFunction)(void * data);
+
+		/**
+		* A function run on part of a range by JobSystem::ParallelFor.
+		*
+		* @param data The data given to ParallelFor.
+		* @param begin The first index to work on.
+		* @param end One past the last index to work on.
+		*/
+		typedef void (*JobRangeFunction)(void * data, uint32 begin, uint32 end);
+
+		class JobCounter;
+
+		/**
+		* One piece of work. Only one of Function and RangeFunction is set.
+		*/
+		struct Job
+		{
+			JobFunction Function;			/**< The function to run.*/
+			JobRangeFunction RangeFunction;	/**< The range function to run.*/
+			void * Data;					/**< Passed to the function.*/
+			uint32 Begin;					/**< The start of the range.*/
+			uint32 End;						/**< The end of the range.*/
+			JobCounter * Counter;			/**< Lowered when the job is done. May be NULL.*/
+		};
+
+		/**
+		* Counts jobs that are not finished. A counter is raised when a job is submitted with it
+		* and lowered when the job finishes, so waiting for a counter waits for every job 
+		* submitted with it. A counter can also hold back jobs that depend on it until it 
+		* reaches zero.
+		*
+		* A counter must not be destroyed until it has been waited on with JobSystem::Wait.
+		*/
+		class BIO_CORE_API JobCounter
+		{
+			friend class JobSystem;
+
+		private:
+			/**
+			* The number of jobs that are not finished.
+			*/
+			std::atomic<int> _count;
+
+			/**
+			* The number of threads still inside of the code finishing a job. Wait does not 
+			* return until this is zero so the counter can be destroyed right after.
+			*/
+			std::atomic<int> _finishing;
+
+			/**
+			* Guards _waiting.
+			*/
+			std::mutex _mutex;
+
+			/**
+			* Jobs held back until the counter reaches zero.
+			*/
+			std::vector<Job> _waiting;
+
+			/**Do not allow copying.*/
+			JobCounter(const JobCounter & other);
+			JobCounter & operator = (const JobCounter & other);
+
+		public:
+			/**
+			* Constructor
+			*/
+			JobCounter();
+
+			/**
+			* Get the number of jobs that are not finished.
+			*
+			* @return Returns the count.
+			*/
+			int GetCount() const;
+
+			/**
+			* Check if every job submitted with the counter is finished.
+			*
+			* @return Returns true if the count is zero.
+			*/
+			bool IsDone() const;
+		};
+
+		struct _JobQueue;
+
+		/**
+		* A pool of worker threads that run jobs. Each worker, and the thread that created the 
+		* system (the main thread), has its own queue. A thread pushes and pops jobs at one end
+		* of its own queue without locking, and threads with nothing to do steal from the other
+		* end of someone else's queue.
+		*
+		* Jobs may submit more jobs and wait on them. A thread waiting on a counter runs other 
+		* jobs until the counter is done, so waiting never blocks a worker.
+		*
+		* Main thread jobs are for work that must happen on the main thread (anything touching
+		* the rendering device). They run when the main thread calls RunMainThreadJobs or waits
+		* on a counter.
+		*/
+		class BIO_CORE_API JobSystem
+		{
+		private:
+			/**
+			* The queues. Index 0 belongs to the main thread.
+			*/
+			std::vector<_JobQueue *> _queues;
+
+			/**
+			* The worker threads.
+			*/
+			std::vector<std::thread> _workers;
+
+			/**
+			* Jobs submitted by threads that do not belong to the system.
+			*/
+			std::deque<Job> _external;
+
+			/**
+			* The number of jobs in _external. Lets threads skip the lock when it is empty.
+			*/
+			std::atomic<int> _externalCount;
+
+			/**
+			* Guards _external.
+			*/
+			std::mutex _externalMutex;
+
+			/**
+			* Jobs that must run on the main thread.
+			*/
+			std::vector<Job> _mainThreadJobs;
+
+			/**
+			* Guards _mainThreadJobs.
+			*/
+			std::mutex _mainThreadMutex;
+
+			/**
+			* The number of jobs that are queued and not taken yet.
+			*/
+			std::atomic<int> _queued;
+
+			/**
+			* The number of workers sleeping.
+			*/
+			std::atomic<int> _sleeping;
+
+			/**
+			* Guards sleeping and waking the workers.
+			*/
+			std::mutex _sleepMutex;
+
+			/**
+			* Wakes the workers when jobs are queued.
+			*/
+			std::condition_variable _wake;
+
+			/**
+			* Set to stop the workers.
+			*/
+			std::atomic<bool> _stop;
+
+			/**
+			* Jobs run by threads that do not belong to the system.
+			*/
+			std::atomic<uint64> _externalExecuted;
+
+			/**
+			* The main thread.
+			*/
+			std::thread::id _mainThread;
+
+			/**
+			* Get the queue of the calling thread.
+			*
+			* @return Returns the queue or NULL if the thread does not belong to the system.
+			*/
+			_JobQueue * _GetQueue() const;
+
+			/**
+			* Queue a job where the calling thread can find it fastest.
+			*/
+			void _Push(const Job & job);
+
+			/**
+			* Run a job and finish its counter.
+			*
+			* @param job The job to run.
+			* @param queue The queue of the calling thread or NULL.
+			*/
+			void _Run(const Job & job, _JobQueue * queue);
+
+			/**
+			* Run a job that is in a queue's pool and give the slot back to the queue.
+			*
+			* @param owner The queue the job's slot belongs to.
+			* @param job The job's slot.
+			* @param queue The queue of the calling thread or NULL.
+			*/
+			void _RunPooled(_JobQueue * owner, Job * job, _JobQueue * queue);
+
+			/**
+			* Find one job and run it.
+			*
+			* @return Returns true if a job was run.
+			*/
+			bool _RunOne();
+
+			/**
+			* Lower a counter and release the jobs waiting on it if it reaches zero.
+			*/
+			void _Finish(JobCounter * counter);
+
+			/**
+			* Wake a sleeping worker if there is one.
+			*/
+			void _WakeWorker();
+
+			/**
+			* The loop run by each worker thread.
+			*
+			* @param index The index of the worker's queue.
+			* @param core The core to pin the worker to or -1 to not pin it.
+			*/
+			void _WorkerLoop(unsigned int index, int core);
+
+			/**Do not allow copying.*/
+			JobSystem(const JobSystem & other);
+			JobSystem & operator = (const JobSystem & other);
+
+		public:
+			/**
+			* Constructor. The calling thread becomes the main thread.
+			*
+			* @param workerCount The number of worker threads. 0 uses one less than the number 
+			*			of cores.
+			* @param pinWorkers If true each worker is kept on its own core.
+			*/
+			JobSystem(unsigned int workerCount = 0, bool pinWorkers = false);
+
+			/**
+			* Destructor. Stops the workers. Jobs that have not started are not run.
+			*/
+			~JobSystem();
+
+			/**
+			* Get the number of jobs that have been run.
+			*
+			* @return Returns the number of jobs.
+			*/
+			uint64 GetExecutedCount() const;
+
+			/**
+			* Get the number of jobs that were stolen from another thread's queue.
+			*
+			* @return Returns the number of jobs.
+			*/
+			uint64 GetStolenCount() const;
+
+			/**
+			* Get the number of worker threads.
+			*
+			* @return Returns the number of workers.
+			*/
+			unsigned int GetWorkerCount() const;
+
+			/**
+			* Check if the calling thread is the main thread.
+			*
+			* @return Returns true on the thread that created the system.
+			*/
+			bool IsMainThread() const;
+
+			/**
+			* Run a function on every index of a range, split into batches run as jobs. Returns
+			* when the whole range is done.
+			*
+			* @param count The number of indices. The range is 0 to count.
+			* @param batchSize The number of indices each job works on. 0 picks a size.
+			* @param function The function to run on each batch.
+			* @param data Passed to the function.
+			*/
+			void ParallelFor(uint32 count, uint32 batchSize, JobRangeFunction function, void * data);
+
+			/**
+			* Run the jobs that must run on the main thread. Only the main thread may call this.
+			*
+			* @return Returns the number of jobs run.
+			*/
+			unsigned int RunMainThreadJobs();
+
+			/**
+			* Submit a job.
+			*
+			* @param function The function to run.
+			* @param data Passed to the function.
+			* @param counter If not NULL it is raised now and lowered when the job is done.
+			* @param dependency If not NULL the job does not start until this counter is zero.
+			*/
+			void Submit(JobFunction function, 
+				void * data, 
+				JobCounter * counter = NULL, 
+				JobCounter * dependency = NULL);
+
+			/**
+			* Submit a job that must run on the main thread.
+			*
+			* @param function The function to run.
+			* @param data Passed to the function.
+			* @param counter If not NULL it is raised now and lowered when the job is done.
+			*/
+			void SubmitMainThread(JobFunction function, void * data, JobCounter * counter = NULL);
+
+			/**
+			* Wait until every job submitted with a counter is done. The calling thread runs 
+			* other jobs while it waits.
+			*
+			* @param counter The counter to wait on.
+			*/
+			void Wait(JobCounter & counter);
+		};
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for the JobSystem class.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		bool TestJobSystem(XNELO::TESTING::Test * test);
+#endif
+	}//end namespace CORE
+}//end namespace BIO
+
+inline BIO::CORE::JobCounter::JobCounter() : _count(0), _finishing(0), _mutex(), _waiting()
+{
+	//Do Nothing
+}
+
+inline int BIO::CORE::JobCounter::GetCount() const
+{
+	return _count.load(std::memory_order_acquire);
+}
+
+inline bool BIO::CORE::JobCounter::IsDone() const
+{
+	return GetCount() <= 0;
+}
+
+inline unsigned int BIO::CORE::JobSystem::GetWorkerCount() const
+{
+	return (unsigned int)_workers.size();
+}
+
+inline bool BIO::CORE::JobSystem::IsMainThread() const
+{
+	return std::this_thread::get_id() == _mainThread;
+}
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+namespace BIO
+{
+	namespace CORE
+	{
+		/**Adds one to an atomic int.*/
+		inline void _TestJobIncrement(void * data)
+		{
+			((std::atomic<int> *)data)->fetch_add(1);
+		}
+
+		/**Data for the job dependency test.*/
+		struct _TestJobOrder
+		{
+			std::atomic<int> firstDone;
+			std::atomic<int> secondSawFirst;
+		};
+
+		/**The first job of the dependency test.*/
+		inline void _TestJobFirst(void * data)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			((_TestJobOrder *)data)->firstDone.store(1);
+		}
+
+		/**The second job of the dependency test.*/
+		inline void _TestJobSecond(void * data)
+		{
+			_TestJobOrder * order = (_TestJobOrder *)data;
+			order->secondSawFirst.store(order->firstDone.load());
+		}
+
+		/**Data for the nested job test.*/
+		struct _TestJobNested
+		{
+			JobSystem * system;
+			std::atomic<int> count;
+		};
+
+		/**Submits and waits on more jobs from inside a job.*/
+		inline void _TestJobParent(void * data)
+		{
+			_TestJobNested * nested = (_TestJobNested *)data;
+			JobCounter children;
+
+			for (int i = 0; i < 10; i++)
+				nested->system->Submit(_TestJobIncrement, &nested->count, &children);
+
+			nested->system->Wait(children);
+		}
+
+		/**Data for the main thread job test.*/
+		struct _TestJobMain
+		{
+			JobSystem * system;
+			std::atomic<int> ranOnMain;
+		};
+
+		/**Records if it ran on the main thread.*/
+		inline void _TestJobOnMain(void * data)
+		{
+			_TestJobMain * main = (_TestJobMain *)data;
+			main->ranOnMain.store(main->system->IsMainThread() ? 1 : 0);
+		}
+
+		/**Sums a range of values.*/
+		inline void _TestJobSum(void * data, uint32 begin, uint32 end)
+		{
+			std::vector<uint32> & values = *(std::vector<uint32> *)data;
+
+			for (uint32 i = begin; i < end; i++)
+				values[i] = i * 2;
+		}
+	}
+}
+
+inline bool BIO::CORE::TestJobSystem(XNELO::TESTING::Test * test)
+{
+	test->SetName("JobSystem Tests");
+
+	JobSystem jobs(3);
+	test->UnitTest(jobs.GetWorkerCount() == 3, "Worker count");
+	test->UnitTest(jobs.IsMainThread(), "Creating thread is the main thread");
+
+	//many jobs
+	std::atomic<int> count(0);
+	JobCounter counter;
+	for (int i = 0; i < 10000; i++)
+		jobs.Submit(_TestJobIncrement, &count, &counter);
+	jobs.Wait(counter);
+	test->UnitTest(count.load() == 10000, "Every job runs");
+	test->UnitTest(counter.IsDone(), "Counter is done");
+	test->UnitTest(jobs.GetExecutedCount() >= 10000, "Executed count");
+
+	//dependencies
+	_TestJobOrder order;
+	order.firstDone.store(0);
+	order.secondSawFirst.store(0);
+	JobCounter first;
+	JobCounter second;
+	jobs.Submit(_TestJobFirst, &order, &first);
+	jobs.Submit(_TestJobSecond, &order, &second, &first);
+	jobs.Wait(second);
+	jobs.Wait(first);
+	test->UnitTest(order.secondSawFirst.load() == 1, "Dependent job runs after its dependency");
+
+	//a dependency that is already done
+	count.store(0);
+	jobs.Submit(_TestJobIncrement, &count, &second, &first);
+	jobs.Wait(second);
+	test->UnitTest(count.load() == 1, "Job with finished dependency runs");
+
+	//nested jobs
+	_TestJobNested nested;
+	nested.system = &jobs;
+	nested.count.store(0);
+	JobCounter parents;
+	for (int i = 0; i < 20; i++)
+		jobs.Submit(_TestJobParent, &nested, &parents);
+	jobs.Wait(parents);
+	test->UnitTest(nested.count.load() == 200, "Jobs can wait on other jobs");
+
+	//main thread jobs
+	_TestJobMain main;
+	main.system = &jobs;
+	main.ranOnMain.store(0);
+	JobCounter mainCounter;
+	jobs.SubmitMainThread(_TestJobOnMain, &main, &mainCounter);
+	test->UnitTest(jobs.RunMainThreadJobs() == 1, "Run main thread jobs");
+	jobs.Wait(mainCounter);
+	test->UnitTest(main.ranOnMain.load() == 1, "Main thread job runs on the main thread");
+
+	//jobs from other threads
+	count.store(0);
+	JobCounter external;
+	std::thread submitter([&]()
+	{
+		for (int i = 0; i < 100; i++)
+			jobs.Submit(_TestJobIncrement, &count, &external);
+	});
+	submitter.join();
+	jobs.Wait(external);
+	test->UnitTest(count.load() == 100, "Jobs from other threads run");
+
+	//parallel for
+	std::vector<uint32> values(100000, 0);
+	jobs.ParallelFor((uint32)values.size(), 0, _TestJobSum, &values);
+	bool allSet = true;
+	for (uint32 i = 0; i < values.size(); i++)
+	{
+		if (values[i] != i * 2)
+			allSet = false;
+	}
+	test->UnitTest(allSet, "ParallelFor covers the whole range");
+
+	//no workers
+	JobSystem single(1);
+	count.store(0);
+	JobCounter singleCounter;
+	for (int i = 0; i < 5000; i++)
+		single.Submit(_TestJobIncrement, &count, &singleCounter);
+	single.Wait(singleCounter);
+	test->UnitTest(count.load() == 5000, "Jobs run past a full queue");
+
+	return test->GetSuccess();
+}
+#endif
+
+#endif //___BIO_CORE_JOBSYSTEM_HPP__2015___
@@ -0,0 +1,376 @@
+/**
+* @file LogArguments.hpp
+* @author Spencer Hoffa
+*
+* Captures the raw arguments of a log statement so they can be formatted later.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_CORE_LOGARGUMENTS_HPP__2015___
+#define ___BIO_CORE_LOGARGUMENTS_HPP__2015___
+
+#include "Config.h"
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+//Binary log file layout. Every entry starts with one of the entry types.
+#define BIO_LOGGER_BINARY_MAGIC "BIOLOG"
+#define BIO_LOGGER_BINARY_MAGIC_SIZE 6
+#define BIO_LOGGER_BINARY_VERSION 1
+#define BIO_LOGGER_BINARY_ENTRY_SITE 1
+#define BIO_LOGGER_BINARY_ENTRY_RECORD 2
+#define BIO_LOGGER_BINARY_ENTRY_TEXT 3
+
+namespace BIO
+{
+	namespace LOGGING
+	{
+		/**
+		* Describes one BIO_LOG statement in the source code. Every log macro creates a static
+		* LogSite so the file, line and format string only need to be written to a binary log
+		* once. The site also keeps the counts used to rate limit the statement. Everything but the 
+		* file and line starts at zero.
+		*/
+		struct LogSite
+		{
+			const char * filename;		/**< The file the statement is in.*/
+			unsigned int line;			/**< The line the statement is on.*/
+			unsigned int id;			/**< The id given to this site in the binary log.*/
+			unsigned int generation;	/**< The binary log the id belongs to.*/
+			std::atomic<unsigned int> rateWindow;		/**< The second being rate limited.*/
+			std::atomic<unsigned int> rateCount;		/**< Records logged in rateWindow.*/
+			std::atomic<unsigned int> rateSuppressed;	/**< Records thrown away by the limit.*/
+		};
+
+		/**
+		* The type tags written in front of every captured argument.
+		*/
+		enum LOG_ARGUMENT_TYPE
+		{
+			LOG_ARGUMENT_INT32 = 1,
+			LOG_ARGUMENT_UINT32,
+			LOG_ARGUMENT_INT64,
+			LOG_ARGUMENT_UINT64,
+			LOG_ARGUMENT_DOUBLE,
+			LOG_ARGUMENT_STRING,
+			LOG_ARGUMENT_POINTER
+		};
+
+		/**
+		* The memory the arguments of a log statement are written into. This normally points
+		* directly into a queued log record.
+		*/
+		struct LogArgumentBuffer
+		{
+			unsigned char * data;		/**< Where to write the arguments.*/
+			unsigned int size;			/**< The number of bytes written so far.*/
+			unsigned int capacity;		/**< The number of bytes data can hold.*/
+			void * record;				/**< The log record being written. Used by the Logger.*/
+		};
+
+		/**
+		* Write one tagged argument into the buffer. If the argument does not fit then the
+		* buffer is closed so no more arguments get written.
+		*
+		* @param buffer The buffer to write to.
+		* @param type The LOG_ARGUMENT_TYPE of the argument.
+		* @param bytes The raw bytes of the argument.
+		* @param count The number of bytes to write.
+		*/
+		inline void WriteLogArgument(LogArgumentBuffer & buffer,
+			unsigned char type,
+			const void * bytes,
+			unsigned int count)
+		{
+			if (buffer.size + 1 + count > buffer.capacity)
+			{
+				buffer.capacity = buffer.size;
+				return;
+			}
+
+			buffer.data[buffer.size] = type;
+			memcpy(buffer.data + buffer.size + 1, bytes, count);
+			buffer.size += 1 + count;
+		}
+
+		/**
+		* Write a string argument into the buffer. The string is truncated to fit in the space
+		* that is left.
+		*
+		* @param buffer The buffer to write to.
+		* @param value The string to write. NULL is written as "(null)".
+		* @param length The number of characters in value.
+		*/
+		inline void WriteLogString(LogArgumentBuffer & buffer, const char * value, size_t length)
+		{
+			if (value == NULL)
+			{
+				value = "(null)";
+				length = 6;
+			}
+
+			//type + length
+			if (buffer.size + 3 > buffer.capacity)
+			{
+				buffer.capacity = buffer.size;
+				return;
+			}
+
+			size_t space = buffer.capacity - buffer.size - 3;
+			unsigned short count = (unsigned short)(length < space ? length : space);
+
+			buffer.data[buffer.size] = LOG_ARGUMENT_STRING;
+			memcpy(buffer.data + buffer.size + 1, &count, 2);
+			memcpy(buffer.data + buffer.size + 3, value, count);
+			buffer.size += 3 + count;
+		}
+
+		/**
+		* Write a signed integer argument using 4 bytes if it fits, otherwise 8.
+		*
+		* @param buffer The buffer to write to.
+		* @param value The value to write.
+		*/
+		inline void WriteLogInteger(LogArgumentBuffer & buffer, long long value)
+		{
+			if ((value >= -2147483647 - 1) && (value <= 2147483647))
+			{
+				int small = (int)value;
+				WriteLogArgument(buffer, LOG_ARGUMENT_INT32, &small, sizeof(small));
+			}
+			else
+			{
+				WriteLogArgument(buffer, LOG_ARGUMENT_INT64, &value, sizeof(value));
+			}
+		}
+
+		/**
+		* Write an unsigned integer argument using 4 bytes if it fits, otherwise 8.
+		*
+		* @param buffer The buffer to write to.
+		* @param value The value to write.
+		*/
+		inline void WriteLogUnsigned(LogArgumentBuffer & buffer, unsigned long long value)
+		{
+			if (value <= 4294967295ULL)
+			{
+				unsigned int small = (unsigned int)value;
+				WriteLogArgument(buffer, LOG_ARGUMENT_UINT32, &small, sizeof(small));
+			}
+			else
+			{
+				WriteLogArgument(buffer, LOG_ARGUMENT_UINT64, &value, sizeof(value));
+			}
+		}
+
+		/**
+		* Capture one argument of a log statement. There is an overload for every type that can
+		* be passed to a printf style format. Enums and anything else that converts to an
+		* integer use the template version.
+		*
+		* @param buffer The buffer to write to.
+		* @param value The argument to capture.
+		*/
+		template <typename Type>
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, const Type & value)
+		{
+			WriteLogInteger(buffer, (long long)value);
+		}
+
+		template <typename Type>
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, Type * value)
+		{
+			unsigned long long address = (unsigned long long)(size_t)value;
+			WriteLogArgument(buffer, LOG_ARGUMENT_POINTER, &address, sizeof(address));
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, bool value)
+		{
+			WriteLogInteger(buffer, value ? 1 : 0);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, unsigned char value)
+		{
+			WriteLogUnsigned(buffer, value);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, unsigned short value)
+		{
+			WriteLogUnsigned(buffer, value);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, unsigned int value)
+		{
+			WriteLogUnsigned(buffer, value);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, unsigned long value)
+		{
+			WriteLogUnsigned(buffer, value);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, unsigned long long value)
+		{
+			WriteLogUnsigned(buffer, value);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, float value)
+		{
+			double wide = value;
+			WriteLogArgument(buffer, LOG_ARGUMENT_DOUBLE, &wide, sizeof(wide));
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, double value)
+		{
+			WriteLogArgument(buffer, LOG_ARGUMENT_DOUBLE, &value, sizeof(value));
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, long double value)
+		{
+			double wide = (double)value;
+			WriteLogArgument(buffer, LOG_ARGUMENT_DOUBLE, &wide, sizeof(wide));
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, const char * value)
+		{
+			WriteLogString(buffer, value, value ? strlen(value) : 0);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, char * value)
+		{
+			WriteLogString(buffer, value, value ? strlen(value) : 0);
+		}
+
+		inline void EncodeLogArgument(LogArgumentBuffer & buffer, const std::string & value)
+		{
+			WriteLogString(buffer, value.c_str(), value.size());
+		}
+
+		/**
+		* Capture all of the arguments of a log statement in order.
+		*/
+		inline void EncodeLogArguments(LogArgumentBuffer &)
+		{
+			//no more arguments
+		}
+
+		template <typename Type, typename... Rest>
+		inline void EncodeLogArguments(LogArgumentBuffer & buffer,
+			const Type & value,
+			const Rest &... rest)
+		{
+			EncodeLogArgument(buffer, value);
+			EncodeLogArguments(buffer, rest...);
+		}
+
+		/**
+		* Turn a format string and the arguments captured for it back into text. This works the
+		* same as snprintf except the arguments come from a capture buffer. Arguments that are
+		* missing or have the wrong type for their format specifier are written as "(?)".
+		*
+		* @param[in] format The printf style format string.
+		* @param[in] data The captured arguments.
+		* @param[in] size The number of bytes in data.
+		* @param[out] output Where to write the text. This is always null terminated.
+		* @param[in] outputSize The number of chars output can hold.
+		*
+		* @return Returns the number of chars written, not counting the null terminator.
+		*/
+		BIO_CORE_API unsigned int FormatLogArguments(const char * format,
+			const unsigned char * data,
+			unsigned int size,
+			char * output,
+			unsigned int outputSize);
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for capturing and formatting log arguments.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		bool TestLogArguments(XNELO::TESTING::Test * test);
+#endif
+	}//end namespace LOGGING
+}//end namespace BIO
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+/**
+* Capture the arguments and format them into a string. Used by the log argument tests.
+*/
+template <typename... Args>
+inline std::string TestFormatLogArguments(unsigned int capacity, const char * format, const Args &... args)
+{
+	unsigned char data[256];
+	BIO::LOGGING::LogArgumentBuffer buffer = { data, 0, capacity, NULL };
+	BIO::LOGGING::EncodeLogArguments(buffer, args...);
+
+	char output[256];
+	BIO::LOGGING::FormatLogArguments(format, data, buffer.size, output, sizeof(output));
+
+	return std::string(output);
+}
+
+inline bool BIO::LOGGING::TestLogArguments(XNELO::TESTING::Test * test)
+{
+	test->SetName("Log Arguments Tests");
+
+	std::string name = "tank1";
+	const char * cName = "level";
+	char buffer[16] = "buffer";
+
+	test->UnitTest(TestFormatLogArguments(256, "No arguments") == "No arguments",
+		"Format without arguments");
+	test->UnitTest(TestFormatLogArguments(256, "100%%") == "100%", "Format percent sign");
+	test->UnitTest(TestFormatLogArguments(256, "%i %d %u", -5, 12, 7u) == "-5 12 7",
+		"Format integers");
+	test->UnitTest(TestFormatLogArguments(256, "%lld", 123456789012LL) == "123456789012",
+		"Format 64 bit integer");
+	test->UnitTest(TestFormatLogArguments(256, "%x %04X", 255, 171) == "ff 00AB",
+		"Format hex");
+	test->UnitTest(TestFormatLogArguments(256, "%.2f %g", 1.5f, 2.25) == "1.50 2.25",
+		"Format floating point");
+	test->UnitTest(TestFormatLogArguments(256, "%s %s %s", name, cName, buffer) == "tank1 level buffer",
+		"Format strings");
+	test->UnitTest(TestFormatLogArguments(256, "%-6s|%5s", "ab", "cd") == "ab    |   cd",
+		"Format string width");
+	test->UnitTest(TestFormatLogArguments(256, "%c%c", 'o', 'k') == "ok", "Format chars");
+	test->UnitTest(TestFormatLogArguments(256, "%*d", 4, 7) == "   7", "Format star width");
+	test->UnitTest(TestFormatLogArguments(256, "%d %d", 1) == "1 (?)", "Format missing argument");
+	test->UnitTest(TestFormatLogArguments(256, "%s", 12) == "(?)", "Format wrong argument type");
+	test->UnitTest(TestFormatLogArguments(256, "%i", true) == "1", "Format bool");
+	test->UnitTest(TestFormatLogArguments(8, "%d %d %d", 1, 2, 3) == "1 (?) (?)",
+		"Arguments that do not fit are dropped");
+	test->UnitTest(TestFormatLogArguments(8, "%s", "truncated") == "trunc",
+		"Strings are truncated to fit");
+
+	return test->GetSuccess();
+}
+#endif
+
+#endif //___BIO_CORE_LOGARGUMENTS_HPP__2015___
@@ -0,0 +1,407 @@
+/**
+* @file LogSinks.hpp
+* @author Spencer Hoffa
+*
+* The places the Logger can write log statements to besides its main stream.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_CORE_LOGSINKS_HPP__2015___
+#define ___BIO_CORE_LOGSINKS_HPP__2015___
+
+#include "Config.h"
+#include "Logger.hpp"
+
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#include "FileUtils.hpp"
+#include <sstream>
+#endif
+
+namespace BIO
+{
+	namespace LOGGING
+	{
+		/**
+		* An abstract interface for a place log statements are written to. Each sink has its own
+		* logging level so it can hold less (or more) than the other sinks.
+		*
+		* The Logger only calls Write and Flush from one thread at a time so a sink does not
+		* need to lock unless it is also read from other threads.
+		*/
+		class BIO_CORE_API ILogSink
+		{
+		protected:
+			/**
+			* The highest level this sink writes.
+			*/
+			std::atomic<int> _level;
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param level The highest level this sink writes.
+			*/
+			ILogSink(int level);
+
+			/**
+			* Destructor
+			*/
+			virtual ~ILogSink();
+
+			/**
+			* Get the highest level this sink writes.
+			*
+			* @return Returns the level of the sink.
+			*/
+			int GetLevel() const;
+
+			/**
+			* Set the highest level this sink writes. This can be called from any thread.
+			*
+			* @param level The new level of the sink.
+			*/
+			void SetLevel(int level);
+
+			/**
+			* Write one formatted log line.
+			*
+			* @param level The level of the statement.
+			* @param text The formatted line, ending with a newline. Not null terminated.
+			* @param length The number of chars in text.
+			*/
+			virtual void Write(int level, const char * text, unsigned int length) = 0;
+
+			/**
+			* Make sure everything written so far is stored.
+			*/
+			virtual void Flush();
+		};
+
+		/**
+		* A sink that writes to the console, or any other stream.
+		*/
+		class BIO_CORE_API ConsoleLogSink : public ILogSink
+		{
+		private:
+			/**
+			* The stream to write to.
+			*/
+			std::ostream * _stream;
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param level The highest level this sink writes.
+			* @param stream The stream to write to. If NULL then std::cout is used.
+			*/
+			ConsoleLogSink(int level = MaxLoggingLevel, std::ostream * stream = NULL);
+
+			virtual void Write(int level, const char * text, unsigned int length);
+
+			virtual void Flush();
+		};
+
+		/**
+		* A sink that writes to a file and starts a new file when the current one gets too big
+		* or too old. Old files are kept as filename.1 (the newest) up to filename.N.
+		*/
+		class BIO_CORE_API RotatingFileLogSink : public ILogSink
+		{
+		private:
+			/**
+			* The file currently being written.
+			*/
+			std::string _filename;
+
+			/**
+			* The open file.
+			*/
+			std::ofstream _file;
+
+			/**
+			* Start a new file when the current one would go over this size. 0 for no limit.
+			*/
+			unsigned long long _maxBytes;
+
+			/**
+			* Start a new file when the current one is this many seconds old. 0 for no limit.
+			*/
+			unsigned int _maxSeconds;
+
+			/**
+			* The number of old files to keep.
+			*/
+			unsigned int _maxFiles;
+
+			/**
+			* The number of bytes in the current file.
+			*/
+			unsigned long long _size;
+
+			/**
+			* When the current file was started.
+			*/
+			time_t _opened;
+
+			/**
+			* The number of times a new file was started.
+			*/
+			unsigned int _rotations;
+
+			/**
+			* Close the current file, rename the old files and start a new file.
+			*/
+			void _Rotate();
+
+			/**
+			* Get the name of an old file.
+			*
+			* @param index Which old file. 1 is the newest.
+			*
+			* @return Returns the name of the file.
+			*/
+			std::string _GetOldFilename(unsigned int index) const;
+
+		public:
+			/**
+			* Constructor. The file is truncated when it is opened.
+			*
+			* @param filename The file to write to.
+			* @param level The highest level this sink writes.
+			* @param maxBytes Start a new file when the current one would go over this size.
+			*			0 for no limit.
+			* @param maxSeconds Start a new file when the current one is this many seconds old.
+			*			0 for no limit.
+			* @param maxFiles The number of old files to keep. If 0 the file is just truncated.
+			*/
+			RotatingFileLogSink(const char * filename,
+				int level = MaxLoggingLevel,
+				unsigned long long maxBytes = 0,
+				unsigned int maxSeconds = 0,
+				unsigned int maxFiles = 1);
+
+			/**
+			* Destructor
+			*/
+			virtual ~RotatingFileLogSink();
+
+			/**
+			* Check if the file was opened.
+			*
+			* @return Returns true if the file is open.
+			*/
+			bool IsOpen() const;
+
+			/**
+			* Get the number of times a new file was started.
+			*
+			* @return Returns the number of rotations.
+			*/
+			unsigned int GetRotationCount() const;
+
+			virtual void Write(int level, const char * text, unsigned int length);
+
+			virtual void Flush();
+		};
+
+		/**
+		* A sink that keeps the most recent log text in memory so it can be written out after a
+		* crash. Only the last capacity bytes are kept.
+		*/
+		class BIO_CORE_API MemoryLogSink : public ILogSink
+		{
+		private:
+			/**
+			* The ring of text.
+			*/
+			char * _buffer;
+
+			/**
+			* The size of _buffer.
+			*/
+			unsigned int _capacity;
+
+			/**
+			* The total number of bytes ever written. The next byte goes at _written % _capacity.
+			*/
+			unsigned long long _written;
+
+			/**
+			* Guards the buffer so it can be read from any thread.
+			*/
+			mutable std::mutex _mutex;
+
+			/**Do not allow copying.*/
+			MemoryLogSink(const MemoryLogSink & other);
+			MemoryLogSink & operator = (const MemoryLogSink & other);
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param capacity The number of bytes of text to keep.
+			* @param level The highest level this sink writes.
+			*/
+			MemoryLogSink(unsigned int capacity, int level = MaxLoggingLevel);
+
+			/**
+			* Destructor
+			*/
+			virtual ~MemoryLogSink();
+
+			/**
+			* Get the text that is being kept. If older text was thrown away the partial line at
+			* the start is skipped.
+			*
+			* @return Returns the most recent lines in the order they were written.
+			*/
+			std::string GetContents() const;
+
+			/**
+			* Write the text that is being kept to a stream.
+			*
+			* @param stream The stream to write to.
+			*/
+			void Dump(std::ostream & stream) const;
+
+			/**
+			* Throw away everything being kept.
+			*/
+			void Clear();
+
+			virtual void Write(int level, const char * text, unsigned int length);
+		};
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for the log sinks.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		bool TestLogSinks(XNELO::TESTING::Test * test);
+#endif
+	}//end namespace LOGGING
+}//end namespace BIO
+
+inline BIO::LOGGING::ILogSink::ILogSink(int level) : _level(level)
+{
+	//Do Nothing
+}
+
+inline BIO::LOGGING::ILogSink::~ILogSink()
+{
+	//Do Nothing
+}
+
+inline int BIO::LOGGING::ILogSink::GetLevel() const
+{
+	return _level.load(std::memory_order_relaxed);
+}
+
+inline void BIO::LOGGING::ILogSink::SetLevel(int level)
+{
+	_level.store(level, std::memory_order_relaxed);
+}
+
+inline void BIO::LOGGING::ILogSink::Flush()
+{
+	//Do Nothing
+}
+
+inline bool BIO::LOGGING::RotatingFileLogSink::IsOpen() const
+{
+	return _file.is_open();
+}
+
+inline unsigned int BIO::LOGGING::RotatingFileLogSink::GetRotationCount() const
+{
+	return _rotations;
+}
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+inline bool BIO::LOGGING::TestLogSinks(XNELO::TESTING::Test * test)
+{
+	test->SetName("Log Sinks Tests");
+
+	//Console
+	std::stringstream console;
+	ConsoleLogSink consoleSink(BIO_LOGGER_LEVEL_WARNING, &console);
+	test->UnitTest(consoleSink.GetLevel() == BIO_LOGGER_LEVEL_WARNING, "Sink level");
+	consoleSink.Write(BIO_LOGGER_LEVEL_ERROR, "line one\n", 9);
+	test->UnitTest(console.str() == "line one\n", "Console sink writes to its stream");
+	consoleSink.SetLevel(BIO_LOGGER_LEVEL_DEBUG);
+	test->UnitTest(consoleSink.GetLevel() == BIO_LOGGER_LEVEL_DEBUG, "Set sink level");
+
+	//Memory
+	MemoryLogSink memory(16);
+	test->UnitTest(memory.GetContents() == "", "New memory sink is empty");
+	memory.Write(BIO_LOGGER_LEVEL_INFO, "first\n", 6);
+	memory.Write(BIO_LOGGER_LEVEL_INFO, "second\n", 7);
+	test->UnitTest(memory.GetContents() == "first\nsecond\n", "Memory sink keeps lines");
+	memory.Write(BIO_LOGGER_LEVEL_INFO, "third\n", 6);
+	test->UnitTest(memory.GetContents() == "second\nthird\n", "Memory sink drops old lines");
+	memory.Write(BIO_LOGGER_LEVEL_INFO, "a much longer line\n", 19);
+	test->UnitTest(memory.GetContents() == "", "Memory sink skips partial line");
+	memory.Write(BIO_LOGGER_LEVEL_INFO, "end\n", 4);
+	test->UnitTest(memory.GetContents() == "end\n", "Memory sink after partial line");
+	memory.Clear();
+	test->UnitTest(memory.GetContents() == "", "Memory sink clear");
+
+	//Rotating file
+	const char * filename = "BIOLogSinkTest.log";
+	{
+		RotatingFileLogSink file(filename, MaxLoggingLevel, 20, 0, 2);
+		test->UnitTest(file.IsOpen(), "Rotating file is open");
+
+		for (int i = 0; i < 5; i++)
+			file.Write(BIO_LOGGER_LEVEL_INFO, "0123456789\n", 11);
+
+		file.Flush();
+		test->UnitTest(file.GetRotationCount() == 4, "Rotating file rotates on size");
+	}
+
+	test->UnitTest(FILE::FileExists(filename), "Rotating file current file");
+	test->UnitTest(FILE::FileExists("BIOLogSinkTest.log.1"), "Rotating file first old file");
+	test->UnitTest(FILE::FileExists("BIOLogSinkTest.log.2"), "Rotating file second old file");
+	test->UnitTest(!FILE::FileExists("BIOLogSinkTest.log.3"), "Rotating file keeps maxFiles");
+
+	FILE::DeleteFile(filename);
+	FILE::DeleteFile("BIOLogSinkTest.log.1");
+	FILE::DeleteFile("BIOLogSinkTest.log.2");
+
+	return test->GetSuccess();
+}
+#endif
+
+#endif //___BIO_CORE_LOGSINKS_HPP__2015___
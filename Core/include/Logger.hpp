@@ -28,9 +28,16 @@
 #define ___BIO_CORE_LOGGER_HPP__2015___
 
 #include "Config.h"
+#include "LogArguments.hpp"
+#include <atomic>
+#include <istream>
 #include <ostream>
 #include <stdarg.h>
 
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
 //define the logging levels
 #define BIO_LOGGER_LEVEL_OFF 0
 #define BIO_LOGGER_LEVEL_CRITICAL 1
@@ -48,6 +55,53 @@
 #define BIO_LOGGER_MAX_LOGGING_LEVEL BIO_LOGGER_LEVEL_DEBUG4
 #endif //BIO_LOGGER_MAX_LOGGING_LEVEL
 
+//define the modules that log statements belong to
+#define BIO_LOGGER_MODULE_CORE 0
+#define BIO_LOGGER_MODULE_ENGINE 1
+#define BIO_LOGGER_MODULE_LOADER 2
+#define BIO_LOGGER_MODULE_RENDERER 3
+#define BIO_LOGGER_MODULE_COUNT 4
+
+//The highest level each module is compiled with. Statements above these levels compile to 
+//nothing. Define any of these in the build to strip a module's verbose logging.
+#ifndef BIO_LOGGER_MAX_LEVEL_CORE
+#define BIO_LOGGER_MAX_LEVEL_CORE BIO_LOGGER_MAX_LOGGING_LEVEL
+#endif //BIO_LOGGER_MAX_LEVEL_CORE
+
+#ifndef BIO_LOGGER_MAX_LEVEL_ENGINE
+#define BIO_LOGGER_MAX_LEVEL_ENGINE BIO_LOGGER_MAX_LOGGING_LEVEL
+#endif //BIO_LOGGER_MAX_LEVEL_ENGINE
+
+#ifndef BIO_LOGGER_MAX_LEVEL_LOADER
+#define BIO_LOGGER_MAX_LEVEL_LOADER BIO_LOGGER_MAX_LOGGING_LEVEL
+#endif //BIO_LOGGER_MAX_LEVEL_LOADER
+
+#ifndef BIO_LOGGER_MAX_LEVEL_RENDERER
+#define BIO_LOGGER_MAX_LEVEL_RENDERER BIO_LOGGER_MAX_LOGGING_LEVEL
+#endif //BIO_LOGGER_MAX_LEVEL_RENDERER
+
+//Tell the compiler which way the runtime level check usually goes.
+#if defined(__GNUC__)
+#define BIO_LOGGER_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define BIO_LOGGER_UNLIKELY(condition) (condition)
+#endif
+
+//The longest message (or captured arguments) a log record can hold. Longer messages are truncated.
+#ifndef BIO_LOGGER_RECORD_MESSAGE_SIZE
+#define BIO_LOGGER_RECORD_MESSAGE_SIZE 256
+#endif //BIO_LOGGER_RECORD_MESSAGE_SIZE
+
+//The default number of records each thread can queue before the drain thread catches up.
+#ifndef BIO_LOGGER_DEFAULT_QUEUE_SIZE
+#define BIO_LOGGER_DEFAULT_QUEUE_SIZE 1024
+#endif //BIO_LOGGER_DEFAULT_QUEUE_SIZE
+
+//The most sinks that can be registered with the Logger at once.
+#ifndef BIO_LOGGER_MAX_SINKS
+#define BIO_LOGGER_MAX_SINKS 8
+#endif //BIO_LOGGER_MAX_SINKS
+
 namespace BIO
 {
 	namespace LOGGING
@@ -55,11 +109,156 @@ namespace BIO
 		/**The maximum logging level allowed*/
 		const int MaxLoggingLevel = BIO_LOGGER_MAX_LOGGING_LEVEL;
 
+		class ILogSink;
+
+		/**
+		* Defines how log statements get written to the output stream.
+		*/
+		enum LOGGING_MODE
+		{
+			/**Format and write every log statement on the calling thread.*/
+			LOGGING_MODE_SYNCHRONOUS = 0,
+			/**
+			* Queue log records on the calling thread and let a background thread do the 
+			* formatting and writing.
+			*/
+			LOGGING_MODE_ASYNCHRONOUS
+		};
+
+		/**
+		* Defines what happens when a thread's queue is full in asynchronous mode.
+		*/
+		enum LOGGING_QUEUE_POLICY
+		{
+			/**Throw the record away and count it as dropped.*/
+			LOGGING_QUEUE_DROP = 0,
+			/**Wait for the background thread to make room in the queue.*/
+			LOGGING_QUEUE_BLOCK
+		};
+
+		/**
+		* Defines what gets written to the output stream.
+		*/
+		enum LOGGING_OUTPUT
+		{
+			/**Human readable text.*/
+			LOGGING_OUTPUT_TEXT = 0,
+			/**
+			* Binary records holding the raw arguments of each log statement. The stream should 
+			* be opened in binary mode. Use DecodeBinaryLog (or the LogDecoder utility) to turn 
+			* it back into text.
+			*/
+			LOGGING_OUTPUT_BINARY,
+			/**Nothing is written to the output stream. Statements only go to the sinks.*/
+			LOGGING_OUTPUT_NONE
+		};
+
+		/**
+		* Holds all of the properties needed to initialize the Logger.
+		*/
+		class LoggerConfiguration
+		{
+		public:
+			/**Write log statements synchronously or asynchronously.*/
+			LOGGING_MODE mode;
+
+			/**Write text or binary records.*/
+			LOGGING_OUTPUT output;
+
+			/**What to do when a queue is full. Only used in asynchronous mode.*/
+			LOGGING_QUEUE_POLICY queuePolicy;
+
+			/**
+			* The number of records each logging thread can queue. This is rounded up to a power 
+			* of two. Only used in asynchronous mode.
+			*/
+			unsigned int queueSize;
+
+			/**
+			* The most records a single log statement may write each second. Records over the 
+			* limit are thrown away and counted, the next record written from the statement says 
+			* how many were thrown away. 0 for no limit.
+			*/
+			unsigned int rateLimit;
+
+			/**
+			* The sinks to write to along with the output stream. These are not owned by the 
+			* Logger and must stay alive until Shutdown is called or they are removed.
+			*/
+			ILogSink * sinks[BIO_LOGGER_MAX_SINKS];
+
+			/**The number of sinks in sinks.*/
+			unsigned int sinkCount;
+
+			/**
+			* Default Constructor
+			*/
+			LoggerConfiguration();
+
+			/**
+			* Add a sink to be registered when the Logger is initialized.
+			*
+			* @param[in] sink The sink to add.
+			*
+			* @return Returns false if sink is NULL or there is no room for more sinks.
+			*/
+			bool AddSink(ILogSink * sink);
+		};
+
 		/**
 		* Initialize the Logger.
 		*/
 		BIO_CORE_API void Init(int level, std::ostream * stream = NULL);
 
+		/**
+		* Initialize the Logger.
+		*
+		* @param[in] level The logging level to start at.
+		* @param[in] stream The stream to write to. If NULL then std::cout is used.
+		* @param[in] config A LoggerConfiguration with the mode and queue settings to use.
+		*/
+		BIO_CORE_API void Init(int level, std::ostream * stream, const LoggerConfiguration & config);
+
+		/**
+		* Wait until every queued log record has been written to the output stream. In 
+		* synchronous mode this only flushes the output stream.
+		*/
+		BIO_CORE_API void Flush();
+
+		/**
+		* Get the number of log records that were thrown away because a queue was full.
+		*
+		* @return Returns the number of dropped records since Init was called.
+		*/
+		BIO_CORE_API unsigned long long GetDroppedRecordCount();
+
+		/**
+		* Get the number of log records that were thrown away by rate limiting.
+		*
+		* @return Returns the number of rate limited records since Init was called.
+		*/
+		BIO_CORE_API unsigned long long GetRateLimitedRecordCount();
+
+		/**
+		* Start writing log statements to a sink. The sink is not owned by the Logger and must 
+		* stay alive until Shutdown is called or it is removed. Sinks are cleared by Shutdown.
+		*
+		* @param[in] sink The sink to add.
+		*
+		* @return Returns false if sink is NULL, already added or BIO_LOGGER_MAX_SINKS are 
+		*			already registered.
+		*/
+		BIO_CORE_API bool AddSink(ILogSink * sink);
+
+		/**
+		* Stop writing log statements to a sink. The sink is flushed first.
+		*
+		* @param[in] sink The sink to remove.
+		*
+		* @return Returns false if the sink was not registered.
+		*/
+		BIO_CORE_API bool RemoveSink(ILogSink * sink);
+
 		/**
 		* Log a message. This function is similar to the printf strings in C. See printf 
 		* documentation for formating information.
@@ -91,14 +290,103 @@ namespace BIO
 		BIO_CORE_API void Log(int level, const char * format, ...);
 
 		/**
-		* Set the logging level to use. Only logging levels that are equal to or less than the set 
-		* value will be printed in the log.
+		* Start a deferred log statement. A record is reserved for the statement and buffer is 
+		* pointed at the space for its arguments. The level is not checked here, the BIO_LOG 
+		* macros check it with IsLogging first. Use the BIO_LOG macros instead of calling this 
+		* directly.
+		*
+		* @param[in] level The level of the message being logged.
+		* @param[in] site The static LogSite of the statement.
+		* @param[in] format The format string of the statement. This must stay valid until the 
+		*				Logger is shutdown (a string literal).
+		* @param[out] buffer Where to write the arguments of the statement.
+		*
+		* @return Returns true if the arguments should be written and EndDeferredLog called. 
+		*			False if the statement was dropped.
+		*/
+		BIO_CORE_API bool BeginDeferredLog(int level, 
+			LogSite & site, 
+			const char * format, 
+			LogArgumentBuffer & buffer);
+
+		/**
+		* Finish a deferred log statement started with BeginDeferredLog.
+		*
+		* @param[in] buffer The buffer the arguments were written to.
+		*/
+		BIO_CORE_API void EndDeferredLog(LogArgumentBuffer & buffer);
+
+		/**
+		* Log a message without formatting it on the calling thread. The arguments are copied 
+		* into a log record and the format string is only applied when the record is written as 
+		* text, or offline when a binary log is decoded. The level is not checked, call 
+		* IsLogging first.
+		*
+		* @param[in] level The level of the message being logged.
+		* @param[in] site The static LogSite of the statement.
+		* @param[in] format A printf style format string. Must be a string literal.
+		* @param[in] args The arguments for the format string.
+		*/
+		template <typename... Args>
+		void LogDeferred(int level, LogSite & site, const char * format, const Args &... args);
+
+		/**
+		* Turn a binary log written with LOGGING_OUTPUT_BINARY back into text.
+		*
+		* @param[in] input The binary log. Should be opened in binary mode.
+		* @param[out] output Where to write the text.
+		*
+		* @return Returns true if the whole log was decoded. False if the input is not a binary 
+		*			log or it is corrupt. Everything up to the error is still written.
+		*/
+		BIO_CORE_API bool DecodeBinaryLog(std::istream & input, std::ostream & output);
+
+		/**
+		* Set the logging level to use for every module. Only logging levels that are equal to or 
+		* less than the set value will be printed in the log.
 		*
 		* @param[in] level The new level to log to. If level > MaxLoggingLevel then the level will 
 		*				be set to MaxLoggingLevel. If the new level < 0 then it will be set to 0.
 		*/
 		BIO_CORE_API void SetLoggingLevel(int level);
 
+		/**
+		* Set the logging level of one module. Only statements of the module with a level equal 
+		* to or less than the set value will be printed in the log.
+		*
+		* @param[in] module The module to change. One of the BIO_LOGGER_MODULE_* values.
+		* @param[in] level The new level to log to. Clamped the same as SetLoggingLevel.
+		*/
+		BIO_CORE_API void SetModuleLoggingLevel(int module, int level);
+
+		/**
+		* Get the logging level of one module.
+		*
+		* @param[in] module The module to check. One of the BIO_LOGGER_MODULE_* values.
+		*
+		* @return Returns the current logging level of the module.
+		*/
+		BIO_CORE_API int GetModuleLoggingLevel(int module);
+
+		/**
+		* Check if a statement of the given module and level would be logged. This is only a 
+		* relaxed load and a compare so it is cheap enough to do before the arguments of every 
+		* statement are evaluated.
+		*
+		* @param[in] module The module of the statement. One of the BIO_LOGGER_MODULE_* values.
+		* @param[in] level The level of the statement.
+		*
+		* @return Returns true if the statement should be logged.
+		*/
+		bool IsLogging(int module, int level);
+
+#if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
+		/**
+		* The runtime logging level of each module. Use SetModuleLoggingLevel to change these.
+		*/
+		BIO_CORE_API extern std::atomic<int> ModuleLoggingLevels[BIO_LOGGER_MODULE_COUNT];
+#endif
+
 		/**
 		* Shutdown logging. 
 		*
@@ -106,51 +394,145 @@ namespace BIO
 		*		when the program exits. If it is called earlier nothing is done updon program exit.
 		*/
 		BIO_CORE_API void Shutdown();
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for the Logger. The Logger is initialized and shutdown by the 
+		* tests so they must not run while something else is logging.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		BIO_CORE_API bool TestLogger(XNELO::TESTING::Test * test);
+#endif
 	}//end namespace LOGGING
 }//end namespace BIO
 
+inline BIO::LOGGING::LoggerConfiguration::LoggerConfiguration() :
+mode(LOGGING_MODE_SYNCHRONOUS),
+output(LOGGING_OUTPUT_TEXT),
+queuePolicy(LOGGING_QUEUE_DROP),
+queueSize(BIO_LOGGER_DEFAULT_QUEUE_SIZE),
+rateLimit(0),
+sinkCount(0)
+{
+	//Do Nothing
+}
+
+inline bool BIO::LOGGING::LoggerConfiguration::AddSink(ILogSink * sink)
+{
+	if ((sink == NULL) || (sinkCount >= BIO_LOGGER_MAX_SINKS))
+		return false;
+
+	sinks[sinkCount++] = sink;
+
+	return true;
+}
+
+inline bool BIO::LOGGING::IsLogging(int module, int level)
+{
+#if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
+	return level <= ModuleLoggingLevels[module].load(std::memory_order_relaxed);
+#else
+	return false;
+#endif
+}
+
+template <typename... Args>
+inline void BIO::LOGGING::LogDeferred(int level, LogSite & site, const char * format, const Args &... args)
+{
+	LogArgumentBuffer buffer;
+
+	if (!BeginDeferredLog(level, site, format, buffer))
+		return;
+
+	EncodeLogArguments(buffer, args...);
+	EndDeferredLog(buffer);
+}
+
 //define macros to use instead of the function calls
 #if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
 
 #define BIO_LOGGING_INIT(level, stream) BIO::LOGGING::Init(level, stream);
 
-#define BIO_LOG(level, format, ...) BIO::LOGGING::Log(level, __LINE__, __FILE__, format, __VA_ARGS__);
+#define BIO_LOGGING_INIT_CONFIG(level, stream, config) BIO::LOGGING::Init(level, stream, config);
+
+//The format string is the first of the variable arguments so that log statements without any 
+//arguments work on every compiler. Each statement gets its own static LogSite.
+//module is CORE, ENGINE, LOADER or RENDERER. The first check is a constant so statements above 
+//the module's compiled level are removed by the compiler. The second is the runtime level, done 
+//before any of the arguments are evaluated.
+#define BIO_LOG_MODULE(module, level, ...) do { \
+	if (((level) <= BIO_LOGGER_MAX_LEVEL_##module) && \
+		BIO_LOGGER_UNLIKELY(BIO::LOGGING::IsLogging(BIO_LOGGER_MODULE_##module, (level)))) \
+	{ \
+		static BIO::LOGGING::LogSite _bioLogSite = { __FILE__, __LINE__, 0, 0, {0}, {0}, {0} }; \
+		BIO::LOGGING::LogDeferred((level), _bioLogSite, __VA_ARGS__); \
+	} \
+} while (0);
+
+//Log to a module. level is the name of the level, e.g. BIO_LOG_ENGINE(DEBUG4, "Yielding").
+#define BIO_LOG_CORE(level, ...) BIO_LOG_MODULE(CORE, BIO_LOGGER_LEVEL_##level, __VA_ARGS__)
+#define BIO_LOG_ENGINE(level, ...) BIO_LOG_MODULE(ENGINE, BIO_LOGGER_LEVEL_##level, __VA_ARGS__)
+#define BIO_LOG_LOADER(level, ...) BIO_LOG_MODULE(LOADER, BIO_LOGGER_LEVEL_##level, __VA_ARGS__)
+#define BIO_LOG_RENDERER(level, ...) BIO_LOG_MODULE(RENDERER, BIO_LOGGER_LEVEL_##level, __VA_ARGS__)
 
-#define BIO_LOG_CRITICAL(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_CRITICAL, format, __VA_ARGS__)
-#define BIO_LOG_ERROR(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_ERROR, format, __VA_ARGS__)
-#define BIO_LOG_WARNING(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_WARNING, format, __VA_ARGS__)
-#define BIO_LOG_INFO(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_INFO, format, __VA_ARGS__)
-#define BIO_LOG_MESSAGE(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_MESSAGE, format, __VA_ARGS__)
-#define BIO_LOG_DEBUG_N(level, format, ...) BIO_LOG((level + BIO_LOGGER_LEVEL_INFO), format, __VA_ARGS__)
-#define BIO_LOG_DEBUG(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG, format, __VA_ARGS__)
-#define BIO_LOG_DEBUG1(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG1, format, __VA_ARGS__)
-#define BIO_LOG_DEBUG2(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG2, format, __VA_ARGS__)
-#define BIO_LOG_DEBUG3(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG3, format, __VA_ARGS__)
-#define BIO_LOG_DEBUG4(format, ...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG4, format, __VA_ARGS__)
+//Statements that do not name a module belong to Core.
+#define BIO_LOG(level, ...) BIO_LOG_MODULE(CORE, level, __VA_ARGS__)
+
+#define BIO_LOG_CRITICAL(...) BIO_LOG(BIO_LOGGER_LEVEL_CRITICAL, __VA_ARGS__)
+#define BIO_LOG_ERROR(...) BIO_LOG(BIO_LOGGER_LEVEL_ERROR, __VA_ARGS__)
+#define BIO_LOG_WARNING(...) BIO_LOG(BIO_LOGGER_LEVEL_WARNING, __VA_ARGS__)
+#define BIO_LOG_INFO(...) BIO_LOG(BIO_LOGGER_LEVEL_INFO, __VA_ARGS__)
+#define BIO_LOG_MESSAGE(...) BIO_LOG(BIO_LOGGER_LEVEL_MESSAGE, __VA_ARGS__)
+#define BIO_LOG_DEBUG_N(level, ...) BIO_LOG((level + BIO_LOGGER_LEVEL_INFO), __VA_ARGS__)
+#define BIO_LOG_DEBUG(...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+#define BIO_LOG_DEBUG1(...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG1, __VA_ARGS__)
+#define BIO_LOG_DEBUG2(...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG2, __VA_ARGS__)
+#define BIO_LOG_DEBUG3(...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG3, __VA_ARGS__)
+#define BIO_LOG_DEBUG4(...) BIO_LOG(BIO_LOGGER_LEVEL_DEBUG4, __VA_ARGS__)
 
 #define BIO_LOGGING_SET_LOGGING_LEVEL(level) BIO::LOGGING::SetLoggingLevel(level);
 
+#define BIO_LOGGING_SET_MODULE_LOGGING_LEVEL(module, level) \
+	BIO::LOGGING::SetModuleLoggingLevel(BIO_LOGGER_MODULE_##module, level);
+
+#define BIO_LOGGING_FLUSH BIO::LOGGING::Flush();
+
 #define BIO_LOGGING_SHUTDOWN BIO::LOGGING::Shutdown();
 
 #else //it's off
 #define BIO_LOGGING_INIT(level, stream) //DO NOTHING
 
-#define BIO_LOG(level, format, ...) //DO NOTHING
+#define BIO_LOGGING_INIT_CONFIG(level, stream, config) //DO NOTHING
+
+#define BIO_LOG_MODULE(module, level, ...) //DO NOTHING
+#define BIO_LOG_CORE(level, ...) //DO NOTHING
+#define BIO_LOG_ENGINE(level, ...) //DO NOTHING
+#define BIO_LOG_LOADER(level, ...) //DO NOTHING
+#define BIO_LOG_RENDERER(level, ...) //DO NOTHING
 
-#define BIO_LOG_CRITICAL(format, ...) //DO NOTHING
-#define BIO_LOG_ERROR(format, ...) //DO NOTHING
-#define BIO_LOG_WARNING(format, ...) //DO NOTHING
-#define BIO_LOG_INFO(format, ...) //DO NOTHING
-#define BIO_LOG_MESSAGE(format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG_N(level, format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG(format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG1(format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG2(format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG3(format, ...) //DO NOTHING
-#define BIO_LOG_DEBUG4(format, ...) //DO NOTHING
+#define BIO_LOG(level, ...) //DO NOTHING
+
+#define BIO_LOG_CRITICAL(...) //DO NOTHING
+#define BIO_LOG_ERROR(...) //DO NOTHING
+#define BIO_LOG_WARNING(...) //DO NOTHING
+#define BIO_LOG_INFO(...) //DO NOTHING
+#define BIO_LOG_MESSAGE(...) //DO NOTHING
+#define BIO_LOG_DEBUG_N(level, ...) //DO NOTHING
+#define BIO_LOG_DEBUG(...) //DO NOTHING
+#define BIO_LOG_DEBUG1(...) //DO NOTHING
+#define BIO_LOG_DEBUG2(...) //DO NOTHING
+#define BIO_LOG_DEBUG3(...) //DO NOTHING
+#define BIO_LOG_DEBUG4(...) //DO NOTHING
 
 #define BIO_LOGGING_SET_LOGGING_LEVEL(level) //DO NOTHING
 
+#define BIO_LOGGING_SET_MODULE_LOGGING_LEVEL(module, level) //DO NOTHING
+
+#define BIO_LOGGING_FLUSH //DO NOTHING
+
 #define BIO_LOGGING_SHUTDOWN //DO NOTHING
 #endif//BIO_LOGGING_IS_ENABLED
 
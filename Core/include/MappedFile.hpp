@@ -0,0 +1,187 @@
+/**
+* @file MappedFile.hpp
+* @author Spencer Hoffa
+*
+* Read only access to a file mapped into memory.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_CORE_MAPPEDFILE_HPP__2015___
+#define ___BIO_CORE_MAPPEDFILE_HPP__2015___
+
+#include "Config.h"
+
+#include <cstddef>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#include <cstring>
+#include <fstream>
+#endif
+
+namespace BIO
+{
+	namespace FILE
+	{
+		/**
+		* A file mapped read only into memory. Nothing is read when the file is opened; the OS 
+		* pages the file in as the data is touched, so the cost of using a file depends on how 
+		* much of it is read instead of how big it is.
+		*
+		* The start of the data is always aligned to a page, so structures stored at aligned 
+		* offsets in the file can be used in place.
+		*/
+		class BIO_CORE_API MappedFile
+		{
+		private:
+			/**
+			* The start of the mapped file. NULL if no file is open.
+			*/
+			const char * _data;
+
+			/**
+			* The number of bytes in the file.
+			*/
+			size_t _size;
+
+			/**
+			* The OS handle to the file mapping. Only used on Windows.
+			*/
+			void * _mapping;
+
+			/**Do not allow copying.*/
+			MappedFile(const MappedFile & other);
+			MappedFile & operator = (const MappedFile & other);
+
+		public:
+			/**
+			* Constructor
+			*/
+			MappedFile();
+
+			/**
+			* Destructor. Closes the file if it is open.
+			*/
+			~MappedFile();
+
+			/**
+			* Map a file into memory. Any file already open is closed first.
+			*
+			* @param filename The file to map.
+			*
+			* @return Returns true if the file was mapped. Empty files can not be mapped.
+			*/
+			bool Open(const char * filename);
+
+			/**
+			* Unmap the file. Pointers into the data are no longer valid after this.
+			*/
+			void Close();
+
+			/**
+			* Get the contents of the file.
+			*
+			* @return Returns a pointer to the first byte of the file or NULL if no file is open.
+			*/
+			const char * GetData() const;
+
+			/**
+			* Get the size of the file.
+			*
+			* @return Returns the number of bytes in the file or 0 if no file is open.
+			*/
+			size_t GetSize() const;
+
+			/**
+			* Check if a file is mapped.
+			*
+			* @return Returns true if a file is open.
+			*/
+			bool IsOpen() const;
+		};
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for the MappedFile class.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		bool TestMappedFile(XNELO::TESTING::Test * test);
+#endif
+	}//end namespace FILE
+}//end namespace BIO
+
+inline const char * BIO::FILE::MappedFile::GetData() const
+{
+	return _data;
+}
+
+inline size_t BIO::FILE::MappedFile::GetSize() const
+{
+	return _size;
+}
+
+inline bool BIO::FILE::MappedFile::IsOpen() const
+{
+	return _data != NULL;
+}
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+inline bool BIO::FILE::TestMappedFile(XNELO::TESTING::Test * test)
+{
+	test->SetName("MappedFile Tests");
+
+	const char * filename = "BIOMappedFileTest.bin";
+	const char * contents = "Mapped file contents.";
+
+	MappedFile file;
+	test->UnitTest(file.IsOpen() == false, "New mapped file is not open");
+	test->UnitTest(file.Open(filename) == false, "Open missing file fails");
+	test->UnitTest(file.GetData() == NULL && file.GetSize() == 0, "Failed open has no data");
+
+	std::ofstream output(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+	output.write(contents, strlen(contents));
+	output.close();
+
+	test->UnitTest(file.Open(filename) == true, "Open file");
+	test->UnitTest(file.GetSize() == strlen(contents), "Mapped file size");
+	test->UnitTest(file.GetData() != NULL && 
+		memcmp(file.GetData(), contents, strlen(contents)) == 0, "Mapped file contents");
+	test->UnitTest(((size_t)file.GetData() & 15) == 0, "Mapped data is aligned");
+
+	file.Close();
+	test->UnitTest(file.IsOpen() == false && file.GetSize() == 0, "Close mapped file");
+
+	//empty files can not be mapped
+	output.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+	output.close();
+	test->UnitTest(file.Open(filename) == false, "Open empty file fails");
+
+	remove(filename);
+
+	return test->GetSuccess();
+}
+#endif
+
+#endif //___BIO_CORE_MAPPEDFILE_HPP__2015___
@@ -0,0 +1,357 @@
+/**
+* @file RingBuffer.hpp
+* @author Spencer Hoffa
+*
+* A fixed size lock-free ring buffer for passing data from one thread to another.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_CORE_RINGBUFFER_HPP__2015___
+#define ___BIO_CORE_RINGBUFFER_HPP__2015___
+
+#include "Config.h"
+#include "BasicTypes.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+/**The size of a cache line. Used to keep the reader and writer indices apart.*/
+#define BIO_CORE_CACHE_LINE_SIZE 64
+
+namespace BIO
+{
+	namespace CORE
+	{
+		/**
+		* A single producer, single consumer ring buffer. One thread may write into the buffer
+		* while another thread reads from it without any locking. The capacity is fixed when the
+		* buffer is created and is always rounded up to a power of two.
+		*
+		* Elements are written and read in place. Call BeginWrite to get the next free slot, fill
+		* it in, then call EndWrite to publish it to the reader. The reader does the same with
+		* BeginRead and EndRead. Push and Pop are provided as copying helpers.
+		*/
+		template <typename Type>
+		class RingBuffer
+		{
+		private:
+			/**The storage for the elements.*/
+			Type * _buffer;
+
+			/**The number of elements the buffer can hold.*/
+			uint32 _capacity;
+
+			/**Mask used to turn an index into a slot in the buffer.*/
+			uint32 _mask;
+
+			/**Keep the indices off of the cache line holding the buffer information.*/
+			char _padding0[BIO_CORE_CACHE_LINE_SIZE];
+
+			/**The index of the next slot to write. Only changed by the writer.*/
+			std::atomic<uint32> _head;
+
+			/**Keep the writer and reader indices on separate cache lines.*/
+			char _padding1[BIO_CORE_CACHE_LINE_SIZE - sizeof(std::atomic<uint32>)];
+
+			/**The index of the next slot to read. Only changed by the reader.*/
+			std::atomic<uint32> _tail;
+
+			/**Do not allow copying.*/
+			RingBuffer(const RingBuffer & other);
+			RingBuffer & operator = (const RingBuffer & other);
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param capacity The number of elements the buffer can hold. This will be rounded
+			*			up to the next power of two. A value of 0 is treated as 1 and values 
+			*			over 2^31 are treated as 2^31.
+			*/
+			RingBuffer(uint32 capacity);
+
+			/**
+			* Destructor
+			*/
+			~RingBuffer();
+
+			/**
+			* Get the number of elements the buffer can hold.
+			*
+			* @return Returns the capacity of the buffer.
+			*/
+			uint32 GetCapacity() const;
+
+			/**
+			* Get the number of elements currently waiting to be read.
+			*
+			* @NOTE This value is only a snapshot when called from a thread other than the reader
+			*		or writer.
+			*
+			* @return Returns the number of elements in the buffer.
+			*/
+			uint32 GetSize() const;
+
+			/**
+			* Check if the buffer has nothing to read.
+			*
+			* @return Returns true if there are no elements in the buffer.
+			*/
+			bool IsEmpty() const;
+
+			/**
+			* Check if the buffer has no room for another element.
+			*
+			* @return Returns true if the buffer is full.
+			*/
+			bool IsFull() const;
+
+			/**
+			* Get the next free slot to write into. Only the writing thread may call this.
+			*
+			* @return Returns a pointer to the slot or NULL if the buffer is full.
+			*/
+			Type * BeginWrite();
+
+			/**
+			* Publish the slot returned from BeginWrite to the reader.
+			*/
+			void EndWrite();
+
+			/**
+			* Copy a value into the buffer. Only the writing thread may call this.
+			*
+			* @param value The value to copy into the buffer.
+			*
+			* @return Returns true if the value was added. False if the buffer is full.
+			*/
+			bool Push(const Type & value);
+
+			/**
+			* Get the oldest element in the buffer. Only the reading thread may call this.
+			*
+			* @return Returns a pointer to the element or NULL if the buffer is empty.
+			*/
+			Type * BeginRead();
+
+			/**
+			* Release the slot returned from BeginRead back to the writer.
+			*/
+			void EndRead();
+
+			/**
+			* Copy the oldest value out of the buffer. Only the reading thread may call this.
+			*
+			* @param[out] value Where to copy the value to.
+			*
+			* @return Returns true if a value was copied. False if the buffer is empty.
+			*/
+			bool Pop(Type & value);
+		};
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+		/**
+		* Execute the unit tests for the RingBuffer class.
+		*
+		* @param test A pointer to a Test object which will hold all tests and results.
+		*
+		* @return Returns a boolean value. True if all tests pass. False if even one failed.
+		*/
+		bool TestRingBuffer(XNELO::TESTING::Test * test);
+#endif
+	}//end namespace CORE
+}//end namespace BIO
+
+template <typename Type>
+inline BIO::CORE::RingBuffer<Type>::RingBuffer(uint32 capacity) : _head(0), _tail(0)
+{
+	//2^31 is the largest power of two a uint32 can hold
+	if (capacity > 0x80000000u)
+		capacity = 0x80000000u;
+
+	_capacity = 1;
+	while (_capacity < capacity)
+		_capacity <<= 1;
+
+	_mask = _capacity - 1;
+	_buffer = new Type[_capacity];
+}
+
+template <typename Type>
+inline BIO::CORE::RingBuffer<Type>::~RingBuffer()
+{
+	delete[] _buffer;
+	_buffer = NULL;
+}
+
+template <typename Type>
+inline BIO::CORE::uint32 BIO::CORE::RingBuffer<Type>::GetCapacity() const
+{
+	return _capacity;
+}
+
+template <typename Type>
+inline BIO::CORE::uint32 BIO::CORE::RingBuffer<Type>::GetSize() const
+{
+	return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
+
+template <typename Type>
+inline bool BIO::CORE::RingBuffer<Type>::IsEmpty() const
+{
+	return GetSize() == 0;
+}
+
+template <typename Type>
+inline bool BIO::CORE::RingBuffer<Type>::IsFull() const
+{
+	return GetSize() >= _capacity;
+}
+
+template <typename Type>
+inline Type * BIO::CORE::RingBuffer<Type>::BeginWrite()
+{
+	uint32 head = _head.load(std::memory_order_relaxed);
+
+	if (head - _tail.load(std::memory_order_acquire) >= _capacity)
+		return NULL;
+
+	return &_buffer[head & _mask];
+}
+
+template <typename Type>
+inline void BIO::CORE::RingBuffer<Type>::EndWrite()
+{
+	_head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename Type>
+inline bool BIO::CORE::RingBuffer<Type>::Push(const Type & value)
+{
+	Type * slot = BeginWrite();
+
+	if (slot == NULL)
+		return false;
+
+	*slot = value;
+	EndWrite();
+
+	return true;
+}
+
+template <typename Type>
+inline Type * BIO::CORE::RingBuffer<Type>::BeginRead()
+{
+	uint32 tail = _tail.load(std::memory_order_relaxed);
+
+	if (tail == _head.load(std::memory_order_acquire))
+		return NULL;
+
+	return &_buffer[tail & _mask];
+}
+
+template <typename Type>
+inline void BIO::CORE::RingBuffer<Type>::EndRead()
+{
+	_tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename Type>
+inline bool BIO::CORE::RingBuffer<Type>::Pop(Type & value)
+{
+	Type * slot = BeginRead();
+
+	if (slot == NULL)
+		return false;
+
+	value = *slot;
+	EndRead();
+
+	return true;
+}
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+inline bool BIO::CORE::TestRingBuffer(XNELO::TESTING::Test * test)
+{
+	test->SetName("RingBuffer Tests");
+
+	RingBuffer<int> ring(5);
+	test->UnitTest(ring.GetCapacity() == 8, "Capacity rounded to power of two");
+	test->UnitTest(ring.IsEmpty(), "New buffer is empty");
+	test->UnitTest(ring.BeginRead() == NULL, "Read from empty buffer");
+
+	int value = 0;
+	test->UnitTest(ring.Pop(value) == false, "Pop from empty buffer");
+
+	for (int i = 0; i < 8; i++)
+		ring.Push(i);
+
+	test->UnitTest(ring.IsFull(), "Buffer is full");
+	test->UnitTest(ring.GetSize() == 8, "Buffer size when full");
+	test->UnitTest(ring.Push(100) == false, "Push to full buffer");
+	test->UnitTest(ring.BeginWrite() == NULL, "Write to full buffer");
+
+	bool inOrder = true;
+	for (int i = 0; i < 5; i++)
+	{
+		if (!ring.Pop(value) || value != i)
+			inOrder = false;
+	}
+	test->UnitTest(inOrder, "Pop returns values in order");
+	test->UnitTest(ring.GetSize() == 3, "Buffer size after pop");
+
+	//wrap around the end of the buffer
+	for (int i = 8; i < 13; i++)
+		ring.Push(i);
+
+	inOrder = true;
+	for (int i = 5; i < 13; i++)
+	{
+		if (!ring.Pop(value) || value != i)
+			inOrder = false;
+	}
+	test->UnitTest(inOrder, "Pop returns values in order after wrapping");
+	test->UnitTest(ring.IsEmpty(), "Buffer is empty after wrapping");
+
+	//write in place
+	int * slot = ring.BeginWrite();
+	test->UnitTest(slot != NULL, "BeginWrite returns a slot");
+	*slot = 42;
+	test->UnitTest(ring.IsEmpty(), "Slot is not visible before EndWrite");
+	ring.EndWrite();
+	slot = ring.BeginRead();
+	test->UnitTest(slot != NULL && *slot == 42, "BeginRead returns written slot");
+	ring.EndRead();
+	test->UnitTest(ring.IsEmpty(), "Buffer is empty after EndRead");
+
+	RingBuffer<int> single(0);
+	test->UnitTest(single.GetCapacity() == 1, "Capacity of zero becomes one");
+
+	return test->GetSuccess();
+}
+#endif
+
+#endif //___BIO_CORE_RINGBUFFER_HPP__2015___
@@ -0,0 +1,628 @@
+/**
+* @file JobSystem.cpp
+* @author Spencer Hoffa
+*
+* Implementation of the work stealing job scheduler.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "JobSystem.hpp"
+#include "RingBuffer.hpp"
+
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define BIO_JOBS_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#include <sched.h>
+#define BIO_JOBS_THREAD_LOCAL __thread
+#endif
+
+/**The number of jobs each queue can hold. Must be a power of two.*/
+#define BIO_JOB_QUEUE_SIZE 4096
+
+/**The number of times an idle worker looks for work before it goes to sleep.*/
+#define BIO_JOB_SPIN_COUNT 64
+
+namespace BIO
+{
+	namespace CORE
+	{
+		/**The system the calling worker thread belongs to.*/
+		static BIO_JOBS_THREAD_LOCAL JobSystem * _threadSystem = NULL;
+
+		/**The index of the calling worker thread's queue.*/
+		static BIO_JOBS_THREAD_LOCAL unsigned int _threadIndex = 0;
+
+		/**The state used to pick which queue to steal from.*/
+		static BIO_JOBS_THREAD_LOCAL uint32 _threadSeed = 0;
+
+		/**
+		* A queue of jobs owned by one thread, along with the storage for its jobs. The owner
+		* pushes and pops at the bottom, other threads steal from the top. This is the 
+		* Chase-Lev deque with a fixed size.
+		*/
+		struct _JobQueue
+		{
+			/**The next index to steal from.*/
+			std::atomic<sint64> top;
+
+			/**Keep the two ends on separate cache lines.*/
+			char padding0[BIO_CORE_CACHE_LINE_SIZE - sizeof(std::atomic<sint64>)];
+
+			/**The next index to push to.*/
+			std::atomic<sint64> bottom;
+
+			/**Keep the owner's end off of the slots.*/
+			char padding1[BIO_CORE_CACHE_LINE_SIZE - sizeof(std::atomic<sint64>)];
+
+			/**The queued jobs.*/
+			std::atomic<Job *> slots[BIO_JOB_QUEUE_SIZE];
+
+			/**The storage for the jobs. Only the owner takes a job from here.*/
+			Job pool[BIO_JOB_QUEUE_SIZE];
+
+			/**Which jobs in the pool are in use. Whoever runs a job gives it back.*/
+			std::atomic<bool> used[BIO_JOB_QUEUE_SIZE];
+
+			/**Where to start looking for a free job in the pool.*/
+			uint32 next;
+
+			/**The number of jobs the owner has run.*/
+			std::atomic<uint64> executed;
+
+			/**The number of jobs stolen from this queue.*/
+			std::atomic<uint64> stolen;
+
+			_JobQueue() : top(0), bottom(0), next(0), executed(0), stolen(0)
+			{
+				for (uint32 i = 0; i < BIO_JOB_QUEUE_SIZE; i++)
+				{
+					slots[i].store(NULL, std::memory_order_relaxed);
+					used[i].store(false, std::memory_order_relaxed);
+				}
+			}
+
+			/**
+			* Get a free job from the pool. Only the owner may call this.
+			*
+			* @return Returns the job or NULL if every job is in use.
+			*/
+			Job * Allocate()
+			{
+				//every job in the pool is queued, skip looking through it
+				if (bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_acquire) >= BIO_JOB_QUEUE_SIZE)
+					return NULL;
+
+				for (uint32 i = 0; i < BIO_JOB_QUEUE_SIZE; i++)
+				{
+					uint32 index = (next + i) & (BIO_JOB_QUEUE_SIZE - 1);
+
+					if (!used[index].load(std::memory_order_acquire))
+					{
+						used[index].store(true, std::memory_order_relaxed);
+						next = index + 1;
+						return &pool[index];
+					}
+				}
+
+				return NULL;
+			}
+
+			/**
+			* Give a job back to the pool. Any thread may call this.
+			*/
+			void Free(Job * job)
+			{
+				used[job - pool].store(false, std::memory_order_release);
+			}
+
+			/**
+			* Push a job on the bottom. Only the owner may call this.
+			*
+			* @return Returns false if the queue is full.
+			*/
+			bool Push(Job * job)
+			{
+				sint64 b = bottom.load(std::memory_order_relaxed);
+				sint64 t = top.load(std::memory_order_acquire);
+
+				if (b - t >= BIO_JOB_QUEUE_SIZE)
+					return false;
+
+				slots[b & (BIO_JOB_QUEUE_SIZE - 1)].store(job, std::memory_order_release);
+				bottom.store(b + 1, std::memory_order_release);
+
+				return true;
+			}
+
+			/**
+			* Pop the newest job from the bottom. Only the owner may call this.
+			*
+			* @return Returns the job or NULL if the queue is empty.
+			*/
+			Job * Pop()
+			{
+				sint64 b = bottom.load(std::memory_order_relaxed) - 1;
+				bottom.store(b, std::memory_order_seq_cst);
+				sint64 t = top.load(std::memory_order_seq_cst);
+
+				if (t > b)
+				{
+					bottom.store(b + 1, std::memory_order_relaxed);
+					return NULL;
+				}
+
+				Job * job = slots[b & (BIO_JOB_QUEUE_SIZE - 1)].load(std::memory_order_acquire);
+
+				//the last job, race the thieves for it
+				if (t == b)
+				{
+					if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst))
+						job = NULL;
+
+					bottom.store(b + 1, std::memory_order_relaxed);
+				}
+
+				return job;
+			}
+
+			/**
+			* Steal the oldest job from the top. Any thread may call this.
+			*
+			* @return Returns the job or NULL if the queue is empty or another thread won it.
+			*/
+			Job * Steal()
+			{
+				sint64 t = top.load(std::memory_order_seq_cst);
+				sint64 b = bottom.load(std::memory_order_seq_cst);
+
+				if (t >= b)
+					return NULL;
+
+				Job * job = slots[t & (BIO_JOB_QUEUE_SIZE - 1)].load(std::memory_order_acquire);
+
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst))
+					return NULL;
+
+				return job;
+			}
+		};
+
+		/**
+		* Get a random number for the calling thread.
+		*/
+		static uint32 _NextRandom()
+		{
+			if (_threadSeed == 0)
+				_threadSeed = (uint32)(size_t)&_threadSeed | 1;
+
+			//xorshift
+			_threadSeed ^= _threadSeed << 13;
+			_threadSeed ^= _threadSeed >> 17;
+			_threadSeed ^= _threadSeed << 5;
+
+			return _threadSeed;
+		}
+
+		/**
+		* Keep the calling thread on one core.
+		*/
+		static void _PinThread(int core)
+		{
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+			SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core);
+#elif defined(__linux__)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(core, &set);
+			pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+#endif
+		}
+
+		JobSystem::JobSystem(unsigned int workerCount, bool pinWorkers) :
+			_externalCount(0),
+			_queued(0),
+			_sleeping(0),
+			_stop(false),
+			_externalExecuted(0),
+			_mainThread(std::this_thread::get_id())
+		{
+			unsigned int cores = std::thread::hardware_concurrency();
+
+			if (cores == 0)
+				cores = 1;
+
+			if (workerCount == 0)
+				workerCount = (cores > 1) ? cores - 1 : 1;
+
+			for (unsigned int i = 0; i <= workerCount; i++)
+				_queues.push_back(new _JobQueue());
+
+			//the main thread keeps core 0
+			for (unsigned int i = 1; i <= workerCount; i++)
+			{
+				int core = pinWorkers ? (int)(i % cores) : -1;
+				_workers.push_back(std::thread(&JobSystem::_WorkerLoop, this, i, core));
+			}
+		}
+
+		JobSystem::~JobSystem()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_sleepMutex);
+				_stop.store(true);
+				_wake.notify_all();
+			}
+
+			for (unsigned int i = 0; i < _workers.size(); i++)
+				_workers[i].join();
+
+			for (unsigned int i = 0; i < _queues.size(); i++)
+				delete _queues[i];
+
+			_queues.clear();
+		}
+
+		_JobQueue * JobSystem::_GetQueue() const
+		{
+			if (_threadSystem == this)
+				return _queues[_threadIndex];
+
+			if (IsMainThread())
+				return _queues[0];
+
+			return NULL;
+		}
+
+		void JobSystem::_Push(const Job & job)
+		{
+			_JobQueue * queue = _GetQueue();
+
+			//raised before the job can be seen so a worker going to sleep does not miss it
+			_queued.fetch_add(1);
+
+			if (queue != NULL)
+			{
+				Job * slot = queue->Allocate();
+
+				if (slot != NULL)
+				{
+					*slot = job;
+
+					if (queue->Push(slot))
+					{
+						_WakeWorker();
+						return;
+					}
+
+					queue->Free(slot);
+				}
+
+				//the queue is full, just run it
+				_queued.fetch_sub(1);
+				_Run(job, queue);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_externalMutex);
+				_external.push_back(job);
+				_externalCount.fetch_add(1);
+			}
+
+			_WakeWorker();
+		}
+
+		void JobSystem::_Run(const Job & job, _JobQueue * queue)
+		{
+			if (job.Function != NULL)
+				job.Function(job.Data);
+			else
+				job.RangeFunction(job.Data, job.Begin, job.End);
+
+			if (queue != NULL)
+				queue->executed.fetch_add(1, std::memory_order_relaxed);
+			else
+				_externalExecuted.fetch_add(1, std::memory_order_relaxed);
+
+			if (job.Counter != NULL)
+				_Finish(job.Counter);
+		}
+
+		void JobSystem::_RunPooled(_JobQueue * owner, Job * job, _JobQueue * queue)
+		{
+			//copy it out so the slot can be reused while the job runs
+			Job copy = *job;
+			owner->Free(job);
+
+			_queued.fetch_sub(1);
+			_Run(copy, queue);
+		}
+
+		bool JobSystem::_RunOne()
+		{
+			_JobQueue * queue = _GetQueue();
+
+			if (queue != NULL)
+			{
+				Job * job = queue->Pop();
+
+				if (job != NULL)
+				{
+					_RunPooled(queue, job, queue);
+					return true;
+				}
+			}
+
+			if (_externalCount.load() > 0)
+			{
+				Job job;
+				bool found = false;
+
+				{
+					std::lock_guard<std::mutex> lock(_externalMutex);
+
+					if (!_external.empty())
+					{
+						job = _external.front();
+						_external.pop_front();
+						_externalCount.fetch_sub(1);
+						found = true;
+					}
+				}
+
+				if (found)
+				{
+					_queued.fetch_sub(1);
+					_Run(job, queue);
+					return true;
+				}
+			}
+
+			unsigned int count = (unsigned int)_queues.size();
+			unsigned int start = _NextRandom() % count;
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				_JobQueue * victim = _queues[(start + i) % count];
+
+				if (victim == queue)
+					continue;
+
+				Job * job = victim->Steal();
+
+				if (job != NULL)
+				{
+					victim->stolen.fetch_add(1, std::memory_order_relaxed);
+					_RunPooled(victim, job, queue);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void JobSystem::_Finish(JobCounter * counter)
+		{
+			//Wait does not return while this is raised so the counter stays alive
+			counter->_finishing.fetch_add(1);
+
+			if (counter->_count.fetch_sub(1) == 1)
+			{
+				std::vector<Job> released;
+
+				{
+					std::lock_guard<std::mutex> lock(counter->_mutex);
+					released.swap(counter->_waiting);
+				}
+
+				for (unsigned int i = 0; i < released.size(); i++)
+					_Push(released[i]);
+			}
+
+			counter->_finishing.fetch_sub(1);
+		}
+
+		void JobSystem::_WakeWorker()
+		{
+			if (_sleeping.load() > 0)
+			{
+				std::lock_guard<std::mutex> lock(_sleepMutex);
+				_wake.notify_one();
+			}
+		}
+
+		void JobSystem::_WorkerLoop(unsigned int index, int core)
+		{
+			_threadSystem = this;
+			_threadIndex = index;
+
+			if (core >= 0)
+				_PinThread(core);
+
+			unsigned int idle = 0;
+
+			while (!_stop.load())
+			{
+				if (_RunOne())
+				{
+					idle = 0;
+					continue;
+				}
+
+				if (++idle < BIO_JOB_SPIN_COUNT)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(_sleepMutex);
+				_sleeping.fetch_add(1);
+
+				while (_queued.load() <= 0 && !_stop.load())
+					_wake.wait(lock);
+
+				_sleeping.fetch_sub(1);
+				idle = 0;
+			}
+
+			_threadSystem = NULL;
+		}
+
+		uint64 JobSystem::GetExecutedCount() const
+		{
+			uint64 count = _externalExecuted.load(std::memory_order_relaxed);
+
+			for (unsigned int i = 0; i < _queues.size(); i++)
+				count += _queues[i]->executed.load(std::memory_order_relaxed);
+
+			return count;
+		}
+
+		uint64 JobSystem::GetStolenCount() const
+		{
+			uint64 count = 0;
+
+			for (unsigned int i = 0; i < _queues.size(); i++)
+				count += _queues[i]->stolen.load(std::memory_order_relaxed);
+
+			return count;
+		}
+
+		void JobSystem::ParallelFor(uint32 count, uint32 batchSize, JobRangeFunction function, void * data)
+		{
+			if (count == 0)
+				return;
+
+			//a few batches per thread so the threads that finish first can steal the rest
+			if (batchSize == 0)
+			{
+				uint32 batches = (uint32)_queues.size() * 4;
+				batchSize = (count + batches - 1) / batches;
+			}
+
+			JobCounter counter;
+
+			for (uint32 begin = 0; begin < count; begin += batchSize)
+			{
+				Job job;
+				job.Function = NULL;
+				job.RangeFunction = function;
+				job.Data = data;
+				job.Begin = begin;
+				job.End = (count - begin > batchSize) ? begin + batchSize : count;
+				job.Counter = &counter;
+
+				counter._count.fetch_add(1);
+				_Push(job);
+			}
+
+			Wait(counter);
+		}
+
+		unsigned int JobSystem::RunMainThreadJobs()
+		{
+			std::vector<Job> jobs;
+
+			{
+				std::lock_guard<std::mutex> lock(_mainThreadMutex);
+
+				if (_mainThreadJobs.empty())
+					return 0;
+
+				jobs.swap(_mainThreadJobs);
+			}
+
+			for (unsigned int i = 0; i < jobs.size(); i++)
+				_Run(jobs[i], _queues[0]);
+
+			return (unsigned int)jobs.size();
+		}
+
+		void JobSystem::Submit(JobFunction function, 
+			void * data, 
+			JobCounter * counter, 
+			JobCounter * dependency)
+		{
+			Job job;
+			job.Function = function;
+			job.RangeFunction = NULL;
+			job.Data = data;
+			job.Begin = 0;
+			job.End = 0;
+			job.Counter = counter;
+
+			if (counter != NULL)
+				counter->_count.fetch_add(1);
+
+			if (dependency != NULL)
+			{
+				std::lock_guard<std::mutex> lock(dependency->_mutex);
+
+				//the job that lowers it to zero takes the lock before releasing these
+				if (dependency->_count.load() > 0)
+				{
+					dependency->_waiting.push_back(job);
+					return;
+				}
+			}
+
+			_Push(job);
+		}
+
+		void JobSystem::SubmitMainThread(JobFunction function, void * data, JobCounter * counter)
+		{
+			Job job;
+			job.Function = function;
+			job.RangeFunction = NULL;
+			job.Data = data;
+			job.Begin = 0;
+			job.End = 0;
+			job.Counter = counter;
+
+			if (counter != NULL)
+				counter->_count.fetch_add(1);
+
+			std::lock_guard<std::mutex> lock(_mainThreadMutex);
+			_mainThreadJobs.push_back(job);
+		}
+
+		void JobSystem::Wait(JobCounter & counter)
+		{
+			bool mainThread = IsMainThread();
+
+			while (counter._count.load(std::memory_order_acquire) > 0)
+			{
+				if (mainThread && RunMainThreadJobs() > 0)
+					continue;
+
+				if (!_RunOne())
+					std::this_thread::yield();
+			}
+
+			while (counter._finishing.load(std::memory_order_acquire) > 0)
+				std::this_thread::yield();
+		}
+	}//end namespace CORE
+}//end namespace BIO
@@ -0,0 +1,206 @@
+/**
+* @file LogSinks.cpp
+* @author Spencer Hoffa
+*
+* Implementation of the log sinks.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "LogSinks.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace BIO
+{
+	namespace LOGGING
+	{
+		//---------------------------------------------------------------------------------------
+		// ConsoleLogSink
+		//---------------------------------------------------------------------------------------
+		ConsoleLogSink::ConsoleLogSink(int level, std::ostream * stream) :
+			ILogSink(level),
+			_stream(stream)
+		{
+			if (_stream == NULL)
+				_stream = &std::cout;
+		}
+
+		void ConsoleLogSink::Write(int, const char * text, unsigned int length)
+		{
+			_stream->write(text, length);
+		}
+
+		void ConsoleLogSink::Flush()
+		{
+			_stream->flush();
+		}
+
+		//---------------------------------------------------------------------------------------
+		// RotatingFileLogSink
+		//---------------------------------------------------------------------------------------
+		RotatingFileLogSink::RotatingFileLogSink(const char * filename,
+			int level,
+			unsigned long long maxBytes,
+			unsigned int maxSeconds,
+			unsigned int maxFiles) :
+			ILogSink(level),
+			_filename(filename),
+			_maxBytes(maxBytes),
+			_maxSeconds(maxSeconds),
+			_maxFiles(maxFiles),
+			_size(0),
+			_rotations(0)
+		{
+			_file.open(_filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+			time(&_opened);
+		}
+
+		RotatingFileLogSink::~RotatingFileLogSink()
+		{
+			if (_file.is_open())
+				_file.close();
+		}
+
+		std::string RotatingFileLogSink::_GetOldFilename(unsigned int index) const
+		{
+			return _filename + "." + std::to_string(index);
+		}
+
+		void RotatingFileLogSink::_Rotate()
+		{
+			if (_file.is_open())
+				_file.close();
+
+			if (_maxFiles > 0)
+			{
+				remove(_GetOldFilename(_maxFiles).c_str());
+
+				for (unsigned int i = _maxFiles - 1; i > 0; i--)
+					rename(_GetOldFilename(i).c_str(), _GetOldFilename(i + 1).c_str());
+
+				rename(_filename.c_str(), _GetOldFilename(1).c_str());
+			}
+
+			_file.open(_filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+			_size = 0;
+			time(&_opened);
+			_rotations++;
+		}
+
+		void RotatingFileLogSink::Write(int, const char * text, unsigned int length)
+		{
+			bool tooBig = (_maxBytes > 0) && (_size > 0) && (_size + length > _maxBytes);
+			bool tooOld = (_maxSeconds > 0) && (difftime(time(NULL), _opened) >= _maxSeconds);
+
+			if (tooBig || tooOld)
+				_Rotate();
+
+			if (!_file.is_open())
+				return;
+
+			_file.write(text, length);
+			_size += length;
+		}
+
+		void RotatingFileLogSink::Flush()
+		{
+			if (_file.is_open())
+				_file.flush();
+		}
+
+		//---------------------------------------------------------------------------------------
+		// MemoryLogSink
+		//---------------------------------------------------------------------------------------
+		MemoryLogSink::MemoryLogSink(unsigned int capacity, int level) :
+			ILogSink(level),
+			_buffer(NULL),
+			_capacity(capacity > 0 ? capacity : 1),
+			_written(0)
+		{
+			_buffer = new char[_capacity];
+		}
+
+		MemoryLogSink::~MemoryLogSink()
+		{
+			delete[] _buffer;
+			_buffer = NULL;
+		}
+
+		void MemoryLogSink::Write(int, const char * text, unsigned int length)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			//only the end of text can fit
+			if (length > _capacity)
+			{
+				_written += length - _capacity;
+				text += length - _capacity;
+				length = _capacity;
+			}
+
+			unsigned int start = (unsigned int)(_written % _capacity);
+			unsigned int first = (length < _capacity - start) ? length : _capacity - start;
+
+			memcpy(_buffer + start, text, first);
+			memcpy(_buffer, text + first, length - first);
+
+			_written += length;
+		}
+
+		std::string MemoryLogSink::GetContents() const
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_written <= _capacity)
+				return std::string(_buffer, (size_t)_written);
+
+			//the buffer is full, the oldest byte is where the next one goes
+			unsigned int start = (unsigned int)(_written % _capacity);
+			std::string contents;
+			contents.reserve(_capacity);
+			contents.append(_buffer + start, _capacity - start);
+			contents.append(_buffer, start);
+
+			//the first line was partly overwritten
+			size_t newline = contents.find('\n');
+			if (newline == std::string::npos)
+				return std::string();
+
+			return contents.substr(newline + 1);
+		}
+
+		void MemoryLogSink::Dump(std::ostream & stream) const
+		{
+			std::string contents = GetContents();
+			stream.write(contents.c_str(), contents.size());
+			stream.flush();
+		}
+
+		void MemoryLogSink::Clear()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_written = 0;
+		}
+	}//end namespace LOGGING
+}//end namespace BIO
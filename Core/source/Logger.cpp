@@ -27,11 +27,386 @@
 #include <vld.h> //check for leaks
 #include "Logger.hpp"
 
+#include <cstdio>
+#include <cstring>
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#include <sstream>
+#include <string>
+#include <thread>
+#include "LogSinks.hpp"
+#endif
+
+//Captured arguments are formatted the same way whether or not logging is enabled so that logs 
+//and tests built with logging turned off still decode.
+namespace BIO
+{
+	namespace LOGGING
+	{
+		/**A value read from a buffer of captured arguments.*/
+		struct _LogValue
+		{
+			unsigned char type;				/**< The LOG_ARGUMENT_TYPE of the value.*/
+			long long integer;				/**< The value of signed types.*/
+			unsigned long long uinteger;	/**< The value of unsigned types and pointers.*/
+			double real;					/**< The value of floating point types.*/
+			const char * string;			/**< The chars of a string. Not null terminated.*/
+			unsigned short length;			/**< The number of chars in string.*/
+		};
+
+		/**
+		* Read the next captured argument. This is a private function for this library.
+		*
+		* @param[in] data The captured arguments.
+		* @param[in] size The number of bytes in data.
+		* @param[in,out] offset Where the next argument starts. Moved past the argument.
+		* @param[out] value The argument that was read.
+		*
+		* @return Returns true if an argument was read. False if there are none left.
+		*/
+		bool _ReadLogArgument(const unsigned char * data, 
+			unsigned int size, 
+			unsigned int & offset, 
+			_LogValue & value)
+		{
+			if (offset >= size)
+				return false;
+
+			value.type = data[offset];
+			const unsigned char * bytes = data + offset + 1;
+			unsigned int remaining = size - offset - 1;
+			unsigned int count;
+
+			switch (value.type)
+			{
+			case LOG_ARGUMENT_INT32:
+			{
+				int small;
+				count = sizeof(small);
+				if (remaining < count) return false;
+				memcpy(&small, bytes, count);
+				value.integer = small;
+				break;
+			}
+			case LOG_ARGUMENT_UINT32:
+			{
+				unsigned int small;
+				count = sizeof(small);
+				if (remaining < count) return false;
+				memcpy(&small, bytes, count);
+				value.uinteger = small;
+				break;
+			}
+			case LOG_ARGUMENT_INT64:
+				count = sizeof(value.integer);
+				if (remaining < count) return false;
+				memcpy(&value.integer, bytes, count);
+				break;
+			case LOG_ARGUMENT_UINT64:
+			case LOG_ARGUMENT_POINTER:
+				count = sizeof(value.uinteger);
+				if (remaining < count) return false;
+				memcpy(&value.uinteger, bytes, count);
+				break;
+			case LOG_ARGUMENT_DOUBLE:
+				count = sizeof(value.real);
+				if (remaining < count) return false;
+				memcpy(&value.real, bytes, count);
+				break;
+			case LOG_ARGUMENT_STRING:
+				if (remaining < 2) return false;
+				memcpy(&value.length, bytes, 2);
+				if (remaining - 2 < value.length) return false;
+				value.string = (const char *)bytes + 2;
+				count = 2 + value.length;
+				break;
+			default:
+				return false;
+			}
+
+			offset += 1 + count;
+			return true;
+		}
+
+		/**
+		* Get a captured argument as a signed integer. This is a private function for this 
+		* library.
+		*
+		* @param[in] value The captured argument.
+		* @param[out] result The integer value.
+		*
+		* @return Returns false if the argument is not a number.
+		*/
+		inline bool _LogValueToInteger(const _LogValue & value, long long & result)
+		{
+			switch (value.type)
+			{
+			case LOG_ARGUMENT_INT32:
+			case LOG_ARGUMENT_INT64:
+				result = value.integer;
+				return true;
+			case LOG_ARGUMENT_UINT32:
+			case LOG_ARGUMENT_UINT64:
+			case LOG_ARGUMENT_POINTER:
+				result = (long long)value.uinteger;
+				return true;
+			case LOG_ARGUMENT_DOUBLE:
+				result = (long long)value.real;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		/**
+		* Write into a buffer using a printf format. This is a private function for this library.
+		*
+		* @return Returns the number of chars written. The output is always null terminated.
+		*/
+		inline unsigned int _PrintToBuffer(char * buffer, size_t size, const char * format, ...)
+		{
+			va_list args;
+			va_start(args, format);
+
+			#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+				int charsPrinted = vsnprintf_s(buffer, size, _TRUNCATE, format, args);
+			#else //Not windows
+				int charsPrinted = vsnprintf(buffer, size, format, args);
+			#endif
+
+			va_end(args);
+
+			if (charsPrinted < 0)
+				return (unsigned int)strlen(buffer);
+
+			if ((size_t)charsPrinted >= size)
+				return (unsigned int)(size - 1);
+
+			return (unsigned int)charsPrinted;
+		}
+
+		unsigned int FormatLogArguments(const char * format,
+			const unsigned char * data,
+			unsigned int size,
+			char * output,
+			unsigned int outputSize)
+		{
+			if (outputSize == 0)
+				return 0;
+
+			unsigned int written = 0;
+			unsigned int offset = 0;
+			const char * c = format;
+
+			while ((*c != '\0') && (written + 1 < outputSize))
+			{
+				if (*c != '%')
+				{
+					output[written++] = *c++;
+					continue;
+				}
+
+				if (c[1] == '%')
+				{
+					output[written++] = '%';
+					c += 2;
+					continue;
+				}
+
+				//rebuild the format specifier so the value can be printed with its real type
+				char spec[32];
+				unsigned int specLength = 0;
+				bool valid = true;
+				_LogValue value;
+				long long number;
+
+				spec[specLength++] = *c++;
+
+				while ((*c != '\0') && (strchr("-+ #0", *c) != NULL))
+				{
+					if (specLength < 8)
+						spec[specLength++] = *c;
+					c++;
+				}
+
+				if (*c == '*')
+				{
+					if (_ReadLogArgument(data, size, offset, value) && _LogValueToInteger(value, number))
+						specLength += _PrintToBuffer(spec + specLength, 8, "%d", (int)number);
+					else
+						valid = false;
+					c++;
+				}
+				else
+				{
+					while ((*c >= '0') && (*c <= '9'))
+					{
+						if (specLength < 16)
+							spec[specLength++] = *c;
+						c++;
+					}
+				}
+
+				if (*c == '.')
+				{
+					spec[specLength++] = *c++;
+
+					if (*c == '*')
+					{
+						if (_ReadLogArgument(data, size, offset, value) && _LogValueToInteger(value, number))
+							specLength += _PrintToBuffer(spec + specLength, 8, "%d", (int)number);
+						else
+							valid = false;
+						c++;
+					}
+					else
+					{
+						while ((*c >= '0') && (*c <= '9'))
+						{
+							if (specLength < 24)
+								spec[specLength++] = *c;
+							c++;
+						}
+					}
+				}
+
+				//the length modifiers are replaced based on the captured type
+				while ((*c != '\0') && (strchr("hlLqjzt", *c) != NULL))
+					c++;
+
+				char conversion = *c;
+				if (conversion == '\0')
+					break;
+				c++;
+
+				if (conversion == 'n')
+					continue;
+
+				bool haveValue = _ReadLogArgument(data, size, offset, value);
+				char piece[BIO_LOGGER_RECORD_MESSAGE_SIZE + 64];
+				unsigned int pieceLength = 0;
+
+				switch (conversion)
+				{
+				case 'd':
+				case 'i':
+					spec[specLength++] = 'l';
+					spec[specLength++] = 'l';
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && _LogValueToInteger(value, number))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, number);
+					else
+						valid = false;
+					break;
+				case 'u':
+				case 'o':
+				case 'x':
+				case 'X':
+					spec[specLength++] = 'l';
+					spec[specLength++] = 'l';
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && _LogValueToInteger(value, number))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, (unsigned long long)number);
+					else
+						valid = false;
+					break;
+				case 'c':
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && _LogValueToInteger(value, number))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, (int)number);
+					else
+						valid = false;
+					break;
+				case 'f':
+				case 'F':
+				case 'e':
+				case 'E':
+				case 'g':
+				case 'G':
+				case 'a':
+				case 'A':
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && (value.type == LOG_ARGUMENT_DOUBLE))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, value.real);
+					else if (valid && haveValue && _LogValueToInteger(value, number))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, (double)number);
+					else
+						valid = false;
+					break;
+				case 's':
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && (value.type == LOG_ARGUMENT_STRING))
+					{
+						char string[BIO_LOGGER_RECORD_MESSAGE_SIZE + 1];
+						unsigned int length = value.length < BIO_LOGGER_RECORD_MESSAGE_SIZE ? 
+							value.length : BIO_LOGGER_RECORD_MESSAGE_SIZE;
+						memcpy(string, value.string, length);
+						string[length] = '\0';
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, string);
+					}
+					else
+					{
+						valid = false;
+					}
+					break;
+				case 'p':
+					spec[specLength++] = conversion;
+					spec[specLength] = '\0';
+					if (valid && haveValue && _LogValueToInteger(value, number))
+						pieceLength = _PrintToBuffer(piece, sizeof(piece), spec, (void *)(size_t)number);
+					else
+						valid = false;
+					break;
+				default:
+					valid = false;
+					break;
+				}
+
+				if (!valid)
+					pieceLength = _PrintToBuffer(piece, sizeof(piece), "(?)");
+
+				for (unsigned int i = 0; (i < pieceLength) && (written + 1 < outputSize); i++)
+					output[written++] = piece[i];
+			}
+
+			output[written] = '\0';
+
+			return written;
+		}
+	}//end namespace LOGGING
+}//end namespace BIO
+
 #if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
 
 #define BIO_LOGGER_INITIAL_BUFFER_SIZE 512
+//How long the drain thread waits for new records before checking the queues again.
+#define BIO_LOGGER_DRAIN_INTERVAL_MS 5
 #include <iostream>
 #include <ctime>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogSinks.hpp"
+#include "RingBuffer.hpp"
+
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+#include <windows.h>
+#define BIO_LOGGER_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#define BIO_LOGGER_THREAD_LOCAL __thread
+#endif
 
 namespace BIO
 {
@@ -43,8 +418,126 @@ namespace BIO
 		/**Has the init function already been called?*/
 		bool _initCalled = false;
 
-		/**Keeps track of the current logging level*/
-		int _level = MaxLoggingLevel;
+		std::atomic<int> ModuleLoggingLevels[BIO_LOGGER_MODULE_COUNT] = {
+			{ MaxLoggingLevel },
+			{ MaxLoggingLevel },
+			{ MaxLoggingLevel },
+			{ MaxLoggingLevel }
+		};
+
+		/**
+		* A log statement waiting in a queue to be written by the drain thread.
+		*/
+		struct _LogRecord
+		{
+			int level;				/**< The logging level of the statement.*/
+			unsigned int line;		/**< The line number of the statement.*/
+			const char * filename;	/**< The file of the statement. NULL if not given.*/
+			time_t time;			/**< When the statement was logged.*/
+			LogSite * site;			/**< The site of a deferred statement. NULL if formatted.*/
+			const char * format;	/**< The format string of a deferred statement.*/
+			unsigned int size;		/**< The number of bytes of captured arguments.*/
+			unsigned int suppressed;	/**< Records of the same site rate limited before this.*/
+			/**The formatted message, or the captured arguments of a deferred statement.*/
+			char message[BIO_LOGGER_RECORD_MESSAGE_SIZE];
+		};
+
+		/**
+		* The queue owned by a single logging thread. All of the queues are linked together so 
+		* the drain thread can find them.
+		*/
+		struct _ThreadQueue
+		{
+			CORE::RingBuffer<_LogRecord> records;	/**< The records waiting to be written.*/
+			_ThreadQueue * next;					/**< The next queue in the list.*/
+			std::atomic<bool> released;				/**< Has the owning thread exited?*/
+
+			_ThreadQueue(unsigned int size) : records(size), next(NULL), released(false) {}
+		};
+
+		/**The configuration passed into Init.*/
+		LoggerConfiguration _config;
+
+		/**Is the drain thread running? Log statements are queued while this is true.*/
+		std::atomic<bool> _asyncRunning(false);
+
+		/**
+		* The number of threads writing a record into their queue. The queues are not deleted 
+		* until this is back to 0.
+		*/
+		std::atomic<unsigned int> _asyncWriters(0);
+
+		/**The list of every thread's queue.*/
+		std::atomic<_ThreadQueue *> _queues(NULL);
+
+		/**
+		* Changes every time asynchronous logging is started so threads know their queue from a 
+		* previous Init was deleted.
+		*/
+		std::atomic<unsigned int> _queueGeneration(0);
+
+		/**The number of records thrown away because a queue was full.*/
+		std::atomic<unsigned long long> _droppedRecords(0);
+
+		/**The thread that formats and writes the queued records.*/
+		std::thread _drainThread;
+
+		/**
+		* Held while records are written to the output. By the drain thread when logging 
+		* asynchronously and by the logging thread when logging synchronously.
+		*/
+		std::mutex _drainMutex;
+
+		/**Used to wake up the drain thread.*/
+		std::condition_variable _drainSignal;
+
+		/**The queue used by the current thread.*/
+		BIO_LOGGER_THREAD_LOCAL _ThreadQueue * _threadQueue = NULL;
+
+		/**Used to find out when a thread with a queue exits so its queue can be deleted.*/
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+		DWORD _threadExitKey = FLS_OUT_OF_INDEXES;
+#else
+		pthread_key_t _threadExitKey;
+#endif
+
+		/**Has _threadExitKey been created?*/
+		bool _threadExitKeyCreated = false;
+
+		/**The generation the current thread's queue was created in.*/
+		BIO_LOGGER_THREAD_LOCAL unsigned int _threadQueueGeneration = 0;
+
+		/**The sinks log statements are written to along with the output stream.*/
+		ILogSink * _sinks[BIO_LOGGER_MAX_SINKS];
+
+		/**The number of sinks in _sinks.*/
+		unsigned int _sinkCount = 0;
+
+		/**Reused to format lines. Only touched while holding _drainMutex.*/
+		std::string _line;
+
+		/**The number of records thrown away by rate limiting.*/
+		std::atomic<unsigned long long> _rateLimitedRecords(0);
+
+		/**The record deferred statements are captured into when logging synchronously.*/
+		BIO_LOGGER_THREAD_LOCAL _LogRecord _syncRecord;
+
+		/**
+		* Changes every time a binary log is started so sites know if their id has been written 
+		* to the current log.
+		*/
+		unsigned int _binaryGeneration = 0;
+
+		/**The last id given to a LogSite in the current binary log.*/
+		unsigned int _lastSiteId = 0;
+
+		/**A LogSite read back from a binary log.*/
+		struct _DecodedSite
+		{
+			std::string filename;	/**< The file the statement is in.*/
+			unsigned int line;		/**< The line the statement is on.*/
+			std::string format;		/**< The format string of the statement.*/
+		};
 
 		///////////////////////////////////////////////////////////////////////////////////////////
 		//
@@ -124,7 +617,7 @@ namespace BIO
 
 				//std::cout << "Increasing size" << std::endl;
 				//delete the old buffer, increase size, and start over.
-				delete buffer;
+				delete[] buffer;
 				size = size * 2;
 			}
 
@@ -132,194 +625,1368 @@ namespace BIO
 		}
 
 		/**
-		* Generate the current time to place into the log output. This is a private function for 
-		* the BIO LOGGING LIBRARY.
+		* Write the time into a buffer to place into the log output. This is a private function 
+		* for the BIO LOGGING LIBRARY.
 		*
-		* @return Returns a C-String with the current time. This string is created on the heap. The 
-		*			caller is responsible for deleteing it when done.
+		* @param[in] rawtime The time to write.
+		* @param[out] buffer Where to write the time.
+		* @param[in] bufferLength The size of buffer.
 		*/
-		inline char * _LogInternalTime()
+		inline void _LogInternalTime(time_t rawtime, char * buffer, size_t bufferLength)
 		{
-			unsigned int buffer_length = 80;
-
-			time_t rawtime;
-			struct tm * timeinfo = NULL;
-			char * buffer = new char[buffer_length];
-			memset(buffer, 0, sizeof(char)* buffer_length);
-
-			time(&rawtime);
+			struct tm timeinfo;
 
 			#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
-				timeinfo = new struct tm;
-				localtime_s(timeinfo, &rawtime);
+				localtime_s(&timeinfo, &rawtime);
 			#else //Not windows
-				timeinfo = localtime(&rawtime);
+				localtime_r(&rawtime, &timeinfo);
 			#endif
 
-			strftime(buffer, buffer_length, "%H:%M:%S", timeinfo);
-
-			delete timeinfo;
-
-			return buffer;
+			strftime(buffer, bufferLength, "%H:%M:%S", &timeinfo);
 		}
 
 		/**
-		* Get the filename only. This function will stripp of all the directories from an 
+		* Get the filename only. This function will skip all the directories of an 
 		* absolute/relative filepath. This is a private function for this libary.
 		*
 		* @param filename The filename to strip down. Most likely __FILE__ macro
 		*
-		* @return Returns a char * with the stripped down filename. The returned value will be 
-		*			allocated on the stack. The user is responsible for deleting the returned 
-		*			pointer.
+		* @return Returns a pointer into filename where the name of the file starts.
 		*/
-		char * _StripPath(const char * filename)
+		inline const char * _StripPath(const char * filename)
 		{
-			int filenameLength = strlen(filename);
-			int fileStart = filenameLength;
-			for (; fileStart >= 0; fileStart--)
-			{
-				if ((filename[fileStart] == '\\') || (filename[fileStart] == '/'))
-				{
-					break;
-				}
-			}
-
-			fileStart++;
+			const char * fileStart = filename;
 
-			int finalLength = filenameLength - fileStart;
-			char * returnVal = new char[finalLength + 1];
-
-			int counter = 0;
-			for (int i = fileStart; i < filenameLength; i++)
+			for (const char * c = filename; *c != '\0'; c++)
 			{
-				returnVal[counter] = filename[i];
-				counter++;
+				if ((*c == '\\') || (*c == '/'))
+					fileStart = c + 1;
 			}
 
-			returnVal[finalLength] = '\0';
-
-			return returnVal;
+			return fileStart;
 		}
-		//^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
-		//				End Private Functions
-		///////////////////////////////////////////////////////////////////////////////////////////
 
-		void Init(int level, std::ostream * stream)
+		/**
+		* Format one log statement as a line of text. This is a private function for this 
+		* library.
+		*
+		* @param[out] text Where to put the line. Anything already in it is replaced.
+		* @param[in] level The level of the message being logged.
+		* @param[in] rawtime When the message was logged.
+		* @param[in] filename The file the message was logged from. If NULL then only the level 
+		*				and message are written.
+		* @param[in] line The line the message was logged from.
+		* @param[in] message The formatted message.
+		*/
+		inline void _FormatLine(std::string & text, 
+			int level, 
+			time_t rawtime, 
+			const char * filename, 
+			unsigned int line, 
+			const char * message)
 		{
-			if (_initCalled)
+			text.assign("[");
+
+			if (filename != NULL)
 			{
-				Log(BIO_LOGGER_LEVEL_WARNING, 
-					__LINE__, 
-					__FILE__, 
-					"Init has already been called. Exiting Init");
-				return;
-			}
+				char bufferTime[16];
+				_LogInternalTime(rawtime, bufferTime, sizeof(bufferTime));
 
-			if (stream == NULL)
-				_output = &std::cout;
+				text.append(bufferTime);
+				text.append(" ");
+				text.append(_GetLoggingLevelString(level));
+				text.append(" ");
+				text.append(_StripPath(filename));
+				text.append(" ");
+				text.append(std::to_string(line));
+			}
 			else
-				_output = stream;
-
-			SetLoggingLevel(level);
-
-			(*_output) <<
-				" -----------------------------------\n" <<
-				"| Initializing BIO Logger           |\n" <<
-				" -----------------------------------\n";
-
-			_initCalled = true;
+			{
+				text.append(_GetLoggingLevelString(level));
+			}
 
-			atexit(Shutdown);
+			text.append("]: ");
+			text.append(message);
+			text.append("\n");
 		}
 
-		void Log(int level, const char * format, ...)
+		/**
+		* Write one log statement to a stream as text. The stream is not flushed. This is a 
+		* private function for this library.
+		*
+		* @param[out] stream The stream to write to.
+		* @param[in] level The level of the message being logged.
+		* @param[in] rawtime When the message was logged.
+		* @param[in] filename The file the message was logged from. If NULL then only the level 
+		*				and message are written.
+		* @param[in] line The line the message was logged from.
+		* @param[in] message The formatted message.
+		*/
+		inline void _WriteLog(std::ostream & stream, 
+			int level, 
+			time_t rawtime, 
+			const char * filename, 
+			unsigned int line, 
+			const char * message)
 		{
-			if (level > _level)
-				return;
-
-			va_list args;
-			va_start(args, format);
-
-			char * buffer = _LogInternal(format, args);
-
-			va_end(args);
-
-			(*_output) << "[" << _GetLoggingLevelString(level) << "]: " << buffer << std::endl;
-			_output->flush();
+			std::string text;
+			_FormatLine(text, level, rawtime, filename, line, message);
+			stream.write(text.c_str(), text.size());
+		}
 
-			delete buffer;
+		/**
+		* Write a value to a binary log. This is a private function for this library.
+		*
+		* @param[out] stream The stream to write to.
+		* @param[in] value The value to write.
+		*/
+		template <typename Type>
+		inline void _WriteBinary(std::ostream & stream, const Type & value)
+		{
+			stream.write((const char *)&value, sizeof(Type));
 		}
 
-		void Log(int level, unsigned int line, const char * filename, const char * format, ...)
+		/**
+		* Write a string to a binary log as a 16 bit length followed by the chars. This is a 
+		* private function for this library.
+		*
+		* @param[out] stream The stream to write to.
+		* @param[in] value The string to write. NULL is written as an empty string.
+		*/
+		inline void _WriteBinaryString(std::ostream & stream, const char * value)
 		{
-			if (level > _level)
-				return;
+			size_t length = (value == NULL) ? 0 : strlen(value);
+			unsigned short count = (unsigned short)(length < 65535 ? length : 65535);
 
-			va_list args;
-			va_start(args, format);
+			_WriteBinary(stream, count);
+			stream.write(value, count);
+		}
 
-			char * buffer = _LogInternal(format, args);
-			char * bufferTime = _LogInternalTime();
+		/**
+		* Check if any sink would write a statement. This is a private function for this library.
+		*
+		* @param[in] level The level of the statement.
+		*
+		* @return Returns true if at least one sink wants the statement.
+		*/
+		inline bool _SinksWant(int level)
+		{
+			for (unsigned int i = 0; i < _sinkCount; i++)
+			{
+				if (level <= _sinks[i]->GetLevel())
+					return true;
+			}
 
-			va_end(args);
+			return false;
+		}
 
-			char * finalFilename = _StripPath(filename);
-			(*_output) << "[" <<
-				bufferTime << " " <<
-				_GetLoggingLevelString(level) << " " <<
-				finalFilename << " " <<
-				line << "]: " <<
-				buffer << std::endl;
+		/**
+		* Format one log statement as text and write it to the sinks that want it, and to the 
+		* output stream if asked. This is a private function for this library.
+		*
+		* @param[in] level The level of the message being logged.
+		* @param[in] rawtime When the message was logged.
+		* @param[in] filename The file the message was logged from. May be NULL.
+		* @param[in] line The line the message was logged from.
+		* @param[in] message The formatted message.
+		* @param[in] toOutput Also write the line to the output stream.
+		*/
+		inline void _WriteText(int level, 
+			time_t rawtime, 
+			const char * filename, 
+			unsigned int line, 
+			const char * message, 
+			bool toOutput)
+		{
+			_FormatLine(_line, level, rawtime, filename, line, message);
 
-			_output->flush();//std::cout.flush();
+			if (toOutput)
+				_output->write(_line.c_str(), _line.size());
 
-			delete finalFilename;
-			delete buffer;
-			delete bufferTime;
+			for (unsigned int i = 0; i < _sinkCount; i++)
+			{
+				if (level <= _sinks[i]->GetLevel())
+					_sinks[i]->Write(level, _line.c_str(), (unsigned int)_line.size());
+			}
 		}
 
-		void SetLoggingLevel(int level)
+		/**
+		* Write one log statement to the output stream and the sinks. Text is written to the 
+		* output stream as a text line or as a text entry in a binary log. This is a private 
+		* function for this library.
+		*
+		* @param[in] level The level of the message being logged.
+		* @param[in] rawtime When the message was logged.
+		* @param[in] filename The file the message was logged from. May be NULL.
+		* @param[in] line The line the message was logged from.
+		* @param[in] message The formatted message.
+		*/
+		inline void _WriteMessage(int level, 
+			time_t rawtime, 
+			const char * filename, 
+			unsigned int line, 
+			const char * message)
 		{
-			if (level <= 0)
+			if (_config.output == LOGGING_OUTPUT_TEXT)
 			{
-				_level = 0;
+				_WriteText(level, rawtime, filename, line, message, true);
 				return;
 			}
 
-
-			if (level > MaxLoggingLevel)
+			if (_config.output == LOGGING_OUTPUT_BINARY)
 			{
-				_level = MaxLoggingLevel;
-				return;
+				_WriteBinary(*_output, (unsigned char)BIO_LOGGER_BINARY_ENTRY_TEXT);
+				_WriteBinary(*_output, (unsigned char)level);
+				_WriteBinary(*_output, (long long)rawtime);
+				_WriteBinary(*_output, line);
+				_WriteBinaryString(*_output, filename);
+				_WriteBinaryString(*_output, message);
 			}
 
-			_level = level;
+			if (_SinksWant(level))
+				_WriteText(level, rawtime, filename, line, message, false);
 		}
 
-		void Shutdown()
+		/**
+		* Write a record to the output stream and the sinks. Deferred records are formatted when 
+		* writing text and written as is in a binary log. This is a private function for this 
+		* library.
+		*
+		* @param[in] record The record to write.
+		*/
+		void _WriteRecord(const _LogRecord & record)
 		{
-			if (_initCalled == false)
-				return; //no need to shutdown
+			if (record.suppressed > 0)
+			{
+				std::string message = std::to_string(record.suppressed) + 
+					" records from this statement were rate limited.";
 
-			(*_output) <<
-				" -----------------------------------\n" <<
-				"| Shutting Down BIO Logger          |\n" <<
-				" -----------------------------------\n";
+				_WriteMessage(record.level, record.time, record.filename, record.line, message.c_str());
+			}
 
-			_output = &std::cout;
+			if (record.site == NULL)
+			{
+				_WriteMessage(record.level, record.time, record.filename, record.line, record.message);
+				return;
+			}
 
-			_initCalled = false;
-		}
-	}//end namespace LOGGING
-}//end namespace BIO
+			if (_config.output == LOGGING_OUTPUT_BINARY)
+			{
+				LogSite & site = *record.site;
 
-#else
-//define empyt implementations
-inline void BIO::LOGGING::Init(int level, std::ostream * stream){}
-inline void BIO::LOGGING::Log(int level, unsigned int line, const char * filename, const char * format, ...){}
-inline void BIO::LOGGING::Log(int level, const char * format, ...){}
-inline void BIO::LOGGING::SetLoggingLevel(int level){}
-inline void BIO::LOGGING::Shutdown(){}
+				//the first time a site is used in this log write where it is and its format
+				if (site.generation != _binaryGeneration)
+				{
+					site.generation = _binaryGeneration;
+					site.id = ++_lastSiteId;
+
+					_WriteBinary(*_output, (unsigned char)BIO_LOGGER_BINARY_ENTRY_SITE);
+					_WriteBinary(*_output, site.id);
+					_WriteBinary(*_output, site.line);
+					_WriteBinaryString(*_output, site.filename);
+					_WriteBinaryString(*_output, record.format);
+				}
+
+				_WriteBinary(*_output, (unsigned char)BIO_LOGGER_BINARY_ENTRY_RECORD);
+				_WriteBinary(*_output, site.id);
+				_WriteBinary(*_output, (unsigned char)record.level);
+				_WriteBinary(*_output, (long long)record.time);
+				_WriteBinary(*_output, (unsigned short)record.size);
+				_output->write(record.message, record.size);
+			}
+
+			bool toOutput = (_config.output == LOGGING_OUTPUT_TEXT);
+
+			if (toOutput || _SinksWant(record.level))
+			{
+				char text[BIO_LOGGER_RECORD_MESSAGE_SIZE * 2];
+				FormatLogArguments(record.format, 
+					(const unsigned char *)record.message, 
+					record.size, 
+					text, 
+					sizeof(text));
+
+				_WriteText(record.level, record.time, record.filename, record.line, text, toOutput);
+			}
+		}
+
+		/**
+		* Flush the output stream and every sink. This is a private function for this library.
+		*/
+		inline void _FlushOutputs()
+		{
+			_output->flush();
+
+			for (unsigned int i = 0; i < _sinkCount; i++)
+				_sinks[i]->Flush();
+		}
+
+		/**
+		* Check if a log statement is over its rate limit. This is a private function for this 
+		* library.
+		*
+		* @param[in] site The statement being logged.
+		* @param[in] now The current time.
+		*
+		* @return Returns true if the statement may be logged. False if it was rate limited.
+		*/
+		inline bool _CheckRateLimit(LogSite & site, time_t now)
+		{
+			unsigned int second = (unsigned int)now;
+			unsigned int window = site.rateWindow.load(std::memory_order_relaxed);
+
+			//start counting again every second
+			if ((window != second) && 
+				site.rateWindow.compare_exchange_strong(window, second, std::memory_order_relaxed))
+			{
+				site.rateCount.store(0, std::memory_order_relaxed);
+			}
+
+			if (site.rateCount.fetch_add(1, std::memory_order_relaxed) < _config.rateLimit)
+				return true;
+
+			site.rateSuppressed.fetch_add(1, std::memory_order_relaxed);
+			_rateLimitedRecords.fetch_add(1, std::memory_order_relaxed);
+
+			return false;
+		}
+
+		/**
+		* Read a value from a binary log. This is a private function for this library.
+		*
+		* @param[in] stream The stream to read from.
+		* @param[out] value Where to store the value.
+		*
+		* @return Returns true if the value was read.
+		*/
+		template <typename Type>
+		inline bool _ReadBinary(std::istream & stream, Type & value)
+		{
+			stream.read((char *)&value, sizeof(Type));
+			return stream.gcount() == sizeof(Type);
+		}
+
+		/**
+		* Read a string written with _WriteBinaryString. This is a private function for this 
+		* library.
+		*
+		* @param[in] stream The stream to read from.
+		* @param[out] value Where to store the string.
+		*
+		* @return Returns true if the string was read.
+		*/
+		inline bool _ReadBinaryString(std::istream & stream, std::string & value)
+		{
+			unsigned short count;
+			if (!_ReadBinary(stream, count))
+				return false;
+
+			value.resize(count);
+			if (count == 0)
+				return true;
+
+			stream.read(&value[0], count);
+			return stream.gcount() == count;
+		}
+
+		/**
+		* Called when a thread that owns a queue exits. The queue is marked so the drain thread 
+		* deletes it once it is empty. This is a private function for this library.
+		*
+		* @param[in] queue The exiting thread's queue.
+		*/
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+		void WINAPI _ReleaseThreadQueue(void * queue);
+#else
+		void _ReleaseThreadQueue(void * queue);
+#endif
+
+		/**
+		* Create _threadExitKey if it does not exist yet. Must be called before the drain thread 
+		* is started. This is a private function for this library.
+		*/
+		void _CreateThreadExitKey()
+		{
+			if (_threadExitKeyCreated)
+				return;
+
+			#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+				_threadExitKey = FlsAlloc(_ReleaseThreadQueue);
+				_threadExitKeyCreated = (_threadExitKey != FLS_OUT_OF_INDEXES);
+			#else //Not windows
+				_threadExitKeyCreated = (pthread_key_create(&_threadExitKey, _ReleaseThreadQueue) == 0);
+			#endif
+		}
+
+		/**
+		* Get the queue for the current thread. A new queue is created the first time a thread 
+		* logs after asynchronous logging is started. This is a private function for this 
+		* library.
+		*
+		* @return Returns the current thread's queue.
+		*/
+		inline _ThreadQueue * _GetThreadQueue()
+		{
+			unsigned int generation = _queueGeneration.load(std::memory_order_acquire);
+
+			if ((_threadQueue != NULL) && (_threadQueueGeneration == generation))
+				return _threadQueue;
+
+			_ThreadQueue * queue = new _ThreadQueue(_config.queueSize);
+
+			//add the queue to the front of the list
+			_ThreadQueue * head = _queues.load(std::memory_order_relaxed);
+			do
+			{
+				queue->next = head;
+			} while (!_queues.compare_exchange_weak(head, queue,
+				std::memory_order_release,
+				std::memory_order_relaxed));
+
+			_threadQueue = queue;
+			_threadQueueGeneration = generation;
+
+			//without the key the queue is kept until Shutdown
+			if (_threadExitKeyCreated)
+			{
+				#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+					FlsSetValue(_threadExitKey, queue);
+				#else //Not windows
+					pthread_setspecific(_threadExitKey, queue);
+				#endif
+			}
+
+			return queue;
+		}
+
+		/**
+		* Start writing a record into the current thread's queue if asynchronous logging is 
+		* running. The queues are kept alive until _EndAsyncWrite is called. This is a private 
+		* function for this library.
+		*
+		* @return Returns true if the record should be queued, false if it should be written 
+		*			synchronously.
+		*/
+		inline bool _BeginAsyncWrite()
+		{
+			//counted before checking so _StopAsync either sees this writer or this writer sees 
+			//that logging was stopped
+			_asyncWriters.fetch_add(1);
+
+			if (_asyncRunning.load())
+				return true;
+
+			_asyncWriters.fetch_sub(1);
+			return false;
+		}
+
+		/**
+		* Finish a write started with _BeginAsyncWrite. This is a private function for this 
+		* library.
+		*/
+		inline void _EndAsyncWrite()
+		{
+			_asyncWriters.fetch_sub(1, std::memory_order_release);
+		}
+
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+		void WINAPI _ReleaseThreadQueue(void * queue)
+#else
+		void _ReleaseThreadQueue(void * queue)
+#endif
+		{
+			//counted as a writer so the queue is not deleted by _StopAsync while it is marked
+			if (!_BeginAsyncWrite())
+				return;
+
+			//a queue from before the last Shutdown has already been deleted
+			if ((queue == _threadQueue) && 
+				(_threadQueueGeneration == _queueGeneration.load(std::memory_order_acquire)))
+			{
+				_threadQueue->released.store(true, std::memory_order_release);
+				_threadQueue = NULL;
+			}
+
+			_EndAsyncWrite();
+		}
+
+		/**
+		* Get the next free record in the current thread's queue. If the queue is full then the 
+		* queue policy decides if this waits or drops the record. This is a private function for 
+		* this library.
+		*
+		* @return Returns the record to fill in, or NULL if the record was dropped. Call EndWrite 
+		*			on the current thread's queue when the record is filled in.
+		*/
+		inline _LogRecord * _ReserveRecord()
+		{
+			_ThreadQueue * queue = _GetThreadQueue();
+			_LogRecord * record = queue->records.BeginWrite();
+
+			while (record == NULL)
+			{
+				if ((_config.queuePolicy == LOGGING_QUEUE_DROP) || 
+					(_asyncRunning.load(std::memory_order_relaxed) == false))
+				{
+					_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+					return NULL;
+				}
+
+				//wait for the drain thread to make room
+				_drainSignal.notify_one();
+				std::this_thread::yield();
+				record = queue->records.BeginWrite();
+			}
+
+			return record;
+		}
+
+		/**
+		* Put a log statement into the current thread's queue. Must be called between 
+		* _BeginAsyncWrite and _EndAsyncWrite. This is a private function for this library.
+		*
+		* @param[in] level The level of the message being logged.
+		* @param[in] line The line the message was logged from.
+		* @param[in] filename The file the message was logged from. May be NULL.
+		* @param[in] format The format string of the message.
+		* @param[in] args The arguments for the format string.
+		*/
+		inline void _QueueRecord(int level, 
+			unsigned int line, 
+			const char * filename, 
+			const char * format, 
+			va_list args)
+		{
+			_LogRecord * record = _ReserveRecord();
+
+			if (record == NULL)
+				return;
+
+			record->level = level;
+			record->line = line;
+			record->filename = filename;
+			record->site = NULL;
+			record->suppressed = 0;
+			time(&record->time);
+
+			#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+				vsnprintf_s(record->message, BIO_LOGGER_RECORD_MESSAGE_SIZE, _TRUNCATE, format, args);
+			#else //Not windows
+				vsnprintf(record->message, BIO_LOGGER_RECORD_MESSAGE_SIZE, format, args);
+			#endif
+
+			_threadQueue->records.EndWrite();
+		}
+
+		/**
+		* Write every record in every queue to the output stream. Queues of threads that have 
+		* exited are deleted once they are empty. This is a private function for this library 
+		* and must only be called while holding _drainMutex.
+		*
+		* @return Returns the number of records that were written.
+		*/
+		unsigned int _DrainQueues()
+		{
+			unsigned int written = 0;
+			_ThreadQueue * previous = NULL;
+			_ThreadQueue * queue = _queues.load(std::memory_order_acquire);
+
+			while (queue != NULL)
+			{
+				//checked first, nothing is added to a released queue
+				bool released = queue->released.load(std::memory_order_acquire);
+				_ThreadQueue * next = queue->next;
+				_LogRecord * record = queue->records.BeginRead();
+
+				while (record != NULL)
+				{
+					_WriteRecord(*record);
+
+					queue->records.EndRead();
+					written++;
+
+					record = queue->records.BeginRead();
+				}
+
+				//new queues are only added to the front of the list, so unlinking the first 
+				//queue can fail. It is tried again on the next pass.
+				bool unlinked = false;
+				if (released)
+				{
+					if (previous == NULL)
+					{
+						_ThreadQueue * expected = queue;
+						unlinked = _queues.compare_exchange_strong(expected, next);
+					}
+					else
+					{
+						previous->next = next;
+						unlinked = true;
+					}
+				}
+
+				if (unlinked)
+					delete queue;
+				else
+					previous = queue;
+
+				queue = next;
+			}
+
+			if (written > 0)
+				_FlushOutputs();
+
+			return written;
+		}
+
+		/**
+		* The main function of the drain thread. Writes records until asynchronous logging is 
+		* stopped. This is a private function for this library.
+		*/
+		void _DrainThreadMain()
+		{
+			std::unique_lock<std::mutex> lock(_drainMutex);
+
+			while (_asyncRunning.load(std::memory_order_acquire))
+			{
+				if (_DrainQueues() == 0)
+				{
+					_drainSignal.wait_for(lock, 
+						std::chrono::milliseconds(BIO_LOGGER_DRAIN_INTERVAL_MS));
+				}
+			}
+
+			//write anything that was queued while stopping
+			_DrainQueues();
+		}
+
+		/**
+		* Stop the drain thread, write all queued records, and delete all of the queues. This is 
+		* a private function for this library.
+		*/
+		void _StopAsync()
+		{
+			if (_asyncRunning.exchange(false) == false)
+				return;
+
+			//wait for the threads still writing into a queue, the drain thread keeps making 
+			//room for them
+			while (_asyncWriters.load(std::memory_order_acquire) != 0)
+			{
+				_drainSignal.notify_one();
+				std::this_thread::yield();
+			}
+
+			_drainSignal.notify_one();
+			_drainThread.join();
+
+			//write the records finished after the drain thread's last pass
+			{
+				std::lock_guard<std::mutex> lock(_drainMutex);
+				_DrainQueues();
+			}
+
+			_ThreadQueue * queue = _queues.exchange(NULL);
+			while (queue != NULL)
+			{
+				_ThreadQueue * next = queue->next;
+				delete queue;
+				queue = next;
+			}
+		}
+		//^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+		//				End Private Functions
+		///////////////////////////////////////////////////////////////////////////////////////////
+
+		void Init(int level, std::ostream * stream)
+		{
+			Init(level, stream, LoggerConfiguration());
+		}
+
+		void Init(int level, std::ostream * stream, const LoggerConfiguration & config)
+		{
+			if (_initCalled)
+			{
+				Log(BIO_LOGGER_LEVEL_WARNING, 
+					__LINE__, 
+					__FILE__, 
+					"Init has already been called. Exiting Init");
+				return;
+			}
+
+			if (stream == NULL)
+				_output = &std::cout;
+			else
+				_output = stream;
+
+			SetLoggingLevel(level);
+
+			_config = config;
+			_droppedRecords.store(0);
+			_rateLimitedRecords.store(0);
+
+			_sinkCount = 0;
+			for (unsigned int i = 0; i < _config.sinkCount; i++)
+				AddSink(_config.sinks[i]);
+
+			if (_config.output == LOGGING_OUTPUT_BINARY)
+			{
+				_binaryGeneration++;
+				_lastSiteId = 0;
+
+				_output->write(BIO_LOGGER_BINARY_MAGIC, BIO_LOGGER_BINARY_MAGIC_SIZE);
+				_WriteBinary(*_output, (unsigned short)BIO_LOGGER_BINARY_VERSION);
+			}
+			else if (_config.output == LOGGING_OUTPUT_TEXT)
+			{
+				(*_output) <<
+					" -----------------------------------\n" <<
+					"| Initializing BIO Logger           |\n" <<
+					" -----------------------------------\n";
+			}
+
+			if (_config.mode == LOGGING_MODE_ASYNCHRONOUS)
+			{
+				_CreateThreadExitKey();
+				_queueGeneration.fetch_add(1, std::memory_order_release);
+				_asyncRunning.store(true);
+				_drainThread = std::thread(_DrainThreadMain);
+			}
+
+			_initCalled = true;
+
+			atexit(Shutdown);
+		}
+
+		void Flush()
+		{
+			if (_asyncRunning.load(std::memory_order_acquire) == false)
+			{
+				std::lock_guard<std::mutex> lock(_drainMutex);
+				_FlushOutputs();
+				return;
+			}
+
+			//waits for the drain thread to finish writing the records it took, then writes the 
+			//rest
+			std::lock_guard<std::mutex> lock(_drainMutex);
+			_DrainQueues();
+			_FlushOutputs();
+		}
+
+		unsigned long long GetDroppedRecordCount()
+		{
+			return _droppedRecords.load(std::memory_order_relaxed);
+		}
+
+		unsigned long long GetRateLimitedRecordCount()
+		{
+			return _rateLimitedRecords.load(std::memory_order_relaxed);
+		}
+
+		bool AddSink(ILogSink * sink)
+		{
+			if (sink == NULL)
+				return false;
+
+			std::lock_guard<std::mutex> lock(_drainMutex);
+
+			if (_sinkCount >= BIO_LOGGER_MAX_SINKS)
+				return false;
+
+			for (unsigned int i = 0; i < _sinkCount; i++)
+			{
+				if (_sinks[i] == sink)
+					return false;
+			}
+
+			_sinks[_sinkCount++] = sink;
+
+			return true;
+		}
+
+		bool RemoveSink(ILogSink * sink)
+		{
+			std::lock_guard<std::mutex> lock(_drainMutex);
+
+			for (unsigned int i = 0; i < _sinkCount; i++)
+			{
+				if (_sinks[i] == sink)
+				{
+					sink->Flush();
+
+					//keep the rest of the sinks in order
+					for (unsigned int j = i + 1; j < _sinkCount; j++)
+						_sinks[j - 1] = _sinks[j];
+
+					_sinkCount--;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Log(int level, const char * format, ...)
+		{
+			if (!IsLogging(BIO_LOGGER_MODULE_CORE, level))
+				return;
+
+			va_list args;
+			va_start(args, format);
+
+			if (_BeginAsyncWrite())
+			{
+				_QueueRecord(level, 0, NULL, format, args);
+				_EndAsyncWrite();
+				va_end(args);
+				return;
+			}
+
+			char * buffer = _LogInternal(format, args);
+
+			va_end(args);
+
+			{
+				std::lock_guard<std::mutex> lock(_drainMutex);
+				_WriteMessage(level, time(NULL), NULL, 0, buffer);
+				_FlushOutputs();
+			}
+
+			delete[] buffer;
+		}
+
+		void Log(int level, unsigned int line, const char * filename, const char * format, ...)
+		{
+			if (!IsLogging(BIO_LOGGER_MODULE_CORE, level))
+				return;
+
+			va_list args;
+			va_start(args, format);
+
+			if (_BeginAsyncWrite())
+			{
+				_QueueRecord(level, line, filename, format, args);
+				_EndAsyncWrite();
+				va_end(args);
+				return;
+			}
+
+			char * buffer = _LogInternal(format, args);
+
+			va_end(args);
+
+			{
+				std::lock_guard<std::mutex> lock(_drainMutex);
+				_WriteMessage(level, time(NULL), filename, line, buffer);
+				_FlushOutputs();
+			}
+
+			delete[] buffer;
+		}
+
+		bool BeginDeferredLog(int level, 
+			LogSite & site, 
+			const char * format, 
+			LogArgumentBuffer & buffer)
+		{
+			time_t now = time(NULL);
+
+			if ((_config.rateLimit > 0) && !_CheckRateLimit(site, now))
+				return false;
+
+			_LogRecord * record;
+
+			if (_BeginAsyncWrite())
+			{
+				record = _ReserveRecord();
+
+				if (record == NULL)
+				{
+					_EndAsyncWrite();
+					return false;
+				}
+			}
+			else
+			{
+				record = &_syncRecord;
+			}
+
+			record->level = level;
+			record->line = site.line;
+			record->filename = site.filename;
+			record->site = &site;
+			record->format = format;
+			record->time = now;
+			record->suppressed = (_config.rateLimit > 0) ? 
+				site.rateSuppressed.exchange(0, std::memory_order_relaxed) : 0;
+
+			buffer.data = (unsigned char *)record->message;
+			buffer.size = 0;
+			buffer.capacity = BIO_LOGGER_RECORD_MESSAGE_SIZE;
+			buffer.record = record;
+
+			return true;
+		}
+
+		void EndDeferredLog(LogArgumentBuffer & buffer)
+		{
+			_LogRecord * record = (_LogRecord *)buffer.record;
+			record->size = buffer.size;
+
+			if (record == &_syncRecord)
+			{
+				std::lock_guard<std::mutex> lock(_drainMutex);
+				_WriteRecord(*record);
+				_FlushOutputs();
+				return;
+			}
+
+			_threadQueue->records.EndWrite();
+			_EndAsyncWrite();
+		}
+
+		bool DecodeBinaryLog(std::istream & input, std::ostream & output)
+		{
+			char magic[BIO_LOGGER_BINARY_MAGIC_SIZE];
+			unsigned short version;
+
+			input.read(magic, BIO_LOGGER_BINARY_MAGIC_SIZE);
+			if ((input.gcount() != BIO_LOGGER_BINARY_MAGIC_SIZE) || 
+				(memcmp(magic, BIO_LOGGER_BINARY_MAGIC, BIO_LOGGER_BINARY_MAGIC_SIZE) != 0))
+				return false;
+
+			if (!_ReadBinary(input, version) || (version != BIO_LOGGER_BINARY_VERSION))
+				return false;
+
+			std::vector<_DecodedSite> sites;
+			std::string message;
+			unsigned char data[BIO_LOGGER_RECORD_MESSAGE_SIZE];
+			char text[BIO_LOGGER_RECORD_MESSAGE_SIZE * 2];
+
+			while (true)
+			{
+				int entry = input.get();
+
+				if (entry == std::char_traits<char>::eof())
+					return true;
+
+				unsigned char level;
+				long long rawtime;
+
+				switch (entry)
+				{
+				case BIO_LOGGER_BINARY_ENTRY_SITE:
+				{
+					unsigned int id;
+					_DecodedSite site;
+
+					if (!_ReadBinary(input, id) || 
+						!_ReadBinary(input, site.line) || 
+						!_ReadBinaryString(input, site.filename) || 
+						!_ReadBinaryString(input, site.format))
+						return false;
+
+					//ids are handed out in order, so a new site is always the next one
+					if ((id == 0) || (id > sites.size() + 1))
+						return false;
+
+					if (id > sites.size())
+						sites.push_back(site);
+					else
+						sites[id - 1] = site;
+					break;
+				}
+				case BIO_LOGGER_BINARY_ENTRY_RECORD:
+				{
+					unsigned int id;
+					unsigned short size;
+
+					if (!_ReadBinary(input, id) || 
+						!_ReadBinary(input, level) || 
+						!_ReadBinary(input, rawtime) || 
+						!_ReadBinary(input, size))
+						return false;
+
+					if ((id == 0) || (id > sites.size()) || (size > sizeof(data)))
+						return false;
+
+					input.read((char *)data, size);
+					if (input.gcount() != size)
+						return false;
+
+					const _DecodedSite & site = sites[id - 1];
+					FormatLogArguments(site.format.c_str(), data, size, text, sizeof(text));
+					_WriteLog(output, level, (time_t)rawtime, site.filename.c_str(), site.line, text);
+					break;
+				}
+				case BIO_LOGGER_BINARY_ENTRY_TEXT:
+				{
+					unsigned int line;
+					std::string filename;
+
+					if (!_ReadBinary(input, level) || 
+						!_ReadBinary(input, rawtime) || 
+						!_ReadBinary(input, line) || 
+						!_ReadBinaryString(input, filename) || 
+						!_ReadBinaryString(input, message))
+						return false;
+
+					_WriteLog(output, 
+						level, 
+						(time_t)rawtime, 
+						filename.empty() ? NULL : filename.c_str(), 
+						line, 
+						message.c_str());
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+		}
+
+		void SetLoggingLevel(int level)
+		{
+			for (int module = 0; module < BIO_LOGGER_MODULE_COUNT; module++)
+				SetModuleLoggingLevel(module, level);
+		}
+
+		void SetModuleLoggingLevel(int module, int level)
+		{
+			if ((module < 0) || (module >= BIO_LOGGER_MODULE_COUNT))
+				return;
+
+			if (level <= 0)
+				level = 0;
+			else if (level > MaxLoggingLevel)
+				level = MaxLoggingLevel;
+
+			ModuleLoggingLevels[module].store(level, std::memory_order_relaxed);
+		}
+
+		int GetModuleLoggingLevel(int module)
+		{
+			if ((module < 0) || (module >= BIO_LOGGER_MODULE_COUNT))
+				return BIO_LOGGER_LEVEL_OFF;
+
+			return ModuleLoggingLevels[module].load(std::memory_order_relaxed);
+		}
+
+		void Shutdown()
+		{
+			if (_initCalled == false)
+				return; //no need to shutdown
+
+			_StopAsync();
+
+			//other threads may still be logging synchronously
+			std::lock_guard<std::mutex> lock(_drainMutex);
+
+			unsigned long long dropped = GetDroppedRecordCount();
+			if (dropped > 0)
+			{
+				char message[64];
+				_PrintToBuffer(message, sizeof(message), "%llu log records were dropped.", dropped);
+				_WriteMessage(BIO_LOGGER_LEVEL_WARNING, time(NULL), NULL, 0, message);
+			}
+
+			if (_config.output == LOGGING_OUTPUT_TEXT)
+			{
+				(*_output) <<
+					" -----------------------------------\n" <<
+					"| Shutting Down BIO Logger          |\n" <<
+					" -----------------------------------\n";
+			}
+
+			_FlushOutputs();
+			_output = &std::cout;
+			_config = LoggerConfiguration();
+			_sinkCount = 0;
+
+			_initCalled = false;
+		}
+	}//end namespace LOGGING
+}//end namespace BIO
+
+#else
+//define empyt implementations
+void BIO::LOGGING::Init(int level, std::ostream * stream){}
+void BIO::LOGGING::Init(int level, std::ostream * stream, const LoggerConfiguration & config){}
+void BIO::LOGGING::Flush(){}
+unsigned long long BIO::LOGGING::GetDroppedRecordCount(){ return 0; }
+unsigned long long BIO::LOGGING::GetRateLimitedRecordCount(){ return 0; }
+bool BIO::LOGGING::AddSink(ILogSink * sink){ return false; }
+bool BIO::LOGGING::RemoveSink(ILogSink * sink){ return false; }
+bool BIO::LOGGING::BeginDeferredLog(int level, LogSite & site, const char * format, LogArgumentBuffer & buffer){ return false; }
+void BIO::LOGGING::EndDeferredLog(LogArgumentBuffer & buffer){}
+bool BIO::LOGGING::DecodeBinaryLog(std::istream & input, std::ostream & output){ return false; }
+void BIO::LOGGING::Log(int level, unsigned int line, const char * filename, const char * format, ...){}
+void BIO::LOGGING::Log(int level, const char * format, ...){}
+void BIO::LOGGING::SetLoggingLevel(int level){}
+void BIO::LOGGING::SetModuleLoggingLevel(int module, int level){}
+int BIO::LOGGING::GetModuleLoggingLevel(int module){ return BIO_LOGGER_LEVEL_OFF; }
+void BIO::LOGGING::Shutdown(){}
+
+#endif //BIO_LOGGING_IS_ENABLED
+
+#if BIO_TESTING_IS_ENABLED == BIO_TESTING_ON
+#if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
+namespace
+{
+	/**A sink that holds up the drain thread until it is released.*/
+	class _BlockingLogSink : public BIO::LOGGING::ILogSink
+	{
+	public:
+		std::atomic<bool> entered;	/**< Has Write been called?*/
+		std::atomic<bool> released;	/**< Can Write return?*/
+
+		_BlockingLogSink() : ILogSink(BIO::LOGGING::MaxLoggingLevel), entered(false), released(false) {}
+
+		virtual void Write(int, const char *, unsigned int)
+		{
+			entered.store(true);
+
+			while (!released.load())
+				std::this_thread::yield();
+		}
+	};
+
+	/**Count how many times text is in log.*/
+	unsigned int _CountInLog(const std::string & log, const char * text)
+	{
+		unsigned int count = 0;
+
+		for (size_t i = log.find(text); i != std::string::npos; i = log.find(text, i + 1))
+			count++;
+
+		return count;
+	}
+
+	/**Count the queues in the list of every thread's queue.*/
+	unsigned int _CountQueues()
+	{
+		std::lock_guard<std::mutex> lock(BIO::LOGGING::_drainMutex);
+		unsigned int count = 0;
+
+		for (BIO::LOGGING::_ThreadQueue * queue = BIO::LOGGING::_queues.load();
+			queue != NULL;
+			queue = queue->next)
+			count++;
+
+		return count;
+	}
+
+	/**Log from a new thread that exits right away.*/
+	void _LogFromThread()
+	{
+		BIO::LOGGING::Log(BIO_LOGGER_LEVEL_ERROR, "thread record");
+	}
+}
+#endif
+
+bool BIO::LOGGING::TestLogger(XNELO::TESTING::Test * test)
+{
+	test->SetName("Logger Tests");
+
+#if BIO_LOGGING_IS_ENABLED == BIO_LOGGING_ON
+	int levels[BIO_LOGGER_MODULE_COUNT];
+	for (int module = 0; module < BIO_LOGGER_MODULE_COUNT; module++)
+		levels[module] = GetModuleLoggingLevel(module);
+
+	//Module levels
+	std::stringstream modules;
+	Init(BIO_LOGGER_LEVEL_WARNING, &modules);
+	SetModuleLoggingLevel(BIO_LOGGER_MODULE_RENDERER, BIO_LOGGER_LEVEL_DEBUG2);
+	test->UnitTest(GetModuleLoggingLevel(BIO_LOGGER_MODULE_CORE) == BIO_LOGGER_LEVEL_WARNING, 
+		"Init sets every module level");
+	test->UnitTest(GetModuleLoggingLevel(BIO_LOGGER_MODULE_RENDERER) == BIO_LOGGER_LEVEL_DEBUG2, 
+		"Set one module level");
+	test->UnitTest(IsLogging(BIO_LOGGER_MODULE_ENGINE, BIO_LOGGER_LEVEL_WARNING), 
+		"Module logs at its level");
+	test->UnitTest(!IsLogging(BIO_LOGGER_MODULE_ENGINE, BIO_LOGGER_LEVEL_INFO), 
+		"Module does not log above its level");
+	test->UnitTest(IsLogging(BIO_LOGGER_MODULE_RENDERER, BIO_LOGGER_LEVEL_DEBUG2), 
+		"Raised module logs at its level");
+	test->UnitTest(!IsLogging(BIO_LOGGER_MODULE_RENDERER, BIO_LOGGER_LEVEL_DEBUG3), 
+		"Raised module does not log above its level");
+
+	int evaluated = 0;
+	BIO_LOG_ENGINE(DEBUG4, "engine statement %d", ++evaluated);
+	BIO_LOG_RENDERER(DEBUG2, "renderer statement %d", ++evaluated);
+	test->UnitTest(evaluated == 1, "Filtered statements do not evaluate their arguments");
+	test->UnitTest(_CountInLog(modules.str(), "renderer statement 1") == 1, 
+		"Statement of a raised module is written");
+	test->UnitTest(_CountInLog(modules.str(), "engine statement") == 0, 
+		"Filtered statement is not written");
+
+	SetModuleLoggingLevel(BIO_LOGGER_MODULE_LOADER, MaxLoggingLevel + 5);
+	test->UnitTest(GetModuleLoggingLevel(BIO_LOGGER_MODULE_LOADER) == MaxLoggingLevel, 
+		"Module level is clamped to MaxLoggingLevel");
+	SetModuleLoggingLevel(BIO_LOGGER_MODULE_LOADER, -2);
+	test->UnitTest(GetModuleLoggingLevel(BIO_LOGGER_MODULE_LOADER) == BIO_LOGGER_LEVEL_OFF, 
+		"Module level is clamped to 0");
+	SetModuleLoggingLevel(BIO_LOGGER_MODULE_COUNT, BIO_LOGGER_LEVEL_DEBUG);
+	test->UnitTest(GetModuleLoggingLevel(BIO_LOGGER_MODULE_COUNT) == BIO_LOGGER_LEVEL_OFF, 
+		"Unknown module is ignored");
+	Shutdown();
+
+	//Sinks
+	MemoryLogSink warnings(4096, BIO_LOGGER_LEVEL_WARNING);
+	MemoryLogSink everything(4096);
+	LoggerConfiguration sinkConfig;
+	sinkConfig.output = LOGGING_OUTPUT_NONE;
+	sinkConfig.rateLimit = 3;
+	sinkConfig.AddSink(&warnings);
+	Init(BIO_LOGGER_LEVEL_DEBUG4, NULL, sinkConfig);
+	test->UnitTest(AddSink(&everything), "Add a sink after Init");
+	test->UnitTest(!AddSink(&everything), "Add a sink twice");
+	Log(BIO_LOGGER_LEVEL_ERROR, "sink error");
+	Log(BIO_LOGGER_LEVEL_INFO, "sink info");
+	test->UnitTest(_CountInLog(warnings.GetContents(), "sink error") == 1, "Sink writes its level");
+	test->UnitTest(_CountInLog(warnings.GetContents(), "sink info") == 0, 
+		"Sink does not write above its level");
+	test->UnitTest(_CountInLog(everything.GetContents(), "sink error") == 1 && 
+		_CountInLog(everything.GetContents(), "sink info") == 1, "Each sink has its own level");
+
+	//the limit is per second, so try again if the statements did not all land in one second
+	bool sameSecond = false;
+	unsigned long long limited = 0;
+	for (unsigned int attempt = 0; (attempt < 3) && !sameSecond; attempt++)
+	{
+		LogSite rateSite = { __FILE__, __LINE__, 0, 0, {0}, {0}, {0} };
+		unsigned long long before = GetRateLimitedRecordCount();
+		everything.Clear();
+
+		time_t start = time(NULL);
+		for (unsigned int i = 0; i < 10; i++)
+			LogDeferred(BIO_LOGGER_LEVEL_WARNING, rateSite, "rate statement %u", i);
+		sameSecond = (time(NULL) == start);
+
+		limited = GetRateLimitedRecordCount() - before;
+	}
+	test->UnitTest(sameSecond && (limited == 7), "Statement over the rate limit is counted");
+	test->UnitTest(_CountInLog(everything.GetContents(), "rate statement") == 3, 
+		"Statement over the rate limit is not written");
+
+	test->UnitTest(RemoveSink(&everything), "Remove a sink");
+	test->UnitTest(!RemoveSink(&everything), "Remove a sink twice");
+	Log(BIO_LOGGER_LEVEL_ERROR, "after remove");
+	test->UnitTest(_CountInLog(everything.GetContents(), "after remove") == 0, 
+		"Removed sink is not written to");
+	Shutdown();
+
+	//Binary output
+	std::stringstream binary;
+	LoggerConfiguration config;
+	config.output = LOGGING_OUTPUT_BINARY;
+	Init(BIO_LOGGER_LEVEL_DEBUG4, &binary, config);
+	static LogSite site = { __FILE__, __LINE__, 0, 0, {0}, {0}, {0} };
+	LogDeferred(BIO_LOGGER_LEVEL_ERROR, site, "binary %d %s", 42, "record");
+	Shutdown();
+
+	std::string log = binary.str();
+	std::stringstream decoded;
+	std::stringstream input(log);
+	test->UnitTest(DecodeBinaryLog(input, decoded), "Decode binary log");
+	test->UnitTest(decoded.str().find("binary 42 record") != std::string::npos, 
+		"Decode binary log record");
+
+	std::stringstream truncated(log.substr(0, log.size() - 3));
+	decoded.str("");
+	test->UnitTest(!DecodeBinaryLog(truncated, decoded), "Decode truncated binary log");
+
+	std::stringstream notBinary("not a binary log");
+	test->UnitTest(!DecodeBinaryLog(notBinary, decoded), "Decode text as binary log");
+
+	//a site with a huge id must be rejected instead of growing the site table
+	std::string corrupt(BIO_LOGGER_BINARY_MAGIC, BIO_LOGGER_BINARY_MAGIC_SIZE);
+	unsigned short version = BIO_LOGGER_BINARY_VERSION;
+	unsigned int id = 0x7FFFFFFF;
+	unsigned int line = 1;
+	unsigned short length = 0;
+	corrupt.append((const char *)&version, sizeof(version));
+	corrupt.push_back((char)BIO_LOGGER_BINARY_ENTRY_SITE);
+	corrupt.append((const char *)&id, sizeof(id));
+	corrupt.append((const char *)&line, sizeof(line));
+	corrupt.append((const char *)&length, sizeof(length));
+	corrupt.append((const char *)&length, sizeof(length));
+	std::stringstream badSite(corrupt);
+	test->UnitTest(!DecodeBinaryLog(badSite, decoded), "Decode site with a bad id");
+
+	//a record for a site that was never written
+	corrupt.resize(BIO_LOGGER_BINARY_MAGIC_SIZE + sizeof(version));
+	id = 1;
+	corrupt.push_back((char)BIO_LOGGER_BINARY_ENTRY_RECORD);
+	corrupt.append((const char *)&id, sizeof(id));
+	std::stringstream badRecord(corrupt);
+	test->UnitTest(!DecodeBinaryLog(badRecord, decoded), "Decode record without a site");
+
+	//Asynchronous output
+	std::stringstream async;
+	LoggerConfiguration asyncConfig;
+	asyncConfig.mode = LOGGING_MODE_ASYNCHRONOUS;
+	Init(BIO_LOGGER_LEVEL_DEBUG4, &async, asyncConfig);
+	static LogSite asyncSite = { __FILE__, __LINE__, 0, 0, {0}, {0}, {0} };
+	LogDeferred(BIO_LOGGER_LEVEL_ERROR, asyncSite, "async %d %s", 7, "record");
+	Log(BIO_LOGGER_LEVEL_ERROR, "async %s", "text");
+	Flush();
+	test->UnitTest(_CountInLog(async.str(), "async 7 record") == 1, "Async deferred record");
+	test->UnitTest(_CountInLog(async.str(), "async text") == 1, "Async text record");
+
+	//every thread gets a queue, it is deleted after the thread exits
+	unsigned int queues = _CountQueues();
+	std::thread threads[8];
+	for (unsigned int i = 0; i < 8; i++)
+		threads[i] = std::thread(_LogFromThread);
+	for (unsigned int i = 0; i < 8; i++)
+		threads[i].join();
+	Flush();
+	test->UnitTest(_CountInLog(async.str(), "thread record") == 8, "Records of exited threads");
+	test->UnitTest(_CountQueues() == queues, "Queues of exited threads are deleted");
+	Shutdown();
+	test->UnitTest(_CountQueues() == 0, "Shutdown deletes the queues");
+
+	//a full queue drops records. The drain thread is held up by the sink while it writes the 
+	//first record, which keeps one of the 4 records in use.
+	std::stringstream drop;
+	_BlockingLogSink blocking;
+	LoggerConfiguration dropConfig;
+	dropConfig.mode = LOGGING_MODE_ASYNCHRONOUS;
+	dropConfig.queuePolicy = LOGGING_QUEUE_DROP;
+	dropConfig.queueSize = 4;
+	dropConfig.AddSink(&blocking);
+	Init(BIO_LOGGER_LEVEL_DEBUG4, &drop, dropConfig);
+	Log(BIO_LOGGER_LEVEL_ERROR, "first record");
+	while (!blocking.entered.load())
+		std::this_thread::yield();
+	for (unsigned int i = 0; i < 10; i++)
+		Log(BIO_LOGGER_LEVEL_ERROR, "queued record");
+	test->UnitTest(GetDroppedRecordCount() == 7, "Full queue drops records");
+	blocking.released.store(true);
+	Shutdown();
+	test->UnitTest(_CountInLog(drop.str(), "queued record") == 3, "Records that fit are written");
+	test->UnitTest(_CountInLog(drop.str(), "7 log records were dropped") == 1, 
+		"Dropped records are reported");
+
+	//a full queue waits for the drain thread
+	std::stringstream block;
+	LoggerConfiguration blockConfig;
+	blockConfig.mode = LOGGING_MODE_ASYNCHRONOUS;
+	blockConfig.queuePolicy = LOGGING_QUEUE_BLOCK;
+	blockConfig.queueSize = 4;
+	Init(BIO_LOGGER_LEVEL_DEBUG4, &block, blockConfig);
+	for (unsigned int i = 0; i < 200; i++)
+		Log(BIO_LOGGER_LEVEL_ERROR, "blocking record");
+	Flush();
+	test->UnitTest(GetDroppedRecordCount() == 0, "Full queue blocks");
+	test->UnitTest(_CountInLog(block.str(), "blocking record") == 200, "Blocked records are written");
+	Shutdown();
+
+	for (int module = 0; module < BIO_LOGGER_MODULE_COUNT; module++)
+		SetModuleLoggingLevel(module, levels[module]);
+#endif
 
-#endif //BIO_LOGGING_IS_ENABLED
\ No newline at end of file
+	return test->GetSuccess();
+}
+#endif //BIO_TESTING_IS_ENABLED
@@ -0,0 +1,161 @@
+/**
+* @file MappedFile.cpp
+* @author Spencer Hoffa
+*
+* Implementation of the MappedFile class for Windows and POSIX systems.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "MappedFile.hpp"
+#include "Logger.hpp"
+
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BIO
+{
+	namespace FILE
+	{
+		MappedFile::MappedFile() : _data(NULL), _size(0), _mapping(NULL)
+		{
+			//Do Nothing
+		}
+
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+#if BIO_CORE_PLATFORM == BIO_CORE_WINDOWS
+		bool MappedFile::Open(const char * filename)
+		{
+			Close();
+
+			HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 
+				FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				BIO_LOG_CORE(WARNING, "Unable to open '%s' for mapping", filename);
+				return false;
+			}
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || (size.QuadPart == 0))
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			//the mapping keeps the file open
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			CloseHandle(file);
+
+			if (mapping == NULL)
+			{
+				BIO_LOG_CORE(WARNING, "Unable to map '%s'", filename);
+				return false;
+			}
+
+			void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+			if (data == NULL)
+			{
+				BIO_LOG_CORE(WARNING, "Unable to map '%s'", filename);
+				CloseHandle(mapping);
+				return false;
+			}
+
+			_mapping = mapping;
+			_data = (const char *)data;
+			_size = (size_t)size.QuadPart;
+
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			if (_data)
+				UnmapViewOfFile(_data);
+
+			if (_mapping)
+				CloseHandle((HANDLE)_mapping);
+
+			_data = NULL;
+			_size = 0;
+			_mapping = NULL;
+		}
+#else
+		bool MappedFile::Open(const char * filename)
+		{
+			Close();
+
+			int file = open(filename, O_RDONLY);
+
+			if (file < 0)
+			{
+				BIO_LOG_CORE(WARNING, "Unable to open '%s' for mapping", filename);
+				return false;
+			}
+
+			struct stat info;
+			if ((fstat(file, &info) != 0) || (info.st_size == 0))
+			{
+				close(file);
+				return false;
+			}
+
+			//the mapping keeps the file open
+			void * data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			close(file);
+
+			if (data == MAP_FAILED)
+			{
+				BIO_LOG_CORE(WARNING, "Unable to map '%s'", filename);
+				return false;
+			}
+
+			_data = (const char *)data;
+			_size = (size_t)info.st_size;
+
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			if (_data)
+				munmap((void *)_data, _size);
+
+			_data = NULL;
+			_size = 0;
+			_mapping = NULL;
+		}
+#endif
+	}//end namespace FILE
+}//end namespace BIO
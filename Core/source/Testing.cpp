@@ -34,6 +34,12 @@
 #include "BasicTypes.hpp"
 #include "StringUtils.hpp"
 #include "FileUtils.hpp"
+#include "RingBuffer.hpp"
+#include "LogArguments.hpp"
+#include "LogSinks.hpp"
+#include "Logger.hpp"
+#include "MappedFile.hpp"
+#include "JobSystem.hpp"
 #endif
 
 bool BIO::CORE::TestCore()
@@ -52,6 +58,12 @@ bool BIO::CORE::TestCore()
 	testSuite.AddTestFunction(TestBasicTypes);
 	testSuite.AddTestFunction(STRING::TestStringUtils);
 	testSuite.AddTestFunction(FILE::FileUtilsTests);
+	testSuite.AddTestFunction(FILE::TestMappedFile);
+	testSuite.AddTestFunction(TestRingBuffer);
+	testSuite.AddTestFunction(TestJobSystem);
+	testSuite.AddTestFunction(LOGGING::TestLogArguments);
+	testSuite.AddTestFunction(LOGGING::TestLogSinks);
+	testSuite.AddTestFunction(LOGGING::TestLogger);
 
 	//run tests and print out results
 	testSuite.ExecuteTests();
@@ -128,6 +128,14 @@ namespace scene
 		//! Returns the nearest scene node which collides with a 3d ray and whose id matches a bitmask.
 		/** The collision tests are done using a bounding box for each
 		scene node. The recursive search can be limited be specifying a scene node.
+		With ISceneManager::setBoundingVolumeTree() the nodes are searched in the
+		tree instead. It holds the nodes which registered for rendering in the
+		last drawAll() and the nodes added to the scene or shown since then.
+		The leaves of the nodes whose absolute transformation was calculated
+		again since then are fitted again first. Nodes which never register,
+		like dummy transformation and bone scene nodes, are only found until
+		the drawAll() after they were added, and a node whose bounding box grew
+		without moving may be missed until the next drawAll().
 		\param ray Line with which collisions are tested.
 		\param idBitMask Only scene nodes with an id which matches at
 		least one of the bits contained in this mask will be tested.
@@ -1144,7 +1144,9 @@ namespace scene
 		\param pass: Specifies when the node wants to be drawn in relation to the other nodes.
 		For example, if the node is a shadow, it usually wants to be drawn after all other nodes
 		and will use ESNRP_SHADOW for this. See scene::E_SCENE_NODE_RENDER_PASS for details.
-		\return scene will be rendered ( passed culling ) */
+		\return scene will be rendered ( passed culling ). Nodes of the solid, transparent
+		and shadow passes are culled together after all nodes registered, so only their
+		occlusion query can make this 0. */
 		virtual u32 registerNodeForRendering(ISceneNode* node,
 			E_SCENE_NODE_RENDER_PASS pass = ESNRP_AUTOMATIC) = 0;
 
@@ -1653,6 +1655,40 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Set how many threads animate the scene in drawAll().
+		/** Each subtree below the root of the scene is animated as a whole by one
+		thread, and the subtrees at the same time. Subtrees with a node or an
+		animator which is not thread safe are animated afterwards on the calling
+		thread, in scene order. See ISceneNode::isAnimateThreadSafe() and
+		ISceneNodeAnimator::isThreadSafe(). The threads are shared with the
+		Burning software rasterizer.
+		\param threads Number of threads, including the calling thread. 0 or 1
+		animates the whole scene on the calling thread, which is the default.
+		\param deterministic Give each thread a fixed range of the subtrees instead
+		of the next one left, so a subtree is animated by the same thread every frame. */
+		virtual void setAnimateThreads(u32 threads, bool deterministic=false) = 0;
+
+		//! Get the number of threads which animate the scene, including the calling thread.
+		virtual u32 getAnimateThreads() const = 0;
+
+		//! Set if the scene manager keeps a bounding volume tree of the scene nodes.
+		/** The tree holds the nodes which registered for rendering in the
+		last drawAll(), in boxes a bit larger than the nodes, so it only changes
+		when a node moves out of its box. drawAll() culls the tree against the
+		view frustum first, which rejects a whole group of nodes in one test
+		and leaves only the nodes near the border of the frustum to be tested
+		one by one. ISceneCollisionManager::getSceneNodeFromRayBB() searches
+		the tree instead of walking through the scene, see there for what it
+		does not find. The scene nodes report their moves to the tree, see
+		ISceneNode::OnSceneNodeChanged(), so only the leaves of moved nodes are
+		fitted again. The tree holds a reference to its nodes, nodes removed
+		from the scene are released by the next drawAll(). Off by default.
+		\param enable True to keep the tree, false to release it. */
+		virtual void setBoundingVolumeTree(bool enable) = 0;
+
+		//! Get if the scene manager keeps a bounding volume tree of the scene nodes.
+		virtual bool isBoundingVolumeTreeEnabled() const = 0;
 	};
 
 
@@ -49,7 +49,8 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				IsVisible(true), IsDebugObject(false), AbsoluteTransformationDirty(true),
+				BoundingVolumeLeaf(-1)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -134,6 +135,20 @@ namespace scene
 		}
 
 
+		//! Returns if OnAnimate() of this node may run on a worker thread.
+		/** When ISceneManager::setAnimateThreads() is used, subtrees of the scene
+		are animated at the same time on several threads. A node is safe if its
+		OnAnimate() changes nothing but the node and its children, and reads nothing
+		another subtree could be changing. Subtrees with a node that is not safe, or
+		with an animator which is not ISceneNodeAnimator::isThreadSafe(), are
+		animated on the calling thread.
+		\return true by default, nodes which override OnAnimate() may need to return false. */
+		virtual bool isAnimateThreadSafe() const
+		{
+			return true;
+		}
+
+
 		//! Renders the node.
 		virtual void render() = 0;
 
@@ -251,7 +266,13 @@ namespace scene
 		\param isVisible If the node shall be visible. */
 		virtual void setVisible(bool isVisible)
 		{
+			const bool shown = isVisible && !IsVisible;
+
 			IsVisible = isVisible;
+
+			// hidden nodes are skipped when picking, shown ones have to be found again
+			if (shown)
+				noteSceneChange(false);
 		}
 
 
@@ -289,6 +310,8 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				child->setAbsoluteTransformationDirty();
+				child->noteSceneChange(false);
 			}
 		}
 
@@ -306,6 +329,7 @@ namespace scene
 				if ((*it) == child)
 				{
 					(*it)->Parent = 0;
+					(*it)->setAbsoluteTransformationDirty();
 					(*it)->drop();
 					Children.erase(it);
 					return true;
@@ -326,6 +350,7 @@ namespace scene
 			for (; it != Children.end(); ++it)
 			{
 				(*it)->Parent = 0;
+				(*it)->setAbsoluteTransformationDirty();
 				(*it)->drop();
 			}
 
@@ -468,6 +493,7 @@ namespace scene
 		virtual void setScale(const core::vector3df& scale)
 		{
 			RelativeScale = scale;
+			setAbsoluteTransformationDirty();
 		}
 
 
@@ -488,6 +514,7 @@ namespace scene
 		virtual void setRotation(const core::vector3df& rotation)
 		{
 			RelativeRotation = rotation;
+			setAbsoluteTransformationDirty();
 		}
 
 
@@ -507,6 +534,7 @@ namespace scene
 		virtual void setPosition(const core::vector3df& newpos)
 		{
 			RelativeTranslation = newpos;
+			setAbsoluteTransformationDirty();
 		}
 
 
@@ -648,9 +676,14 @@ namespace scene
 
 		//! Updates the absolute position based on the relative and the parents position
 		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-			hierarchy you might want to update the parents first.*/
+			hierarchy you might want to update the parents first.
+			Nothing is done if the absolute transformation is up to date, see
+			setAbsoluteTransformationDirty().*/
 		virtual void updateAbsolutePosition()
 		{
+			if (!AbsoluteTransformationDirty)
+				return;
+
 			if (Parent)
 			{
 				AbsoluteTransformation =
@@ -658,6 +691,67 @@ namespace scene
 			}
 			else
 				AbsoluteTransformation = getRelativeTransformation();
+
+			// the bounding volume tree refits the leaf of the node
+			if (BoundingVolumeLeaf != -1)
+				noteSceneChange(true);
+
+			// the children are marked when they are about to be updated, not when
+			// this node is moved, so moving a node does not walk its subtree
+			ISceneNodeList::Iterator it = Children.begin();
+			for (; it != Children.end(); ++it)
+				(*it)->AbsoluteTransformationDirty = true;
+
+			// a parent which is not up to date yet makes this node update again
+			AbsoluteTransformationDirty = Parent && Parent->AbsoluteTransformationDirty;
+		}
+
+
+		//! Marks the absolute transformation of this node as out of date.
+		/** The next updateAbsolutePosition() calculates it again, and the ones of
+		the children after it. setPosition(), setRotation(), setScale() and
+		changing the parent do this already. Nodes whose getRelativeTransformation()
+		depends on anything else have to call it when that changes. */
+		void setAbsoluteTransformationDirty()
+		{
+			AbsoluteTransformationDirty = true;
+		}
+
+
+		//! Returns if updateAbsolutePosition() will calculate the absolute transformation again.
+		/** The children of a node which was moved only become dirty when the node
+		is updated. */
+		bool isAbsoluteTransformationDirty() const
+		{
+			return AbsoluteTransformationDirty;
+		}
+
+
+		//! Sets the leaf of this node in the bounding volume tree of the scene manager.
+		/** Only used by the scene manager, see ISceneManager::setBoundingVolumeTree(). */
+		void setBoundingVolumeLeaf(s32 leaf)
+		{
+			BoundingVolumeLeaf = leaf;
+		}
+
+
+		//! Returns the leaf of this node in the bounding volume tree of the scene manager, or -1.
+		s32 getBoundingVolumeLeaf() const
+		{
+			return BoundingVolumeLeaf;
+		}
+
+
+		//! Called on the root of a scene when a scene node in it changed.
+		/** The scene manager is the root of its scene and keeps its bounding
+		volume tree up to date with it, see ISceneManager::setBoundingVolumeTree().
+		Moves are only passed on for nodes with a leaf in a tree. Can be called
+		from several threads at once while the scene is animated.
+		\param node The scene node which changed.
+		\param moved True if the absolute transformation of the node was
+		calculated again, false if the node was added to the scene or shown. */
+		virtual void OnSceneNodeChanged(ISceneNode* node, bool moved)
+		{
 		}
 
 
@@ -749,6 +843,16 @@ namespace scene
 
 	protected:
 
+		//! Tells the root of the scene that this node changed, see OnSceneNodeChanged().
+		void noteSceneChange(bool moved)
+		{
+			ISceneNode* root = this;
+			while (root->Parent)
+				root = root->Parent;
+
+			root->OnSceneNodeChanged(this, moved);
+		}
+
 		//! A clone function for the ISceneNode members.
 		/** This method can be used by clone() implementations of
 		derived classes
@@ -761,6 +865,7 @@ namespace scene
 			RelativeTranslation = toCopyFrom->RelativeTranslation;
 			RelativeRotation = toCopyFrom->RelativeRotation;
 			RelativeScale = toCopyFrom->RelativeScale;
+			AbsoluteTransformationDirty = true;
 			ID = toCopyFrom->ID;
 			setTriangleSelector(toCopyFrom->TriangleSelector);
 			AutomaticCullingState = toCopyFrom->AutomaticCullingState;
@@ -848,6 +953,12 @@ namespace scene
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+		//! Has the relative transformation of this node or the absolute one of the parent changed since the last updateAbsolutePosition()?
+		bool AbsoluteTransformationDirty;
+
+		//! Leaf of the node in the bounding volume tree of the scene manager
+		s32 BoundingVolumeLeaf;
 	};
 
 
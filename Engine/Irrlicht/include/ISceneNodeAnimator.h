@@ -68,6 +68,18 @@ namespace scene
 		{
 			return false;
 		}
+
+		//! Returns if the animator may animate its node on a worker thread.
+		/** When ISceneManager::setAnimateThreads() is used, subtrees of the scene
+		are animated at the same time on several threads. An animator may opt in if
+		animateNode() changes nothing but the node it animates, and reads nothing
+		another subtree could be changing. Subtrees with an animator that does not
+		opt in are animated on the calling thread.
+		\return true if the animator is thread safe, false by default. */
+		virtual bool isThreadSafe() const
+		{
+			return false;
+		}
 	};
 
 
@@ -1373,6 +1373,14 @@ namespace video
 		/** \return An image created from the last rendered frame. */
 		virtual IImage* createScreenShot(video::ECOLOR_FORMAT format=video::ECF_UNKNOWN, video::E_RENDER_TARGET target=video::ERT_FRAME_BUFFER) =0;
 
+		//! Get the image the frame is rendered into, without copying it.
+		/** Only drivers which render in system memory have one. The image is
+		owned by the driver, don't drop it. After endScene() it holds the last
+		rendered frame until the next beginScene(). It is replaced when the
+		screen is resized.
+		\return The back buffer, or 0 if the driver renders on the graphics card. */
+		virtual IImage* getBackBuffer() const =0;
+
 		//! Check if the image is already loaded.
 		/** Works similar to getTexture(), but does not load the texture
 		if it is not currently loaded.
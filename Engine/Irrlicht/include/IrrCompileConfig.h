@@ -181,6 +181,16 @@ comment this define out */
 #undef _IRR_COMPILE_WITH_BURNINGSVIDEO_
 #endif
 
+//! Define _IRR_COMPILE_WITH_SIMD_BLITTER_ to convert and blend image rows with SSE2 or AVX2
+/** Used by the color converter, the image blitters and the 2d drawing of
+both software drivers. The instruction set is chosen from the cpu at runtime
+and the pixels are the same as without the define. Only x86 and x64 builds
+have the kernels. */
+#define _IRR_COMPILE_WITH_SIMD_BLITTER_
+#ifdef NO_IRR_COMPILE_WITH_SIMD_BLITTER_
+#undef _IRR_COMPILE_WITH_SIMD_BLITTER_
+#endif
+
 //! Define _IRR_COMPILE_WITH_X11_ to compile the Irrlicht engine with X11 support.
 /** If you do not wish the engine to be compiled with X11, comment this
 define out. */
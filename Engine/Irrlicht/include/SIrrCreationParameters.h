@@ -45,6 +45,12 @@ namespace irr
 			DisplayAdapter(0),
 			DriverMultithreaded(false),
 			UsePerformanceTimer(true),
+			SoftwareRasterThreads(0),
+			SoftwareVertexBatch(true),
+			SoftwareSpanKernels(true),
+			SoftwareHierarchicalDepth(true),
+			SoftwareTiledTextures(false),
+			ConsoleOutput(true),
 			SDK_version_do_not_use(IRRLICHT_SDK_VERSION)
 		{
 		}
@@ -76,6 +82,12 @@ namespace irr
 			DriverMultithreaded = other.DriverMultithreaded;
 			DisplayAdapter = other.DisplayAdapter;
 			UsePerformanceTimer = other.UsePerformanceTimer;
+			SoftwareRasterThreads = other.SoftwareRasterThreads;
+			SoftwareVertexBatch = other.SoftwareVertexBatch;
+			SoftwareSpanKernels = other.SoftwareSpanKernels;
+			SoftwareHierarchicalDepth = other.SoftwareHierarchicalDepth;
+			SoftwareTiledTextures = other.SoftwareTiledTextures;
+			ConsoleOutput = other.ConsoleOutput;
 			return *this;
 		}
 
@@ -283,6 +295,53 @@ namespace irr
 		*/
 		bool UsePerformanceTimer;
 
+		//! Number of threads the Burning's Video driver rasterizes with.
+		/** With more than one thread the triangles of each draw call are sorted
+		into bands of screen rows, and the bands are rasterized in parallel. The
+		image is exactly the same as when drawn on one thread. Default is 0, which
+		rasterizes everything on the calling thread. Only supported by
+		EDT_BURNINGSVIDEO. */
+		u32 SoftwareRasterThreads;
+
+		//! Transform whole vertex buffers at once in the Burning's Video driver.
+		/** Large indexed draw calls are transformed, lit and clip tested in one
+		pass over the vertex buffer, four vertices at a time with SSE where the
+		compiler supports it, instead of through a small cache of recently used
+		vertices. Default is true. Only supported by EDT_BURNINGSVIDEO. */
+		bool SoftwareVertexBatch;
+
+		//! Shade scanlines several pixels at a time in the Burning's Video driver.
+		/** The textured gouraud and lightmap shaders draw their spans four
+		pixels at a time with SSE2 or eight with AVX2, picked from the cpu
+		features at runtime. The image is exactly the same as with the scalar
+		loops. Default is true. Only supported by EDT_BURNINGSVIDEO. */
+		bool SoftwareSpanKernels;
+
+		//! Skip hidden triangles and spans in the Burning's Video driver.
+		/** The depth buffer keeps the farthest depth of each 8x8 pixel tile. Triangles
+		and spans that lie behind it are skipped before they are shaded, and clearing
+		the depth buffer only clears the tiles that were drawn to. The image is exactly
+		the same as without. Default is true. Only supported by EDT_BURNINGSVIDEO. */
+		bool SoftwareHierarchicalDepth;
+
+		//! Sample textures from 4x4 texel tiles in the Burning's Video driver.
+		/** Each mip level keeps a second copy of its texels, stored tile by tile,
+		so walking a texture up or down stays in the same cache lines. This helps
+		large textures drawn at about one texel a pixel at any angle, minified
+		textures without mip maps are sampled faster from the rows. Locking a
+		texture still gives the rows of texels, the tiles are updated on unlock.
+		Textures with sides which are not a power of two and render targets are
+		not tiled. The image is exactly the same as without. Default is false.
+		Only supported by EDT_BURNINGSVIDEO. */
+		bool SoftwareTiledTextures;
+
+		//! Draw the frames as text on the terminal with the console device.
+		/** Turn it off to render into memory only, for example on a server or
+		in tests. The terminal is then left alone and the rendered frame is read
+		with IVideoDriver::getBackBuffer() or createScreenShot(). Default is
+		true. Only supported by EIDT_CONSOLE. */
+		bool ConsoleOutput;
+
 		//! Don't use or change this parameter.
 		/** Always set it to IRRLICHT_SDK_VERSION, which is done by default.
 		This is needed for sdk version checks. */
@@ -39,6 +39,9 @@ namespace scene
 		//! OnAnimate() is called just before rendering the whole scene.
 		virtual void OnAnimate(u32 timeMs);
 
+		//! the animated mesh, and the frame it builds, may be shared with other nodes
+		virtual bool isAnimateThreadSafe() const { return false; }
+
 		//! renders the node.
 		virtual void render();
 
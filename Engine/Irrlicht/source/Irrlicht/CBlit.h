@@ -6,6 +6,7 @@
 #define _C_BLIT_H_INCLUDED_
 
 #include "SoftwareDriver2_helper.h"
+#include "CBlitKernels.h"
 
 namespace irr
 {
@@ -305,6 +306,10 @@ static void RenderLine32_Blend(video::IImage *t,
 	u32 *dst;
 	dst = (u32*) ( (u8*) t->lock() + ( p0.Y * t->getPitch() ) + ( p0.X << 2 ) );
 
+	// flat lines blend their horizontal runs with the kernel
+	const video::tBlitBlendKernel kernel = video::getBlitBlendKernel( video::EBB_COLOR );
+	const bool blendRuns = kernel && dx >= dy * 8;
+
 	if ( dy > dx )
 	{
 		s32 tmp;
@@ -321,19 +326,48 @@ static void RenderLine32_Blend(video::IImage *t,
 
 	run = dx;
 	const u32 packA = packAlpha ( alpha );
-	do
+	if ( blendRuns )
 	{
-		*dst = packA | PixelBlend32( *dst, argb, alpha );
+		const u32 color = packA | ( argb & 0x00FFFFFF );
+		u32 *start = dst;
+		s32 length = 0;
+		do
+		{
+			length += 1;
 
-		dst = (u32*) ( (u8*) dst + xInc );	// x += xInc
-		d += m;
-		if ( d > dx )
+			dst = (u32*) ( (u8*) dst + xInc );	// x += xInc
+			d += m;
+			if ( d > dx )
+			{
+				kernel( xInc > 0 ? start : start - ( length - 1 ), 0, length, color, alpha );
+
+				dst = (u32*) ( (u8*) dst + yInc );	// y += yInc
+				d -= c;
+				start = dst;
+				length = 0;
+			}
+			run -= 1;
+		} while (run>=0);
+
+		if ( length )
+			kernel( xInc > 0 ? start : start - ( length - 1 ), 0, length, color, alpha );
+	}
+	else
+	{
+		do
 		{
-			dst = (u32*) ( (u8*) dst + yInc );	// y += yInc
-			d -= c;
-		}
-		run -= 1;
-	} while (run>=0);
+			*dst = packA | PixelBlend32( *dst, argb, alpha );
+
+			dst = (u32*) ( (u8*) dst + xInc );	// x += xInc
+			d += m;
+			if ( d > dx )
+			{
+				dst = (u32*) ( (u8*) dst + yInc );	// y += yInc
+				d -= c;
+			}
+			run -= 1;
+		} while (run>=0);
+	}
 
 	t->unlock();
 }
@@ -544,13 +578,21 @@ static void executeBlit_TextureCopy_32_to_16( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitConvertKernel kernel = video::getBlitConvertKernel( video::EBC_A8R8G8B8_TO_A1R5G5B5_PREMULTIPLIED );
 		for ( u32 dy = 0; dy != h; ++dy )
 		{
-			for ( u32 dx = 0; dx != w; ++dx )
+			if ( kernel )
 			{
-				//16 bit Blitter depends on pre-multiplied color
-				const u32 s = PixelLerp32( src[dx] | 0xFF000000, extractAlpha( src[dx] ) );
-				dst[dx] = video::A8R8G8B8toA1R5G5B5( s );
+				kernel( src, w, dst );
+			}
+			else
+			{
+				for ( u32 dx = 0; dx != w; ++dx )
+				{
+					//16 bit Blitter depends on pre-multiplied color
+					const u32 s = PixelLerp32( src[dx] | 0xFF000000, extractAlpha( src[dx] ) );
+					dst[dx] = video::A8R8G8B8toA1R5G5B5( s );
+				}
 			}
 
 			src = (u32*) ( (u8*) (src) + job->srcPitch );
@@ -588,13 +630,21 @@ static void executeBlit_TextureCopy_24_to_16( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitConvertKernel kernel = video::getBlitConvertKernel( video::EBC_R8G8B8_TO_A1R5G5B5 );
 		for ( u32 dy = 0; dy != h; ++dy )
 		{
-			const u8* s = src;
-			for ( u32 dx = 0; dx != w; ++dx )
+			if ( kernel )
 			{
-				dst[dx] = video::RGBA16(s[0], s[1], s[2]);
-				s += 3;
+				kernel( src, w, dst );
+			}
+			else
+			{
+				const u8* s = src;
+				for ( u32 dx = 0; dx != w; ++dx )
+				{
+					dst[dx] = video::RGBA16(s[0], s[1], s[2]);
+					s += 3;
+				}
 			}
 
 			src = src+job->srcPitch;
@@ -633,11 +683,19 @@ static void executeBlit_TextureCopy_16_to_32( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitConvertKernel kernel = video::getBlitConvertKernel( video::EBC_A1R5G5B5_TO_A8R8G8B8 );
 		for ( u32 dy = 0; dy != h; ++dy )
 		{
-			for ( u32 dx = 0; dx != w; ++dx )
+			if ( kernel )
+			{
+				kernel( src, w, dst );
+			}
+			else
 			{
-				dst[dx] = video::A1R5G5B5toA8R8G8B8( src[dx] );
+				for ( u32 dx = 0; dx != w; ++dx )
+				{
+					dst[dx] = video::A1R5G5B5toA8R8G8B8( src[dx] );
+				}
 			}
 
 			src = (u16*) ( (u8*) (src) + job->srcPitch );
@@ -723,14 +781,22 @@ static void executeBlit_TextureCopy_24_to_32( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitConvertKernel kernel = video::getBlitConvertKernel( video::EBC_R8G8B8_TO_A8R8G8B8 );
 		for ( s32 dy = 0; dy != job->height; ++dy )
 		{
-			const u8* s = src;
-
-			for ( s32 dx = 0; dx != job->width; ++dx )
+			if ( kernel )
 			{
-				dst[dx] = 0xFF000000 | s[0] << 16 | s[1] << 8 | s[2];
-				s += 3;
+				kernel( src, job->width, dst );
+			}
+			else
+			{
+				const u8* s = src;
+
+				for ( s32 dx = 0; dx != job->width; ++dx )
+				{
+					dst[dx] = 0xFF000000 | s[0] << 16 | s[1] << 8 | s[2];
+					s += 3;
+				}
 			}
 
 			src = src + job->srcPitch;
@@ -769,14 +835,22 @@ static void executeBlit_TextureCopy_32_to_24( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitConvertKernel kernel = video::getBlitConvertKernel( video::EBC_A8R8G8B8_TO_R8G8B8 );
 		for ( u32 dy = 0; dy != h; ++dy )
 		{
-			for ( u32 dx = 0; dx != w; ++dx )
+			if ( kernel )
 			{
-				u8 * writeTo = &dst[dx * 3];
-				*writeTo++ = (src[dx] >> 16)& 0xFF;
-				*writeTo++ = (src[dx] >> 8) & 0xFF;
-				*writeTo++ = src[dx] & 0xFF;
+				kernel( src, w, dst );
+			}
+			else
+			{
+				for ( u32 dx = 0; dx != w; ++dx )
+				{
+					u8 * writeTo = &dst[dx * 3];
+					*writeTo++ = (src[dx] >> 16)& 0xFF;
+					*writeTo++ = (src[dx] >> 8) & 0xFF;
+					*writeTo++ = src[dx] & 0xFF;
+				}
 			}
 
 			src = (u32*) ( (u8*) (src) + job->srcPitch );
@@ -869,11 +943,19 @@ static void executeBlit_TextureBlend_32_to_32( const SBlitJob * job )
 	}
 	else
 	{
+		const video::tBlitBlendKernel kernel = video::getBlitBlendKernel( video::EBB_TEXTURE );
 		for ( u32 dy = 0; dy != h; ++dy )
 		{
-			for ( u32 dx = 0; dx != w; ++dx )
+			if ( kernel )
 			{
-				dst[dx] = PixelBlend32( dst[dx], src[dx] );
+				kernel( dst, src, w, 0, 0 );
+			}
+			else
+			{
+				for ( u32 dx = 0; dx != w; ++dx )
+				{
+					dst[dx] = PixelBlend32( dst[dx], src[dx] );
+				}
 			}
 			src = (u32*) ( (u8*) (src) + job->srcPitch );
 			dst = (u32*) ( (u8*) (dst) + job->dstPitch );
@@ -911,11 +993,19 @@ static void executeBlit_TextureBlendColor_32_to_32( const SBlitJob * job )
 	u32 *src = (u32*) job->src;
 	u32 *dst = (u32*) job->dst;
 
+	const video::tBlitBlendKernel kernel = video::getBlitBlendKernel( video::EBB_TEXTURE_COLOR );
 	for ( s32 dy = 0; dy != job->height; ++dy )
 	{
-		for ( s32 dx = 0; dx != job->width; ++dx )
+		if ( kernel )
 		{
-			dst[dx] = PixelBlend32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+			kernel( dst, src, job->width, job->argb, 0 );
+		}
+		else
+		{
+			for ( s32 dx = 0; dx != job->width; ++dx )
+			{
+				dst[dx] = PixelBlend32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+			}
 		}
 		src = (u32*) ( (u8*) (src) + job->srcPitch );
 		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
@@ -979,11 +1069,19 @@ static void executeBlit_ColorAlpha_32_to_32( const SBlitJob * job )
 	const u32 alpha = extractAlpha( job->argb );
 	const u32 src = job->argb;
 
+	const video::tBlitBlendKernel kernel = video::getBlitBlendKernel( video::EBB_COLOR );
 	for ( s32 dy = 0; dy != job->height; ++dy )
 	{
-		for ( s32 dx = 0; dx != job->width; ++dx )
+		if ( kernel )
 		{
-			dst[dx] = (job->argb & 0xFF000000 ) | PixelBlend32( dst[dx], src, alpha );
+			kernel( dst, 0, job->width, src, alpha );
+		}
+		else
+		{
+			for ( s32 dx = 0; dx != job->width; ++dx )
+			{
+				dst[dx] = (job->argb & 0xFF000000 ) | PixelBlend32( dst[dx], src, alpha );
+			}
 		}
 		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
 	}
@@ -0,0 +1,627 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#include "CBlitKernels.h"
+#include "CCPUFeatures.h"
+
+// the kernels read the pixels as little endian words and need sse2 at least,
+// which is asked from the cpu at runtime
+#if defined ( _IRR_COMPILE_WITH_SIMD_BLITTER_ ) && !defined ( __BIG_ENDIAN__ ) && \
+	( defined ( _M_IX86 ) || defined ( _M_X64 ) || defined ( __i386__ ) || defined ( __x86_64__ ) )
+	#define BLIT_KERNELS
+	#include <string.h>
+	#include <emmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#define BLIT_SSE2
+		#define BLIT_AVX2
+	#else
+		// the kernels are built for their own instruction set only,
+		// the rest of the library stays on the baseline target
+		#define BLIT_SSE2 __attribute__ ( ( target ( "sse2" ) ) )
+		#define BLIT_AVX2 __attribute__ ( ( target ( "avx2" ) ) )
+	#endif
+	#ifndef REALINLINE
+		#ifdef _MSC_VER
+			#define REALINLINE __forceinline
+		#else
+			#define REALINLINE inline
+		#endif
+	#endif
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+#ifdef BLIT_KERNELS
+
+namespace
+{
+
+// ------------------------------------ SSE2 ------------------------------------
+
+//! four 32 bit pixels
+BLIT_SSE2 REALINLINE __m128i load32_SSE2 ( const u8* s )
+{
+	return _mm_loadu_si128 ( (const __m128i*) s );
+}
+
+BLIT_SSE2 REALINLINE void store32_SSE2 ( u8* d, const __m128i v )
+{
+	_mm_storeu_si128 ( (__m128i*) d, v );
+}
+
+//! four 16 bit pixels, one in the low half of each lane
+BLIT_SSE2 REALINLINE __m128i load16_SSE2 ( const u8* s )
+{
+	return _mm_unpacklo_epi16 ( _mm_loadl_epi64 ( (const __m128i*) s ), _mm_setzero_si128 () );
+}
+
+BLIT_SSE2 REALINLINE void store16_SSE2 ( u8* d, const __m128i v )
+{
+	// sign extended, the signed saturation of the pack keeps all 16 bits
+	const __m128i s = _mm_srai_epi32 ( _mm_slli_epi32 ( v, 16 ), 16 );
+	_mm_storel_epi64 ( (__m128i*) d, _mm_packs_epi32 ( s, s ) );
+}
+
+//! swaps the lowest and the third byte of each lane
+BLIT_SSE2 REALINLINE __m128i swapRB_SSE2 ( const __m128i v )
+{
+	const __m128i b = _mm_set1_epi32 ( 0x000000FF );
+	return _mm_or_si128 ( _mm_and_si128 ( v, _mm_set1_epi32 ( 0xFF00FF00 ) ),
+						  _mm_or_si128 ( _mm_slli_epi32 ( _mm_and_si128 ( v, b ), 16 ),
+										 _mm_and_si128 ( _mm_srli_epi32 ( v, 16 ), b ) ) );
+}
+
+//! four 24 bit pixels, bytes 0,1,2 in the low 24 bits of each lane or swapped
+template < bool swap >
+BLIT_SSE2 REALINLINE __m128i load24_SSE2 ( const u8* s )
+{
+	const __m128i v = _mm_or_si128 ( _mm_loadl_epi64 ( (const __m128i*) s ),
+									 _mm_slli_si128 ( _mm_cvtsi32_si128 ( *(const s32*) ( s + 8 ) ), 8 ) );
+
+	const __m128i r = _mm_or_si128 (
+		_mm_or_si128 ( _mm_and_si128 ( v, _mm_setr_epi32 ( 0x00FFFFFF, 0, 0, 0 ) ),
+					   _mm_and_si128 ( _mm_slli_si128 ( v, 1 ), _mm_setr_epi32 ( 0, 0x00FFFFFF, 0, 0 ) ) ),
+		_mm_or_si128 ( _mm_and_si128 ( _mm_slli_si128 ( v, 2 ), _mm_setr_epi32 ( 0, 0, 0x00FFFFFF, 0 ) ),
+					   _mm_and_si128 ( _mm_slli_si128 ( v, 3 ), _mm_setr_epi32 ( 0, 0, 0, 0x00FFFFFF ) ) ) );
+
+	return swap ? swapRB_SSE2 ( r ) : r;
+}
+
+template < bool swap >
+BLIT_SSE2 REALINLINE void store24_SSE2 ( u8* d, __m128i v )
+{
+	if ( swap )
+		v = swapRB_SSE2 ( v );
+
+	const __m128i r = _mm_or_si128 (
+		_mm_or_si128 ( _mm_and_si128 ( v, _mm_setr_epi32 ( 0x00FFFFFF, 0, 0, 0 ) ),
+					   _mm_srli_si128 ( _mm_and_si128 ( v, _mm_setr_epi32 ( 0, 0x00FFFFFF, 0, 0 ) ), 1 ) ),
+		_mm_or_si128 ( _mm_srli_si128 ( _mm_and_si128 ( v, _mm_setr_epi32 ( 0, 0, 0x00FFFFFF, 0 ) ), 2 ),
+					   _mm_srli_si128 ( _mm_and_si128 ( v, _mm_setr_epi32 ( 0, 0, 0, 0x00FFFFFF ) ), 3 ) ) );
+
+	_mm_storel_epi64 ( (__m128i*) d, r );
+	*(s32*) ( d + 8 ) = _mm_cvtsi128_si32 ( _mm_srli_si128 ( r, 8 ) );
+}
+
+BLIT_SSE2 REALINLINE __m128i copy_SSE2 ( const __m128i v )
+{
+	return v;
+}
+
+//! v & mask, shifted right, or left if shift is negative
+template < u32 mask, s32 shift >
+BLIT_SSE2 REALINLINE __m128i field_SSE2 ( const __m128i v )
+{
+	const __m128i f = _mm_and_si128 ( v, _mm_set1_epi32 ( mask ) );
+	return shift >= 0 ? _mm_srli_epi32 ( f, shift >= 0 ? shift : 0 ) : _mm_slli_epi32 ( f, shift < 0 ? -shift : 0 );
+}
+
+//! A8R8G8B8toA1R5G5B5
+BLIT_SSE2 REALINLINE __m128i toA1R5G5B5_SSE2 ( const __m128i v )
+{
+	return _mm_or_si128 ( _mm_or_si128 ( field_SSE2 < 0x80000000, 16 > ( v ), field_SSE2 < 0x00F80000, 9 > ( v ) ),
+						  _mm_or_si128 ( field_SSE2 < 0x0000F800, 6 > ( v ), field_SSE2 < 0x000000F8, 3 > ( v ) ) );
+}
+
+//! A8R8G8B8toR5G6B5
+BLIT_SSE2 REALINLINE __m128i toR5G6B5_SSE2 ( const __m128i v )
+{
+	return _mm_or_si128 ( _mm_or_si128 ( field_SSE2 < 0x00F80000, 8 > ( v ), field_SSE2 < 0x0000FC00, 5 > ( v ) ),
+						  field_SSE2 < 0x000000F8, 3 > ( v ) );
+}
+
+//! A1R5G5B5toA8R8G8B8
+BLIT_SSE2 REALINLINE __m128i fromA1R5G5B5_SSE2 ( const __m128i v )
+{
+	const __m128i a = _mm_and_si128 ( _mm_srai_epi32 ( _mm_slli_epi32 ( v, 16 ), 31 ), _mm_set1_epi32 ( 0xFF000000 ) );
+	return _mm_or_si128 ( _mm_or_si128 ( _mm_or_si128 ( a, field_SSE2 < 0x00007C00, -9 > ( v ) ),
+										 _mm_or_si128 ( field_SSE2 < 0x00007000, -4 > ( v ), field_SSE2 < 0x000003E0, -6 > ( v ) ) ),
+						  _mm_or_si128 ( _mm_or_si128 ( field_SSE2 < 0x00000380, -1 > ( v ), field_SSE2 < 0x0000001F, -3 > ( v ) ),
+										 field_SSE2 < 0x0000001C, 2 > ( v ) ) );
+}
+
+//! R5G6B5toA8R8G8B8
+BLIT_SSE2 REALINLINE __m128i fromR5G6B5_SSE2 ( const __m128i v )
+{
+	return _mm_or_si128 ( _mm_or_si128 ( _mm_set1_epi32 ( 0xFF000000 ), field_SSE2 < 0xF800, -8 > ( v ) ),
+						  _mm_or_si128 ( field_SSE2 < 0x07E0, -5 > ( v ), field_SSE2 < 0x001F, -3 > ( v ) ) );
+}
+
+BLIT_SSE2 REALINLINE __m128i opaque_SSE2 ( const __m128i v )
+{
+	return _mm_or_si128 ( v, _mm_set1_epi32 ( 0xFF000000 ) );
+}
+
+BLIT_SSE2 REALINLINE __m128i opaqueToA1R5G5B5_SSE2 ( const __m128i v )
+{
+	return toA1R5G5B5_SSE2 ( opaque_SSE2 ( v ) );
+}
+
+//! reverses the bytes of each lane
+BLIT_SSE2 REALINLINE __m128i swapBytes_SSE2 ( const __m128i v )
+{
+	return _mm_or_si128 ( _mm_or_si128 ( _mm_slli_epi32 ( v, 24 ), field_SSE2 < 0x0000FF00, -8 > ( v ) ),
+						  _mm_or_si128 ( field_SSE2 < 0x00FF0000, 8 > ( v ), _mm_srli_epi32 ( v, 24 ) ) );
+}
+
+//! the low 32 bits of v * a, with a below 2^16 in both halves of the lane
+BLIT_SSE2 REALINLINE __m128i mulLo_SSE2 ( const __m128i v, const __m128i a )
+{
+	return _mm_add_epi32 ( _mm_mullo_epi16 ( v, a ), _mm_slli_epi32 ( _mm_mulhi_epu16 ( v, a ), 16 ) );
+}
+
+//! PixelLerp32 ( v | 0xFF000000, extractAlpha ( v ) ), see executeBlit_TextureCopy_32_to_16
+BLIT_SSE2 REALINLINE __m128i premultiplyToA1R5G5B5_SSE2 ( const __m128i v )
+{
+	__m128i a = _mm_srli_epi32 ( v, 24 );
+	a = _mm_add_epi32 ( a, _mm_srli_epi32 ( a, 7 ) );
+	a = _mm_or_si128 ( a, _mm_slli_epi32 ( a, 16 ) );
+
+	// both products of a lane stay below 2^16
+	const __m128i o = opaque_SSE2 ( v );
+	const __m128i rb = _mm_mullo_epi16 ( _mm_and_si128 ( o, _mm_set1_epi32 ( 0x00FF00FF ) ), a );
+	const __m128i xg = _mm_mullo_epi16 ( field_SSE2 < 0xFF00FF00, 8 > ( o ), a );
+
+	return toA1R5G5B5_SSE2 ( _mm_or_si128 ( field_SSE2 < 0xFF00FF00, 8 > ( rb ),
+											_mm_and_si128 ( xg, _mm_set1_epi32 ( 0xFF00FF00 ) ) ) );
+}
+
+//! converts four pixels per step
+/** The last pixels go through a buffer, so no load or store leaves the rows. */
+template < __m128i ( *Load ) ( const u8* ), __m128i ( *Op ) ( const __m128i ),
+		   void ( *Store ) ( u8*, __m128i ), u32 srcBytes, u32 dstBytes >
+BLIT_SSE2 void convert_SSE2 ( const void* src, s32 count, void* dst )
+{
+	const u8* s = (const u8*) src;
+	u8* d = (u8*) dst;
+
+	for ( ; count >= 4; count -= 4 )
+	{
+		Store ( d, Op ( Load ( s ) ) );
+		s += 4 * srcBytes;
+		d += 4 * dstBytes;
+	}
+
+	if ( count > 0 )
+	{
+		u8 in[ 4 * 4 ] = { 0 };
+		u8 out[ 4 * 4 ];
+		memcpy ( in, s, count * srcBytes );
+		Store ( out, Op ( Load ( in ) ) );
+		memcpy ( d, out, count * dstBytes );
+	}
+}
+
+//! PixelBlend32 ( dst, src, alpha ) without the alpha channel
+BLIT_SSE2 REALINLINE __m128i pixelBlend_SSE2 ( const __m128i dst, const __m128i src, const __m128i a )
+{
+	const __m128i maskRB = _mm_set1_epi32 ( 0x00FF00FF );
+	const __m128i maskXG = _mm_set1_epi32 ( 0x0000FF00 );
+
+	const __m128i dstRB = _mm_and_si128 ( dst, maskRB );
+	const __m128i dstXG = _mm_and_si128 ( dst, maskXG );
+
+	__m128i rb = _mm_sub_epi32 ( _mm_and_si128 ( src, maskRB ), dstRB );
+	__m128i xg = _mm_sub_epi32 ( _mm_and_si128 ( src, maskXG ), dstXG );
+
+	rb = _mm_add_epi32 ( _mm_srli_epi32 ( mulLo_SSE2 ( rb, a ), 8 ), dstRB );
+	xg = _mm_add_epi32 ( _mm_srli_epi32 ( mulLo_SSE2 ( xg, a ), 8 ), dstXG );
+
+	return _mm_or_si128 ( _mm_and_si128 ( rb, maskRB ), _mm_and_si128 ( xg, maskXG ) );
+}
+
+//! PixelBlend32 ( dst, src ), the alpha of src
+BLIT_SSE2 REALINLINE __m128i blendTexture_SSE2 ( const __m128i dst, const __m128i src, const __m128i, const __m128i )
+{
+	const __m128i alpha = _mm_srli_epi32 ( src, 24 );
+	__m128i a = _mm_add_epi32 ( alpha, _mm_srli_epi32 ( alpha, 7 ) );
+	a = _mm_or_si128 ( a, _mm_slli_epi32 ( a, 16 ) );
+
+	const __m128i r = _mm_or_si128 ( _mm_and_si128 ( src, _mm_set1_epi32 ( 0xFF000000 ) ), pixelBlend_SSE2 ( dst, src, a ) );
+
+	// a fully opaque src is already copied by the blend
+	const __m128i clear = _mm_cmpeq_epi32 ( alpha, _mm_setzero_si128 () );
+	return _mm_or_si128 ( _mm_and_si128 ( clear, dst ), _mm_andnot_si128 ( clear, r ) );
+}
+
+//! PixelBlend32 ( dst, PixelMul32_2 ( src, argb ) )
+BLIT_SSE2 REALINLINE __m128i blendTextureColor_SSE2 ( const __m128i dst, const __m128i src, const __m128i argb, const __m128i a )
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i c = _mm_unpacklo_epi8 ( argb, zero );
+	const __m128i lo = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpacklo_epi8 ( src, zero ), c ), 8 );
+	const __m128i hi = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpackhi_epi8 ( src, zero ), c ), 8 );
+
+	return blendTexture_SSE2 ( dst, _mm_packus_epi16 ( lo, hi ), argb, a );
+}
+
+//! ( argb & 0xFF000000 ) | PixelBlend32 ( dst, argb, alpha )
+BLIT_SSE2 REALINLINE __m128i blendColor_SSE2 ( const __m128i dst, const __m128i, const __m128i argb, const __m128i a )
+{
+	return _mm_or_si128 ( _mm_and_si128 ( argb, _mm_set1_epi32 ( 0xFF000000 ) ), pixelBlend_SSE2 ( dst, argb, a ) );
+}
+
+//! blends four pixels per step
+template < __m128i ( *Blend ) ( const __m128i, const __m128i, const __m128i, const __m128i ), bool readSrc >
+BLIT_SSE2 void blend_SSE2 ( u32* dst, const u32* src, s32 count, u32 argb, u32 alpha )
+{
+	const __m128i c = _mm_set1_epi32 ( argb );
+	const __m128i a = _mm_set1_epi32 ( alpha | ( alpha << 16 ) );
+
+	for ( ; count >= 4; count -= 4 )
+	{
+		const __m128i s = readSrc ? _mm_loadu_si128 ( (const __m128i*) src ) : c;
+		_mm_storeu_si128 ( (__m128i*) dst, Blend ( _mm_loadu_si128 ( (const __m128i*) dst ), s, c, a ) );
+		dst += 4;
+		if ( readSrc )
+			src += 4;
+	}
+
+	if ( count > 0 )
+	{
+		u32 d[ 4 ] = { 0 };
+		u32 s[ 4 ] = { 0 };
+		memcpy ( d, dst, count * 4 );
+		if ( readSrc )
+			memcpy ( s, src, count * 4 );
+
+		const __m128i v = readSrc ? _mm_loadu_si128 ( (const __m128i*) s ) : c;
+		_mm_storeu_si128 ( (__m128i*) d, Blend ( _mm_loadu_si128 ( (const __m128i*) d ), v, c, a ) );
+		memcpy ( dst, d, count * 4 );
+	}
+}
+
+
+// ------------------------------------ AVX2 ------------------------------------
+
+//! eight 32 bit pixels
+BLIT_AVX2 REALINLINE __m256i load32_AVX2 ( const u8* s )
+{
+	return _mm256_loadu_si256 ( (const __m256i*) s );
+}
+
+BLIT_AVX2 REALINLINE void store32_AVX2 ( u8* d, const __m256i v )
+{
+	_mm256_storeu_si256 ( (__m256i*) d, v );
+}
+
+//! eight 16 bit pixels, one in the low half of each lane
+BLIT_AVX2 REALINLINE __m256i load16_AVX2 ( const u8* s )
+{
+	return _mm256_cvtepu16_epi32 ( _mm_loadu_si128 ( (const __m128i*) s ) );
+}
+
+BLIT_AVX2 REALINLINE void store16_AVX2 ( u8* d, const __m256i v )
+{
+	_mm_storeu_si128 ( (__m128i*) d, _mm_packus_epi32 ( _mm256_castsi256_si128 ( v ), _mm256_extracti128_si256 ( v, 1 ) ) );
+}
+
+//! eight 24 bit pixels, bytes 0,1,2 in the low 24 bits of each lane or swapped
+template < bool swap >
+BLIT_AVX2 REALINLINE __m256i load24_AVX2 ( const u8* s )
+{
+	// the upper half loads pixels 4-7 from byte 4 on, so both loads stay inside the 24 bytes
+	const __m256i v = _mm256_inserti128_si256 ( _mm256_castsi128_si256 ( _mm_loadu_si128 ( (const __m128i*) s ) ),
+												_mm_loadu_si128 ( (const __m128i*) ( s + 8 ) ), 1 );
+	const __m256i order = swap ?
+		_mm256_setr_epi8 ( 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+						   6, 5, 4, -1, 9, 8, 7, -1, 12, 11, 10, -1, 15, 14, 13, -1 ) :
+		_mm256_setr_epi8 ( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+						   4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1 );
+	return _mm256_shuffle_epi8 ( v, order );
+}
+
+template < bool swap >
+BLIT_AVX2 REALINLINE void store24_AVX2 ( u8* d, const __m256i v )
+{
+	const __m256i order = swap ?
+		_mm256_setr_epi8 ( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+						   2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) :
+		_mm256_setr_epi8 ( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+						   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+
+	// twelve bytes in each half, moved together
+	const __m256i r = _mm256_permutevar8x32_epi32 ( _mm256_shuffle_epi8 ( v, order ),
+													_mm256_setr_epi32 ( 0, 1, 2, 4, 5, 6, 3, 7 ) );
+	_mm_storeu_si128 ( (__m128i*) d, _mm256_castsi256_si128 ( r ) );
+	_mm_storel_epi64 ( (__m128i*) ( d + 16 ), _mm256_extracti128_si256 ( r, 1 ) );
+}
+
+BLIT_AVX2 REALINLINE __m256i copy_AVX2 ( const __m256i v )
+{
+	return v;
+}
+
+//! v & mask, shifted right, or left if shift is negative
+template < u32 mask, s32 shift >
+BLIT_AVX2 REALINLINE __m256i field_AVX2 ( const __m256i v )
+{
+	const __m256i f = _mm256_and_si256 ( v, _mm256_set1_epi32 ( mask ) );
+	return shift >= 0 ? _mm256_srli_epi32 ( f, shift >= 0 ? shift : 0 ) : _mm256_slli_epi32 ( f, shift < 0 ? -shift : 0 );
+}
+
+//! A8R8G8B8toA1R5G5B5
+BLIT_AVX2 REALINLINE __m256i toA1R5G5B5_AVX2 ( const __m256i v )
+{
+	return _mm256_or_si256 ( _mm256_or_si256 ( field_AVX2 < 0x80000000, 16 > ( v ), field_AVX2 < 0x00F80000, 9 > ( v ) ),
+							 _mm256_or_si256 ( field_AVX2 < 0x0000F800, 6 > ( v ), field_AVX2 < 0x000000F8, 3 > ( v ) ) );
+}
+
+//! A8R8G8B8toR5G6B5
+BLIT_AVX2 REALINLINE __m256i toR5G6B5_AVX2 ( const __m256i v )
+{
+	return _mm256_or_si256 ( _mm256_or_si256 ( field_AVX2 < 0x00F80000, 8 > ( v ), field_AVX2 < 0x0000FC00, 5 > ( v ) ),
+							 field_AVX2 < 0x000000F8, 3 > ( v ) );
+}
+
+//! A1R5G5B5toA8R8G8B8
+BLIT_AVX2 REALINLINE __m256i fromA1R5G5B5_AVX2 ( const __m256i v )
+{
+	const __m256i a = _mm256_and_si256 ( _mm256_srai_epi32 ( _mm256_slli_epi32 ( v, 16 ), 31 ), _mm256_set1_epi32 ( 0xFF000000 ) );
+	return _mm256_or_si256 ( _mm256_or_si256 ( _mm256_or_si256 ( a, field_AVX2 < 0x00007C00, -9 > ( v ) ),
+											   _mm256_or_si256 ( field_AVX2 < 0x00007000, -4 > ( v ), field_AVX2 < 0x000003E0, -6 > ( v ) ) ),
+							 _mm256_or_si256 ( _mm256_or_si256 ( field_AVX2 < 0x00000380, -1 > ( v ), field_AVX2 < 0x0000001F, -3 > ( v ) ),
+											   field_AVX2 < 0x0000001C, 2 > ( v ) ) );
+}
+
+//! R5G6B5toA8R8G8B8
+BLIT_AVX2 REALINLINE __m256i fromR5G6B5_AVX2 ( const __m256i v )
+{
+	return _mm256_or_si256 ( _mm256_or_si256 ( _mm256_set1_epi32 ( 0xFF000000 ), field_AVX2 < 0xF800, -8 > ( v ) ),
+							 _mm256_or_si256 ( field_AVX2 < 0x07E0, -5 > ( v ), field_AVX2 < 0x001F, -3 > ( v ) ) );
+}
+
+BLIT_AVX2 REALINLINE __m256i opaque_AVX2 ( const __m256i v )
+{
+	return _mm256_or_si256 ( v, _mm256_set1_epi32 ( 0xFF000000 ) );
+}
+
+BLIT_AVX2 REALINLINE __m256i opaqueToA1R5G5B5_AVX2 ( const __m256i v )
+{
+	return toA1R5G5B5_AVX2 ( opaque_AVX2 ( v ) );
+}
+
+//! reverses the bytes of each lane
+BLIT_AVX2 REALINLINE __m256i swapBytes_AVX2 ( const __m256i v )
+{
+	return _mm256_shuffle_epi8 ( v, _mm256_setr_epi8 ( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+													   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 ) );
+}
+
+//! the low 32 bits of v * a, with a below 2^16 in both halves of the lane
+BLIT_AVX2 REALINLINE __m256i mulLo_AVX2 ( const __m256i v, const __m256i a )
+{
+	return _mm256_add_epi32 ( _mm256_mullo_epi16 ( v, a ), _mm256_slli_epi32 ( _mm256_mulhi_epu16 ( v, a ), 16 ) );
+}
+
+//! PixelLerp32 ( v | 0xFF000000, extractAlpha ( v ) ), see executeBlit_TextureCopy_32_to_16
+BLIT_AVX2 REALINLINE __m256i premultiplyToA1R5G5B5_AVX2 ( const __m256i v )
+{
+	__m256i a = _mm256_srli_epi32 ( v, 24 );
+	a = _mm256_add_epi32 ( a, _mm256_srli_epi32 ( a, 7 ) );
+	a = _mm256_or_si256 ( a, _mm256_slli_epi32 ( a, 16 ) );
+
+	// both products of a lane stay below 2^16
+	const __m256i o = opaque_AVX2 ( v );
+	const __m256i rb = _mm256_mullo_epi16 ( _mm256_and_si256 ( o, _mm256_set1_epi32 ( 0x00FF00FF ) ), a );
+	const __m256i xg = _mm256_mullo_epi16 ( field_AVX2 < 0xFF00FF00, 8 > ( o ), a );
+
+	return toA1R5G5B5_AVX2 ( _mm256_or_si256 ( field_AVX2 < 0xFF00FF00, 8 > ( rb ),
+											   _mm256_and_si256 ( xg, _mm256_set1_epi32 ( 0xFF00FF00 ) ) ) );
+}
+
+//! converts eight pixels per step
+template < __m256i ( *Load ) ( const u8* ), __m256i ( *Op ) ( const __m256i ),
+		   void ( *Store ) ( u8*, __m256i ), u32 srcBytes, u32 dstBytes >
+BLIT_AVX2 void convert_AVX2 ( const void* src, s32 count, void* dst )
+{
+	const u8* s = (const u8*) src;
+	u8* d = (u8*) dst;
+
+	for ( ; count >= 8; count -= 8 )
+	{
+		Store ( d, Op ( Load ( s ) ) );
+		s += 8 * srcBytes;
+		d += 8 * dstBytes;
+	}
+
+	if ( count > 0 )
+	{
+		u8 in[ 8 * 4 ] = { 0 };
+		u8 out[ 8 * 4 ];
+		memcpy ( in, s, count * srcBytes );
+		Store ( out, Op ( Load ( in ) ) );
+		memcpy ( d, out, count * dstBytes );
+	}
+}
+
+//! PixelBlend32 ( dst, src, alpha ) without the alpha channel
+BLIT_AVX2 REALINLINE __m256i pixelBlend_AVX2 ( const __m256i dst, const __m256i src, const __m256i a )
+{
+	const __m256i maskRB = _mm256_set1_epi32 ( 0x00FF00FF );
+	const __m256i maskXG = _mm256_set1_epi32 ( 0x0000FF00 );
+
+	const __m256i dstRB = _mm256_and_si256 ( dst, maskRB );
+	const __m256i dstXG = _mm256_and_si256 ( dst, maskXG );
+
+	__m256i rb = _mm256_sub_epi32 ( _mm256_and_si256 ( src, maskRB ), dstRB );
+	__m256i xg = _mm256_sub_epi32 ( _mm256_and_si256 ( src, maskXG ), dstXG );
+
+	rb = _mm256_add_epi32 ( _mm256_srli_epi32 ( mulLo_AVX2 ( rb, a ), 8 ), dstRB );
+	xg = _mm256_add_epi32 ( _mm256_srli_epi32 ( mulLo_AVX2 ( xg, a ), 8 ), dstXG );
+
+	return _mm256_or_si256 ( _mm256_and_si256 ( rb, maskRB ), _mm256_and_si256 ( xg, maskXG ) );
+}
+
+//! PixelBlend32 ( dst, src ), the alpha of src
+BLIT_AVX2 REALINLINE __m256i blendTexture_AVX2 ( const __m256i dst, const __m256i src, const __m256i, const __m256i )
+{
+	const __m256i alpha = _mm256_srli_epi32 ( src, 24 );
+	__m256i a = _mm256_add_epi32 ( alpha, _mm256_srli_epi32 ( alpha, 7 ) );
+	a = _mm256_or_si256 ( a, _mm256_slli_epi32 ( a, 16 ) );
+
+	const __m256i r = _mm256_or_si256 ( _mm256_and_si256 ( src, _mm256_set1_epi32 ( 0xFF000000 ) ), pixelBlend_AVX2 ( dst, src, a ) );
+
+	// a fully opaque src is already copied by the blend
+	return _mm256_blendv_epi8 ( r, dst, _mm256_cmpeq_epi32 ( alpha, _mm256_setzero_si256 () ) );
+}
+
+//! PixelBlend32 ( dst, PixelMul32_2 ( src, argb ) )
+BLIT_AVX2 REALINLINE __m256i blendTextureColor_AVX2 ( const __m256i dst, const __m256i src, const __m256i argb, const __m256i a )
+{
+	const __m256i zero = _mm256_setzero_si256 ();
+	const __m256i c = _mm256_unpacklo_epi8 ( argb, zero );
+	const __m256i lo = _mm256_srli_epi16 ( _mm256_mullo_epi16 ( _mm256_unpacklo_epi8 ( src, zero ), c ), 8 );
+	const __m256i hi = _mm256_srli_epi16 ( _mm256_mullo_epi16 ( _mm256_unpackhi_epi8 ( src, zero ), c ), 8 );
+
+	return blendTexture_AVX2 ( dst, _mm256_packus_epi16 ( lo, hi ), argb, a );
+}
+
+//! ( argb & 0xFF000000 ) | PixelBlend32 ( dst, argb, alpha )
+BLIT_AVX2 REALINLINE __m256i blendColor_AVX2 ( const __m256i dst, const __m256i, const __m256i argb, const __m256i a )
+{
+	return _mm256_or_si256 ( _mm256_and_si256 ( argb, _mm256_set1_epi32 ( 0xFF000000 ) ), pixelBlend_AVX2 ( dst, argb, a ) );
+}
+
+//! blends eight pixels per step
+template < __m256i ( *Blend ) ( const __m256i, const __m256i, const __m256i, const __m256i ), bool readSrc >
+BLIT_AVX2 void blend_AVX2 ( u32* dst, const u32* src, s32 count, u32 argb, u32 alpha )
+{
+	const __m256i c = _mm256_set1_epi32 ( argb );
+	const __m256i a = _mm256_set1_epi32 ( alpha | ( alpha << 16 ) );
+
+	for ( ; count >= 8; count -= 8 )
+	{
+		const __m256i s = readSrc ? _mm256_loadu_si256 ( (const __m256i*) src ) : c;
+		_mm256_storeu_si256 ( (__m256i*) dst, Blend ( _mm256_loadu_si256 ( (const __m256i*) dst ), s, c, a ) );
+		dst += 8;
+		if ( readSrc )
+			src += 8;
+	}
+
+	if ( count > 0 )
+	{
+		u32 d[ 8 ] = { 0 };
+		u32 s[ 8 ] = { 0 };
+		memcpy ( d, dst, count * 4 );
+		if ( readSrc )
+			memcpy ( s, src, count * 4 );
+
+		const __m256i v = readSrc ? _mm256_loadu_si256 ( (const __m256i*) s ) : c;
+		_mm256_storeu_si256 ( (__m256i*) d, Blend ( _mm256_loadu_si256 ( (const __m256i*) d ), v, c, a ) );
+		memcpy ( dst, d, count * 4 );
+	}
+}
+
+
+//! the cpu features the kernels need
+E_BLIT_ISA detectBlitISA ()
+{
+	switch ( getCPUISA () )
+	{
+		case ECI_AVX2: return EBI_AVX2;
+		case ECI_SSE2: return EBI_SSE2;
+		default: return EBI_SCALAR;
+	}
+}
+
+//! asked once, before main
+const E_BLIT_ISA BlitISA = detectBlitISA ();
+
+#define BLIT_CONVERT_KERNELS(isa) \
+{ \
+	convert_##isa < load32_##isa, toA1R5G5B5_##isa, store16_##isa, 4, 2 >, \
+	convert_##isa < load32_##isa, toR5G6B5_##isa, store16_##isa, 4, 2 >, \
+	convert_##isa < load32_##isa, copy_##isa, store24_##isa < true >, 4, 3 >, \
+	convert_##isa < load32_##isa, copy_##isa, store24_##isa < false >, 4, 3 >, \
+	convert_##isa < load16_##isa, fromA1R5G5B5_##isa, store32_##isa, 2, 4 >, \
+	convert_##isa < load16_##isa, fromR5G6B5_##isa, store32_##isa, 2, 4 >, \
+	convert_##isa < load24_##isa < true >, opaque_##isa, store32_##isa, 3, 4 >, \
+	convert_##isa < load24_##isa < true >, opaqueToA1R5G5B5_##isa, store16_##isa, 3, 2 >, \
+	convert_##isa < load24_##isa < true >, toR5G6B5_##isa, store16_##isa, 3, 2 >, \
+	convert_##isa < load24_##isa < true >, copy_##isa, store24_##isa < false >, 3, 3 >, \
+	convert_##isa < load24_##isa < false >, opaque_##isa, store32_##isa, 3, 4 >, \
+	convert_##isa < load32_##isa, swapBytes_##isa, store32_##isa, 4, 4 >, \
+	convert_##isa < load32_##isa, premultiplyToA1R5G5B5_##isa, store16_##isa, 4, 2 > \
+}
+
+const tBlitConvertKernel ConvertKernels[ EBI_COUNT ][ EBC_COUNT ] =
+{
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+	BLIT_CONVERT_KERNELS ( SSE2 ),
+	BLIT_CONVERT_KERNELS ( AVX2 )
+};
+
+const tBlitBlendKernel BlendKernels[ EBI_COUNT ][ EBB_COUNT ] =
+{
+	{ 0, 0, 0 },
+	{ blend_SSE2 < blendTexture_SSE2, true >, blend_SSE2 < blendTextureColor_SSE2, true >, blend_SSE2 < blendColor_SSE2, false > },
+	{ blend_AVX2 < blendTexture_AVX2, true >, blend_AVX2 < blendTextureColor_AVX2, true >, blend_AVX2 < blendColor_AVX2, false > }
+};
+
+} // end anonymous namespace
+
+#endif // BLIT_KERNELS
+
+
+//! returns the best instruction set of this cpu that kernels were compiled for
+E_BLIT_ISA getBlitISASupported ()
+{
+#ifdef BLIT_KERNELS
+	return BlitISA;
+#else
+	return EBI_SCALAR;
+#endif
+}
+
+
+//! returns the conversion kernel for this cpu, or 0 if the scalar loop has to be used
+tBlitConvertKernel getBlitConvertKernel ( E_BLIT_CONVERT convert )
+{
+#ifdef BLIT_KERNELS
+	return ConvertKernels[BlitISA][convert];
+#else
+	return 0;
+#endif
+}
+
+
+//! returns the blend kernel for this cpu, or 0 if the scalar loop has to be used
+tBlitBlendKernel getBlitBlendKernel ( E_BLIT_BLEND blend )
+{
+#ifdef BLIT_KERNELS
+	return BlendKernels[BlitISA][blend];
+#else
+	return 0;
+#endif
+}
+
+
+} // end namespace video
+} // end namespace irr
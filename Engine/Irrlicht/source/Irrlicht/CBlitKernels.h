@@ -0,0 +1,88 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BLIT_KERNELS_H_INCLUDED__
+#define __C_BLIT_KERNELS_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace video
+{
+	//! instruction sets the blit kernels are written for
+	enum E_BLIT_ISA
+	{
+		//! no kernels, the callers run their own pixel loops
+		EBI_SCALAR = 0,
+
+		//! four pixels at a time
+		EBI_SSE2,
+
+		//! eight pixels at a time
+		EBI_AVX2,
+
+		EBI_COUNT
+	};
+
+	//! color conversions which have a simd kernel
+	/** 24 bit formats are named by their byte order in memory, the others
+	by their channels from the highest bit down, as in CColorConverter. */
+	enum E_BLIT_CONVERT
+	{
+		EBC_A8R8G8B8_TO_A1R5G5B5 = 0,
+		EBC_A8R8G8B8_TO_R5G6B5,
+		EBC_A8R8G8B8_TO_R8G8B8,
+		EBC_A8R8G8B8_TO_B8G8R8,
+		EBC_A1R5G5B5_TO_A8R8G8B8,
+		EBC_R5G6B5_TO_A8R8G8B8,
+		EBC_R8G8B8_TO_A8R8G8B8,
+		EBC_R8G8B8_TO_A1R5G5B5,
+		EBC_R8G8B8_TO_R5G6B5,
+		EBC_R8G8B8_TO_B8G8R8,
+		EBC_B8G8R8_TO_A8R8G8B8,
+		EBC_B8G8R8A8_TO_A8R8G8B8,
+
+		//! the 16 bit blitter's copy, the color is multiplied by its alpha first
+		EBC_A8R8G8B8_TO_A1R5G5B5_PREMULTIPLIED,
+
+		EBC_COUNT
+	};
+
+	//! 32 bit blend loops which have a simd kernel
+	enum E_BLIT_BLEND
+	{
+		//! dst = PixelBlend32 ( dst, src )
+		EBB_TEXTURE = 0,
+
+		//! dst = PixelBlend32 ( dst, PixelMul32_2 ( src, argb ) )
+		EBB_TEXTURE_COLOR,
+
+		//! dst = ( argb & 0xFF000000 ) | PixelBlend32 ( dst, argb, alpha ), src is not read
+		EBB_COLOR,
+
+		EBB_COUNT
+	};
+
+	//! converts count pixels from src to dst
+	/** Same arguments and output as the CColorConverter::convert_ functions.
+	src and dst may be the same memory if both formats have the same size. */
+	typedef void (*tBlitConvertKernel) ( const void* src, s32 count, void* dst );
+
+	//! blends count pixels into dst
+	typedef void (*tBlitBlendKernel) ( u32* dst, const u32* src, s32 count, u32 argb, u32 alpha );
+
+	//! returns the best instruction set of this cpu that kernels were compiled for
+	E_BLIT_ISA getBlitISASupported ();
+
+	//! returns the conversion kernel for this cpu, or 0 if the scalar loop has to be used
+	tBlitConvertKernel getBlitConvertKernel ( E_BLIT_CONVERT convert );
+
+	//! returns the blend kernel for this cpu, or 0 if the scalar loop has to be used
+	tBlitBlendKernel getBlitBlendKernel ( E_BLIT_BLEND blend );
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -0,0 +1,592 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CBoundingVolumeTree.h"
+#include "CFrustumCuller.h"
+#include "ISceneNode.h"
+#include "ECullingTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! the culling tests the tree can answer
+	const u32 TreeCulling = EAC_BOX | EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE;
+
+	//! how much larger than the sphere around the node the box of a leaf is
+	const f32 LeafMargin = 1.25f;
+
+	//! returns the box around two boxes
+	core::aabbox3df join(const core::aabbox3df& a, const core::aabbox3df& b)
+	{
+		core::aabbox3df box(a);
+		box.addInternalBox(b);
+		return box;
+	}
+}
+
+
+//! constructor
+CBoundingVolumeTree::CBoundingVolumeTree(ISceneNode* root)
+: Root(-1), FreeList(-1), LeafCount(0), UpdateCount(0), Frame(0), CullFrame(0),
+	SceneRoot(root), MovedCount(0)
+{
+}
+
+
+//! destructor
+CBoundingVolumeTree::~CBoundingVolumeTree()
+{
+	clear();
+}
+
+
+//! removes all nodes
+void CBoundingVolumeTree::clear()
+{
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		if (Nodes[i].Height == 0)
+		{
+			ISceneNode* node = Leaves[i].SceneNode;
+			if (node->getBoundingVolumeLeaf() == (s32)i)
+				node->setBoundingVolumeLeaf(-1);
+			node->drop();
+		}
+	}
+
+	Nodes.clear();
+	Leaves.clear();
+	MovedLeaves.clear();
+	MovedCount = 0;
+	Root = -1;
+	FreeList = -1;
+	LeafCount = 0;
+
+	core::array<ISceneNode*> added;
+	{
+		std::lock_guard<std::mutex> lock(AddedLock);
+		added.swap(AddedNodes);
+	}
+
+	for (u32 i=0; i<added.size(); ++i)
+		added[i]->drop();
+}
+
+
+//! starts a new frame and culls the tree against the view frustum
+void CBoundingVolumeTree::cull(const SViewFrustum* frustum)
+{
+	// cull the nodes where they are now
+	refresh();
+
+	++Frame;
+	UpdateCount = 0;
+
+	if (!frustum)
+		return;
+
+	CullFrame = Frame;
+
+	// the leaves which are not reached are culled by every test
+	if (Root != -1)
+		cullNode(Root, *frustum, frustum->getBoundingBox(), (1 << SViewFrustum::VF_PLANE_COUNT) - 1, 0, 0);
+}
+
+
+//! culls the subtree at the index
+void CBoundingVolumeTree::cullNode(s32 index, const SViewFrustum& frustum,
+		const core::aabbox3df& frustumBox, u32 planes, u32 culled, u32 kept)
+{
+	const core::aabbox3df& box = Nodes[index].Box;
+
+	// EAC_BOX tests the box of the node against the box around the frustum
+	if (!((culled | kept) & EAC_BOX))
+	{
+		if (!box.intersectsWithBox(frustumBox))
+			culled |= EAC_BOX;
+		else if (box.isFullInside(frustumBox))
+			kept |= EAC_BOX;
+	}
+
+	// EAC_FRUSTUM_BOX and EAC_FRUSTUM_SPHERE test the planes, and everything
+	// in the node is in its box
+	if (planes)
+	{
+		const core::vector3df center = box.getCenter();
+		const core::vector3df half = box.getExtent() * 0.5f;
+
+		for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			if (!(planes & (1 << i)))
+				continue;
+
+			const core::plane3df& plane = frustum.planes[i];
+			const f32 d = plane.getDistanceTo(center);
+			const f32 e = core::abs_(plane.Normal.X) * half.X +
+				core::abs_(plane.Normal.Y) * half.Y +
+				core::abs_(plane.Normal.Z) * half.Z;
+
+			if (d - e > core::ROUNDING_ERROR_f32)
+			{
+				culled |= EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE;
+				planes = 0;
+				break;
+			}
+
+			if (d + e < -core::ROUNDING_ERROR_f32)
+				planes &= ~(1 << i);
+		}
+
+		if (!planes && !(culled & EAC_FRUSTUM_BOX))
+			kept |= EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE;
+	}
+
+	if (culled == TreeCulling)
+		return;
+
+	if (Nodes[index].Height == 0)
+	{
+		SLeaf& leaf = Leaves[index];
+		leaf.CullFrame = Frame;
+		leaf.Culled = culled;
+		leaf.Kept = kept;
+		return;
+	}
+
+	cullNode(Nodes[index].Child[0], frustum, frustumBox, planes, culled, kept);
+	cullNode(Nodes[index].Child[1], frustum, frustumBox, planes, culled, kept);
+}
+
+
+//! notes a scene node whose absolute transformation was calculated again
+void CBoundingVolumeTree::noteMoved(ISceneNode* node)
+{
+	const s32 index = node->getBoundingVolumeLeaf();
+
+	// a node is only updated by one thread at a time, so only it writes its flag
+	if (!isLeafOf(index, node) || Leaves[index].Moved)
+		return;
+
+	Leaves[index].Moved = true;
+
+	const u32 slot = MovedCount.fetch_add(1, std::memory_order_relaxed);
+	if (slot < MovedLeaves.size())
+		MovedLeaves[slot] = index;
+}
+
+
+//! notes a scene node which was added to the scene or shown
+void CBoundingVolumeTree::noteAdded(ISceneNode* node)
+{
+	node->grab();
+
+	std::lock_guard<std::mutex> lock(AddedLock);
+	AddedNodes.push_back(node);
+}
+
+
+//! fits the leaves of the moved nodes again and adds the new ones
+void CBoundingVolumeTree::refresh()
+{
+	const u32 moved = core::min_(MovedCount.load(std::memory_order_relaxed), MovedLeaves.size());
+	MovedCount.store(0, std::memory_order_relaxed);
+
+	for (u32 i=0; i<moved; ++i)
+	{
+		const s32 index = MovedLeaves[i];
+		Leaves[index].Moved = false;
+		refitLeaf(index);
+	}
+
+	core::array<ISceneNode*> added;
+	{
+		std::lock_guard<std::mutex> lock(AddedLock);
+		added.swap(AddedNodes);
+	}
+
+	for (u32 i=0; i<added.size(); ++i)
+	{
+		ISceneNode* node = added[i];
+
+		// it may have been hidden, removed or given to another scene since
+		ISceneNode* root = node;
+		while (root->getParent() && root->isVisible())
+			root = root->getParent();
+
+		if (root == SceneRoot && root->isVisible())
+			insertTree(node);
+
+		node->drop();
+	}
+}
+
+
+//! puts a node and its visible children in the tree
+void CBoundingVolumeTree::insertTree(ISceneNode* node)
+{
+	if (node != SceneRoot)
+		insert(node);
+
+	const ISceneNodeList& children = node->getChildren();
+	for (ISceneNodeList::ConstIterator it = children.begin(); it != children.end(); ++it)
+	{
+		if ((*it)->isVisible())
+			insertTree(*it);
+	}
+}
+
+
+//! puts a node in the tree, or fits its leaf again
+void CBoundingVolumeTree::insert(ISceneNode* node)
+{
+	const s32 index = node->getBoundingVolumeLeaf();
+
+	if (isLeafOf(index, node))
+		refitLeaf(index);
+	else
+		update(node);
+}
+
+
+//! adds a node which registered for the frame, or moves it in the tree
+void CBoundingVolumeTree::update(ISceneNode* node)
+{
+	s32 index = node->getBoundingVolumeLeaf();
+
+	if (!isLeafOf(index, node))
+	{
+		index = allocate();
+		getLeafBox(node, Nodes[index].Box, LeafMargin);
+
+		SLeaf& leaf = Leaves[index];
+		leaf.SceneNode = node;
+		leaf.Transformation = node->getAbsoluteTransformation();
+		leaf.BoundingBox = node->getBoundingBox();
+		leaf.UpdateFrame = Frame;
+		leaf.MoveFrame = Frame;
+		leaf.CullFrame = 0;
+		leaf.Moved = false;
+
+		node->grab();
+		node->setBoundingVolumeLeaf(index);
+		++LeafCount;
+		++UpdateCount;
+
+		insertLeaf(index);
+		return;
+	}
+
+	SLeaf& leaf = Leaves[index];
+	if (leaf.UpdateFrame == Frame)
+		return;
+
+	leaf.UpdateFrame = Frame;
+	++UpdateCount;
+
+	refitLeaf(index);
+}
+
+
+//! moves a leaf in the tree if its node left its box
+void CBoundingVolumeTree::refitLeaf(s32 index)
+{
+	SLeaf& leaf = Leaves[index];
+	ISceneNode* node = leaf.SceneNode;
+
+	if (leaf.Transformation == node->getAbsoluteTransformation() &&
+		leaf.BoundingBox == node->getBoundingBox())
+		return;
+
+	leaf.Transformation = node->getAbsoluteTransformation();
+	leaf.BoundingBox = node->getBoundingBox();
+
+	// the leaf stays where it is as long as the node is in its box
+	core::aabbox3df box;
+	getLeafBox(node, box, 1.f);
+	if (box.isFullInside(Nodes[index].Box))
+		return;
+
+	leaf.MoveFrame = Frame;
+
+	removeLeaf(index);
+	getLeafBox(node, Nodes[index].Box, LeafMargin);
+	insertLeaf(index);
+}
+
+
+//! gets the culling tests which are left for a node after cull()
+bool CBoundingVolumeTree::getCulling(const ISceneNode* node, u32& culling) const
+{
+	const s32 index = node->getBoundingVolumeLeaf();
+
+	if (CullFrame != Frame || !isLeafOf(index, node))
+		return true;
+
+	const SLeaf& leaf = Leaves[index];
+
+	// was not in the tree when it was culled
+	if (leaf.MoveFrame == Frame)
+		return true;
+
+	// not reached by cull(), so in a subtree which every test culls
+	if (leaf.CullFrame != Frame)
+		return (culling & TreeCulling) == 0;
+
+	if (culling & leaf.Culled)
+		return false;
+
+	culling &= ~leaf.Kept;
+	return true;
+}
+
+
+//! removes the nodes which did not register since the last cull()
+void CBoundingVolumeTree::removeUnused()
+{
+	// a leaf is only noted once while it is in the tree
+	refresh();
+
+	// every leaf was updated, nothing to look for
+	if (UpdateCount == LeafCount)
+		return;
+
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		if (Nodes[i].Height != 0 || Leaves[i].UpdateFrame == Frame)
+			continue;
+
+		ISceneNode* node = Leaves[i].SceneNode;
+		if (node->getBoundingVolumeLeaf() == (s32)i)
+			node->setBoundingVolumeLeaf(-1);
+		node->drop();
+
+		removeLeaf(i);
+		release(i);
+		--LeafCount;
+	}
+}
+
+
+//! returns if the index is the leaf of the node
+bool CBoundingVolumeTree::isLeafOf(s32 index, const ISceneNode* node) const
+{
+	// a node can have a leaf in the tree of another scene manager
+	return index >= 0 && index < (s32)Nodes.size() &&
+		Nodes[index].Height == 0 && Leaves[index].SceneNode == node;
+}
+
+
+//! gets the box around the sphere around a scene node, scaled by a factor
+void CBoundingVolumeTree::getLeafBox(const ISceneNode* node, core::aabbox3df& box, f32 scale) const
+{
+	// the box around the sphere holds the box of the node in any rotation,
+	// so the tree can answer all three culling tests
+	core::vector3df center;
+	f32 radius;
+	CFrustumCuller::getBoundingSphere(node, center, radius);
+
+	radius *= scale;
+	box.MinEdge.set(center.X - radius, center.Y - radius, center.Z - radius);
+	box.MaxEdge.set(center.X + radius, center.Y + radius, center.Z + radius);
+}
+
+
+s32 CBoundingVolumeTree::allocate()
+{
+	s32 index = FreeList;
+
+	if (index == -1)
+	{
+		index = Nodes.size();
+		Nodes.push_back(SNode());
+		Leaves.push_back(SLeaf());
+		MovedLeaves.push_back(-1);
+	}
+	else
+		FreeList = Nodes[index].Parent;
+
+	SNode& node = Nodes[index];
+	node.Parent = -1;
+	node.Child[0] = -1;
+	node.Child[1] = -1;
+	node.Height = 0;
+	Leaves[index].SceneNode = 0;
+	Leaves[index].Moved = false;
+
+	return index;
+}
+
+
+void CBoundingVolumeTree::release(s32 index)
+{
+	Nodes[index].Parent = FreeList;
+	Nodes[index].Height = -1;
+	Leaves[index].SceneNode = 0;
+	FreeList = index;
+}
+
+
+void CBoundingVolumeTree::insertLeaf(s32 leaf)
+{
+	if (Root == -1)
+	{
+		Root = leaf;
+		Nodes[leaf].Parent = -1;
+		return;
+	}
+
+	// go down to the sibling which makes the tree grow least
+	const core::aabbox3df box = Nodes[leaf].Box;
+	s32 index = Root;
+
+	while (Nodes[index].Height != 0)
+	{
+		const f32 area = Nodes[index].Box.getArea();
+		const f32 joinedArea = join(Nodes[index].Box, box).getArea();
+
+		// cost of a new parent for this node and the leaf
+		const f32 cost = 2.f * joinedArea;
+
+		// every node below grows as much as this one
+		const f32 inherited = 2.f * (joinedArea - area);
+
+		f32 childCost[2];
+		for (u32 c=0; c<2; ++c)
+		{
+			const SNode& child = Nodes[Nodes[index].Child[c]];
+			childCost[c] = join(child.Box, box).getArea() + inherited;
+			if (child.Height != 0)
+				childCost[c] -= child.Box.getArea();
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+
+		index = Nodes[index].Child[childCost[0] < childCost[1] ? 0 : 1];
+	}
+
+	const s32 sibling = index;
+	const s32 oldParent = Nodes[sibling].Parent;
+	const s32 parent = allocate();
+
+	Nodes[parent].Parent = oldParent;
+	Nodes[parent].Child[0] = sibling;
+	Nodes[parent].Child[1] = leaf;
+	Nodes[sibling].Parent = parent;
+	Nodes[leaf].Parent = parent;
+	refit(parent);
+
+	if (oldParent != -1)
+	{
+		SNode& p = Nodes[oldParent];
+		p.Child[p.Child[0] == sibling ? 0 : 1] = parent;
+	}
+	else
+		Root = parent;
+
+	for (index = Nodes[parent].Parent; index != -1; index = Nodes[index].Parent)
+	{
+		index = balance(index);
+		refit(index);
+	}
+}
+
+
+void CBoundingVolumeTree::removeLeaf(s32 leaf)
+{
+	if (leaf == Root)
+	{
+		Root = -1;
+		return;
+	}
+
+	const s32 parent = Nodes[leaf].Parent;
+	const s32 grandParent = Nodes[parent].Parent;
+	const s32 sibling = Nodes[parent].Child[Nodes[parent].Child[0] == leaf ? 1 : 0];
+
+	release(parent);
+	Nodes[sibling].Parent = grandParent;
+
+	if (grandParent == -1)
+	{
+		Root = sibling;
+		return;
+	}
+
+	SNode& g = Nodes[grandParent];
+	g.Child[g.Child[0] == parent ? 0 : 1] = sibling;
+
+	for (s32 index = grandParent; index != -1; index = Nodes[index].Parent)
+	{
+		index = balance(index);
+		refit(index);
+	}
+}
+
+
+//! rotates the subtree at the index if it is out of balance, returns its new root
+s32 CBoundingVolumeTree::balance(s32 a)
+{
+	if (Nodes[a].Height < 2)
+		return a;
+
+	const s32 b = Nodes[a].Child[0];
+	const s32 c = Nodes[a].Child[1];
+	const s32 diff = Nodes[c].Height - Nodes[b].Height;
+
+	if (diff >= -1 && diff <= 1)
+		return a;
+
+	// the higher child takes the place of a, a takes the place of its lower
+	// grand child, and the higher grand child stays below it
+	const u32 high = diff > 1 ? 1 : 0;
+	const s32 up = Nodes[a].Child[high];
+	const s32 f = Nodes[up].Child[0];
+	const s32 g = Nodes[up].Child[1];
+	const s32 oldParent = Nodes[a].Parent;
+
+	Nodes[up].Child[0] = a;
+	Nodes[up].Parent = oldParent;
+	Nodes[a].Parent = up;
+
+	if (oldParent != -1)
+	{
+		SNode& p = Nodes[oldParent];
+		p.Child[p.Child[0] == a ? 0 : 1] = up;
+	}
+	else
+		Root = up;
+
+	const bool fHigher = Nodes[f].Height > Nodes[g].Height;
+	const s32 keep = fHigher ? f : g;
+	const s32 move = fHigher ? g : f;
+
+	Nodes[up].Child[1] = keep;
+	Nodes[a].Child[high] = move;
+	Nodes[move].Parent = a;
+
+	refit(a);
+	refit(up);
+	return up;
+}
+
+
+//! sets the box and height of a node from its children
+void CBoundingVolumeTree::refit(s32 index)
+{
+	SNode& node = Nodes[index];
+	const SNode& c0 = Nodes[node.Child[0]];
+	const SNode& c1 = Nodes[node.Child[1]];
+
+	node.Box = join(c0.Box, c1.Box);
+	node.Height = 1 + core::max_(c0.Height, c1.Height);
+}
+
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,212 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BOUNDING_VOLUME_TREE_H_INCLUDED__
+#define __C_BOUNDING_VOLUME_TREE_H_INCLUDED__
+
+#include "irrArray.h"
+#include "matrix4.h"
+#include "SViewFrustum.h"
+#include "ISceneNode.h"
+#include <atomic>
+#include <mutex>
+
+namespace irr
+{
+namespace scene
+{
+	//! A dynamic tree of boxes around scene nodes
+	/** Each leaf holds a node in a box a bit larger than the sphere around its
+	bounding box, so the leaf only moves in the tree when the node leaves that
+	box. The tree is kept balanced by rotations, like an AVL tree. It holds a
+	reference to its nodes, the nodes which did not register for a frame are
+	removed with removeUnused(). Between frames the scene nodes report their
+	moves, see ISceneNode::OnSceneNodeChanged(), and only the moved leaves are
+	fitted again by refresh(). */
+	class CBoundingVolumeTree
+	{
+	public:
+
+		//! constructor
+		/** \param root The root of the scene, nodes added below it are put in the tree. */
+		CBoundingVolumeTree(ISceneNode* root);
+
+		//! destructor
+		~CBoundingVolumeTree();
+
+		//! removes all nodes
+		void clear();
+
+		//! starts a new frame and culls the tree against the view frustum
+		/** Has to be called before the nodes register for the frame, the
+		changes since the last frame are applied first.
+		\param frustum The view frustum, 0 when there is no camera. */
+		void cull(const SViewFrustum* frustum);
+
+		//! notes a scene node whose absolute transformation was calculated again
+		/** Can be called from several threads at once, but not while the tree
+		changes. The leaf is fitted again by the next refresh(). */
+		void noteMoved(ISceneNode* node);
+
+		//! notes a scene node which was added to the scene or shown
+		/** Can be called from several threads at once. The next refresh() puts
+		the node and its visible children in the tree. */
+		void noteAdded(ISceneNode* node);
+
+		//! fits the leaves of the moved nodes again and adds the new ones
+		/** Makes the tree hold the scene as it is now, for picking. The added
+		nodes stay in the tree until the next frame even if they never register. */
+		void refresh();
+
+		//! adds a node which registered for the frame, or moves it in the tree
+		void update(ISceneNode* node);
+
+		//! gets the culling tests which are left for a node after cull()
+		/** \param node A node which was updated for this frame.
+		\param culling The E_CULLING_TYPE bits of the node, the tests which
+		can't cull it are removed.
+		\return False if the node is culled. */
+		bool getCulling(const ISceneNode* node, u32& culling) const;
+
+		//! removes the nodes which did not register since the last cull()
+		void removeUnused();
+
+		//! returns the index of the root, -1 when the tree is empty
+		s32 getRoot() const
+		{
+			return Root;
+		}
+
+		//! returns if the node at the index is a leaf
+		bool isLeaf(s32 index) const
+		{
+			return Nodes[index].Height == 0;
+		}
+
+		//! returns the first or second child of the node at the index
+		s32 getChild(s32 index, u32 child) const
+		{
+			return Nodes[index].Child[child];
+		}
+
+		//! returns the box of the node at the index
+		const core::aabbox3df& getBox(s32 index) const
+		{
+			return Nodes[index].Box;
+		}
+
+		//! returns the scene node of the leaf at the index
+		ISceneNode* getSceneNode(s32 index) const
+		{
+			return Leaves[index].SceneNode;
+		}
+
+		//! returns the number of scene nodes in the tree
+		u32 size() const
+		{
+			return LeafCount;
+		}
+
+	private:
+
+		//! a node of the tree
+		struct SNode
+		{
+			//! the box around the children, or the scene node of a leaf
+			core::aabbox3df Box;
+
+			//! the parent, or the next free node
+			s32 Parent;
+
+			s32 Child[2];
+
+			//! 0 for a leaf, -1 for a free node
+			s32 Height;
+		};
+
+		//! the scene node of a leaf, kept apart from the nodes to walk the tree faster
+		struct SLeaf
+		{
+			ISceneNode* SceneNode;
+
+			//! what the box of the leaf was built from
+			core::matrix4 Transformation;
+			core::aabbox3df BoundingBox;
+
+			//! frame of the last update(), of the last move in the tree and of the last cull()
+			u32 UpdateFrame;
+			u32 MoveFrame;
+			u32 CullFrame;
+
+			//! the E_CULLING_TYPE tests which cull the node, and which can't
+			u32 Culled;
+			u32 Kept;
+
+			//! was noted as moved since the last refresh()
+			bool Moved;
+		};
+
+		//! returns if the index is the leaf of the node
+		bool isLeafOf(s32 index, const ISceneNode* node) const;
+
+		//! puts a node in the tree, or fits its leaf again
+		void insert(ISceneNode* node);
+
+		//! puts a node and its visible children in the tree
+		void insertTree(ISceneNode* node);
+
+		//! moves a leaf in the tree if its node left its box
+		void refitLeaf(s32 index);
+
+		//! gets the box around the sphere around a scene node, scaled by a factor
+		void getLeafBox(const ISceneNode* node, core::aabbox3df& box, f32 scale) const;
+
+		s32 allocate();
+		void release(s32 index);
+
+		void insertLeaf(s32 leaf);
+		void removeLeaf(s32 leaf);
+
+		//! rotates the subtree at the index if it is out of balance, returns its new root
+		s32 balance(s32 index);
+
+		//! sets the box and height of a node from its children
+		void refit(s32 index);
+
+		//! culls the subtree at the index
+		/** \param planes A bit for each plane of the frustum the subtree is not inside of yet.
+		\param culled The tests which cull the whole subtree.
+		\param kept The tests which can't cull anything in it. */
+		void cullNode(s32 index, const SViewFrustum& frustum, const core::aabbox3df& frustumBox,
+			u32 planes, u32 culled, u32 kept);
+
+		core::array<SNode> Nodes;
+		core::array<SLeaf> Leaves;
+		s32 Root;
+		s32 FreeList;
+		u32 LeafCount;
+
+		//! number of leaves updated since the last cull()
+		u32 UpdateCount;
+		u32 Frame;
+
+		//! frame of the last cull() with a frustum
+		u32 CullFrame;
+
+		//! the root of the scene
+		ISceneNode* SceneRoot;
+
+		//! the leaves noted as moved, there is room for each leaf once
+		core::array<s32> MovedLeaves;
+		std::atomic<u32> MovedCount;
+
+		//! the nodes noted as added, with a reference
+		core::array<ISceneNode*> AddedNodes;
+		std::mutex AddedLock;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
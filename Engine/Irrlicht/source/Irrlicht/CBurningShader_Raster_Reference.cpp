@@ -956,6 +956,7 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 		}
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -978,7 +979,8 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 			}
 
 			// render a scanline
-			scanline ();
+			if ( line.y >= ScanRowStart )
+				scanline ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -1071,6 +1073,7 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 		}
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -1093,7 +1096,8 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 			}
 
 			// render a scanline
-			scanline ();
+			if ( line.y >= ScanRowStart )
+				scanline ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -0,0 +1,512 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+#include "CBurningSpanKernels.h"
+#include "CCPUFeatures.h"
+
+#ifdef SOFTWARE_DRIVER_2_SPAN_KERNELS
+	#include <emmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#define BURNING_SPAN_SSE2
+		#define BURNING_SPAN_AVX2
+	#else
+		// the kernels are built for their own instruction set only,
+		// the rest of the driver stays on the baseline target
+		#define BURNING_SPAN_SSE2 __attribute__ ( ( target ( "sse2" ) ) )
+		#define BURNING_SPAN_AVX2 __attribute__ ( ( target ( "avx2" ) ) )
+	#endif
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+#ifdef SOFTWARE_DRIVER_2_SPAN_KERNELS
+
+namespace
+{
+
+//! fills the per lane interpolants of the next pixels of a span
+/** Stepped one pixel at a time, exactly like the scalar scanline, so each
+lane gets the same floats the scalar loop would have used. */
+template < E_BURNING_SPAN_KERNEL K, s32 N >
+struct sSpanLanes
+{
+	f32 w[N];
+	f32 c[3][N];
+	f32 t[4][N];
+
+	sSpanLanes ( const sBurningSpan& span )
+		: W ( span.w ), C ( span.c ), T0 ( span.t[0] ), T1 ( span.t[1] ) {}
+
+	REALINLINE void step ( const sBurningSpan& span )
+	{
+		for ( s32 k = 0; k != N; ++k )
+		{
+			w[k] = W;
+			W += span.slopeW;
+
+			t[0][k] = T0.x;
+			t[1][k] = T0.y;
+			T0 += span.slopeT[0];
+
+			if ( K == EBSK_TEXTURE_GOURAUD )
+			{
+				c[0][k] = C.y;
+				c[1][k] = C.z;
+				c[2][k] = C.w;
+				C += span.slopeC;
+			}
+			else
+			{
+				t[2][k] = T1.x;
+				t[3][k] = T1.y;
+				T1 += span.slopeT[1];
+			}
+		}
+	}
+
+private:
+	f32 W;
+	sVec4 C;
+	sVec2 T0;
+	sVec2 T1;
+};
+
+
+// ------------------------------------ SSE2 ------------------------------------
+
+//! 32 bit multiply, low half. SSE2 only multiplies the even lanes
+BURNING_SPAN_SSE2 REALINLINE __m128i mullo_SSE2 ( const __m128i a, const __m128i b )
+{
+	const __m128i even = _mm_mul_epu32 ( a, b );
+	const __m128i odd = _mm_mul_epu32 ( _mm_srli_epi64 ( a, 32 ), _mm_srli_epi64 ( b, 32 ) );
+	return _mm_unpacklo_epi32 ( _mm_shuffle_epi32 ( even, _MM_SHUFFLE ( 0, 0, 2, 0 ) ),
+								_mm_shuffle_epi32 ( odd, _MM_SHUFFLE ( 0, 0, 2, 0 ) ) );
+}
+
+//! getTexelOffsetX for four pixels
+BURNING_SPAN_SSE2 REALINLINE __m128i texelOffsetX_SSE2 ( const sInternalTexture* t, const __m128i tx )
+{
+	return _mm_srl_epi32 ( _mm_and_si128 ( tx, _mm_set1_epi32 ( t->textureXMask ) ), _mm_cvtsi32_si128 ( t->texelXShift ) );
+}
+
+//! getTexelOffsetY for four pixels
+BURNING_SPAN_SSE2 REALINLINE __m128i texelOffsetY_SSE2 ( const sInternalTexture* t, const __m128i ty )
+{
+	const __m128i y = _mm_srli_epi32 ( _mm_and_si128 ( ty, _mm_set1_epi32 ( t->textureYMask ) ), FIX_POINT_PRE );
+	const __m128i tile = _mm_set1_epi32 ( t->tileYMask );
+	return _mm_or_si128 ( _mm_slli_epi32 ( _mm_and_si128 ( y, tile ), VIDEO_SAMPLE_GRANULARITY ),
+						  _mm_sll_epi32 ( _mm_andnot_si128 ( tile, y ), _mm_cvtsi32_si128 ( t->pitchlog2 ) ) );
+}
+
+//! loads the texels at byte offsets from the texture data
+BURNING_SPAN_SSE2 REALINLINE __m128i gather_SSE2 ( const sInternalTexture* t, const __m128i ofs )
+{
+	u32 o[4];
+	_mm_storeu_si128 ( (__m128i*) o, ofs );
+
+	const u8* data = (const u8*) t->data;
+	return _mm_setr_epi32 ( *(const s32*) ( data + o[0] ), *(const s32*) ( data + o[1] ),
+							*(const s32*) ( data + o[2] ), *(const s32*) ( data + o[3] ) );
+}
+
+//! one channel of a bilinear sample, see getSample_texture
+BURNING_SPAN_SSE2 REALINLINE __m128i bilinearChannel_SSE2 ( const __m128i t00, const __m128i t10,
+	const __m128i t01, const __m128i t11, const __m128i w00, const __m128i w10,
+	const __m128i w01, const __m128i w11, const s32 mask, const s32 shift )
+{
+	const __m128i m = _mm_set1_epi32 ( mask );
+	const __m128i c00 = _mm_srli_epi32 ( _mm_and_si128 ( t00, m ), shift );
+	const __m128i c10 = _mm_srli_epi32 ( _mm_and_si128 ( t10, m ), shift );
+	const __m128i c01 = _mm_srli_epi32 ( _mm_and_si128 ( t01, m ), shift );
+	const __m128i c11 = _mm_srli_epi32 ( _mm_and_si128 ( t11, m ), shift );
+
+	return _mm_add_epi32 ( _mm_add_epi32 ( mullo_SSE2 ( c00, w00 ), mullo_SSE2 ( c01, w01 ) ),
+						   _mm_add_epi32 ( mullo_SSE2 ( c10, w10 ), mullo_SSE2 ( c11, w11 ) ) );
+}
+
+//! getSample_texture for four pixels
+BURNING_SPAN_SSE2 REALINLINE void sampleBilinear_SSE2 ( __m128i& r, __m128i& g, __m128i& b,
+	const sInternalTexture* t, const __m128i tx, const __m128i ty )
+{
+	const __m128i one = _mm_set1_epi32 ( FIX_POINT_ONE );
+
+	const __m128i o0 = texelOffsetY_SSE2 ( t, ty );
+	const __m128i o1 = texelOffsetY_SSE2 ( t, _mm_add_epi32 ( ty, one ) );
+	const __m128i o2 = texelOffsetX_SSE2 ( t, tx );
+	const __m128i o3 = texelOffsetX_SSE2 ( t, _mm_add_epi32 ( tx, one ) );
+
+	const __m128i t00 = gather_SSE2 ( t, _mm_or_si128 ( o0, o2 ) );
+	const __m128i t10 = gather_SSE2 ( t, _mm_or_si128 ( o0, o3 ) );
+	const __m128i t01 = gather_SSE2 ( t, _mm_or_si128 ( o1, o2 ) );
+	const __m128i t11 = gather_SSE2 ( t, _mm_or_si128 ( o1, o3 ) );
+
+	const __m128i fract = _mm_set1_epi32 ( FIX_POINT_FRACT_MASK );
+	const __m128i txFract = _mm_and_si128 ( tx, fract );
+	const __m128i txFractInv = _mm_sub_epi32 ( one, txFract );
+	const __m128i tyFract = _mm_and_si128 ( ty, fract );
+	const __m128i tyFractInv = _mm_sub_epi32 ( one, tyFract );
+
+	const __m128i w00 = _mm_srli_epi32 ( mullo_SSE2 ( txFractInv, tyFractInv ), FIX_POINT_PRE );
+	const __m128i w10 = _mm_srli_epi32 ( mullo_SSE2 ( txFract, tyFractInv ), FIX_POINT_PRE );
+	const __m128i w01 = _mm_srli_epi32 ( mullo_SSE2 ( txFractInv, tyFract ), FIX_POINT_PRE );
+	const __m128i w11 = _mm_srli_epi32 ( mullo_SSE2 ( txFract, tyFract ), FIX_POINT_PRE );
+
+	r = bilinearChannel_SSE2 ( t00, t10, t01, t11, w00, w10, w01, w11, MASK_R, SHIFT_R );
+	g = bilinearChannel_SSE2 ( t00, t10, t01, t11, w00, w10, w01, w11, MASK_G, SHIFT_G );
+	b = bilinearChannel_SSE2 ( t00, t10, t01, t11, w00, w10, w01, w11, MASK_B, SHIFT_B );
+}
+
+//! getTexel_fix for four pixels
+BURNING_SPAN_SSE2 REALINLINE void sampleNearest_SSE2 ( __m128i& r, __m128i& g, __m128i& b,
+	const sInternalTexture* t, const __m128i tx, const __m128i ty )
+{
+	const __m128i ofs = _mm_or_si128 ( texelOffsetY_SSE2 ( t, ty ), texelOffsetX_SSE2 ( t, tx ) );
+
+	const __m128i t00 = gather_SSE2 ( t, ofs );
+
+	r = _mm_srli_epi32 ( _mm_and_si128 ( t00, _mm_set1_epi32 ( MASK_R ) ), SHIFT_R - FIX_POINT_PRE );
+	g = _mm_slli_epi32 ( _mm_and_si128 ( t00, _mm_set1_epi32 ( MASK_G ) ), FIX_POINT_PRE - SHIFT_G );
+	b = _mm_slli_epi32 ( _mm_and_si128 ( t00, _mm_set1_epi32 ( MASK_B ) ), FIX_POINT_PRE - SHIFT_B );
+}
+
+//! clampfix_maxcolor ( imulFix_tex4 ( a, b ) )
+BURNING_SPAN_SSE2 REALINLINE __m128i mulTex4Clamp_SSE2 ( const __m128i a, const __m128i b )
+{
+	const __m128i max = _mm_set1_epi32 ( FIXPOINT_COLOR_MAX );
+	const __m128i v = _mm_srli_epi32 ( mullo_SSE2 ( _mm_srli_epi32 ( a, 2 ), _mm_srli_epi32 ( b, 2 ) ), FIX_POINT_PRE + 2 );
+	const __m128i c = _mm_srai_epi32 ( _mm_sub_epi32 ( v, max ), 31 );
+	return _mm_or_si128 ( _mm_and_si128 ( v, c ), _mm_andnot_si128 ( c, max ) );
+}
+
+//! fix_to_color for four pixels
+BURNING_SPAN_SSE2 REALINLINE __m128i toColor_SSE2 ( const __m128i r, const __m128i g, const __m128i b )
+{
+	const __m128i max = _mm_set1_epi32 ( FIXPOINT_COLOR_MAX );
+	return _mm_or_si128 (
+		_mm_or_si128 ( _mm_set1_epi32 ( FIXPOINT_COLOR_MAX << ( SHIFT_A - FIX_POINT_PRE ) ),
+					   _mm_slli_epi32 ( _mm_and_si128 ( r, max ), SHIFT_R - FIX_POINT_PRE ) ),
+		_mm_or_si128 ( _mm_srli_epi32 ( _mm_and_si128 ( g, max ), FIX_POINT_PRE - SHIFT_G ),
+					   _mm_srli_epi32 ( _mm_and_si128 ( b, max ), FIX_POINT_PRE - SHIFT_B ) ) );
+}
+
+template < E_BURNING_SPAN_KERNEL K >
+BURNING_SPAN_SSE2 void drawSpan_SSE2 ( const sBurningSpan& span )
+{
+	sSpanLanes<K, 4> lanes ( span );
+	const __m128i lane = _mm_setr_epi32 ( 0, 1, 2, 3 );
+
+	for ( s32 i = 0; i < span.count; i += 4 )
+	{
+		lanes.step ( span );
+
+		fp24* z = span.z + i;
+		tVideoSample* dst = span.dst + i;
+		const s32 n = core::s32_min ( span.count - i, 4 );
+
+		// the last pixels go through a copy, so nothing past the span is touched
+		fp24 zTail[4];
+		tVideoSample dstTail[4];
+		if ( n < 4 )
+		{
+			for ( s32 k = 0; k != 4; ++k )
+			{
+				zTail[k] = k < n ? z[k] : 0.f;
+				dstTail[k] = k < n ? dst[k] : 0;
+			}
+			z = zTail;
+			dst = dstTail;
+		}
+
+		const __m128 w = _mm_loadu_ps ( lanes.w );
+		const __m128 zOld = _mm_loadu_ps ( z );
+		const __m128 pass = _mm_and_ps ( _mm_cmpge_ps ( w, zOld ),
+			_mm_castsi128_ps ( _mm_cmpgt_epi32 ( _mm_set1_epi32 ( n ), lane ) ) );
+
+		if ( 0 == _mm_movemask_ps ( pass ) )
+			continue;
+
+		const __m128 inversew = _mm_div_ps ( _mm_set1_ps ( FIX_POINT_F32_MUL ), w );
+		const __m128i tx0 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.t[0] ), inversew ) );
+		const __m128i ty0 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.t[1] ), inversew ) );
+
+		__m128i r0, g0, b0;
+		__m128i r1, g1, b1;
+		__m128i color;
+
+		if ( K == EBSK_TEXTURE_GOURAUD )
+		{
+			sampleBilinear_SSE2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+
+			r1 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.c[0] ), inversew ) );
+			g1 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.c[1] ), inversew ) );
+			b1 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.c[2] ), inversew ) );
+
+			color = toColor_SSE2 ( _mm_srai_epi32 ( mullo_SSE2 ( r0, r1 ), FIX_POINT_PRE ),
+								   _mm_srai_epi32 ( mullo_SSE2 ( g0, g1 ), FIX_POINT_PRE ),
+								   _mm_srai_epi32 ( mullo_SSE2 ( b0, b1 ), FIX_POINT_PRE ) );
+		}
+		else
+		{
+			const __m128i tx1 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.t[2] ), inversew ) );
+			const __m128i ty1 = _mm_cvttps_epi32 ( _mm_mul_ps ( _mm_loadu_ps ( lanes.t[3] ), inversew ) );
+
+			if ( K == EBSK_LIGHTMAP_M4_BILINEAR )
+			{
+				sampleBilinear_SSE2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+				sampleBilinear_SSE2 ( r1, g1, b1, span.texture[1], tx1, ty1 );
+			}
+			else
+			{
+				sampleNearest_SSE2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+				sampleNearest_SSE2 ( r1, g1, b1, span.texture[1], tx1, ty1 );
+			}
+
+			color = toColor_SSE2 ( mulTex4Clamp_SSE2 ( r0, r1 ),
+								   mulTex4Clamp_SSE2 ( g0, g1 ),
+								   mulTex4Clamp_SSE2 ( b0, b1 ) );
+		}
+
+		const __m128i mask = _mm_castps_si128 ( pass );
+		const __m128i dstOld = _mm_loadu_si128 ( (const __m128i*) dst );
+
+		_mm_storeu_ps ( z, _mm_or_ps ( _mm_and_ps ( pass, w ), _mm_andnot_ps ( pass, zOld ) ) );
+		_mm_storeu_si128 ( (__m128i*) dst, _mm_or_si128 ( _mm_and_si128 ( mask, color ), _mm_andnot_si128 ( mask, dstOld ) ) );
+
+		if ( n < 4 )
+		{
+			for ( s32 k = 0; k != n; ++k )
+			{
+				span.z[i + k] = zTail[k];
+				span.dst[i + k] = dstTail[k];
+			}
+		}
+	}
+}
+
+
+// ------------------------------------ AVX2 ------------------------------------
+
+//! getTexelOffsetX for eight pixels
+BURNING_SPAN_AVX2 REALINLINE __m256i texelOffsetX_AVX2 ( const sInternalTexture* t, const __m256i tx )
+{
+	return _mm256_srl_epi32 ( _mm256_and_si256 ( tx, _mm256_set1_epi32 ( t->textureXMask ) ), _mm_cvtsi32_si128 ( t->texelXShift ) );
+}
+
+//! getTexelOffsetY for eight pixels
+BURNING_SPAN_AVX2 REALINLINE __m256i texelOffsetY_AVX2 ( const sInternalTexture* t, const __m256i ty )
+{
+	const __m256i y = _mm256_srli_epi32 ( _mm256_and_si256 ( ty, _mm256_set1_epi32 ( t->textureYMask ) ), FIX_POINT_PRE );
+	const __m256i tile = _mm256_set1_epi32 ( t->tileYMask );
+	return _mm256_or_si256 ( _mm256_slli_epi32 ( _mm256_and_si256 ( y, tile ), VIDEO_SAMPLE_GRANULARITY ),
+							 _mm256_sll_epi32 ( _mm256_andnot_si256 ( tile, y ), _mm_cvtsi32_si128 ( t->pitchlog2 ) ) );
+}
+
+//! getSample_texture for eight pixels
+BURNING_SPAN_AVX2 REALINLINE void sampleBilinear_AVX2 ( __m256i& r, __m256i& g, __m256i& b,
+	const sInternalTexture* t, const __m256i tx, const __m256i ty )
+{
+	const __m256i one = _mm256_set1_epi32 ( FIX_POINT_ONE );
+	const int* data = (const int*) t->data;
+
+	const __m256i o0 = texelOffsetY_AVX2 ( t, ty );
+	const __m256i o1 = texelOffsetY_AVX2 ( t, _mm256_add_epi32 ( ty, one ) );
+	const __m256i o2 = texelOffsetX_AVX2 ( t, tx );
+	const __m256i o3 = texelOffsetX_AVX2 ( t, _mm256_add_epi32 ( tx, one ) );
+
+	// the offsets are in bytes
+	const __m256i t00 = _mm256_i32gather_epi32 ( data, _mm256_or_si256 ( o0, o2 ), 1 );
+	const __m256i t10 = _mm256_i32gather_epi32 ( data, _mm256_or_si256 ( o0, o3 ), 1 );
+	const __m256i t01 = _mm256_i32gather_epi32 ( data, _mm256_or_si256 ( o1, o2 ), 1 );
+	const __m256i t11 = _mm256_i32gather_epi32 ( data, _mm256_or_si256 ( o1, o3 ), 1 );
+
+	const __m256i fract = _mm256_set1_epi32 ( FIX_POINT_FRACT_MASK );
+	const __m256i txFract = _mm256_and_si256 ( tx, fract );
+	const __m256i txFractInv = _mm256_sub_epi32 ( one, txFract );
+	const __m256i tyFract = _mm256_and_si256 ( ty, fract );
+	const __m256i tyFractInv = _mm256_sub_epi32 ( one, tyFract );
+
+	const __m256i w00 = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( txFractInv, tyFractInv ), FIX_POINT_PRE );
+	const __m256i w10 = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( txFract, tyFractInv ), FIX_POINT_PRE );
+	const __m256i w01 = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( txFractInv, tyFract ), FIX_POINT_PRE );
+	const __m256i w11 = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( txFract, tyFract ), FIX_POINT_PRE );
+
+	const __m256i byte = _mm256_set1_epi32 ( 0xFF );
+
+	r = _mm256_add_epi32 (
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t00, SHIFT_R ), byte ), w00 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t01, SHIFT_R ), byte ), w01 ) ),
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t10, SHIFT_R ), byte ), w10 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t11, SHIFT_R ), byte ), w11 ) ) );
+	g = _mm256_add_epi32 (
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t00, SHIFT_G ), byte ), w00 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t01, SHIFT_G ), byte ), w01 ) ),
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t10, SHIFT_G ), byte ), w10 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t11, SHIFT_G ), byte ), w11 ) ) );
+	b = _mm256_add_epi32 (
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t00, SHIFT_B ), byte ), w00 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t01, SHIFT_B ), byte ), w01 ) ),
+		_mm256_add_epi32 ( _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t10, SHIFT_B ), byte ), w10 ),
+						   _mm256_mullo_epi32 ( _mm256_and_si256 ( _mm256_srli_epi32 ( t11, SHIFT_B ), byte ), w11 ) ) );
+}
+
+//! getTexel_fix for eight pixels
+BURNING_SPAN_AVX2 REALINLINE void sampleNearest_AVX2 ( __m256i& r, __m256i& g, __m256i& b,
+	const sInternalTexture* t, const __m256i tx, const __m256i ty )
+{
+	const __m256i ofs = _mm256_or_si256 ( texelOffsetY_AVX2 ( t, ty ), texelOffsetX_AVX2 ( t, tx ) );
+
+	const __m256i t00 = _mm256_i32gather_epi32 ( (const int*) t->data, ofs, 1 );
+
+	r = _mm256_srli_epi32 ( _mm256_and_si256 ( t00, _mm256_set1_epi32 ( MASK_R ) ), SHIFT_R - FIX_POINT_PRE );
+	g = _mm256_slli_epi32 ( _mm256_and_si256 ( t00, _mm256_set1_epi32 ( MASK_G ) ), FIX_POINT_PRE - SHIFT_G );
+	b = _mm256_slli_epi32 ( _mm256_and_si256 ( t00, _mm256_set1_epi32 ( MASK_B ) ), FIX_POINT_PRE - SHIFT_B );
+}
+
+//! clampfix_maxcolor ( imulFix_tex4 ( a, b ) )
+BURNING_SPAN_AVX2 REALINLINE __m256i mulTex4Clamp_AVX2 ( const __m256i a, const __m256i b )
+{
+	const __m256i max = _mm256_set1_epi32 ( FIXPOINT_COLOR_MAX );
+	const __m256i v = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( _mm256_srli_epi32 ( a, 2 ), _mm256_srli_epi32 ( b, 2 ) ), FIX_POINT_PRE + 2 );
+	const __m256i c = _mm256_srai_epi32 ( _mm256_sub_epi32 ( v, max ), 31 );
+	return _mm256_or_si256 ( _mm256_and_si256 ( v, c ), _mm256_andnot_si256 ( c, max ) );
+}
+
+//! fix_to_color for eight pixels
+BURNING_SPAN_AVX2 REALINLINE __m256i toColor_AVX2 ( const __m256i r, const __m256i g, const __m256i b )
+{
+	const __m256i max = _mm256_set1_epi32 ( FIXPOINT_COLOR_MAX );
+	return _mm256_or_si256 (
+		_mm256_or_si256 ( _mm256_set1_epi32 ( FIXPOINT_COLOR_MAX << ( SHIFT_A - FIX_POINT_PRE ) ),
+						  _mm256_slli_epi32 ( _mm256_and_si256 ( r, max ), SHIFT_R - FIX_POINT_PRE ) ),
+		_mm256_or_si256 ( _mm256_srli_epi32 ( _mm256_and_si256 ( g, max ), FIX_POINT_PRE - SHIFT_G ),
+						  _mm256_srli_epi32 ( _mm256_and_si256 ( b, max ), FIX_POINT_PRE - SHIFT_B ) ) );
+}
+
+template < E_BURNING_SPAN_KERNEL K >
+BURNING_SPAN_AVX2 void drawSpan_AVX2 ( const sBurningSpan& span )
+{
+	sSpanLanes<K, 8> lanes ( span );
+	const __m256i lane = _mm256_setr_epi32 ( 0, 1, 2, 3, 4, 5, 6, 7 );
+
+	for ( s32 i = 0; i < span.count; i += 8 )
+	{
+		lanes.step ( span );
+
+		fp24* z = span.z + i;
+		tVideoSample* dst = span.dst + i;
+
+		// masked loads and stores keep the last pixels inside the span
+		const __m256i inside = _mm256_cmpgt_epi32 ( _mm256_set1_epi32 ( span.count - i ), lane );
+
+		const __m256 w = _mm256_loadu_ps ( lanes.w );
+		const __m256 zOld = _mm256_maskload_ps ( z, inside );
+		const __m256 pass = _mm256_and_ps ( _mm256_cmp_ps ( w, zOld, _CMP_GE_OQ ), _mm256_castsi256_ps ( inside ) );
+
+		if ( 0 == _mm256_movemask_ps ( pass ) )
+			continue;
+
+		const __m256 inversew = _mm256_div_ps ( _mm256_set1_ps ( FIX_POINT_F32_MUL ), w );
+		const __m256i tx0 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.t[0] ), inversew ) );
+		const __m256i ty0 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.t[1] ), inversew ) );
+
+		__m256i r0, g0, b0;
+		__m256i r1, g1, b1;
+		__m256i color;
+
+		if ( K == EBSK_TEXTURE_GOURAUD )
+		{
+			sampleBilinear_AVX2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+
+			r1 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.c[0] ), inversew ) );
+			g1 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.c[1] ), inversew ) );
+			b1 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.c[2] ), inversew ) );
+
+			color = toColor_AVX2 ( _mm256_srai_epi32 ( _mm256_mullo_epi32 ( r0, r1 ), FIX_POINT_PRE ),
+								   _mm256_srai_epi32 ( _mm256_mullo_epi32 ( g0, g1 ), FIX_POINT_PRE ),
+								   _mm256_srai_epi32 ( _mm256_mullo_epi32 ( b0, b1 ), FIX_POINT_PRE ) );
+		}
+		else
+		{
+			const __m256i tx1 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.t[2] ), inversew ) );
+			const __m256i ty1 = _mm256_cvttps_epi32 ( _mm256_mul_ps ( _mm256_loadu_ps ( lanes.t[3] ), inversew ) );
+
+			if ( K == EBSK_LIGHTMAP_M4_BILINEAR )
+			{
+				sampleBilinear_AVX2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+				sampleBilinear_AVX2 ( r1, g1, b1, span.texture[1], tx1, ty1 );
+			}
+			else
+			{
+				sampleNearest_AVX2 ( r0, g0, b0, span.texture[0], tx0, ty0 );
+				sampleNearest_AVX2 ( r1, g1, b1, span.texture[1], tx1, ty1 );
+			}
+
+			color = toColor_AVX2 ( mulTex4Clamp_AVX2 ( r0, r1 ),
+								   mulTex4Clamp_AVX2 ( g0, g1 ),
+								   mulTex4Clamp_AVX2 ( b0, b1 ) );
+		}
+
+		const __m256i mask = _mm256_castps_si256 ( pass );
+		_mm256_maskstore_ps ( z, mask, w );
+		_mm256_maskstore_epi32 ( (int*) dst, mask, color );
+	}
+}
+
+
+//! the cpu features the kernels need, asked once per driver
+E_BURNING_SPAN_ISA detectSpanISA ()
+{
+	switch ( getCPUISA () )
+	{
+		case ECI_AVX2: return EBSI_AVX2;
+		case ECI_SSE2: return EBSI_SSE2;
+		default: return EBSI_SCALAR;
+	}
+}
+
+const tBurningSpanKernel SpanKernels[ EBSI_COUNT ][ EBSK_COUNT ] =
+{
+	{ 0, 0, 0 },
+	{ drawSpan_SSE2<EBSK_TEXTURE_GOURAUD>, drawSpan_SSE2<EBSK_LIGHTMAP_M4_BILINEAR>, drawSpan_SSE2<EBSK_LIGHTMAP_M4_NEAREST> },
+	{ drawSpan_AVX2<EBSK_TEXTURE_GOURAUD>, drawSpan_AVX2<EBSK_LIGHTMAP_M4_BILINEAR>, drawSpan_AVX2<EBSK_LIGHTMAP_M4_NEAREST> }
+};
+
+} // end anonymous namespace
+
+#endif // SOFTWARE_DRIVER_2_SPAN_KERNELS
+
+
+//! returns the best instruction set of this cpu that kernels were compiled for
+E_BURNING_SPAN_ISA getBurningSpanISASupported ()
+{
+#ifdef SOFTWARE_DRIVER_2_SPAN_KERNELS
+	return detectSpanISA ();
+#else
+	return EBSI_SCALAR;
+#endif
+}
+
+
+//! returns the kernel for a scanline loop, or 0 if the scalar loop has to be used
+tBurningSpanKernel getBurningSpanKernel ( E_BURNING_SPAN_ISA isa, E_BURNING_SPAN_KERNEL kernel )
+{
+#ifdef SOFTWARE_DRIVER_2_SPAN_KERNELS
+	return SpanKernels[isa][kernel];
+#else
+	return 0;
+#endif
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
@@ -0,0 +1,80 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BURNING_SPAN_KERNELS_H_INCLUDED__
+#define __C_BURNING_SPAN_KERNELS_H_INCLUDED__
+
+#include "SoftwareDriver2_compile_config.h"
+#include "SoftwareDriver2_helper.h"
+#include "S4DVertex.h"
+
+namespace irr
+{
+namespace video
+{
+	//! instruction sets the span kernels are written for
+	enum E_BURNING_SPAN_ISA
+	{
+		//! no kernels, the shaders run their own scanline loops
+		EBSI_SCALAR = 0,
+
+		//! four pixels at a time
+		EBSI_SSE2,
+
+		//! eight pixels at a time, texels are gathered
+		EBSI_AVX2,
+
+		EBSI_COUNT
+	};
+
+	//! scanline loops which have a simd kernel
+	enum E_BURNING_SPAN_KERNEL
+	{
+		//! bilinear texture modulated by the vertex color, CTRTextureGouraudPermutation
+		EBSK_TEXTURE_GOURAUD = 0,
+
+		//! two bilinear textures multiplied by four, CTRTextureLightMap2_M4 magnified
+		EBSK_LIGHTMAP_M4_BILINEAR,
+
+		//! two nearest textures multiplied by four, CTRTextureLightMap2_M4 minified
+		EBSK_LIGHTMAP_M4_NEAREST,
+
+		EBSK_COUNT
+	};
+
+	//! one w-buffered scanline, with the interpolants already stepped to its first pixel
+	struct sBurningSpan
+	{
+		tVideoSample* dst;
+		fp24* z;
+		s32 count;
+
+		f32 w;
+		f32 slopeW;
+
+		sVec4 c;
+		sVec4 slopeC;
+
+		sVec2 t[2];
+		sVec2 slopeT[2];
+
+		const sInternalTexture* texture[2];
+	};
+
+	//! draws a span
+	/** A kernel steps the interpolants one pixel at a time, in the same order
+	as the scalar scanline, and only does the per pixel work in parallel. Its
+	output is exactly the same as the scalar loop's. */
+	typedef void (*tBurningSpanKernel) ( const sBurningSpan& span );
+
+	//! returns the best instruction set of this cpu that kernels were compiled for
+	E_BURNING_SPAN_ISA getBurningSpanISASupported ();
+
+	//! returns the kernel for a scanline loop, or 0 if the scalar loop has to be used
+	tBurningSpanKernel getBurningSpanKernel ( E_BURNING_SPAN_ISA isa, E_BURNING_SPAN_KERNEL kernel );
+
+} // end namespace video
+} // end namespace irr
+
+#endif
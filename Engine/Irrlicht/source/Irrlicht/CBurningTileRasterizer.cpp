@@ -0,0 +1,173 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+#include "CBurningTileRasterizer.h"
+#include "CSoftwareDriver2.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! constructor
+CBurningTileRasterizer::CBurningTileRasterizer(CBurningVideoDriver* driver, u32 threadCount)
+: Driver(driver), Pool(0), ThreadCount(threadCount > 0 ? threadCount : 1),
+	Shader(ETR_INVALID), TextureStages(0), TileCount(0), NextTile(0)
+{
+	Shaders.set_used(ThreadCount * ETR2_COUNT);
+	for (u32 i = 0; i != Shaders.size(); ++i)
+		Shaders[i] = 0;
+
+	Pool = CThreadPool::grabShared(ThreadCount);
+}
+
+
+//! destructor
+CBurningTileRasterizer::~CBurningTileRasterizer()
+{
+	Pool->dropShared();
+
+	for (u32 i = 0; i != Shaders.size(); ++i)
+	{
+		if (Shaders[i])
+			Shaders[i]->drop();
+	}
+}
+
+
+//! returns if the triangles of a shader can be rasterized in tiles
+bool CBurningTileRasterizer::canRasterize(EBurningFFShader shader) const
+{
+	switch (shader)
+	{
+		// these draw lines or are not used for draw calls
+		case ETR_TEXTURE_GOURAUD_WIRE:
+		case ETR_REFERENCE:
+		case ETR_INVALID:
+			return false;
+		default:
+			return true;
+	}
+}
+
+
+//! returns the copy of a shader used by one thread
+IBurningShader* CBurningTileRasterizer::getShader(u32 thread, EBurningFFShader shader)
+{
+	IBurningShader*& s = Shaders[thread * ETR2_COUNT + shader];
+
+	if (0 == s)
+		s = createBurningShader(shader, Driver);
+
+	return s;
+}
+
+
+//! starts collecting the triangles of a draw call
+void CBurningTileRasterizer::begin(EBurningFFShader shader, u32 textureStages, u32 targetHeight)
+{
+	Shader = shader;
+	TextureStages = core::min_(textureStages, (u32) BURNING_MATERIAL_MAX_TEXTURES);
+	TileCount = (targetHeight + SOFTWARE_DRIVER_2_TILE_HEIGHT - 1) / SOFTWARE_DRIVER_2_TILE_HEIGHT;
+
+	Triangles.set_used(0);
+
+	while (Tiles.size() < TileCount)
+		Tiles.push_back(core::array<u32>());
+
+	for (u32 i = 0; i != Tiles.size(); ++i)
+		Tiles[i].set_used(0);
+}
+
+
+//! adds a triangle
+void CBurningTileRasterizer::addTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c,
+				const IBurningShader* source)
+{
+	// the rows a shader draws are ceil(top) to ceil(bottom) - 1
+	const f32 top = core::min_(a->Pos.y, b->Pos.y, c->Pos.y);
+	const f32 bottom = core::max_(a->Pos.y, b->Pos.y, c->Pos.y);
+
+	const s32 firstRow = core::ceil32(top);
+	const s32 lastRow = core::ceil32(bottom) - 1;
+
+	if (lastRow < firstRow || lastRow < 0 || 0 == TileCount)
+		return;
+
+	const s32 firstTile = core::s32_max(firstRow, 0) / SOFTWARE_DRIVER_2_TILE_HEIGHT;
+	const s32 lastTile = core::s32_min(lastRow / SOFTWARE_DRIVER_2_TILE_HEIGHT, TileCount - 1);
+
+	STriangle t;
+	t.v[0] = *a;
+	t.v[1] = *b;
+	t.v[2] = *c;
+
+	for (u32 m = 0; m != TextureStages; ++m)
+		t.Texture[m] = source->getTextureParam(m);
+
+	const u32 index = Triangles.size();
+	Triangles.push_back(t);
+
+	for (s32 tile = firstTile; tile <= lastTile; ++tile)
+		Tiles[tile].push_back(index);
+}
+
+
+//! rasterizes the collected triangles and waits until they are drawn
+void CBurningTileRasterizer::flush()
+{
+	if (0 == Triangles.size())
+		return;
+
+	NextTile.store(0);
+
+	Pool->run(&CBurningTileRasterizer::rasterizeTask, this, ThreadCount);
+
+	Triangles.set_used(0);
+}
+
+
+//! rasterizes tiles until there are none left
+void CBurningTileRasterizer::rasterizeTiles(u32 thread)
+{
+	IBurningShader* shader = Shaders[thread * ETR2_COUNT + Shader];
+
+	u32 tile;
+	while ((tile = NextTile.fetch_add(1)) < TileCount)
+	{
+		const core::array<u32>& triangles = Tiles[tile];
+		if (0 == triangles.size())
+			continue;
+
+		const s32 firstRow = tile * SOFTWARE_DRIVER_2_TILE_HEIGHT;
+		shader->setScanRows(firstRow, firstRow + SOFTWARE_DRIVER_2_TILE_HEIGHT - 1);
+
+		// same order as the draw call, so blending and depth come out the same
+		for (u32 i = 0; i != triangles.size(); ++i)
+		{
+			const STriangle& t = Triangles[triangles[i]];
+
+			for (u32 m = 0; m != TextureStages; ++m)
+				shader->copyTextureParam(m, t.Texture[m]);
+
+			shader->drawTriangle(t.v + 0, t.v + 1, t.v + 2);
+		}
+	}
+}
+
+
+//! task run on each thread of the pool
+void CBurningTileRasterizer::rasterizeTask(void* data, u32 thread)
+{
+	static_cast<CBurningTileRasterizer*>(data)->rasterizeTiles(thread);
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
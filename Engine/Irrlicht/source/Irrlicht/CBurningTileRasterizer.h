@@ -0,0 +1,93 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BURNING_TILE_RASTERIZER_H_INCLUDED__
+#define __C_BURNING_TILE_RASTERIZER_H_INCLUDED__
+
+#include "SoftwareDriver2_compile_config.h"
+#include "IBurningShader.h"
+#include "irrArray.h"
+#include "CThreadPool.h"
+
+#include <atomic>
+
+namespace irr
+{
+namespace video
+{
+	class CBurningVideoDriver;
+
+	//! Rasterizes the triangles of a draw call on several threads.
+	/** Triangles are set up once by the driver and added here, then sorted
+	into tiles of SOFTWARE_DRIVER_2_TILE_HEIGHT screen rows. The tiles are
+	rasterized in parallel, each by one thread with its own copy of the
+	shader, so each thread owns its rows of the color, depth and stencil
+	buffers. Tiles span the whole width because the shaders step their
+	interpolants along the scanline; a tile drawn this way matches the
+	serial rasterizer bit for bit. The threads are the workers of the shared
+	CThreadPool. */
+	class CBurningTileRasterizer
+	{
+	public:
+
+		//! constructor
+		CBurningTileRasterizer(CBurningVideoDriver* driver, u32 threadCount);
+
+		//! destructor
+		~CBurningTileRasterizer();
+
+		//! returns the number of threads rasterizing, including the calling thread
+		u32 getThreadCount() const { return ThreadCount; }
+
+		//! returns if the triangles of a shader can be rasterized in tiles
+		bool canRasterize(EBurningFFShader shader) const;
+
+		//! returns the copy of a shader used by one thread
+		IBurningShader* getShader(u32 thread, EBurningFFShader shader);
+
+		//! starts collecting the triangles of a draw call
+		void begin(EBurningFFShader shader, u32 textureStages, u32 targetHeight);
+
+		//! adds a triangle, and the texture state of the shader it would have been drawn with
+		void addTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c,
+				const IBurningShader* source);
+
+		//! rasterizes the collected triangles and waits until they are drawn
+		void flush();
+
+	private:
+
+		struct STriangle
+		{
+			s4DVertex v[3];
+			sInternalTexture Texture[BURNING_MATERIAL_MAX_TEXTURES];
+		};
+
+		//! rasterizes tiles until there are none left
+		void rasterizeTiles(u32 thread);
+
+		//! task run on each thread of the pool
+		static void rasterizeTask(void* data, u32 thread);
+
+		CBurningVideoDriver* Driver;
+		CThreadPool* Pool;
+		u32 ThreadCount;
+
+		// shader copies, ETR2_COUNT for each thread
+		core::array<IBurningShader*> Shaders;
+
+		EBurningFFShader Shader;
+		u32 TextureStages;
+		u32 TileCount;
+
+		core::array<STriangle> Triangles;
+		core::array< core::array<u32> > Tiles;
+
+		std::atomic<u32> NextTile;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CCPUFeatures.h"
+
+#if defined ( _M_IX86 ) || defined ( _M_X64 ) || defined ( __i386__ ) || defined ( __x86_64__ )
+	#define CPU_FEATURES_X86
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#include <immintrin.h>
+	#endif
+#endif
+
+namespace irr
+{
+
+//! returns the best instruction set of this cpu and os
+E_CPU_ISA getCPUISA ()
+{
+#if defined ( CPU_FEATURES_X86 ) && defined ( _MSC_VER )
+	int info[4];
+	__cpuid ( info, 0 );
+	const int maxLeaf = info[0];
+
+	__cpuid ( info, 1 );
+	if ( 0 == ( info[3] & ( 1 << 26 ) ) )
+		return ECI_SCALAR;
+
+	// avx needs the os to save the ymm registers too
+	const bool osxsave = 0 != ( info[2] & ( 1 << 27 ) );
+	const bool avx = 0 != ( info[2] & ( 1 << 28 ) );
+	if ( maxLeaf >= 7 && osxsave && avx && ( _xgetbv ( 0 ) & 6 ) == 6 )
+	{
+		__cpuidex ( info, 7, 0 );
+		if ( info[1] & ( 1 << 5 ) )
+			return ECI_AVX2;
+	}
+	return ECI_SSE2;
+#elif defined ( CPU_FEATURES_X86 )
+	// checks the os support of the ymm registers for avx2 as well
+	__builtin_cpu_init ();
+	if ( __builtin_cpu_supports ( "avx2" ) )
+		return ECI_AVX2;
+	if ( __builtin_cpu_supports ( "sse2" ) )
+		return ECI_SSE2;
+	return ECI_SCALAR;
+#else
+	return ECI_SCALAR;
+#endif
+}
+
+} // end namespace irr
@@ -0,0 +1,33 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_CPU_FEATURES_H_INCLUDED__
+#define __C_CPU_FEATURES_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+	//! instruction sets the simd code of the engine is written for
+	enum E_CPU_ISA
+	{
+		//! no simd code, or not an x86 cpu
+		ECI_SCALAR = 0,
+
+		//! 128 bit integer and float vectors
+		ECI_SSE2,
+
+		//! 256 bit integer vectors, with the ymm registers saved by the os
+		ECI_AVX2
+	};
+
+	//! returns the best instruction set of this cpu and os
+	/** Asks the cpu each time it is called, so callers keep the result.
+	It does not depend on what the engine was compiled with, that is up to
+	the callers. */
+	E_CPU_ISA getCPUISA ();
+
+} // end namespace irr
+
+#endif
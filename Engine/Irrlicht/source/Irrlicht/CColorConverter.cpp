@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CColorConverter.h"
+#include "CBlitKernels.h"
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
@@ -12,6 +13,17 @@ namespace irr
 namespace video
 {
 
+//! converts a row with the simd kernel of this cpu, returns false if there is none
+static bool convertWithKernel(E_BLIT_CONVERT convert, const void* sP, s32 sN, void* dP)
+{
+	const tBlitConvertKernel kernel = getBlitConvertKernel(convert);
+	if (!kernel)
+		return false;
+
+	kernel(sP, sN, dP);
+	return true;
+}
+
 //! converts a monochrome bitmap to A1R5G5B5 data
 void CColorConverter::convert1BitTo16Bit(const u8* in, s16* out, s32 width, s32 height, s32 linepad, bool flip)
 {
@@ -243,7 +255,11 @@ void CColorConverter::convert24BitTo24Bit(const u8* in, u8* out, s32 width, s32
 	{
 		if (flip)
 			out -= lineWidth;
-		if (bgr)
+		if (!bgr)
+		{
+			memcpy(out,in,lineWidth);
+		}
+		else if (!convertWithKernel(EBC_R8G8B8_TO_B8G8R8, in, width, out))
 		{
 			for (s32 x=0; x<lineWidth; x+=3)
 			{
@@ -252,10 +268,6 @@ void CColorConverter::convert24BitTo24Bit(const u8* in, u8* out, s32 width, s32
 				out[x+2] = in[x+0];
 			}
 		}
-		else
-		{
-			memcpy(out,in,lineWidth);
-		}
 		if (!flip)
 			out += lineWidth;
 		in += lineWidth;
@@ -360,6 +372,9 @@ void CColorConverter::convert_A1R5G5B5toB8G8R8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_A1R5G5B5_TO_A8R8G8B8, sP, sN, dP))
+		return;
+
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
@@ -383,6 +398,9 @@ void CColorConverter::convert_A1R5G5B5toR5G6B5(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_A8R8G8B8_TO_R8G8B8, sP, sN, dP))
+		return;
+
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
@@ -400,6 +418,9 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_A8R8G8B8_TO_B8G8R8, sP, sN, dP))
+		return;
+
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
@@ -422,6 +443,9 @@ void CColorConverter::convert_A8R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_A8R8G8B8_TO_A1R5G5B5, sP, sN, dP))
+		return;
+
 	u32* sB = (u32*)sP;
 	u16* dB = (u16*)dP;
 
@@ -431,6 +455,9 @@ void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toR5G6B5(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_A8R8G8B8_TO_R5G6B5, sP, sN, dP))
+		return;
+
 	u8 * sB = (u8 *)sP;
 	u16* dB = (u16*)dP;
 
@@ -472,6 +499,9 @@ void CColorConverter::convert_R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_R8G8B8_TO_A8R8G8B8, sP, sN, dP))
+		return;
+
 	u8*  sB = (u8* )sP;
 	u32* dB = (u32*)dP;
 
@@ -486,6 +516,9 @@ void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_R8G8B8_TO_A1R5G5B5, sP, sN, dP))
+		return;
+
 	u8 * sB = (u8 *)sP;
 	u16* dB = (u16*)dP;
 
@@ -504,6 +537,9 @@ void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_B8G8R8_TO_A8R8G8B8, sP, sN, dP))
+		return;
+
 	u8*  sB = (u8* )sP;
 	u32* dB = (u32*)dP;
 
@@ -518,6 +554,9 @@ void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_B8G8R8A8_TO_A8R8G8B8, sP, sN, dP))
+		return;
+
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
@@ -536,6 +575,9 @@ void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_R8G8B8toR5G6B5(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_R8G8B8_TO_R5G6B5, sP, sN, dP))
+		return;
+
 	u8 * sB = (u8 *)sP;
 	u16* dB = (u16*)dP;
 
@@ -591,6 +633,9 @@ void CColorConverter::convert_R5G6B5toB8G8R8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R5G6B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
+	if (convertWithKernel(EBC_R5G6B5_TO_A8R8G8B8, sP, sN, dP))
+		return;
+
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
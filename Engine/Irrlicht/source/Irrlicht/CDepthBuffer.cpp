@@ -17,6 +17,9 @@ namespace video
 //! constructor
 CDepthBuffer::CDepthBuffer(const core::dimension2d<u32>& size)
 : Buffer(0), Size(0,0)
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	, TilesEnabled(false), TileCountX(0), TileCountY(0), WrittenTiles(0)
+#endif
 {
 	#ifdef _DEBUG
 	setDebugName("CDepthBuffer");
@@ -49,7 +52,56 @@ void CDepthBuffer::clear()
 	u32 zMaxValue;
 	zMaxValue = IR(zMax);
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	if ( TilesEnabled && WrittenTiles != TileFlags.size() )
+	{
+		// clear the runs of written tiles in each row of tiles
+		const u32 tileSize = 1 << SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+
+		for ( u32 ty = 0; ty != TileCountY && WrittenTiles; ++ty )
+		{
+			const u8* flags = TileFlags.const_pointer() + ty * TileCountX;
+			const u32 y0 = ty * tileSize;
+			const u32 y1 = core::min_ ( y0 + tileSize, Size.Height );
+
+			u32 tx = 0;
+			while ( tx != TileCountX )
+			{
+				if ( 0 == ( flags[tx] & ETF_WRITTEN ) )
+				{
+					tx += 1;
+					continue;
+				}
+
+				const u32 start = tx;
+				while ( tx != TileCountX && ( flags[tx] & ETF_WRITTEN ) )
+					tx += 1;
+
+				const u32 x0 = start * tileSize;
+				const u32 x1 = core::min_ ( tx * tileSize, Size.Width );
+
+				for ( u32 y = y0; y != y1; ++y )
+					memset32 ( (fp24*) ( Buffer + y * Pitch ) + x0, zMaxValue, ( x1 - x0 ) * sizeof ( fp24 ) );
+
+				WrittenTiles -= tx - start;
+			}
+		}
+	}
+	else
+	{
+		memset32 ( Buffer, zMaxValue, TotalSize );
+	}
+
+	if ( TileFlags.size() )
+	{
+		memset32 ( TileDepth.pointer(), zMaxValue, TileDepth.size() * sizeof ( f32 ) );
+		memset ( TileFlags.pointer(), 0, TileFlags.size() );
+	}
+	DirtyTiles.set_used ( 0 );
+	WrittenTiles = 0;
+#else
 	memset32 ( Buffer, zMaxValue, TotalSize );
+#endif
 }
 
 
@@ -68,6 +120,16 @@ void CDepthBuffer::setSize(const core::dimension2d<u32>& size)
 	Pitch = size.Width * sizeof ( fp24 );
 	TotalSize = Pitch * size.Height;
 	Buffer = new u8[TotalSize];
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	const u32 tileSize = 1 << SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+	TileCountX = ( size.Width + tileSize - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+	TileCountY = ( size.Height + tileSize - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+	TileDepth.set_used ( TileCountX * TileCountY );
+	TileFlags.set_used ( TileCountX * TileCountY );
+	resetTiles ();
+#endif
+
 	clear ();
 }
 
@@ -79,6 +141,99 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 	return Size;
 }
 
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+
+//! keeps the farthest depth of each tile, and clears only the tiles written.
+void CDepthBuffer::setTilesEnabled(bool enable)
+{
+	if ( enable == TilesEnabled )
+		return;
+
+	TilesEnabled = enable;
+	resetTiles ();
+}
+
+
+//! sets all tiles written, so the next clear clears everything
+void CDepthBuffer::resetTiles()
+{
+	// nothing is known about the buffer, a depth of 0 never rejects anything
+	if ( TileFlags.size() )
+	{
+		memset32 ( TileDepth.pointer(), 0, TileDepth.size() * sizeof ( f32 ) );
+		memset ( TileFlags.pointer(), ETF_WRITTEN, TileFlags.size() );
+	}
+	DirtyTiles.set_used ( 0 );
+	WrittenTiles = TileFlags.size();
+}
+
+
+//! notes that pixels in the area may have been written
+void CDepthBuffer::markWritten(s32 x0, s32 y0, s32 x1, s32 y1)
+{
+	if ( !TilesEnabled )
+		return;
+
+	const s32 tx0 = core::s32_max ( x0, 0 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+	const s32 ty0 = core::s32_max ( y0, 0 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+	const s32 tx1 = core::s32_min ( x1 >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2, (s32) TileCountX - 1 );
+	const s32 ty1 = core::s32_min ( y1 >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2, (s32) TileCountY - 1 );
+
+	for ( s32 ty = ty0; ty <= ty1; ++ty )
+	{
+		u8* flags = TileFlags.pointer() + ty * TileCountX;
+		for ( s32 tx = tx0; tx <= tx1; ++tx )
+		{
+			if ( flags[tx] & ETF_DIRTY )
+				continue;
+
+			if ( 0 == ( flags[tx] & ETF_WRITTEN ) )
+				WrittenTiles += 1;
+
+			flags[tx] = ETF_WRITTEN | ETF_DIRTY;
+			DirtyTiles.push_back ( ty * TileCountX + tx );
+		}
+	}
+}
+
+
+//! reads the farthest depth of the tiles written since the last update
+void CDepthBuffer::updateTiles()
+{
+	const u32 tileSize = 1 << SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+
+	for ( u32 i = 0; i != DirtyTiles.size(); ++i )
+	{
+		const u32 tile = DirtyTiles[i];
+		const u32 tx = tile % TileCountX;
+		const u32 ty = tile / TileCountX;
+
+		const u32 x0 = tx * tileSize;
+		const u32 y0 = ty * tileSize;
+		const u32 width = core::min_ ( tileSize, Size.Width - x0 );
+		const u32 height = core::min_ ( tileSize, Size.Height - y0 );
+
+		const fp24* z = (fp24*) ( Buffer + y0 * Pitch ) + x0;
+		f32 farthest = z[0];
+
+		for ( u32 y = 0; y != height; ++y )
+		{
+			for ( u32 x = 0; x != width; ++x )
+				farthest = core::min_ ( farthest, (f32) z[x] );
+
+			z = (fp24*) ( (u8*) z + Pitch );
+		}
+
+		TileDepth[tile] = farthest;
+		TileFlags[tile] &= ~ETF_DIRTY;
+	}
+
+	DirtyTiles.set_used ( 0 );
+}
+
+#endif
+
 // -----------------------------------------------------------------
 
 //! constructor
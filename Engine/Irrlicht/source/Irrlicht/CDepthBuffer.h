@@ -6,6 +6,8 @@
 #define __C_Z_BUFFER_H_INCLUDED__
 
 #include "IDepthBuffer.h"
+#include "SoftwareDriver2_compile_config.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -40,6 +42,25 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const { return Pitch; }
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		//! keeps the farthest depth of each tile, and clears only the tiles written.
+		/** Everything that writes depth has to call markWritten while tiles are kept. */
+		void setTilesEnabled(bool enable);
+
+		//! returns if the farthest depth of each tile is kept
+		bool getTilesEnabled() const { return TilesEnabled; }
+
+		//! returns true if no pixel of the area passes a greater equal test against depth w.
+		/** x1 and y1 are inclusive. The depth of the tiles may be lower than the depth
+		in the buffer, but never higher, so it is safe to skip anything occluded. */
+		bool isOccluded(s32 x0, s32 y0, s32 x1, s32 y1, f32 w) const;
+
+		//! notes that pixels in the area may have been written, x1 and y1 are inclusive
+		void markWritten(s32 x0, s32 y0, s32 x1, s32 y1);
+
+		//! reads the farthest depth of the tiles written since the last update
+		void updateTiles();
+#endif
 
 	private:
 
@@ -47,9 +68,54 @@ namespace video
 		core::dimension2d<u32> Size;
 		u32 TotalSize;
 		u32 Pitch;
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		enum E_TILE_FLAG
+		{
+			ETF_WRITTEN = 1,	// written since the last clear
+			ETF_DIRTY = 2		// written since the last update
+		};
+
+		//! sets all tiles written, so the next clear clears everything
+		void resetTiles();
+
+		bool TilesEnabled;
+		u32 TileCountX;
+		u32 TileCountY;
+		u32 WrittenTiles;
+		core::array<f32> TileDepth;
+		core::array<u8> TileFlags;
+		core::array<u32> DirtyTiles;
+#endif
 	};
 
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	inline bool CDepthBuffer::isOccluded(s32 x0, s32 y0, s32 x1, s32 y1, f32 w) const
+	{
+		// leave room for the rounding of the depth stepped along edges and spans
+		const f32 test = w * ( 1.f + 1.f / 256.f );
+
+		const s32 tx0 = core::s32_max ( x0, 0 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+		const s32 ty0 = core::s32_max ( y0, 0 ) >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2;
+		const s32 tx1 = core::s32_min ( x1 >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2, (s32) TileCountX - 1 );
+		const s32 ty1 = core::s32_min ( y1 >> SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2, (s32) TileCountY - 1 );
+
+		for ( s32 ty = ty0; ty <= ty1; ++ty )
+		{
+			const f32* tile = TileDepth.const_pointer() + ty * TileCountX;
+			for ( s32 tx = tx0; tx <= tx1; ++tx )
+			{
+				if ( test >= tile[tx] )
+					return false;
+			}
+		}
+
+		return true;
+	}
+#endif
+
+
 	class CStencilBuffer : public IStencilBuffer
 	{
 	public:
@@ -45,6 +45,20 @@ core::matrix4 CDummyTransformationSceneNode::getRelativeTransformation() const
 	return RelativeTransformationMatrix;
 }
 
+
+//! updates the absolute position, also after the matrix was changed by reference
+void CDummyTransformationSceneNode::updateAbsolutePosition()
+{
+	// getRelativeTransformationMatrix() hands out the matrix, so there is no setter to mark the node
+	if (RelativeTransformationMatrix != UpdatedTransformationMatrix)
+	{
+		UpdatedTransformationMatrix = RelativeTransformationMatrix;
+		setAbsoluteTransformationDirty();
+	}
+
+	IDummyTransformationSceneNode::updateAbsolutePosition();
+}
+
 //! Creates a clone of this scene node and its children.
 ISceneNode* CDummyTransformationSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
 {
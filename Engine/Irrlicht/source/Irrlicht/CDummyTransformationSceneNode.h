@@ -30,6 +30,9 @@ namespace scene
 		//! Returns the relative transformation of the scene node.
 		virtual core::matrix4 getRelativeTransformation() const;
 
+		//! updates the absolute position, also after the matrix was changed by reference
+		virtual void updateAbsolutePosition();
+
 		//! does nothing.
 		virtual void render() {}
 
@@ -52,6 +55,8 @@ namespace scene
 		virtual void setPosition(const core::vector3df& newpos);
 
 		core::matrix4 RelativeTransformationMatrix;
+		//! RelativeTransformationMatrix at the last updateAbsolutePosition()
+		core::matrix4 UpdatedTransformationMatrix;
 		core::aabbox3d<f32> Box;
 	};
 
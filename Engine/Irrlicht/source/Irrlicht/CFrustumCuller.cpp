@@ -0,0 +1,291 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CFrustumCuller.h"
+#include "ISceneNode.h"
+#include "ECullingTypes.h"
+#include "CCPUFeatures.h"
+#include <string.h>
+
+// the cpu is asked for sse2 at runtime
+#if defined ( _M_IX86 ) || defined ( _M_X64 ) || defined ( __i386__ ) || defined ( __x86_64__ )
+	#define CULL_KERNEL
+	#include <emmintrin.h>
+	#ifdef _MSC_VER
+		#define CULL_SSE2
+	#else
+		#define CULL_SSE2 __attribute__ ( ( target ( "sse2" ) ) )
+	#endif
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+#ifdef CULL_KERNEL
+
+namespace
+{
+
+//! culls the four nodes of a block, returns a bit for each culled one
+CULL_SSE2 u32 cullBlock_SSE2 ( const CFrustumCuller::SBlock& block, const SViewFrustum& frustum, const core::aabbox3df& box )
+{
+	const __m128i culling = _mm_loadu_si128 ( (const __m128i*) block.Culling );
+
+	// outside of the box around the frustum, as aabbox3d::intersectsWithBox()
+	__m128 boxOut = _mm_or_ps (
+		_mm_or_ps ( _mm_cmpnle_ps ( _mm_loadu_ps ( block.MinX ), _mm_set1_ps ( box.MaxEdge.X ) ),
+					_mm_cmpnle_ps ( _mm_loadu_ps ( block.MinY ), _mm_set1_ps ( box.MaxEdge.Y ) ) ),
+		_mm_cmpnle_ps ( _mm_loadu_ps ( block.MinZ ), _mm_set1_ps ( box.MaxEdge.Z ) ) );
+	boxOut = _mm_or_ps ( boxOut, _mm_or_ps (
+		_mm_or_ps ( _mm_cmpnge_ps ( _mm_loadu_ps ( block.MaxX ), _mm_set1_ps ( box.MinEdge.X ) ),
+					_mm_cmpnge_ps ( _mm_loadu_ps ( block.MaxY ), _mm_set1_ps ( box.MinEdge.Y ) ) ),
+		_mm_cmpnge_ps ( _mm_loadu_ps ( block.MaxZ ), _mm_set1_ps ( box.MinEdge.Z ) ) ) );
+
+	const __m128 cx = _mm_loadu_ps ( block.CenterX );
+	const __m128 cy = _mm_loadu_ps ( block.CenterY );
+	const __m128 cz = _mm_loadu_ps ( block.CenterZ );
+	const __m128 r = _mm_loadu_ps ( block.Radius );
+	const __m128 sign = _mm_castsi128_ps ( _mm_set1_epi32 ( 0x7FFFFFFF ) );
+	const __m128 epsilon = _mm_set1_ps ( core::ROUNDING_ERROR_f32 );
+
+	__m128 frustumOut = _mm_setzero_ps ();
+	__m128 sphereOut = _mm_setzero_ps ();
+
+	for ( u32 i = 0; i != SViewFrustum::VF_PLANE_COUNT; ++i )
+	{
+		const core::plane3df& plane = frustum.planes[i];
+		const __m128 nx = _mm_set1_ps ( plane.Normal.X );
+		const __m128 ny = _mm_set1_ps ( plane.Normal.Y );
+		const __m128 nz = _mm_set1_ps ( plane.Normal.Z );
+
+		// distance of the center, positive is outside
+		const __m128 d = _mm_add_ps ( _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( cx, nx ),
+			_mm_mul_ps ( cy, ny ) ), _mm_mul_ps ( cz, nz ) ), _mm_set1_ps ( plane.D ) );
+
+		// how far the box reaches towards the plane
+		__m128 e = _mm_setzero_ps ();
+		for ( u32 a = 0; a != 9; a += 3 )
+		{
+			const __m128 p = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( _mm_loadu_ps ( block.Axis[a] ), nx ),
+				_mm_mul_ps ( _mm_loadu_ps ( block.Axis[a + 1] ), ny ) ), _mm_mul_ps ( _mm_loadu_ps ( block.Axis[a + 2] ), nz ) );
+			e = _mm_add_ps ( e, _mm_and_ps ( p, sign ) );
+		}
+
+		// all corners in front of the plane
+		frustumOut = _mm_or_ps ( frustumOut, _mm_cmpgt_ps ( _mm_sub_ps ( d, e ), epsilon ) );
+		sphereOut = _mm_or_ps ( sphereOut, _mm_cmpgt_ps ( d, r ) );
+	}
+
+	// only the tests each node asked for
+	const __m128i boxBit = _mm_set1_epi32 ( EAC_BOX );
+	const __m128i frustumBit = _mm_set1_epi32 ( EAC_FRUSTUM_BOX );
+	const __m128i sphereBit = _mm_set1_epi32 ( EAC_FRUSTUM_SPHERE );
+
+	__m128 culled = _mm_and_ps ( boxOut, _mm_castsi128_ps ( _mm_cmpeq_epi32 ( _mm_and_si128 ( culling, boxBit ), boxBit ) ) );
+	culled = _mm_or_ps ( culled, _mm_and_ps ( frustumOut,
+		_mm_castsi128_ps ( _mm_cmpeq_epi32 ( _mm_and_si128 ( culling, frustumBit ), frustumBit ) ) ) );
+	culled = _mm_or_ps ( culled, _mm_and_ps ( sphereOut,
+		_mm_castsi128_ps ( _mm_cmpeq_epi32 ( _mm_and_si128 ( culling, sphereBit ), sphereBit ) ) ) );
+
+	return (u32) _mm_movemask_ps ( culled );
+}
+
+} // end namespace
+
+#endif
+
+
+//! constructor
+CFrustumCuller::CFrustumCuller()
+: Count(0), UseSIMD(getCPUISA() >= ECI_SSE2)
+{
+}
+
+
+//! forgets all nodes
+void CFrustumCuller::clear()
+{
+	Blocks.set_used(0);
+	Visible.set_used(0);
+	Count = 0;
+}
+
+
+//! adds the bounds of a node
+void CFrustumCuller::add(const ISceneNode* node, u32 culling)
+{
+	const u32 lane = Count & 3;
+
+	if (0 == lane)
+	{
+		Blocks.push_back(SBlock());
+		memset(&Blocks.getLast(), 0, sizeof(SBlock));
+	}
+
+	SBlock& block = Blocks.getLast();
+	++Count;
+
+	block.Culling[lane] = culling;
+
+	if (!culling)
+		return;
+
+	if (culling & EAC_BOX)
+	{
+		core::aabbox3df box = node->getBoundingBox();
+		node->getAbsoluteTransformation().transformBoxEx(box);
+
+		block.MinX[lane] = box.MinEdge.X;
+		block.MinY[lane] = box.MinEdge.Y;
+		block.MinZ[lane] = box.MinEdge.Z;
+		block.MaxX[lane] = box.MaxEdge.X;
+		block.MaxY[lane] = box.MaxEdge.Y;
+		block.MaxZ[lane] = box.MaxEdge.Z;
+	}
+
+	if (culling & (EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE))
+	{
+		core::vector3df center;
+		core::vector3df axis[3];
+		getBoundingAxes(node, center, axis);
+
+		block.CenterX[lane] = center.X;
+		block.CenterY[lane] = center.Y;
+		block.CenterZ[lane] = center.Z;
+
+		for (u32 a = 0; a != 3; ++a)
+		{
+			block.Axis[a * 3 + 0][lane] = axis[a].X;
+			block.Axis[a * 3 + 1][lane] = axis[a].Y;
+			block.Axis[a * 3 + 2][lane] = axis[a].Z;
+		}
+
+		if (culling & EAC_FRUSTUM_SPHERE)
+			block.Radius[lane] = getRadius(axis);
+	}
+}
+
+
+//! tests all added nodes against the frustum
+u32 CFrustumCuller::cull(const SViewFrustum& frustum)
+{
+	const core::aabbox3df& box = frustum.getBoundingBox();
+	const u32 blockCount = Blocks.size();
+
+	Visible.set_used((Count + 31) >> 5);
+	memset(Visible.pointer(), 0, Visible.size() * sizeof(u32));
+
+	u32 culled = 0;
+
+	for (u32 i = 0; i != blockCount; ++i)
+	{
+		u32 out;
+
+#ifdef CULL_KERNEL
+		if (UseSIMD)
+			out = cullBlock_SSE2(Blocks[i], frustum, box);
+		else
+#endif
+			out = cullBlock(Blocks[i], frustum, box);
+
+		// the lanes after the last node are never culled, their culling is 0
+		Visible[i >> 3] |= (~out & 0xF) << ((i & 7) * 4);
+		culled += ((out >> 0) & 1) + ((out >> 1) & 1) + ((out >> 2) & 1) + ((out >> 3) & 1);
+	}
+
+	return culled;
+}
+
+
+//! culls four nodes without simd, returns a bit for each culled one
+u32 CFrustumCuller::cullBlock(const SBlock& block, const SViewFrustum& frustum, const core::aabbox3df& box) const
+{
+	u32 out = 0;
+
+	for (u32 lane = 0; lane != 4; ++lane)
+	{
+		const u32 culling = block.Culling[lane];
+		bool result = false;
+
+		if (culling & EAC_BOX)
+		{
+			result = !(block.MinX[lane] <= box.MaxEdge.X && block.MinY[lane] <= box.MaxEdge.Y &&
+				block.MinZ[lane] <= box.MaxEdge.Z && block.MaxX[lane] >= box.MinEdge.X &&
+				block.MaxY[lane] >= box.MinEdge.Y && block.MaxZ[lane] >= box.MinEdge.Z);
+		}
+
+		if (culling & (EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE))
+		{
+			const core::vector3df center(block.CenterX[lane], block.CenterY[lane], block.CenterZ[lane]);
+
+			for (u32 i = 0; !result && i != SViewFrustum::VF_PLANE_COUNT; ++i)
+			{
+				const core::plane3df& plane = frustum.planes[i];
+				const f32 d = plane.getDistanceTo(center);
+
+				if ((culling & EAC_FRUSTUM_SPHERE) && d > block.Radius[lane])
+					result = true;
+
+				if (culling & EAC_FRUSTUM_BOX)
+				{
+					f32 e = 0.f;
+					for (u32 a = 0; a != 9; a += 3)
+						e += core::abs_(block.Axis[a][lane] * plane.Normal.X +
+							block.Axis[a + 1][lane] * plane.Normal.Y + block.Axis[a + 2][lane] * plane.Normal.Z);
+
+					if (d - e > core::ROUNDING_ERROR_f32)
+						result = true;
+				}
+			}
+		}
+
+		if (result)
+			out |= 1 << lane;
+	}
+
+	return out;
+}
+
+
+//! gets the sphere around the bounding box of a node in world space
+void CFrustumCuller::getBoundingSphere(const ISceneNode* node, core::vector3df& center, f32& radius)
+{
+	core::vector3df axis[3];
+	getBoundingAxes(node, center, axis);
+	radius = getRadius(axis);
+}
+
+
+//! gets the center of the bounding box of a node and its half edges in world space
+void CFrustumCuller::getBoundingAxes(const ISceneNode* node, core::vector3df& center, core::vector3df* axis)
+{
+	const core::matrix4& m = node->getAbsoluteTransformation();
+	const core::aabbox3df& box = node->getBoundingBox();
+
+	center = box.getCenter();
+	m.transformVect(center);
+
+	const core::vector3df half = box.getExtent() * 0.5f;
+	m.rotateVect(axis[0], core::vector3df(half.X, 0.f, 0.f));
+	m.rotateVect(axis[1], core::vector3df(0.f, half.Y, 0.f));
+	m.rotateVect(axis[2], core::vector3df(0.f, 0.f, half.Z));
+}
+
+
+//! returns the distance of the farthest corner of a box from its center
+f32 CFrustumCuller::getRadius(const core::vector3df* axis)
+{
+	// the axes need not be orthogonal, so each diagonal is measured
+	f32 r = (axis[0] + axis[1] + axis[2]).getLengthSQ();
+	r = core::max_(r, (axis[0] + axis[1] - axis[2]).getLengthSQ());
+	r = core::max_(r, (axis[0] - axis[1] + axis[2]).getLengthSQ());
+	r = core::max_(r, (axis[0] - axis[1] - axis[2]).getLengthSQ());
+	return sqrtf(r);
+}
+
+
+} // end namespace scene
+} // end namespace irr
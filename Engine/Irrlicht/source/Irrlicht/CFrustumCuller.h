@@ -0,0 +1,96 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_FRUSTUM_CULLER_H_INCLUDED__
+#define __C_FRUSTUM_CULLER_H_INCLUDED__
+
+#include "irrArray.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ISceneNode;
+
+	//! Culls the bounds of many scene nodes against a view frustum at once
+	/** The world space bounds of the nodes are gathered when they are added, the
+	same as ISceneManager::isCulled() takes them, and are tested in blocks of four
+	nodes with SSE2 when the cpu has it. The tests are those of isCulled(), but the
+	EAC_FRUSTUM_BOX test uses the world space box of the node instead of moving the
+	frustum into the space of the node, which can differ by rounding. */
+	class CFrustumCuller
+	{
+	public:
+
+		//! constructor
+		CFrustumCuller();
+
+		//! forgets all nodes
+		void clear();
+
+		//! adds the bounds of a node
+		/** \param node The node, its bounding box and absolute transformation are read now.
+		\param culling The E_CULLING_TYPE bits which still have to be tested, 0 keeps it visible. */
+		void add(const ISceneNode* node, u32 culling);
+
+		//! tests all added nodes against the frustum
+		/** \return Number of nodes which were culled. */
+		u32 cull(const SViewFrustum& frustum);
+
+		//! returns if the index-th added node passed the last cull()
+		bool isVisible(u32 index) const
+		{
+			return ((Visible[index >> 5] >> (index & 31)) & 1) != 0;
+		}
+
+		//! returns the number of added nodes
+		u32 size() const
+		{
+			return Count;
+		}
+
+		//! gets the sphere around the bounding box of a node in world space
+		static void getBoundingSphere(const ISceneNode* node, core::vector3df& center, f32& radius);
+
+		//! the bounds of four nodes, each value in its own array
+		/** Public only so the simd kernel can read it. */
+		struct SBlock
+		{
+			//! world space bounding box, for EAC_BOX
+			f32 MinX[4], MinY[4], MinZ[4];
+			f32 MaxX[4], MaxY[4], MaxZ[4];
+
+			//! center of the box and half its edges along the node's axes, for EAC_FRUSTUM_BOX
+			f32 CenterX[4], CenterY[4], CenterZ[4];
+			f32 Axis[9][4];
+
+			//! radius of the sphere around the box, for EAC_FRUSTUM_SPHERE
+			f32 Radius[4];
+
+			//! the E_CULLING_TYPE bits to test
+			u32 Culling[4];
+		};
+
+	private:
+
+		//! gets the center of the bounding box of a node and its half edges in world space
+		static void getBoundingAxes(const ISceneNode* node, core::vector3df& center, core::vector3df* axis);
+
+		//! returns the distance of the farthest corner of a box from its center
+		static f32 getRadius(const core::vector3df* axis);
+
+		//! culls four nodes without simd, returns a bit for each culled one
+		u32 cullBlock(const SBlock& block, const SViewFrustum& frustum, const core::aabbox3df& box) const;
+
+		core::array<SBlock> Blocks;
+		core::array<u32> Visible;
+		u32 Count;
+		bool UseSIMD;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
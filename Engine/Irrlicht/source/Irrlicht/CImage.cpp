@@ -315,6 +315,20 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		}
 	}
 
+	if (Size.Width==width && Size.Height==height)
+	{
+		// only the format differs, convert whole scanlines
+		u8* tgtpos = (u8*) target;
+		const u8* srcpos = Data;
+		for (u32 y=0; y<height; ++y)
+		{
+			CColorConverter::convert_viaFormat(srcpos, Format, width, tgtpos, format);
+			tgtpos += pitch;
+			srcpos += Pitch;
+		}
+		return;
+	}
+
 	const f32 sourceXStep = (f32)Size.Width / (f32)width;
 	const f32 sourceYStep = (f32)Size.Height / (f32)height;
 	s32 yval=0, syval=0;
@@ -75,7 +75,8 @@ CIrrDeviceConsole::CIrrDeviceConsole(const SIrrlichtCreationParameters& params)
 	WindowsSTDOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	PCOORD Dimensions = 0;
 
-	if (CreationParams.Fullscreen)
+	// without output the console is left as it is
+	if (CreationParams.ConsoleOutput && CreationParams.Fullscreen)
 	{
 // Some mingw versions lack this define, so avoid it in case it does not exist
 #if (_WIN32_WINNT >= 0x0501) && defined(CONSOLE_FULLSCREEN_MODE)
@@ -86,7 +87,7 @@ CIrrDeviceConsole::CIrrDeviceConsole(const SIrrlichtCreationParameters& params)
 		}
 #endif
 	}
-	else
+	else if (CreationParams.ConsoleOutput)
 	{
 		COORD ConsoleSize;
 		ConsoleSize.X = CreationParams.WindowSize.Width;
@@ -109,10 +110,13 @@ CIrrDeviceConsole::CIrrDeviceConsole(const SIrrlichtCreationParameters& params)
 #endif
 
 #ifdef _IRR_VT100_CONSOLE_
-	// reset terminal
-	fprintf(OutFile, "%cc", 27);
-	// disable line wrapping
-	fprintf(OutFile, "%c[7l", 27);
+	if (CreationParams.ConsoleOutput)
+	{
+		// reset terminal
+		fprintf(OutFile, "%cc", 27);
+		// disable line wrapping
+		fprintf(OutFile, "%c[7l", 27);
+	}
 #endif
 
 	switch (params.DriverType)
@@ -194,7 +198,8 @@ CIrrDeviceConsole::~CIrrDeviceConsole()
 	}
 #ifdef _IRR_VT100_CONSOLE_
 	// reset terminal
-	fprintf(OutFile, "%cc", 27);
+	if (CreationParams.ConsoleOutput)
+		fprintf(OutFile, "%cc", 27);
 #endif
 }
 
@@ -375,6 +380,14 @@ bool CIrrDeviceConsole::isWindowMinimized() const
 //! presents a surface in the client area
 bool CIrrDeviceConsole::present(video::IImage* surface, void* windowId, core::rect<s32>* src)
 {
+	// the frame stays in memory only
+	if (!CreationParams.ConsoleOutput)
+	{
+#ifdef _IRR_USE_CONSOLE_FONT_
+		Text.clear();
+#endif
+		return surface != 0;
+	}
 
 	if (surface)
 	{
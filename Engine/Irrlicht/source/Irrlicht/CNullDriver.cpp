@@ -2341,6 +2341,13 @@ IImage* CNullDriver::createScreenShot(video::ECOLOR_FORMAT format, video::E_REND
 }
 
 
+//! Returns the image the frame is rendered into
+IImage* CNullDriver::getBackBuffer() const
+{
+	return 0;
+}
+
+
 // prints renderer version
 void CNullDriver::printVersion()
 {
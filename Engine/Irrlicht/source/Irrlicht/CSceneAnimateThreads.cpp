@@ -0,0 +1,117 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneAnimateThreads.h"
+#include "ISceneNodeAnimator.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CSceneAnimateThreads::CSceneAnimateThreads(u32 threadCount, bool deterministic)
+: Pool(0), ThreadCount(threadCount > 0 ? threadCount : 1), Deterministic(deterministic),
+	TimeMs(0), NextSubtree(0)
+{
+	Pool = CThreadPool::grabShared(ThreadCount);
+}
+
+
+//! destructor
+CSceneAnimateThreads::~CSceneAnimateThreads()
+{
+	Pool->dropShared();
+}
+
+
+//! calls OnAnimate() of the children and waits until all are animated
+void CSceneAnimateThreads::animate(const core::list<ISceneNode*>& children, u32 timeMs)
+{
+	Subtrees.set_used(0);
+	core::list<ISceneNode*>::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		Subtrees.push_back(*it);
+
+	Deferred.set_used(Subtrees.size());
+	TimeMs = timeMs;
+	NextSubtree.store(0);
+
+	Pool->run(&CSceneAnimateThreads::animateTask, this, ThreadCount);
+
+	for (u32 i = 0; i != Subtrees.size(); ++i)
+	{
+		if (Deferred[i])
+			Subtrees[i]->OnAnimate(timeMs);
+	}
+}
+
+
+//! returns if a subtree can be animated on a worker thread
+bool CSceneAnimateThreads::isThreadSafe(const ISceneNode* node)
+{
+	// invisible subtrees are not animated
+	if (!node->isVisible())
+		return true;
+
+	if (!node->isAnimateThreadSafe())
+		return false;
+
+	const core::list<ISceneNodeAnimator*>& animators = node->getAnimators();
+	core::list<ISceneNodeAnimator*>::ConstIterator ait = animators.begin();
+	for (; ait != animators.end(); ++ait)
+	{
+		if (!(*ait)->isThreadSafe())
+			return false;
+	}
+
+	const core::list<ISceneNode*>& children = node->getChildren();
+	core::list<ISceneNode*>::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+	{
+		if (!isThreadSafe(*it))
+			return false;
+	}
+
+	return true;
+}
+
+
+//! animates subtrees until there are none left
+void CSceneAnimateThreads::animateSubtrees(u32 thread)
+{
+	const u32 count = Subtrees.size();
+	u32 i;
+
+	if (Deterministic)
+	{
+		// a fixed range for each thread
+		const u32 last = (u32) ((u64) count * (thread + 1) / ThreadCount);
+		for (i = (u32) ((u64) count * thread / ThreadCount); i < last; ++i)
+		{
+			Deferred[i] = !isThreadSafe(Subtrees[i]);
+			if (!Deferred[i])
+				Subtrees[i]->OnAnimate(TimeMs);
+		}
+		return;
+	}
+
+	while ((i = NextSubtree.fetch_add(1)) < count)
+	{
+		Deferred[i] = !isThreadSafe(Subtrees[i]);
+		if (!Deferred[i])
+			Subtrees[i]->OnAnimate(TimeMs);
+	}
+}
+
+
+//! task run on each thread of the pool
+void CSceneAnimateThreads::animateTask(void* data, u32 thread)
+{
+	static_cast<CSceneAnimateThreads*>(data)->animateSubtrees(thread);
+}
+
+
+} // end namespace scene
+} // end namespace irr
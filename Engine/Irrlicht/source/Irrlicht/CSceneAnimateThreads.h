@@ -0,0 +1,66 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_ANIMATE_THREADS_H_INCLUDED__
+#define __C_SCENE_ANIMATE_THREADS_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "irrArray.h"
+#include "CThreadPool.h"
+
+#include <atomic>
+
+namespace irr
+{
+namespace scene
+{
+	//! Animates the subtrees below a scene node on several threads.
+	/** Each child of the node is animated with its whole subtree by one
+	thread. A subtree only depends on the absolute transformation of the node
+	above it, which is updated before, so subtrees which are thread safe can
+	be animated in any order. The others are animated on the calling thread
+	once the threads are done, in the order of the children. The threads are
+	the workers of the shared CThreadPool. */
+	class CSceneAnimateThreads
+	{
+	public:
+
+		//! constructor
+		CSceneAnimateThreads(u32 threadCount, bool deterministic);
+
+		//! destructor
+		~CSceneAnimateThreads();
+
+		//! returns the number of threads animating, including the calling thread
+		u32 getThreadCount() const { return ThreadCount; }
+
+		//! calls OnAnimate() of the children and waits until all are animated
+		void animate(const core::list<ISceneNode*>& children, u32 timeMs);
+
+	private:
+
+		//! returns if a subtree can be animated on a worker thread
+		static bool isThreadSafe(const ISceneNode* node);
+
+		//! animates subtrees until there are none left
+		void animateSubtrees(u32 thread);
+
+		//! task run on each thread of the pool
+		static void animateTask(void* data, u32 thread);
+
+		CThreadPool* Pool;
+		u32 ThreadCount;
+		bool Deterministic;
+
+		core::array<ISceneNode*> Subtrees;
+		core::array<u8> Deferred;
+		u32 TimeMs;
+
+		std::atomic<u32> NextSubtree;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CSceneCollisionManager.h"
+#include "CBoundingVolumeTree.h"
 #include "ISceneNode.h"
 #include "ICameraSceneNode.h"
 #include "ITriangleSelector.h"
@@ -18,7 +19,7 @@ namespace scene
 
 //! constructor
 CSceneCollisionManager::CSceneCollisionManager(ISceneManager* smanager, video::IVideoDriver* driver)
-: SceneManager(smanager), Driver(driver)
+: SceneManager(smanager), Driver(driver), NodeTree(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CSceneCollisionManager");
@@ -37,6 +38,13 @@ CSceneCollisionManager::~CSceneCollisionManager()
 }
 
 
+//! Sets the tree of the scene nodes of the scene manager, 0 to walk through the scene.
+void CSceneCollisionManager::setBoundingVolumeTree(CBoundingVolumeTree* tree)
+{
+	NodeTree = tree;
+}
+
+
 //! Returns the scene node, which is currently visible at the given
 //! screen coordinates, viewed from the currently active camera.
 ISceneNode* CSceneCollisionManager::getSceneNodeFromScreenCoordinatesBB(
@@ -62,8 +70,16 @@ ISceneNode* CSceneCollisionManager::getSceneNodeFromRayBB(
 
 	core::line3d<f32> truncatableRay(ray);
 
-	getPickedNodeBB((root==0)?SceneManager->getRootSceneNode():root, truncatableRay,
-		idBitMask, noDebugObjects, dist, best);
+	// the tree has the nodes which registered in the last drawAll(), as they are now
+	if (NodeTree)
+		NodeTree->refresh();
+
+	if (NodeTree && NodeTree->getRoot() != -1)
+		getPickedNodeBBFromTree((root==0)?SceneManager->getRootSceneNode():root, truncatableRay,
+			idBitMask, noDebugObjects, dist, best);
+	else
+		getPickedNodeBB((root==0)?SceneManager->getRootSceneNode():root, truncatableRay,
+			idBitMask, noDebugObjects, dist, best);
 
 	return best;
 }
@@ -84,138 +100,127 @@ void CSceneCollisionManager::getPickedNodeBB(ISceneNode* root,
 
 		if (current->isVisible())
 		{
-			if((noDebugObjects ? !current->isDebugObject() : true) &&
-				(bits==0 || (bits != 0 && (current->getID() & bits))))
-			{
-				// get world to object space transform
-				core::matrix4 worldToObject;
-				if (!current->getAbsoluteTransformation().getInverse(worldToObject))
-					continue;
+			testPickedNodeBB(current, ray, rayVector, bits, noDebugObjects, outbestdistance, outbestnode);
 
-				// transform vector from world space to object space
-				core::line3df objectRay(ray);
-				worldToObject.transformVect(objectRay.start);
-				worldToObject.transformVect(objectRay.end);
+			// Only check the children if this node is visible.
+			getPickedNodeBB(current, ray, bits, noDebugObjects, outbestdistance, outbestnode);
+		}
+	}
+}
 
-				const core::aabbox3df & objectBox = current->getBoundingBox();
 
-				// Do the initial intersection test in object space, since the
-				// object space box test is more accurate.
-				if(objectBox.isPointInside(objectRay.start))
-				{
-					// use fast bbox intersection to find distance to hitpoint
-					// algorithm from Kay et al., code from gamedev.net
-					const core::vector3df dir = (objectRay.end-objectRay.start).normalize();
-					const core::vector3df minDist = (objectBox.MinEdge - objectRay.start)/dir;
-					const core::vector3df maxDist = (objectBox.MaxEdge - objectRay.start)/dir;
-					const core::vector3df realMin(core::min_(minDist.X, maxDist.X),core::min_(minDist.Y, maxDist.Y),core::min_(minDist.Z, maxDist.Z));
-					const core::vector3df realMax(core::max_(minDist.X, maxDist.X),core::max_(minDist.Y, maxDist.Y),core::max_(minDist.Z, maxDist.Z));
-
-					const f32 minmax = core::min_(realMax.X, realMax.Y, realMax.Z);
-					// nearest distance to intersection
-					const f32 maxmin = core::max_(realMin.X, realMin.Y, realMin.Z);
-
-					const f32 toIntersectionSq = (maxmin>0?maxmin*maxmin:minmax*minmax);
-					if (toIntersectionSq < outbestdistance)
-					{
-						outbestdistance = toIntersectionSq;
-						outbestnode = current;
-
-						// And we can truncate the ray to stop us hitting further nodes.
-						ray.end = ray.start + (rayVector * sqrtf(toIntersectionSq));
-					}
-				}
-				else
-				if (objectBox.intersectsWithLine(objectRay))
-				{
-					// Now transform into world space, since we need to use world space
-					// scales and distances.
-					core::aabbox3df worldBox(objectBox);
-					current->getAbsoluteTransformation().transformBox(worldBox);
-
-					core::vector3df edges[8];
-					worldBox.getEdges(edges);
-
-					/* We need to check against each of 6 faces, composed of these corners:
-						  /3--------/7
-						 /  |      / |
-						/   |     /  |
-						1---------5  |
-						|   2- - -| -6
-						|  /      |  /
-						|/        | /
-						0---------4/
-
-						Note that we define them as opposite pairs of faces.
-					*/
-					static const s32 faceEdges[6][3] =
-					{
-						{ 0, 1, 5 }, // Front
-						{ 6, 7, 3 }, // Back
-						{ 2, 3, 1 }, // Left
-						{ 4, 5, 7 }, // Right
-						{ 1, 3, 7 }, // Top
-						{ 2, 0, 4 }  // Bottom
-					};
-
-					core::vector3df intersection;
-					core::plane3df facePlane;
-					f32 bestDistToBoxBorder = FLT_MAX;
-					f32 bestToIntersectionSq = FLT_MAX;
-
-                    for(s32 face = 0; face < 6; ++face)
-					{
-						facePlane.setPlane(edges[faceEdges[face][0]],
-											edges[faceEdges[face][1]],
-											edges[faceEdges[face][2]]);
-
-						// Only consider lines that might be entering through this face, since we
-						// already know that the start point is outside the box.
-						if(facePlane.classifyPointRelation(ray.start) != core::ISREL3D_FRONT)
-							continue;
-
-						// Don't bother using a limited ray, since we already know that it should be long
-						// enough to intersect with the box.
-						if(facePlane.getIntersectionWithLine(ray.start, rayVector, intersection))
-						{
-							const f32 toIntersectionSq = ray.start.getDistanceFromSQ(intersection);
-							if(toIntersectionSq < outbestdistance)
-							{
-								// We have to check that the intersection with this plane is actually
-								// on the box, so need to go back to object space again.
-								worldToObject.transformVect(intersection);
-
-                                // find the closest point on the box borders. Have to do this as exact checks will fail due to floating point problems.
-								f32 distToBorder = core::max_ ( core::min_ (core::abs_(objectBox.MinEdge.X-intersection.X), core::abs_(objectBox.MaxEdge.X-intersection.X)),
-                                                                core::min_ (core::abs_(objectBox.MinEdge.Y-intersection.Y), core::abs_(objectBox.MaxEdge.Y-intersection.Y)),
-                                                                core::min_ (core::abs_(objectBox.MinEdge.Z-intersection.Z), core::abs_(objectBox.MaxEdge.Z-intersection.Z)) );
-                                if ( distToBorder < bestDistToBoxBorder )
-                                {
-                                    bestDistToBoxBorder = distToBorder;
-                                    bestToIntersectionSq = toIntersectionSq;
-                                }
-							}
-						}
-
-						// If the ray could be entering through the first face of a pair, then it can't
-						// also be entering through the opposite face, and so we can skip that face.
-						if (!(face & 0x01))
-							++face;
-					}
-
-					if ( bestDistToBoxBorder < FLT_MAX )
-					{
-                        outbestdistance = bestToIntersectionSq;
-						outbestnode = current;
-
-                        // If we got a hit, we can now truncate the ray to stop us hitting further nodes.
-                        ray.end = ray.start + (rayVector * sqrtf(outbestdistance));
-					}
-				}
+//! goes through the scene nodes in the tree whose boxes the ray hits
+void CSceneCollisionManager::getPickedNodeBBFromTree(ISceneNode* root,
+		core::line3df& ray, s32 bits, bool noDebugObjects,
+		f32& outbestdistance, ISceneNode*& outbestnode)
+{
+	const core::vector3df rayVector = ray.getVector().normalize();
+
+	core::array<s32> stack;
+	stack.push_back(NodeTree->getRoot());
+
+	while (stack.size())
+	{
+		const s32 index = stack.getLast();
+		stack.set_used(stack.size()-1);
+
+		// the ray gets shorter with each hit, which skips the boxes behind it
+		if (!NodeTree->getBox(index).intersectsWithLine(ray))
+			continue;
+
+		if (!NodeTree->isLeaf(index))
+		{
+			stack.push_back(NodeTree->getChild(index, 0));
+			stack.push_back(NodeTree->getChild(index, 1));
+			continue;
+		}
+
+		// the node has to be below the root, and visible like all nodes between them
+		ISceneNode* current = NodeTree->getSceneNode(index);
+		ISceneNode* node = current;
+		while (node && node != root && node->isVisible())
+			node = node->getParent();
+
+		if (node == root && current != root)
+			testPickedNodeBB(current, ray, rayVector, bits, noDebugObjects, outbestdistance, outbestnode);
+	}
+}
+
+
+//! tests the bounding box of one scene node against the ray
+void CSceneCollisionManager::testPickedNodeBB(ISceneNode* current,
+		core::line3df& ray, const core::vector3df& rayVector, s32 bits, bool noDebugObjects,
+		f32& outbestdistance, ISceneNode*& outbestnode)
+{
+	if((noDebugObjects ? !current->isDebugObject() : true) &&
+		(bits==0 || (bits != 0 && (current->getID() & bits))))
+	{
+		// get world to object space transform
+		core::matrix4 worldToObject;
+		if (!current->getAbsoluteTransformation().getInverse(worldToObject))
+			return;
+
+		// transform vector from world space to object space
+		core::line3df objectRay(ray);
+		worldToObject.transformVect(objectRay.start);
+		worldToObject.transformVect(objectRay.end);
+
+		const core::aabbox3df & objectBox = current->getBoundingBox();
+
+		// Do the initial intersection test in object space, since the
+		// object space box test is more accurate.
+		if(objectBox.isPointInside(objectRay.start))
+		{
+			// use fast bbox intersection to find distance to hitpoint
+			// algorithm from Kay et al., code from gamedev.net
+			const core::vector3df dir = (objectRay.end-objectRay.start).normalize();
+			const core::vector3df minDist = (objectBox.MinEdge - objectRay.start)/dir;
+			const core::vector3df maxDist = (objectBox.MaxEdge - objectRay.start)/dir;
+			const core::vector3df realMin(core::min_(minDist.X, maxDist.X),core::min_(minDist.Y, maxDist.Y),core::min_(minDist.Z, maxDist.Z));
+			const core::vector3df realMax(core::max_(minDist.X, maxDist.X),core::max_(minDist.Y, maxDist.Y),core::max_(minDist.Z, maxDist.Z));
+
+			const f32 minmax = core::min_(realMax.X, realMax.Y, realMax.Z);
+			// nearest distance to intersection
+			const f32 maxmin = core::max_(realMin.X, realMin.Y, realMin.Z);
+
+			const f32 toIntersectionSq = (maxmin>0?maxmin*maxmin:minmax*minmax);
+			if (toIntersectionSq < outbestdistance)
+			{
+				outbestdistance = toIntersectionSq;
+				outbestnode = current;
+
+				// And we can truncate the ray to stop us hitting further nodes.
+				// The distance is where the ray leaves the box, which must not
+				// make the ray longer and find nodes behind its end.
+				if (toIntersectionSq < ray.getLengthSQ())
+					ray.end = ray.start + (rayVector * sqrtf(toIntersectionSq));
 			}
+		}
+		else
+		if (objectBox.intersectsWithLine(objectRay))
+		{
+			// The ray enters the box where it has crossed the near side on all
+			// three axes. Its parameter along the ray is the same in world space,
+			// so it gives the world space distance without finding the face.
+			const core::vector3df dir = objectRay.end - objectRay.start;
+			f32 enter = 0.f;
+
+			if (dir.X != 0.f)
+				enter = core::max_(enter, ((dir.X > 0.f ? objectBox.MinEdge.X : objectBox.MaxEdge.X) - objectRay.start.X) / dir.X);
+			if (dir.Y != 0.f)
+				enter = core::max_(enter, ((dir.Y > 0.f ? objectBox.MinEdge.Y : objectBox.MaxEdge.Y) - objectRay.start.Y) / dir.Y);
+			if (dir.Z != 0.f)
+				enter = core::max_(enter, ((dir.Z > 0.f ? objectBox.MinEdge.Z : objectBox.MaxEdge.Z) - objectRay.start.Z) / dir.Z);
+
+			const f32 toIntersectionSq = enter * enter * ray.getLengthSQ();
+			if (toIntersectionSq < outbestdistance)
+			{
+				outbestdistance = toIntersectionSq;
+				outbestnode = current;
 
-			// Only check the children if this node is visible.
-			getPickedNodeBB(current, ray, bits, noDebugObjects, outbestdistance, outbestnode);
+				// If we got a hit, we can now truncate the ray to stop us hitting further nodes.
+				ray.end = ray.start + (ray.end - ray.start) * enter;
+			}
 		}
 	}
 }
@@ -13,6 +13,7 @@ namespace irr
 {
 namespace scene
 {
+	class CBoundingVolumeTree;
 
 	//! The Scene Collision Manager provides methods for performing collision tests and picking on scene nodes.
 	class CSceneCollisionManager : public ISceneCollisionManager
@@ -79,6 +80,8 @@ namespace scene
 								ISceneNode * collisionRootNode = 0,
 								bool noDebugObjects = false);
 
+		//! Sets the tree of the scene nodes of the scene manager, 0 to walk through the scene.
+		void setBoundingVolumeTree(CBoundingVolumeTree* tree);
 
 	private:
 
@@ -87,6 +90,16 @@ namespace scene
 					bool bNoDebugObjects,
 					f32& outbestdistance, ISceneNode*& outbestnode);
 
+		//! goes through the scene nodes in the tree whose boxes the ray hits
+		void getPickedNodeBBFromTree(ISceneNode* root, core::line3df& ray, s32 bits,
+					bool noDebugObjects,
+					f32& outbestdistance, ISceneNode*& outbestnode);
+
+		//! tests the bounding box of one scene node against the ray
+		void testPickedNodeBB(ISceneNode* current, core::line3df& ray,
+					const core::vector3df& rayVector, s32 bits, bool noDebugObjects,
+					f32& outbestdistance, ISceneNode*& outbestnode);
+
 		//! recursive method for going through all scene nodes
 		void getPickedNodeFromBBAndSelector(ISceneNode * root,
 						core::line3df & ray,
@@ -147,6 +160,7 @@ namespace scene
 
 		ISceneManager* SceneManager;
 		video::IVideoDriver* Driver;
+		CBoundingVolumeTree* NodeTree;
 		core::array<core::triangle3df> Triangles; // triangle buffer
 	};
 
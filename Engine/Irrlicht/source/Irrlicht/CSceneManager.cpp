@@ -172,6 +172,8 @@
 #include "CDefaultSceneNodeAnimatorFactory.h"
 
 #include "CGeometryCreator.h"
+#include "CSceneAnimateThreads.h"
+#include "CBoundingVolumeTree.h"
 
 namespace irr
 {
@@ -184,8 +186,8 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 		gui::IGUIEnvironment* gui)
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
 	CursorControl(cursorControl), CollisionManager(0),
-	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0),
-	MeshCache(cache), CurrentRendertime(ESNRP_NONE), LightManager(0),
+	MaterialChanges(0), TextureChanges(0), ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0),
+	MeshCache(cache), CurrentRendertime(ESNRP_NONE), LightManager(0), AnimateThreads(0), NodeTree(0),
 	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
 {
 	#ifdef _DEBUG
@@ -314,6 +316,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 //! destructor
 CSceneManager::~CSceneManager()
 {
+	delete AnimateThreads;
+	setBoundingVolumeTree(false);
+
 	clearDeletionList();
 
 	//! force to remove hardwareTextures from the driver
@@ -1144,6 +1149,43 @@ void CSceneManager::render()
 }
 
 
+//! animates the scene, the subtrees below the root on several threads if enabled
+void CSceneManager::OnAnimate(u32 timeMs)
+{
+	if (!AnimateThreads || !IsVisible)
+	{
+		ISceneNode::OnAnimate(timeMs);
+		return;
+	}
+
+	// the root, as ISceneNode::OnAnimate does
+	ISceneNodeAnimatorList::Iterator ait = Animators.begin();
+	while (ait != Animators.end())
+	{
+		ISceneNodeAnimator* anim = *ait;
+		++ait;
+		anim->animateNode(this, timeMs);
+	}
+
+	updateAbsolutePosition();
+
+	AnimateThreads->animate(Children, timeMs);
+}
+
+
+//! passes the changes of the scene nodes on to the bounding volume tree
+void CSceneManager::OnSceneNodeChanged(ISceneNode* node, bool moved)
+{
+	if (!NodeTree)
+		return;
+
+	if (moved)
+		NodeTree->noteMoved(node);
+	else
+		NodeTree->noteAdded(node);
+}
+
+
 //! returns the axis aligned bounding box of this node
 const core::aabbox3d<f32>& CSceneManager::getBoundingBox() const
 {
@@ -1181,7 +1223,20 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 
 	// can be seen by a bounding sphere
 	if (!result && (node->getAutomaticCulling() & scene::EAC_FRUSTUM_SPHERE))
-	{ // requires bbox diameter
+	{
+		core::vector3df center;
+		f32 radius;
+		CFrustumCuller::getBoundingSphere(node, center, radius);
+
+		const SViewFrustum* frust = cam->getViewFrustum();
+		for (s32 i=0; i<scene::SViewFrustum::VF_PLANE_COUNT; ++i)
+		{
+			if (frust->planes[i].getDistanceTo(center) > radius)
+			{
+				result = true;
+				break;
+			}
+		}
 	}
 
 	// can be seen by cam pyramid planes ?
@@ -1227,6 +1282,10 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 {
 	u32 taken = 0;
 
+	// the tree holds every node which registers, for culling and picking
+	if (NodeTree)
+		NodeTree->update(node);
+
 	switch(pass)
 	{
 		// take camera if it is not already registered
@@ -1263,32 +1322,127 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		taken = 1;
 		break;
 	case ESNRP_SOLID:
-		if (!isCulled(node))
+	case ESNRP_TRANSPARENT:
+	case ESNRP_TRANSPARENT_EFFECT:
+	case ESNRP_AUTOMATIC:
+		// the render queue gets the node once it is known to be visible
+		if (addToCulling(node, RenderQueueCulling))
 		{
-			SolidNodeList.push_back(node);
+			RegisteredNodes.push_back(RegisteredNode(node, pass));
 			taken = 1;
 		}
 		break;
-	case ESNRP_TRANSPARENT:
-		if (!isCulled(node))
+	case ESNRP_SHADOW:
+		if (addToCulling(node, ShadowCulling))
 		{
-			TransparentNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
+			ShadowNodeList.push_back(node);
 			taken = 1;
 		}
 		break;
-	case ESNRP_TRANSPARENT_EFFECT:
-		if (!isCulled(node))
+
+	case ESNRP_NONE: // ignore this one
+		break;
+	}
+
+#ifdef _IRR_SCENEMANAGER_DEBUG
+	s32 index = Parameters.findAttribute ( "calls" );
+	Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
+
+	if (!taken)
+	{
+		index = Parameters.findAttribute ( "culled" );
+		Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
+	}
+#endif
+
+	return taken;
+}
+
+
+//! adds a node to the batch culled after all nodes registered
+bool CSceneManager::addToCulling(const ISceneNode* node, CFrustumCuller& culler)
+{
+	u32 culling = 0;
+
+	// the same tests as isCulled(), the occlusion query is asked at once
+	if (getActiveCamera())
+	{
+		culling = node->getAutomaticCulling();
+
+		if ((culling & scene::EAC_OCC_QUERY) &&
+			Driver->getOcclusionQueryResult(const_cast<ISceneNode*>(node))==0)
+			return false;
+	}
+
+	culling &= scene::EAC_BOX | scene::EAC_FRUSTUM_BOX | scene::EAC_FRUSTUM_SPHERE;
+
+	// the tree culls whole groups of nodes, and drops the tests which can't cull the node
+	if (culling && NodeTree && !NodeTree->getCulling(node, culling))
+		return false;
+
+	culler.add(node, culling);
+	return true;
+}
+
+
+//! culls the registered nodes, puts the visible ones into the render queue
+//! and removes the culled ones from the shadow list
+void CSceneManager::cullRegisteredNodes()
+{
+	const ICameraSceneNode* cam = getActiveCamera();
+	u32 culled = 0;
+	u32 i;
+	u32 used;
+
+	if (cam)
+	{
+		const SViewFrustum& frustum = *cam->getViewFrustum();
+		culled += RenderQueueCulling.cull(frustum);
+		culled += ShadowCulling.cull(frustum);
+
+		for (i=0, used=0; i<ShadowNodeList.size(); ++i)
 		{
-			TransparentEffectNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
-			taken = 1;
+			if (ShadowCulling.isVisible(i))
+				ShadowNodeList[used++] = ShadowNodeList[i];
 		}
+		ShadowNodeList.set_used(used);
+	}
+
+	for (i=0; i<RegisteredNodes.size(); ++i)
+	{
+		if (!cam || RenderQueueCulling.isVisible(i))
+			addToRenderQueue(RegisteredNodes[i].Node, RegisteredNodes[i].Pass);
+	}
+
+	RegisteredNodes.set_used(0);
+	RenderQueueCulling.clear();
+	ShadowCulling.clear();
+
+#ifdef _IRR_SCENEMANAGER_DEBUG
+	s32 index = Parameters.findAttribute ( "culled" );
+	Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + (s32) culled );
+#endif
+}
+
+
+//! adds a visible node to the render queue
+void CSceneManager::addToRenderQueue(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass)
+{
+	switch(pass)
+	{
+	case ESNRP_SOLID:
+		RenderQueue.push_back(RenderQueueEntry(node, ERQP_SOLID, camWorldPos));
 		break;
-	case ESNRP_AUTOMATIC:
-		if (!isCulled(node))
+	case ESNRP_TRANSPARENT:
+		RenderQueue.push_back(RenderQueueEntry(node, ERQP_TRANSPARENT, camWorldPos));
+		break;
+	case ESNRP_TRANSPARENT_EFFECT:
+		RenderQueue.push_back(RenderQueueEntry(node, ERQP_TRANSPARENT_EFFECT, camWorldPos));
+		break;
+	default:
 		{
 			const u32 count = node->getMaterialCount();
 
-			taken = 0;
 			for (u32 i=0; i<count; ++i)
 			{
 				video::IMaterialRenderer* rnd =
@@ -1296,45 +1450,132 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 				if (rnd && rnd->isTransparent())
 				{
 					// register as transparent node
-					TransparentNodeEntry e(node, camWorldPos);
-					TransparentNodeList.push_back(e);
-					taken = 1;
-					break;
+					RenderQueue.push_back(RenderQueueEntry(node, ERQP_TRANSPARENT, camWorldPos));
+					return;
 				}
 			}
 
 			// not transparent, register as solid
-			if (!taken)
-			{
-				SolidNodeList.push_back(node);
-				taken = 1;
-			}
+			RenderQueue.push_back(RenderQueueEntry(node, ERQP_SOLID, camWorldPos));
 		}
 		break;
-	case ESNRP_SHADOW:
-		if (!isCulled(node))
+	}
+}
+
+
+//! builds the sort key of a node in the render queue
+CSceneManager::RenderQueueEntry::RenderQueueEntry(ISceneNode* n, E_RENDER_QUEUE_PASS pass,
+		const core::vector3df& camera)
+	: Node(n), Key((u64) pass << 62), State(0)
+{
+	if (n->getMaterialCount())
+	{
+		const video::SMaterial& material = n->getMaterial(0);
+
+		// 36 bits of the texture layers, 0 without textures
+		u64 textures = 0;
+		for (u32 i=0; i<video::MATERIAL_MAX_TEXTURES; ++i)
+			textures = (textures ^ (u64) (size_t) material.getTexture(i)) * 0x9E3779B97F4A7C15ULL;
+
+		State = ((u64) core::min_((u32) material.MaterialType, 1023u) << 36) | (textures >> 28);
+	}
+
+	// the bits of a positive float sort like the float
+	f32 distance = (f32) n->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
+
+	if (ERQP_SOLID == pass)
+		Key |= (State << 16) | (IR(distance) >> 16);
+	else
+		Key |= ~IR(distance);
+}
+
+
+//! sorts the render queue by key, nodes with the same key keep their order
+void CSceneManager::sortRenderQueue()
+{
+	const u32 size = RenderQueue.size();
+
+	if (size < 2)
+		return;
+
+	// count the bytes of all keys at once
+	u32 count[8][256];
+	memset(count, 0, sizeof(count));
+
+	u32 i;
+	u32 b;
+	for (i=0; i<size; ++i)
+	{
+		const u64 key = RenderQueue[i].Key;
+		for (b=0; b<8; ++b)
+			++count[b][(key >> (b * 8)) & 0xFF];
+	}
+
+	RenderQueueSorted.set_used(size);
+
+	RenderQueueEntry* source = RenderQueue.pointer();
+	RenderQueueEntry* dest = RenderQueueSorted.pointer();
+
+	// least significant byte first, skipping bytes all keys share
+	for (b=0; b<8; ++b)
+	{
+		u32* c = count[b];
+		if (c[(source[0].Key >> (b * 8)) & 0xFF] == size)
+			continue;
+
+		u32 offset = 0;
+		for (i=0; i<256; ++i)
 		{
-			ShadowNodeList.push_back(node);
-			taken = 1;
+			const u32 n = c[i];
+			c[i] = offset;
+			offset += n;
 		}
-		break;
 
-	case ESNRP_NONE: // ignore this one
-		break;
+		for (i=0; i<size; ++i)
+			dest[c[(source[i].Key >> (b * 8)) & 0xFF]++] = source[i];
+
+		core::swap(source, dest);
 	}
 
-#ifdef _IRR_SCENEMANAGER_DEBUG
-	s32 index = Parameters.findAttribute ( "calls" );
-	Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
+	if (source != RenderQueue.pointer())
+		RenderQueue.swap(RenderQueueSorted);
+}
 
-	if (!taken)
+
+//! renders the nodes of a pass from the render queue, starting at first
+u32 CSceneManager::renderQueuePass(u32 first, E_RENDER_QUEUE_PASS pass)
+{
+	u32 i;
+	u32 last = first;
+	while (last < RenderQueue.size() && RenderQueue[last].getPass() == pass)
+		++last;
+
+	if (LightManager)
 	{
-		index = Parameters.findAttribute ( "culled" );
-		Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
+		for (i=first; i<last; ++i)
+		{
+			ISceneNode* node = RenderQueue[i].Node;
+			LightManager->OnNodePreRender(node);
+			node->render();
+			LightManager->OnNodePostRender(node);
+		}
+	}
+	else
+	{
+		for (i=first; i<last; ++i)
+			RenderQueue[i].Node->render();
 	}
-#endif
 
-	return taken;
+	// states of the first material changed between the nodes
+	for (i=first+1; i<last; ++i)
+	{
+		const u64 a = RenderQueue[i-1].State;
+		const u64 b = RenderQueue[i].State;
+		MaterialChanges += (a >> 36) != (b >> 36);
+		TextureChanges += (a & 0xFFFFFFFFFULL) != (b & 0xFFFFFFFFFULL);
+	}
+
+	return last;
 }
 
 
@@ -1353,8 +1594,12 @@ void CSceneManager::drawAll()
 	Parameters.setAttribute ( "drawn_transparent", 0 );
 	Parameters.setAttribute ( "drawn_transparent_effect", 0 );
 #endif
+	MaterialChanges = 0;
+	TextureChanges = 0;
 
 	u32 i; // new ISO for scoping problem in some compilers
+	u32 first;
+	u32 next;
 
 	// reset all transforms
 	Driver->setMaterial(video::SMaterial());
@@ -1381,9 +1626,20 @@ void CSceneManager::drawAll()
 		camWorldPos = ActiveCamera->getAbsolutePosition();
 	}
 
+	// cull the tree of the nodes, before they register again
+	if (NodeTree)
+		NodeTree->cull(ActiveCamera ? ActiveCamera->getViewFrustum() : 0);
+
 	// let all nodes register themselves
 	OnRegisterSceneNode();
 
+	// cull the registered nodes at once
+	cullRegisteredNodes();
+
+	// release the nodes which left the scene or were hidden
+	if (NodeTree)
+		NodeTree->removeUnused();
+
 	if (LightManager)
 		LightManager->OnPreRender(LightList);
 
@@ -1482,29 +1738,17 @@ void CSceneManager::drawAll()
 		CurrentRendertime = ESNRP_SOLID;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRendertime) != 0);
 
-		SolidNodeList.sort(); // sort by textures
+		// sort the nodes of all queued passes at once, by pass and then by their key
+		sortRenderQueue();
 
 		if (LightManager)
-		{
 			LightManager->OnRenderPassPreRender(CurrentRendertime);
-			for (i=0; i<SolidNodeList.size(); ++i)
-			{
-				ISceneNode* node = SolidNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
-				node->render();
-				LightManager->OnNodePostRender(node);
-			}
-		}
-		else
-		{
-			for (i=0; i<SolidNodeList.size(); ++i)
-				SolidNodeList[i].Node->render();
-		}
+
+		next = renderQueuePass(0, ERQP_SOLID);
 
 #ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters.setAttribute("drawn_solid", (s32) SolidNodeList.size() );
+		Parameters.setAttribute("drawn_solid", (s32) next );
 #endif
-		SolidNodeList.set_used(0);
 
 		if (LightManager)
 			LightManager->OnRenderPassPostRender(CurrentRendertime);
@@ -1537,6 +1781,7 @@ void CSceneManager::drawAll()
 				ShadowColor, ShadowColor);
 
 		ShadowNodeList.set_used(0);
+		ShadowCulling.clear();
 
 		if (LightManager)
 			LightManager->OnRenderPassPostRender(CurrentRendertime);
@@ -1547,29 +1792,15 @@ void CSceneManager::drawAll()
 		CurrentRendertime = ESNRP_TRANSPARENT;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRendertime) != 0);
 
-		TransparentNodeList.sort(); // sort by distance from camera
 		if (LightManager)
-		{
 			LightManager->OnRenderPassPreRender(CurrentRendertime);
 
-			for (i=0; i<TransparentNodeList.size(); ++i)
-			{
-				ISceneNode* node = TransparentNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
-				node->render();
-				LightManager->OnNodePostRender(node);
-			}
-		}
-		else
-		{
-			for (i=0; i<TransparentNodeList.size(); ++i)
-				TransparentNodeList[i].Node->render();
-		}
+		first = next;
+		next = renderQueuePass(first, ERQP_TRANSPARENT);
 
 #ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters.setAttribute ( "drawn_transparent", (s32) TransparentNodeList.size() );
+		Parameters.setAttribute ( "drawn_transparent", (s32) (next - first) );
 #endif
-		TransparentNodeList.set_used(0);
 
 		if (LightManager)
 			LightManager->OnRenderPassPostRender(CurrentRendertime);
@@ -1580,31 +1811,25 @@ void CSceneManager::drawAll()
 		CurrentRendertime = ESNRP_TRANSPARENT_EFFECT;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRendertime) != 0);
 
-		TransparentEffectNodeList.sort(); // sort by distance from camera
-
 		if (LightManager)
-		{
 			LightManager->OnRenderPassPreRender(CurrentRendertime);
 
-			for (i=0; i<TransparentEffectNodeList.size(); ++i)
-			{
-				ISceneNode* node = TransparentEffectNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
-				node->render();
-				LightManager->OnNodePostRender(node);
-			}
-		}
-		else
-		{
-			for (i=0; i<TransparentEffectNodeList.size(); ++i)
-				TransparentEffectNodeList[i].Node->render();
-		}
+		first = next;
+		next = renderQueuePass(first, ERQP_TRANSPARENT_EFFECT);
+
 #ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters.setAttribute ( "drawn_transparent_effect", (s32) TransparentEffectNodeList.size() );
+		Parameters.setAttribute ( "drawn_transparent_effect", (s32) (next - first) );
 #endif
-		TransparentEffectNodeList.set_used(0);
+		RenderQueue.set_used(0);
+		RegisteredNodes.set_used(0);
+		RenderQueueCulling.clear();
 	}
 
+#ifdef _IRR_SCENEMANAGER_DEBUG
+	Parameters.setAttribute ( "state_changes_material", (s32) MaterialChanges );
+	Parameters.setAttribute ( "state_changes_texture", (s32) TextureChanges );
+#endif
+
 	if (LightManager)
 		LightManager->OnPostRender();
 
@@ -1625,6 +1850,45 @@ void CSceneManager::setLightManager(ILightManager* lightManager)
 }
 
 
+//! Set how many threads animate the scene in drawAll().
+void CSceneManager::setAnimateThreads(u32 threads, bool deterministic)
+{
+	delete AnimateThreads;
+	AnimateThreads = 0;
+
+	if (threads > 1)
+		AnimateThreads = new CSceneAnimateThreads(threads, deterministic);
+}
+
+
+//! Get the number of threads which animate the scene, including the calling thread.
+u32 CSceneManager::getAnimateThreads() const
+{
+	return AnimateThreads ? AnimateThreads->getThreadCount() : 1;
+}
+
+
+//! Set if the scene manager keeps a bounding volume tree of the scene nodes.
+void CSceneManager::setBoundingVolumeTree(bool enable)
+{
+	if (enable == (NodeTree != 0))
+		return;
+
+	delete NodeTree;
+	NodeTree = enable ? new CBoundingVolumeTree(this) : 0;
+
+	if (CollisionManager)
+		CollisionManager->setBoundingVolumeTree(NodeTree);
+}
+
+
+//! Get if the scene manager keeps a bounding volume tree of the scene nodes.
+bool CSceneManager::isBoundingVolumeTreeEnabled() const
+{
+	return NodeTree != 0;
+}
+
+
 //! Sets the color of stencil buffers shadows drawn by the scene manager.
 void CSceneManager::setShadowColor(video::SColor color)
 {
@@ -1988,6 +2252,9 @@ bool CSceneManager::postEventFromUser(const SEvent& event)
 //! Removes all children of this scene node
 void CSceneManager::removeAll()
 {
+	if (NodeTree)
+		NodeTree->clear();
+
 	ISceneNode::removeAll();
 	setActiveCamera(0);
 	// Make sure the driver is reset, might need a more complex method at some point
@@ -2438,6 +2705,7 @@ void CSceneManager::deserializeAttributes(io::IAttributes* in, io::SAttributeRea
 	DebugDataVisible = scene::EDS_OFF;
 	IsDebugObject = false;
 
+	setAbsoluteTransformationDirty();
 	updateAbsolutePosition();
 }
 
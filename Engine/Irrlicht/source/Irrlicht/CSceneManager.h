@@ -13,6 +13,7 @@
 #include "IMeshLoader.h"
 #include "CAttributes.h"
 #include "ILightManager.h"
+#include "CFrustumCuller.h"
 
 namespace irr
 {
@@ -25,6 +26,9 @@ namespace scene
 {
 	class IMeshCache;
 	class IGeometryCreator;
+	class CSceneAnimateThreads;
+	class CSceneCollisionManager;
+	class CBoundingVolumeTree;
 
 	/*!
 		The Scene Manager manages scene nodes, mesh recources, cameras and all the other stuff.
@@ -104,6 +108,12 @@ namespace scene
 		//! renders the node.
 		virtual void render();
 
+		//! animates the scene, the subtrees below the root on several threads if enabled
+		virtual void OnAnimate(u32 timeMs);
+
+		//! passes the changes of the scene nodes on to the bounding volume tree
+		virtual void OnSceneNodeChanged(ISceneNode* node, bool moved);
+
 		//! returns the axis aligned bounding box of this node
 		virtual const core::aabbox3d<f32>& getBoundingBox() const;
 
@@ -521,6 +531,18 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const;
 
+		//! Set how many threads animate the scene in drawAll().
+		virtual void setAnimateThreads(u32 threads, bool deterministic=false);
+
+		//! Get the number of threads which animate the scene, including the calling thread.
+		virtual u32 getAnimateThreads() const;
+
+		//! Set if the scene manager keeps a bounding volume tree of the scene nodes.
+		virtual void setBoundingVolumeTree(bool enable);
+
+		//! Get if the scene manager keeps a bounding volume tree of the scene nodes.
+		virtual bool isBoundingVolumeTreeEnabled() const;
+
 	private:
 
 		//! clears the deletion list
@@ -529,44 +551,57 @@ namespace scene
 		//! writes a scene node
 		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, const fschar_t* currentPath=0, bool init=false);
 
-		struct DefaultNodeEntry
+		//! the render passes which are drawn from the render queue, in drawing order
+		enum E_RENDER_QUEUE_PASS
 		{
-			DefaultNodeEntry(ISceneNode* n) :
-				Node(n), TextureValue(0)
-			{
-				if (n->getMaterialCount())
-					TextureValue = (n->getMaterial(0).getTexture(0));
-			}
-
-			bool operator < (const DefaultNodeEntry& other) const
-			{
-				return (TextureValue < other.TextureValue);
-			}
-
-			ISceneNode* Node;
-			private:
-			void* TextureValue;
+			ERQP_SOLID = 0,
+			ERQP_TRANSPARENT,
+			ERQP_TRANSPARENT_EFFECT
 		};
 
-		//! sort on distance (center) to camera
-		struct TransparentNodeEntry
+		//! a node in the render queue, drawn in the order of its key
+		/** Solid nodes are keyed by pass, material renderer, textures and then front to back
+		distance (center) to camera, so nodes sharing the same states are drawn in a row.
+		Transparent nodes are keyed by pass and then back to front distance only. */
+		struct RenderQueueEntry
 		{
-			TransparentNodeEntry(ISceneNode* n, const core::vector3df& camera)
-				: Node(n)
-			{
-				Distance = Node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
-			}
+			RenderQueueEntry() : Node(0), Key(0), State(0) {}
 
-			bool operator < (const TransparentNodeEntry& other) const
+			RenderQueueEntry(ISceneNode* n, E_RENDER_QUEUE_PASS pass, const core::vector3df& camera);
+
+			//! returns the pass of the node
+			E_RENDER_QUEUE_PASS getPass() const
 			{
-				return Distance > other.Distance;
+				return (E_RENDER_QUEUE_PASS) (Key >> 62);
 			}
 
 			ISceneNode* Node;
-			private:
-				f64 Distance;
+
+			//! sort key
+			u64 Key;
+
+			//! material renderer and textures of the first material
+			u64 State;
 		};
 
+		//! adds a node to the batch culled after all nodes registered
+		//! \return false if the node is culled already by its occlusion query
+		bool addToCulling(const ISceneNode* node, CFrustumCuller& culler);
+
+		//! culls the registered nodes, puts the visible ones into the render queue
+		//! and removes the culled ones from the shadow list
+		void cullRegisteredNodes();
+
+		//! adds a visible node to the render queue
+		void addToRenderQueue(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass);
+
+		//! sorts the render queue by key, nodes with the same key keep their order
+		void sortRenderQueue();
+
+		//! renders the nodes of a pass from the render queue, starting at first
+		//! \return the first node of the next pass
+		u32 renderQueuePass(u32 first, E_RENDER_QUEUE_PASS pass);
+
 		//! sort on distance (sphere) to camera
 		struct DistanceNodeEntry
 		{
@@ -606,16 +641,37 @@ namespace scene
 		gui::ICursorControl* CursorControl;
 
 		//! collision manager
-		ISceneCollisionManager* CollisionManager;
+		CSceneCollisionManager* CollisionManager;
 
 		//! render pass lists
 		core::array<ISceneNode*> CameraList;
 		core::array<ISceneNode*> LightList;
 		core::array<ISceneNode*> ShadowNodeList;
 		core::array<ISceneNode*> SkyBoxList;
-		core::array<DefaultNodeEntry> SolidNodeList;
-		core::array<TransparentNodeEntry> TransparentNodeList;
-		core::array<TransparentNodeEntry> TransparentEffectNodeList;
+		core::array<RenderQueueEntry> RenderQueue;
+
+		//! the other buffer of the radix sort
+		core::array<RenderQueueEntry> RenderQueueSorted;
+
+		//! a node registered for the render queue, which is not culled yet
+		struct RegisteredNode
+		{
+			RegisteredNode(ISceneNode* n, E_SCENE_NODE_RENDER_PASS pass)
+				: Node(n), Pass(pass) {}
+
+			ISceneNode* Node;
+			E_SCENE_NODE_RENDER_PASS Pass;
+		};
+
+		core::array<RegisteredNode> RegisteredNodes;
+
+		//! bounds of the registered nodes and the shadow list, in the same order
+		CFrustumCuller RenderQueueCulling;
+		CFrustumCuller ShadowCulling;
+
+		//! state changes between the nodes drawn from the render queue this frame
+		u32 MaterialChanges;
+		u32 TextureChanges;
 
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneLoader*> SceneLoaderList;
@@ -643,6 +699,12 @@ namespace scene
 		//! over the scene lighting and rendering.
 		ILightManager* LightManager;
 
+		//! animates the scene on several threads, 0 if animating on the calling thread
+		CSceneAnimateThreads* AnimateThreads;
+
+		//! tree of the nodes which registered for rendering, 0 if there is none
+		CBoundingVolumeTree* NodeTree;
+
 		//! constants for reading and writing XML.
 		//! Not made static due to portability problems.
 		const core::stringw IRR_XML_FORMAT_SCENE;
@@ -938,6 +938,13 @@ IImage* CSoftwareDriver::createScreenShot(video::ECOLOR_FORMAT format, video::E_
 }
 
 
+//! Returns the image the frame is rendered into
+IImage* CSoftwareDriver::getBackBuffer() const
+{
+	return BackBuffer;
+}
+
+
 //! Returns the maximum amount of primitives (mostly vertices) which
 //! the device is able to render with one drawIndexedTriangleList
 //! call.
@@ -14,6 +14,10 @@
 #include "S4DVertex.h"
 #include "CBlit.h"
 
+#if defined ( SOFTWARE_DRIVER_2_SSE )
+#include <xmmintrin.h>
+#endif
+
 
 #define MAT_TEXTURE(tex) ( (video::CSoftwareTexture2*) Material.org.getTexture ( tex ) )
 
@@ -336,7 +340,11 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 : CNullDriver(io, params.WindowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), StencilBuffer ( 0 ),
+	CurrentShaderType(ETR_INVALID), TileRasterizer(0),
+	 DepthBuffer(0), StencilBuffer ( 0 ), StencilRect ( 0, 0, 0, 0 ),
+	VertexBatch(0), VertexBatching(params.SoftwareVertexBatch),
+	SpanISA(params.SoftwareSpanKernels ? getBurningSpanISASupported() : EBSI_SCALAR),
+	TiledTextures(params.SoftwareTiledTextures),
 	 CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 )
 {
 	#ifdef _DEBUG
@@ -358,6 +366,12 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 			StencilBuffer = video::createStencilBuffer(BackBuffer->getDimension());
 	}
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	// keep the farthest depth of the depth buffer tiles
+	if ( DepthBuffer )
+		((CDepthBuffer*) DepthBuffer)->setTilesEnabled ( params.SoftwareHierarchicalDepth );
+#endif
+
 	DriverAttributes->setAttribute("MaxTextures", 2);
 	DriverAttributes->setAttribute("MaxIndices", 1<<16);
 	DriverAttributes->setAttribute("MaxTextureSize", 1024);
@@ -368,36 +382,12 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 	// create triangle renderers
 
 	irr::memset32 ( BurningShader, 0, sizeof ( BurningShader ) );
-	//BurningShader[ETR_FLAT] = createTRFlat2(DepthBuffer);
-	//BurningShader[ETR_FLAT_WIRE] = createTRFlatWire2(DepthBuffer);
-	BurningShader[ETR_GOURAUD] = createTriangleRendererGouraud2(this);
-	BurningShader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(this );
-	BurningShader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(this );
-	//BurningShader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M1] = createTriangleRendererTextureLightMap2_M1(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(this);
-
-	BurningShader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( this );
-
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(this );
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( this );
-
-	BurningShader[ETR_NORMAL_MAP_SOLID] = createTRNormalMap ( this );
-	BurningShader[ETR_STENCIL_SHADOW] = createTRStencilShadow ( this );
-	BurningShader[ETR_TEXTURE_BLEND] = createTRTextureBlend( this );
-
-	BurningShader[ETR_REFERENCE] = createTriangleRendererReference ( this );
+	for ( u32 i = 0; i != ETR2_COUNT; ++i )
+		BurningShader[i] = createBurningShader ( (EBurningFFShader) i, this );
+
+	// rasterize screen tiles on worker threads
+	if ( params.SoftwareRasterThreads > 1 )
+		TileRasterizer = new CBurningTileRasterizer ( this, params.SoftwareRasterThreads );
 
 
 	// add the same renderer for all solid types
@@ -453,7 +443,10 @@ CBurningVideoDriver::~CBurningVideoDriver()
 	if (BackBuffer)
 		BackBuffer->drop();
 
+	delete VertexBatch;
+
 	// delete triangle renderers
+	delete TileRasterizer;
 
 	for (s32 i=0; i<ETR2_COUNT; ++i)
 	{
@@ -583,25 +576,73 @@ void CBurningVideoDriver::setCurrentShader()
 	//shader = ETR_REFERENCE;
 
 	// switchToTriangleRenderer
+	CurrentShaderType = shader;
 	CurrentShader = BurningShader[shader];
 	if ( CurrentShader )
+		setShaderState ( CurrentShader, shader );
+
+}
+
+
+/*!
+	returns if a triangle renderer draws no pixel that fails a greater equal depth test.
+	its triangles and spans behind the depth buffer tiles can be skipped.
+*/
+static bool isDepthRejectable ( EBurningFFShader type )
+{
+	switch ( type )
 	{
-		CurrentShader->setZCompareFunc ( Material.org.ZBuffer );
-		CurrentShader->setRenderTarget(RenderTargetSurface, ViewPort);
-		CurrentShader->setMaterial ( Material );
+		case ETR_GOURAUD:
+		case ETR_TEXTURE_GOURAUD:
+		case ETR_TEXTURE_GOURAUD_WIRE:
+		case ETR_TEXTURE_GOURAUD_ADD:
+		case ETR_TEXTURE_GOURAUD_ADD_NO_Z:
+		case ETR_TEXTURE_GOURAUD_VERTEX_ALPHA:
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M1:
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M2:
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M4:
+		case ETR_TEXTURE_LIGHTMAP_M4:
+		case ETR_TEXTURE_GOURAUD_DETAIL_MAP:
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD:
+		case ETR_GOURAUD_ALPHA:
+		case ETR_TEXTURE_GOURAUD_ALPHA:
+		case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
+		case ETR_NORMAL_MAP_SOLID:
+		// tests greater equal or equal, or draws nothing
+		case ETR_TEXTURE_BLEND:
+			return true;
+		default:
+			return false;
+	}
+}
 
-		switch ( shader )
-		{
-			case ETR_TEXTURE_GOURAUD_ALPHA:
-			case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
-			case ETR_TEXTURE_BLEND:
-				CurrentShader->setParam ( 0, Material.org.MaterialTypeParam );
-				break;
-			default:
+
+/*!
+	passes the render states of the current material to a triangle renderer.
+*/
+void CBurningVideoDriver::setShaderState(IBurningShader* shader, EBurningFFShader type)
+{
+	shader->setZCompareFunc ( Material.org.ZBuffer );
+	shader->setRenderTarget(RenderTargetSurface, ViewPort);
+	shader->setMaterial ( Material );
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	shader->setDepthReject ( getDepthTiles () && isDepthRejectable ( type ) );
+#endif
+
+	switch ( type )
+	{
+		case ETR_TEXTURE_GOURAUD_ALPHA:
+		case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
+		case ETR_TEXTURE_BLEND:
+			shader->setParam ( 0, Material.org.MaterialTypeParam );
 			break;
-		}
+		case ETR_STENCIL_SHADOW:
+			// shadow volumes are drawn with both faces in one pass
+			shader->setParam ( 1, 3 );
+			break;
+		default:
+		break;
 	}
-
 }
 
 
@@ -1195,8 +1236,19 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 	const S3DVertex *base = ((S3DVertex*) source );
 	Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
 
-	//mhm ;-) maybe no goto
-	if ( VertexCache.vType == 4 ) goto clipandproject;
+	if ( VertexCache.vType != 4 )
+		VertexCache_fillAttributes ( dest, source );
+
+	VertexCache_clipAndProject ( dest );
+}
+
+
+/*!
+	light and texture the transformed vertex
+*/
+void CBurningVideoDriver::VertexCache_fillAttributes ( s4DVertex *dest, const u8 *source )
+{
+	const S3DVertex *base = ((S3DVertex*) source );
 
 
 #if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
@@ -1455,8 +1507,14 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 
 
 #endif
+}
+
 
-clipandproject:
+/*!
+	clip test the transformed vertex, and project it if it is inside
+*/
+void CBurningVideoDriver::VertexCache_clipAndProject ( s4DVertex *dest )
+{
 	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
 
 	// test vertex
@@ -1467,10 +1525,203 @@ clipandproject:
 	{
 		ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
 	}
+}
+
+
+/*!
+	transform, light and clip test every vertex of the draw call at once.
+	the same math as VertexCache_fill, done four vertices at a time.
+*/
+void CBurningVideoDriver::VertexBatch_fill ()
+{
+	const u32 count = VertexCache.vertexCount;
+
+	// two s4DVertex for each vertex, clip space and projected
+	if ( 0 == VertexBatch || VertexBatch->ElementSize < count * 2 )
+	{
+		const u32 size = core::max_ ( count * 2, VertexBatch ? VertexBatch->ElementSize * 2 : 0 );
+		delete VertexBatch;
+		VertexBatch = new SAlignedVertex ( size, 128 );
+	}
+
+	const u32 pitch = vSize[VertexCache.vType].Pitch;
+	const u8 * source = (const u8*) VertexCache.vertices;
+	s4DVertex * dest = VertexBatch->data;
+	u32 i = 0;
+
+#if defined ( SOFTWARE_DRIVER_2_SSE )
+	const f32 * M = Transformation [ ETS_CURRENT ].pointer();
+	const f32 * clipScale = Transformation [ ETS_CLIPSCALE ].pointer();
+
+	__m128 row[16];
+	for ( u32 g = 0; g != 16; ++g )
+		row[g] = _mm_set1_ps ( M[g] );
+
+	const __m128 scaleX = _mm_set1_ps ( clipScale[ 0] );
+	const __m128 scaleY = _mm_set1_ps ( clipScale[ 5] );
+	const __m128 offsetX = _mm_set1_ps ( clipScale[12] );
+	const __m128 offsetY = _mm_set1_ps ( clipScale[13] );
+	const __m128 one = _mm_set1_ps ( 1.f );
+	const __m128 sign = _mm_set1_ps ( -0.f );
+
+	for ( ; i + 4 <= count; i += 4, source += pitch * 4, dest += 8 )
+	{
+		const core::vector3df * p0 = (const core::vector3df*) ( source );
+		const core::vector3df * p1 = (const core::vector3df*) ( source + pitch );
+		const core::vector3df * p2 = (const core::vector3df*) ( source + pitch * 2 );
+		const core::vector3df * p3 = (const core::vector3df*) ( source + pitch * 3 );
+
+		const __m128 x = _mm_setr_ps ( p0->X, p1->X, p2->X, p3->X );
+		const __m128 y = _mm_setr_ps ( p0->Y, p1->Y, p2->Y, p3->Y );
+		const __m128 z = _mm_setr_ps ( p0->Z, p1->Z, p2->Z, p3->Z );
+
+		// transform Model * World * Camera * Projection * NDCSpace matrix
+		// summed in the same order as matrix4::transformVect
+		__m128 pos[4];
+		for ( u32 g = 0; g != 4; ++g )
+		{
+			pos[g] = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+						_mm_mul_ps ( x, row[g] ),
+						_mm_mul_ps ( y, row[g + 4] ) ),
+						_mm_mul_ps ( z, row[g + 8] ) ),
+						row[g + 12] );
+		}
+
+		// clip test, one bit per vertex for each plane
+		const __m128 w = pos[3];
+		const __m128 negW = _mm_xor_ps ( w, sign );
+		const u32 plane[6] =
+		{
+			(u32) _mm_movemask_ps ( _mm_cmple_ps ( pos[2], w ) ),
+			(u32) _mm_movemask_ps ( _mm_cmpge_ps ( pos[2], negW ) ),
+			(u32) _mm_movemask_ps ( _mm_cmple_ps ( pos[0], w ) ),
+			(u32) _mm_movemask_ps ( _mm_cmpge_ps ( pos[0], negW ) ),
+			(u32) _mm_movemask_ps ( _mm_cmple_ps ( pos[1], w ) ),
+			(u32) _mm_movemask_ps ( _mm_cmpge_ps ( pos[1], negW ) )
+		};
+
+		// to device coordinates, project homogenous vertex, store 1/w
+		const __m128 iw = _mm_div_ps ( one, w );
+		__m128 dc[4];
+		dc[0] = _mm_mul_ps ( iw, _mm_add_ps ( _mm_mul_ps ( pos[0], scaleX ), _mm_mul_ps ( w, offsetX ) ) );
+		dc[1] = _mm_mul_ps ( iw, _mm_add_ps ( _mm_mul_ps ( pos[1], scaleY ), _mm_mul_ps ( w, offsetY ) ) );
+		dc[2] = _mm_mul_ps ( pos[2], iw );
+		dc[3] = iw;
+
+		_MM_TRANSPOSE4_PS ( pos[0], pos[1], pos[2], pos[3] );
+		_MM_TRANSPOSE4_PS ( dc[0], dc[1], dc[2], dc[3] );
+
+		for ( u32 g = 0; g != 4; ++g )
+		{
+			s4DVertex * v = dest + ( g << 1 );
+
+			_mm_storeu_ps ( &v->Pos.x, pos[g] );
+
+			if ( VertexCache.vType != 4 )
+				VertexCache_fillAttributes ( v, source + pitch * g );
+
+			v[0].flag = v[1].flag = vSize[VertexCache.vType].Format;
+			for ( u32 p = 0; p != 6; ++p )
+				v[0].flag |= ( ( plane[p] >> g ) & 1 ) << p;
+
+			if ( (v[0].flag & VERTEX4D_CLIPMASK ) != VERTEX4D_INSIDE )
+				continue;
+
+			v[1].flag = v[0].flag | VERTEX4D_PROJECTED;
+			_mm_storeu_ps ( &v[1].Pos.x, dc[g] );
+
+		#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
+			#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+				v[1].Color[0] = v[0].Color[0] * v[1].Pos.w;
+			#else
+				v[1].Color[0] = v[0].Color[0];
+			#endif
+		#endif
+
+			v[1].LightTangent[0] = v[0].LightTangent[0] * v[1].Pos.w;
+		}
+	}
+#endif
+
+	// the rest one at a time
+	for ( ; i < count; ++i, source += pitch, dest += 2 )
+	{
+		Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, ((const S3DVertex*) source)->Pos );
 
-	//return dest;
+		if ( VertexCache.vType != 4 )
+			VertexCache_fillAttributes ( dest, source );
+
+		VertexCache_clipAndProject ( dest );
+	}
+}
+
+
+/*!
+	assemble the next primitive from the vertex batch
+*/
+REALINLINE void CBurningVideoDriver::VertexBatch_get ( const s4DVertex ** face )
+{
+	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
+	u32 index[3];
+
+	switch ( VertexCache.iType )
+	{
+		case 1:
+		{
+			const u16 *p = (const u16 *) VertexCache.indices;
+			index[0] = p[ i0    ];
+			index[1] = p[ VertexCache.indicesRun + 1];
+			index[2] = p[ VertexCache.indicesRun + 2];
+		}
+		break;
+
+		case 2:
+		{
+			const u32 *p = (const u32 *) VertexCache.indices;
+			index[0] = p[ i0    ];
+			index[1] = p[ VertexCache.indicesRun + 1];
+			index[2] = p[ VertexCache.indicesRun + 2];
+		}
+		break;
+
+		case 4:
+			index[0] = VertexCache.indicesRun + 0;
+			index[1] = VertexCache.indicesRun + 1;
+			index[2] = VertexCache.indicesRun + 2;
+		break;
+		default:
+			index[0] = index[1] = index[2] = VertexCache.indicesRun + 0;
+		break;
+	}
+
+	face[0] = (s4DVertex *) ( (u8*) VertexBatch->data + ( index[0] << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) );
+	face[1] = (s4DVertex *) ( (u8*) VertexBatch->data + ( index[1] << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) );
+	face[2] = (s4DVertex *) ( (u8*) VertexBatch->data + ( index[2] << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) );
+
+	VertexCache.indicesRun += VertexCache.primitivePitch;
 }
 
+/*!
+	returns the vertex of the vertex batch at position indexRun of the index list.
+	without an index list the vertices are taken in order.
+*/
+REALINLINE s4DVertex * CBurningVideoDriver::VertexBatch_getIndexed ( const u32 indexRun ) const
+{
+	u32 index = indexRun;
+
+	if ( VertexCache.indices )
+	{
+		switch ( VertexCache.iType )
+		{
+			case 1: index = ( (const u16 *) VertexCache.indices ) [ indexRun ]; break;
+			case 2: index = ( (const u32 *) VertexCache.indices ) [ indexRun ]; break;
+		}
+	}
+
+	return (s4DVertex *) ( (u8*) VertexBatch->data + ( index << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) );
+}
+
+
 //
 
 REALINLINE s4DVertex * CBurningVideoDriver::VertexCache_getVertex ( const u32 sourceIndex )
@@ -1733,6 +1984,29 @@ void CBurningVideoDriver::VertexCache_reset ( const void* vertices, u32 vertexCo
 }
 
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+/*!
+	returns true if no pixel of a projected triangle can pass the depth test, so it can
+	be skipped. else the depth tiles it covers are marked as written.
+*/
+static inline bool depthTileTest ( CDepthBuffer* depth, bool reject,
+				const s4DVertex* a, const s4DVertex* b, const s4DVertex* c )
+{
+	const s32 x0 = core::floor32 ( core::min_ ( a->Pos.x, b->Pos.x, c->Pos.x ) );
+	const s32 y0 = core::floor32 ( core::min_ ( a->Pos.y, b->Pos.y, c->Pos.y ) );
+	const s32 x1 = core::ceil32 ( core::max_ ( a->Pos.x, b->Pos.x, c->Pos.x ) );
+	const s32 y1 = core::ceil32 ( core::max_ ( a->Pos.y, b->Pos.y, c->Pos.y ) );
+
+	// the depth of every pixel lies between the depth of the corners
+	if ( reject && depth->isOccluded ( x0, y0, x1, y1, core::max_ ( a->Pos.w, b->Pos.w, c->Pos.w ) ) )
+		return true;
+
+	depth->markWritten ( x0, y0, x1, y1 );
+	return false;
+}
+#endif
+
+
 void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
@@ -1743,18 +2017,74 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
 
-	// These calls would lead to crashes due to wrong index usage.
-	// The vertex cache needs to be rewritten for these primitives.
-	if (pType==scene::EPT_POINTS || pType==scene::EPT_LINE_STRIP ||
-		pType==scene::EPT_LINE_LOOP || pType==scene::EPT_LINES || pType==scene::EPT_POLYGON ||
-		pType==scene::EPT_POINT_SPRITES)
-		return;
+	// a polygon is drawn as the triangle fan of its vertices
+	if ( pType == scene::EPT_POLYGON )
+	{
+		if ( primitiveCount < 3 )
+			return;
+
+		pType = scene::EPT_TRIANGLE_FAN;
+		primitiveCount -= 2;
+	}
+
+	// points and lines take their vertices from the vertex batch, the vertex cache
+	// only assembles triangles
+	switch ( pType )
+	{
+		case scene::EPT_POINTS:
+		case scene::EPT_POINT_SPRITES:
+			VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
+			VertexBatch_fill ();
+			drawPointList ( primitiveCount, pType == scene::EPT_POINT_SPRITES );
+			return;
+
+		case scene::EPT_LINES:
+		case scene::EPT_LINE_STRIP:
+		case scene::EPT_LINE_LOOP:
+			VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
+			VertexBatch_fill ();
+			drawLineList ( primitiveCount );
+			return;
+
+		default:
+			break;
+	}
 
 	if ( 0 == CurrentShader )
 		return;
 
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	// the tiles drawn to since the last rejecting draw call are read again, after that
+	// the depth in the buffer only grows while this draw call is rasterized
+	CDepthBuffer* depthTiles = getDepthTiles ();
+	const bool depthReject = depthTiles && isDepthRejectable ( CurrentShaderType );
+	if ( depthReject )
+		depthTiles->updateTiles ();
+#endif
+
+	// big draw calls that use most of their vertices transform them all at once
+	const bool batched = VertexBatching &&
+		vertexCount >= SOFTWARE_DRIVER_2_BATCH_MIN_VERTICES &&
+		vertexCount <= VertexCache.indexCount;
+
+	if ( batched )
+		VertexBatch_fill ();
+
+	// big enough draw calls are collected into screen tiles and rasterized on all threads
+	const bool tiled = TileRasterizer &&
+		primitiveCount >= SOFTWARE_DRIVER_2_TILE_MIN_TRIANGLES &&
+		TileRasterizer->canRasterize ( CurrentShaderType );
+
+	if ( tiled )
+	{
+		for ( u32 t = 0; t != TileRasterizer->getThreadCount(); ++t )
+			setShaderState ( TileRasterizer->getShader ( t, CurrentShaderType ), CurrentShaderType );
+
+		TileRasterizer->begin ( CurrentShaderType, vSize[VertexCache.vType].TexSize, RenderTargetSize.Height );
+	}
+
 	const s4DVertex * face[3];
 
 	f32 dc_area;
@@ -1766,7 +2096,10 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 	for ( i = 0; i < (u32) primitiveCount; ++i )
 	{
-		VertexCache_get(face);
+		if ( batched )
+			VertexBatch_get ( face );
+		else
+			VertexCache_get(face);
 
 		// if fully outside or outside on same side
 		if ( ( (face[0]->flag | face[1]->flag | face[2]->flag) & VERTEX4D_CLIPMASK )
@@ -1784,6 +2117,11 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			if ( Material.org.FrontfaceCulling && F32_GREATER_EQUAL_0( dc_area ) )
 				continue;
 
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+			if ( depthTiles && depthTileTest ( depthTiles, depthReject, face[0] + 1, face[1] + 1, face[2] + 1 ) )
+				continue;
+#endif
+
 			// select mipmap
 			dc_area = core::reciprocal ( dc_area );
 			for ( m = 0; m != vSize[VertexCache.vType].TexSize; ++m )
@@ -1799,8 +2137,14 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 				select_polygon_mipmap2 ( (s4DVertex**) face, m, tex->getSize() );
 			}
 
+			if ( ETR_STENCIL_SHADOW == CurrentShaderType )
+				StencilRect_add ( face[0] + 1, face[1] + 1, face[2] + 1 );
+
 			// rasterize
-			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			if ( tiled )
+				TileRasterizer->addTriangle ( face[0] + 1, face[1] + 1, face[2] + 1, CurrentShader );
+			else
+				CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
 			continue;
 		}
 
@@ -1878,14 +2222,32 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		// re-tesselate ( triangle-fan, 0-1-2,0-2-3.. )
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+			if ( depthTiles && depthTileTest ( depthTiles, depthReject, CurrentOut.data + 0 + 1,
+							CurrentOut.data + g + 3, CurrentOut.data + g + 5 ) )
+				continue;
+#endif
+
+			if ( ETR_STENCIL_SHADOW == CurrentShaderType )
+				StencilRect_add ( CurrentOut.data + 0 + 1, CurrentOut.data + g + 3, CurrentOut.data + g + 5 );
+
 			// rasterize
-			CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
+			if ( tiled )
+				TileRasterizer->addTriangle ( CurrentOut.data + 0 + 1,
+							CurrentOut.data + g + 3,
+							CurrentOut.data + g + 5,
+							CurrentShader );
+			else
+				CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
 							CurrentOut.data + g + 3,
 							CurrentOut.data + g + 5);
 		}
 
 	}
 
+	if ( tiled )
+		TileRasterizer->flush ();
+
 	// dump statistics
 /*
 	char buf [64];
@@ -1899,6 +2261,224 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 }
 
 
+/*!
+	draws every vertex as a square of Material.Thickness pixels with the shader of the
+	material, as two triangles. point sprites get texture coordinates from 0 to 1 across
+	the square, points keep the ones of their vertex. a point is dropped when its center
+	is outside the frustum, the square is cut at the viewport.
+*/
+void CBurningVideoDriver::drawPointList ( const u32 primitiveCount, const bool sprites )
+{
+	if ( 0 == CurrentShader )
+		return;
+
+	// sizes are rounded like aliased points
+	const s32 size = core::s32_max ( core::round32 ( Material.org.Thickness ), 1 );
+	const f32 half = (f32) size * 0.5f;
+	const f32 invSize = core::reciprocal ( (f32) size );
+
+	// every square has the same texel to pixel ratio, so one mipmap level fits all
+	core::dimension2du texSize[BURNING_MATERIAL_MAX_TEXTURES];
+	video::CSoftwareTexture2* tex;
+	u32 m;
+
+	for ( m = 0; m != vSize[VertexCache.vType].TexSize; ++m )
+	{
+		if ( 0 == (tex = MAT_TEXTURE ( m )) )
+		{
+			CurrentShader->setTextureParam(m, 0, 0);
+			continue;
+		}
+
+		const s32 lodLevel = sprites ? s32_log2_f32 ( tex->getLODFactor ( 1.f ) * invSize * invSize ) : 0;
+		CurrentShader->setTextureParam(m, tex, lodLevel );
+		texSize[m] = tex->getSize();
+	}
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	CDepthBuffer* depthTiles = getDepthTiles ();
+#endif
+
+	// big enough lists are collected into screen tiles and rasterized on all threads
+	const bool tiled = TileRasterizer &&
+		primitiveCount * 2 >= SOFTWARE_DRIVER_2_TILE_MIN_TRIANGLES &&
+		TileRasterizer->canRasterize ( CurrentShaderType );
+
+	if ( tiled )
+	{
+		for ( u32 t = 0; t != TileRasterizer->getThreadCount(); ++t )
+			setShaderState ( TileRasterizer->getShader ( t, CurrentShaderType ), CurrentShaderType );
+
+		TileRasterizer->begin ( CurrentShaderType, vSize[VertexCache.vType].TexSize, RenderTargetSize.Height );
+	}
+
+	// the four corners, clip space and projected
+	s4DVertex * q = CurrentOut.data;
+	s4DVertex * face[3];
+	u32 g;
+
+	for ( u32 i = 0; i != primitiveCount; ++i )
+	{
+		const s4DVertex * v = VertexBatch_getIndexed ( i );
+
+		if ( ( v->flag & VERTEX4D_CLIPMASK ) != VERTEX4D_INSIDE )
+			continue;
+
+		const s32 x0 = core::round32 ( v[1].Pos.x - half );
+		const s32 y0 = core::round32 ( v[1].Pos.y - half );
+
+		const s32 left = core::s32_max ( x0, ViewPort.UpperLeftCorner.X );
+		const s32 top = core::s32_max ( y0, ViewPort.UpperLeftCorner.Y );
+		const s32 right = core::s32_min ( x0 + size, ViewPort.LowerRightCorner.X );
+		const s32 bottom = core::s32_min ( y0 + size, ViewPort.LowerRightCorner.Y );
+
+		if ( left >= right || top >= bottom )
+			continue;
+
+		const s32 corner[4][2] = { { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+
+		for ( g = 0; g != 4; ++g )
+		{
+			s4DVertex * d = q + ( g << 1 );
+			irr::memcpy32_small ( d, v, SIZEOF_SVERTEX * 2 );
+
+			d[1].Pos.x = (f32) corner[g][0];
+			d[1].Pos.y = (f32) corner[g][1];
+
+			if ( sprites )
+			{
+				d[0].Tex[0].x = (f32) ( corner[g][0] - x0 ) * invSize;
+				d[0].Tex[0].y = (f32) ( corner[g][1] - y0 ) * invSize;
+			}
+		}
+
+		for ( m = 0; m != vSize[VertexCache.vType].TexSize; ++m )
+		{
+			if ( 0 == MAT_TEXTURE ( m ) )
+				continue;
+
+			face[0] = q; face[1] = q + 2; face[2] = q + 4;
+			select_polygon_mipmap2 ( face, m, texSize[m] );
+			face[1] = q + 6;
+			select_polygon_mipmap2 ( face, m, texSize[m] );
+		}
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		if ( depthTiles )
+			depthTileTest ( depthTiles, false, q + 1, q + 3, q + 5 );
+#endif
+
+		// rasterize
+		if ( tiled )
+		{
+			TileRasterizer->addTriangle ( q + 1, q + 3, q + 5, CurrentShader );
+			TileRasterizer->addTriangle ( q + 1, q + 5, q + 7, CurrentShader );
+		}
+		else
+		{
+			CurrentShader->drawTriangle ( q + 1, q + 3, q + 5 );
+			CurrentShader->drawTriangle ( q + 1, q + 5, q + 7 );
+		}
+	}
+
+	if ( tiled )
+		TileRasterizer->flush ();
+}
+
+/*!
+	draws a list, strip or loop of lines with the wire shader, like draw3DLine. lines
+	crossing the frustum are clipped.
+*/
+void CBurningVideoDriver::drawLineList ( const u32 primitiveCount )
+{
+	IBurningShader * line = BurningShader [ ETR_TEXTURE_GOURAUD_WIRE ];
+	if ( 0 == line )
+		return;
+
+	line->setRenderTarget(RenderTargetSurface, ViewPort);
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	CDepthBuffer* depthTiles = getDepthTiles ();
+#endif
+
+	const s4DVertex * a;
+	const s4DVertex * b;
+	u32 g;
+	u32 vOut;
+
+	for ( u32 i = 0; i != primitiveCount; ++i )
+	{
+		switch ( VertexCache.pType )
+		{
+			case scene::EPT_LINES:
+				a = VertexBatch_getIndexed ( i * 2 );
+				b = VertexBatch_getIndexed ( i * 2 + 1 );
+				break;
+
+			case scene::EPT_LINE_LOOP:
+				// primitiveCount is the number of vertices, the last line closes the loop
+				a = VertexBatch_getIndexed ( i );
+				b = VertexBatch_getIndexed ( i + 1 != primitiveCount ? i + 1 : 0 );
+				break;
+
+			default:
+				a = VertexBatch_getIndexed ( i );
+				b = VertexBatch_getIndexed ( i + 1 );
+				break;
+		}
+
+		// if fully outside or outside on same side
+		if ( ( (a->flag | b->flag) & VERTEX4D_CLIPMASK ) != VERTEX4D_INSIDE )
+			continue;
+
+		irr::memcpy32_small ( ( (u8*) CurrentOut.data + ( 0 << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) ), a, SIZEOF_SVERTEX * 2 );
+		irr::memcpy32_small ( ( (u8*) CurrentOut.data + ( 1 << ( SIZEOF_SVERTEX_LOG2 + 1 ) ) ), b, SIZEOF_SVERTEX * 2 );
+		vOut = 4;
+
+		// if not complete inside clipping necessary
+		if ( ( a->flag & b->flag & VERTEX4D_CLIPMASK ) != VERTEX4D_INSIDE )
+		{
+			const u32 flag = CurrentOut.data->flag & VERTEX4D_FORMAT_MASK;
+
+			for ( g = 0; g != CurrentOut.ElementSize; ++g )
+			{
+				CurrentOut.data[g].flag = flag;
+				Temp.data[g].flag = flag;
+			}
+
+			// vertices count per line
+			vOut = clipToFrustum ( CurrentOut.data, Temp.data, 2 );
+			if ( vOut < 2 )
+				continue;
+
+			vOut <<= 1;
+
+			// to DC Space, project homogenous vertex
+			ndc_2_dc_and_project ( CurrentOut.data + 1, CurrentOut.data, vOut );
+		}
+
+		// unproject vertex color
+#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
+		for ( g = 0; g != vOut; g += 2 )
+		{
+			CurrentOut.data[ g + 1].Color[0] = CurrentOut.data[ g ].Color[0];
+		}
+#endif
+
+		for ( g = 0; g <= vOut - 4; g += 2 )
+		{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+			if ( depthTiles )
+				depthTileTest ( depthTiles, false, CurrentOut.data + 1, CurrentOut.data + 1, CurrentOut.data + g + 3 );
+#endif
+
+			// rasterize
+			line->drawLine ( CurrentOut.data + 1, CurrentOut.data + g + 3 );
+		}
+	}
+}
+
+
 //! Sets the dynamic ambient light color. The default color is
 //! (0,0,0,0) which means it is dark.
 //! \param color: New color of the ambient light.
@@ -2489,6 +3069,11 @@ void CBurningVideoDriver::draw3DLine(const core::vector3df& start,
 
 	for ( g = 0; g <= vOut - 4; g += 2 )
 	{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		if ( CDepthBuffer* depthTiles = getDepthTiles () )
+			depthTileTest ( depthTiles, false, CurrentOut.data + 1, CurrentOut.data + 1, CurrentOut.data + g + 3 );
+#endif
+
 		// rasterize
 		line->drawLine ( CurrentOut.data + 1, CurrentOut.data + g + 3 );
 	}
@@ -2576,6 +3161,13 @@ IImage* CBurningVideoDriver::createScreenShot(video::ECOLOR_FORMAT format, video
 }
 
 
+//! Returns the image the frame is rendered into
+IImage* CBurningVideoDriver::getBackBuffer() const
+{
+	return BackBuffer;
+}
+
+
 //! returns a device dependent texture from a software surface (IImage)
 //! THIS METHOD HAS TO BE OVERRIDDEN BY DERIVED DRIVERS WITH OWN TEXTURES
 ITexture* CBurningVideoDriver::createDeviceDependentTexture(IImage* surface, const io::path& name, void* mipmapData)
@@ -2583,7 +3175,8 @@ ITexture* CBurningVideoDriver::createDeviceDependentTexture(IImage* surface, con
 	return new CSoftwareTexture2(
 		surface, name,
 		(getTextureCreationFlag(ETCF_CREATE_MIP_MAPS) ? CSoftwareTexture2::GEN_MIPMAP : 0 ) |
-		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE ), mipmapData);
+		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE ) |
+		(TiledTextures ? CSoftwareTexture2::TILED : 0 ), mipmapData);
 
 }
 
@@ -2606,6 +3199,7 @@ void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector
 	IBurningShader *shader = BurningShader [ ETR_STENCIL_SHADOW ];
 
 	CurrentShader = shader;
+	CurrentShaderType = ETR_STENCIL_SHADOW;
 	shader->setRenderTarget(RenderTargetSurface, ViewPort);
 
 	Material.org.MaterialType = video::EMT_SOLID;
@@ -2619,22 +3213,16 @@ void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector
 
 	if (true)// zpass does not work yet
 	{
-		Material.org.BackfaceCulling = true;
-		Material.org.FrontfaceCulling = false;
-		shader->setParam ( 0, 0 );
-		shader->setParam ( 1, 1 );
-		shader->setParam ( 2, 0 );
-		drawVertexPrimitiveList (triangles.const_pointer(), count, 0, count/3, (video::E_VERTEX_TYPE) 4, scene::EPT_TRIANGLES, (video::E_INDEX_TYPE) 4 );
-		//glStencilOp(GL_KEEP, incr, GL_KEEP);
-		//glDrawArrays(GL_TRIANGLES,0,count);
-
+		// two sided, the front faces increment and the back faces decrement. the volume is
+		// transformed once, the sum does not depend on the order so it is rasterized in tiles
 		Material.org.BackfaceCulling = false;
-		Material.org.FrontfaceCulling = true;
+		Material.org.FrontfaceCulling = false;
 		shader->setParam ( 0, 0 );
-		shader->setParam ( 1, 2 );
+		shader->setParam ( 1, 3 );
 		shader->setParam ( 2, 0 );
 		drawVertexPrimitiveList (triangles.const_pointer(), count, 0, count/3, (video::E_VERTEX_TYPE) 4, scene::EPT_TRIANGLES, (video::E_INDEX_TYPE) 4 );
-		//glStencilOp(GL_KEEP, decr, GL_KEEP);
+		//glStencilOpSeparate(GL_FRONT, GL_KEEP, incr, GL_KEEP);
+		//glStencilOpSeparate(GL_BACK, GL_KEEP, decr, GL_KEEP);
 		//glDrawArrays(GL_TRIANGLES,0,count);
 	}
 	else // zpass
@@ -2665,28 +3253,62 @@ void CBurningVideoDriver::drawStencilShadow(bool clearStencilBuffer, video::SCol
 {
 	if (!StencilBuffer)
 		return;
-	// draw a shadow rectangle covering the entire screen using stencil buffer
-	const u32 h = RenderTargetSurface->getDimension().Height;
+	// draw a shadow rectangle covering the part of the screen the shadow volumes were drawn to,
+	// the stencil buffer outside of it is still clear
 	const u32 w = RenderTargetSurface->getDimension().Width;
+	const s32 x0 = core::s32_max ( StencilRect.UpperLeftCorner.X, 0 );
+	const s32 y0 = core::s32_max ( StencilRect.UpperLeftCorner.Y, 0 );
+	const s32 x1 = core::s32_min ( StencilRect.LowerRightCorner.X, (s32) w );
+	const s32 y1 = core::s32_min ( StencilRect.LowerRightCorner.Y, (s32) RenderTargetSurface->getDimension().Height );
+
+	StencilRect = core::rect<s32> ( 0, 0, 0, 0 );
+
+	if ( x0 >= x1 || y0 >= y1 )
+		return;
+
 	tVideoSample *dst;
 	u32 *stencil;
 	u32* const stencilBase=(u32*) StencilBuffer->lock();
 
-	for ( u32 y = 0; y < h; ++y )
+	for ( s32 y = y0; y < y1; ++y )
 	{
 		dst = (tVideoSample*)RenderTargetSurface->lock() + ( y * w );
 		stencil =  stencilBase + ( y * w );
 
-		for ( u32 x = 0; x < w; ++x )
+		for ( s32 x = x0; x < x1; ++x )
 		{
 			if ( stencil[x] > 1 )
 			{
 				dst[x] = PixelBlend32 ( dst[x], leftUpEdge.color );
 			}
 		}
+
+		// clear
+		memset ( stencil + x0, 0, ( x1 - x0 ) * sizeof ( u32 ) );
+	}
+}
+
+
+/*!
+	grows the stencil rectangle by the pixels a shadow volume triangle can cover.
+*/
+void CBurningVideoDriver::StencilRect_add ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c )
+{
+	const core::position2d<s32> upperLeft (
+		core::floor32 ( core::min_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ),
+		core::floor32 ( core::min_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ) );
+	const core::position2d<s32> lowerRight (
+		core::ceil32 ( core::max_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ) + 1,
+		core::ceil32 ( core::max_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ) + 1 );
+
+	if ( 0 == StencilRect.getArea () )
+	{
+		StencilRect = core::rect<s32> ( upperLeft, lowerRight );
+		return;
 	}
 
-	StencilBuffer->clear();
+	StencilRect.addInternalPoint ( upperLeft );
+	StencilRect.addInternalPoint ( lowerRight );
 }
 
 
@@ -7,6 +7,7 @@
 
 #include "SoftwareDriver2_compile_config.h"
 #include "IBurningShader.h"
+#include "CBurningTileRasterizer.h"
 #include "CNullDriver.h"
 #include "CImage.h"
 #include "os.h"
@@ -138,6 +139,9 @@ namespace video
 		//! Returns an image created from the last rendered frame.
 		virtual IImage* createScreenShot(video::ECOLOR_FORMAT format=video::ECF_UNKNOWN, video::E_RENDER_TARGET target=video::ERT_FRAME_BUFFER);
 
+		//! Returns the image the frame is rendered into
+		virtual IImage* getBackBuffer() const;
+
 		//! Returns the maximum amount of primitives (mostly vertices) which
 		//! the device is able to render with one drawIndexedTriangleList
 		//! call.
@@ -164,6 +168,9 @@ namespace video
 		virtual core::dimension2du getMaxTextureSize() const;
 
 		virtual IDepthBuffer * getDepthBuffer () { return DepthBuffer; }
+
+		//! returns the instruction set the shaders draw their spans with
+		E_BURNING_SPAN_ISA getSpanISA () const { return SpanISA; }
 		virtual IStencilBuffer * getStencilBuffer () { return StencilBuffer; }
 
 	protected:
@@ -192,12 +199,32 @@ namespace video
 		//! selects the right triangle renderer based on the render states.
 		void setCurrentShader();
 
+		//! passes the render states of the current material to a triangle renderer.
+		void setShaderState(IBurningShader* shader, EBurningFFShader type);
+
 		IBurningShader* CurrentShader;
+		EBurningFFShader CurrentShaderType;
 		IBurningShader* BurningShader[ETR2_COUNT];
 
+		//! rasterizes draw calls on several threads, 0 if rasterizing on the calling thread
+		CBurningTileRasterizer* TileRasterizer;
+
 		IDepthBuffer* DepthBuffer;
 		IStencilBuffer* StencilBuffer;
 
+		//! the part of the stencil buffer written by shadow volumes since the last drawStencilShadow
+		core::rect<s32> StencilRect;
+		void StencilRect_add ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c );
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		//! returns the depth buffer if it keeps the farthest depth of its tiles, else 0
+		CDepthBuffer* getDepthTiles () const
+		{
+			CDepthBuffer* depth = (CDepthBuffer*) DepthBuffer;
+			return depth && depth->getTilesEnabled () ? depth : 0;
+		}
+#endif
+
 
 		/*
 			extend Matrix Stack
@@ -242,8 +269,28 @@ namespace video
 		void VertexCache_getbypass ( s4DVertex ** face );
 
 		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_fillAttributes ( s4DVertex *dest, const u8 *source );
+		void VertexCache_clipAndProject ( s4DVertex *dest );
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
+		// Vertex Batch, the whole vertex buffer of a draw call transformed at once
+		SAlignedVertex* VertexBatch;
+		bool VertexBatching;
+
+		void VertexBatch_fill ();
+		void VertexBatch_get ( const s4DVertex ** face );
+		s4DVertex * VertexBatch_getIndexed ( const u32 indexRun ) const;
+
+		// points, point sprites and lines, drawn from the vertex batch
+		void drawPointList ( const u32 primitiveCount, const bool sprites );
+		void drawLineList ( const u32 primitiveCount );
+
+		// span kernels the shaders use
+		E_BURNING_SPAN_ISA SpanISA;
+
+		// new textures get a tiled copy for the shaders
+		bool TiledTextures;
+
 
 		// culling & clipping
 		u32 clipToHyperPlane ( s4DVertex * dest, const s4DVertex * source, u32 inCount, const sVec4 &plane );
@@ -10,15 +10,143 @@
 #include "CSoftwareTexture2.h"
 #include "os.h"
 
+#ifdef SOFTWARE_DRIVER_2_MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace video
 {
 
+//! true if both sides are a power of two
+static inline bool isPowerOfTwo ( const core::dimension2d<u32>& size )
+{
+	return ( size.Width & ( size.Width - 1 ) ) == 0 && ( size.Height & ( size.Height - 1 ) ) == 0;
+}
+
+// the sums of the four channels of the texels under a texel of a mip level
+
+#ifdef SOFTWARE_DRIVER_2_MIPMAP_SSE2
+
+typedef __m128i tMipSum;
+
+static inline tMipSum mipSum ( const u32 texel )
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	return _mm_unpacklo_epi16 ( _mm_unpacklo_epi8 ( _mm_cvtsi32_si128 ( texel ), zero ), zero );
+}
+
+static inline tMipSum mipSum ( const u32* sum )
+{
+	return _mm_loadu_si128 ( (const __m128i*) sum );
+}
+
+static inline tMipSum mipAdd ( const tMipSum a, const tMipSum b )
+{
+	return _mm_add_epi32 ( a, b );
+}
+
+static inline void mipStore ( u32* sum, const tMipSum s )
+{
+	_mm_storeu_si128 ( (__m128i*) sum, s );
+}
+
+static inline u32 mipTexel ( const tMipSum s, const u32 shift )
+{
+	const __m128i c = _mm_srl_epi32 ( s, _mm_cvtsi32_si128 ( shift ) );
+	const __m128i w = _mm_packs_epi32 ( c, c );
+	return _mm_cvtsi128_si32 ( _mm_packus_epi16 ( w, w ) );
+}
+
+#else
+
+struct tMipSum
+{
+	u32 c[4];
+};
+
+static inline tMipSum mipSum ( const u32 texel )
+{
+	tMipSum s;
+	for ( u32 i = 0; i != 4; ++i )
+		s.c[i] = ( texel >> ( i << 3 ) ) & 0xFF;
+	return s;
+}
+
+static inline tMipSum mipSum ( const u32* sum )
+{
+	tMipSum s;
+	for ( u32 i = 0; i != 4; ++i )
+		s.c[i] = sum[i];
+	return s;
+}
+
+static inline tMipSum mipAdd ( const tMipSum& a, const tMipSum& b )
+{
+	tMipSum s;
+	for ( u32 i = 0; i != 4; ++i )
+		s.c[i] = a.c[i] + b.c[i];
+	return s;
+}
+
+static inline void mipStore ( u32* sum, const tMipSum& s )
+{
+	for ( u32 i = 0; i != 4; ++i )
+		sum[i] = s.c[i];
+}
+
+static inline u32 mipTexel ( const tMipSum& s, const u32 shift )
+{
+	u32 texel = 0;
+	for ( u32 i = 0; i != 4; ++i )
+		texel |= ( s.c[i] >> shift ) << ( i << 3 );
+	return texel;
+}
+
+#endif
+
+//! the sums under texel o of the level above, from its texels or from its sums
+template <bool fromTexels>
+static inline tMipSum mipLoad ( const u32* src, const u32 o )
+{
+	return fromTexels ? mipSum ( src[o] ) : mipSum ( src + ( o << 2 ) );
+}
+
+//! sums the 2x2 texels of the level above under each texel and stores the sums and
+//! their average. dx and dy are 0 for a side of the level above which is one texel
+template <bool fromTexels>
+static void filterMipMapLevel ( u32* dst, u32* sum, const core::dimension2d<u32>& size,
+							const u32* src, const u32 srcWidth, const u32 dx, const u32 dy, const u32 shift )
+{
+	for ( u32 y = 0; y != size.Height; ++y )
+	{
+		const u32 row = ( y << dy ) * srcWidth;
+
+		for ( u32 x = 0; x != size.Width; ++x )
+		{
+			const u32 o = row + ( x << dx );
+
+			tMipSum s = mipLoad<fromTexels> ( src, o );
+			if ( dx )
+				s = mipAdd ( s, mipLoad<fromTexels> ( src, o + 1 ) );
+			if ( dy )
+			{
+				s = mipAdd ( s, mipLoad<fromTexels> ( src, o + srcWidth ) );
+				if ( dx )
+					s = mipAdd ( s, mipLoad<fromTexels> ( src, o + srcWidth + 1 ) );
+			}
+
+			mipStore ( sum + ( ( y * size.Width + x ) << 2 ), s );
+			dst [ y * size.Width + x ] = mipTexel ( s, shift );
+		}
+	}
+}
+
 //! constructor
 CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 		u32 flags, void* mipmapData)
-		: ITexture(name), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
+		: ITexture(name), MipMapLOD(0), Flags ( flags ), LockMode(ETLM_READ_WRITE), OriginalFormat(video::ECF_UNKNOWN)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture2");
@@ -29,6 +157,7 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 	#endif
 
 	memset32 ( MipMap, 0, sizeof ( MipMap ) );
+	memset32 ( Tiled, 0, sizeof ( Tiled ) );
 
 	if (image)
 	{
@@ -81,6 +210,7 @@ CSoftwareTexture2::~CSoftwareTexture2()
 	{
 		if ( MipMap[i] )
 			MipMap[i]->drop();
+		delete [] Tiled[i];
 	}
 }
 
@@ -90,7 +220,10 @@ CSoftwareTexture2::~CSoftwareTexture2()
 void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 {
 	if ( !hasMipMaps () )
+	{
+		tileMipMapLevel ( 0 );
 		return;
+	}
 
 	s32 i;
 
@@ -99,11 +232,18 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 	{
 		if ( MipMap[i] )
 			MipMap[i]->drop();
+		delete [] Tiled[i];
+		Tiled[i] = 0;
 	}
 
 	core::dimension2d<u32> newSize;
 	core::dimension2d<u32> origSize=OrigSize;
 
+	// levels which halve a power of two texture are all box filtered in one pass
+	// from the sums of the level above
+	const bool boxFilter = !mipmapData && SOFTWARE_DRIVER_2_MIPMAPPING_SCALE == 1 &&
+			BURNINGSHADER_COLOR_FORMAT == ECF_A8R8G8B8 && isPowerOfTwo ( MipMap[0]->getDimension() );
+
 	for (i=1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
 	{
 		newSize = MipMap[i-1]->getDimension();
@@ -142,11 +282,91 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 		{
 			MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
 
-			//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
-			MipMap[i]->fill ( 0 );
-			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+			if ( !boxFilter )
+			{
+				//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
+				MipMap[i]->fill ( 0 );
+				MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+			}
 		}
 	}
+
+	if ( boxFilter )
+		filterMipMapLevels ();
+
+	for ( i = 0; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+		tileMipMapLevel ( i );
+}
+
+
+//! box filters the mip levels from the sums of the texels of the level above.
+/** The sums are exact, so each texel is the truncated average of all texels of
+level 0 under it, the same as when it is scaled down from level 0 on its own. */
+void CSoftwareTexture2::filterMipMapLevels()
+{
+	core::array<u32> sums[2];
+	u32 shift = 0;
+
+	for ( u32 i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+	{
+		const core::dimension2d<u32>& size = MipMap[i]->getDimension();
+		const core::dimension2d<u32>& srcSize = MipMap[i-1]->getDimension();
+
+		// a side which is one texel already is not halved
+		const u32 dx = srcSize.Width != size.Width ? 1 : 0;
+		const u32 dy = srcSize.Height != size.Height ? 1 : 0;
+		shift += dx + dy;
+
+		core::array<u32>& sum = sums[i & 1];
+		sum.set_used ( size.getArea() * 4 );
+
+		u32* dst = (u32*) MipMap[i]->lock();
+		if ( i == 1 )
+			filterMipMapLevel<true> ( dst, sum.pointer(), size, (const u32*) MipMap[0]->lock(),
+				srcSize.Width, dx, dy, shift );
+		else
+			filterMipMapLevel<false> ( dst, sum.pointer(), size, sums[( i - 1 ) & 1].const_pointer(),
+				srcSize.Width, dx, dy, shift );
+		MipMap[i]->unlock();
+	}
+}
+
+
+//! copies the texels of a mip level into its tiles
+void CSoftwareTexture2::tileMipMapLevel(u32 level)
+{
+	CImage* image = MipMap[level];
+
+	if ( !image || !( Flags & TILED ) || ( Flags & IS_RENDERTARGET ) || !isPowerOfTwo ( image->getDimension() ) )
+		return;
+
+	const u32 side = 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2;
+	const core::dimension2d<u32>& size = image->getDimension();
+	const u32 bytes = image->getBytesPerPixel();
+
+	// a level less than a tile high still takes a whole row of tiles
+	const u32 tiledBytes = size.Width * core::s32_max ( size.Height, side ) * bytes;
+
+	if ( !Tiled[level] )
+	{
+		Tiled[level] = new u8 [ tiledBytes ];
+		memset ( Tiled[level], 0, tiledBytes );
+	}
+
+	const u8* src = (const u8*) image->lock();
+
+	// the texels of a column of a tile follow each other, the columns of a row of
+	// tiles follow each other, see getTexelOffset
+	for ( u32 y = 0; y != size.Height; ++y )
+	{
+		const u8* row = src + y * image->getPitch();
+		u8* dst = Tiled[level] + ( ( ( y & ~( side - 1 ) ) * size.Width + ( y & ( side - 1 ) ) ) * bytes );
+
+		for ( u32 x = 0; x != size.Width; ++x )
+			memcpy ( dst + ( ( x * side ) * bytes ), row + x * bytes, bytes );
+	}
+
+	image->unlock();
 }
 
 
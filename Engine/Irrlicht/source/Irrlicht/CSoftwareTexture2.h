@@ -28,7 +28,8 @@ public:
 		GEN_MIPMAP	= 1,
 		IS_RENDERTARGET	= 2,
 		NP2_SIZE	= 4,
-		HAS_ALPHA	= 8
+		HAS_ALPHA	= 8,
+		TILED		= 16
 	};
 	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags, void* mipmapData=0);
 
@@ -40,6 +41,7 @@ public:
 	{
 		if (Flags & GEN_MIPMAP)
 			MipMapLOD=mipmapLevel;
+		LockMode=mode;
 		return MipMap[MipMapLOD]->lock();
 	}
 
@@ -47,6 +49,8 @@ public:
 	virtual void unlock()
 	{
 		MipMap[MipMapLOD]->unlock();
+		if (LockMode != ETLM_READ_ONLY)
+			tileMipMapLevel(MipMapLOD);
 	}
 
 	//! Returns original size of the texture.
@@ -82,6 +86,18 @@ public:
 	}
 
 
+	//! returns the texels of the current mip level the way the shaders sample them
+	const void* getSampleData() const
+	{
+		return Tiled[MipMapLOD] ? Tiled[MipMapLOD] : MipMap[MipMapLOD]->lock();
+	}
+
+	//! returns if the current mip level is sampled from tiles
+	bool isSampleTiled() const
+	{
+		return Tiled[MipMapLOD] != 0;
+	}
+
 	//! returns driver type of texture (=the driver, who created the texture)
 	virtual E_DRIVER_TYPE getDriverType() const
 	{
@@ -123,13 +139,21 @@ public:
 	}
 
 private:
+	//! box filters the mip levels from the sums of the texels of the level above
+	void filterMipMapLevels();
+
+	//! copies the texels of a mip level into its tiles
+	void tileMipMapLevel(u32 level);
+
 	f32 OrigImageDataSizeInPixels;
 	core::dimension2d<u32> OrigSize;
 
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
+	u8 * Tiled[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
 
 	u32 MipMapLOD;
 	u32 Flags;
+	E_TEXTURE_LOCK_MODE LockMode;
 	ECOLOR_FORMAT OriginalFormat;
 };
 
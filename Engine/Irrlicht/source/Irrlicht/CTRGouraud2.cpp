@@ -144,6 +144,12 @@ void CTRGouraud2::scanline_bilinear ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -389,6 +395,7 @@ void CTRGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4D
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -420,7 +427,8 @@ void CTRGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4D
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -549,6 +557,7 @@ void CTRGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4D
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -580,7 +589,8 @@ void CTRGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4D
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
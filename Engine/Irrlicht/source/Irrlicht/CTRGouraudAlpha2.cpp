@@ -150,6 +150,12 @@ void CTRGouraudAlpha2::scanline_bilinear ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -403,6 +409,7 @@ void CTRGouraudAlpha2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -434,7 +441,8 @@ void CTRGouraudAlpha2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 			// render a scanline
-			scanline_bilinear ( );
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ( );
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -563,6 +571,7 @@ void CTRGouraudAlpha2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -594,7 +603,8 @@ void CTRGouraudAlpha2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 			// render a scanline
-			scanline_bilinear ( );
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ( );
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -401,6 +401,7 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -432,7 +433,8 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -561,6 +563,7 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -592,7 +595,8 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
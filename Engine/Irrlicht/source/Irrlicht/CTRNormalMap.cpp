@@ -153,6 +153,12 @@ void CTRNormalMap::scanline_bilinear ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -525,6 +531,7 @@ void CTRNormalMap::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -566,7 +573,8 @@ void CTRNormalMap::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -733,6 +741,7 @@ void CTRNormalMap::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -774,7 +783,8 @@ void CTRNormalMap::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -95,6 +95,9 @@ private:
 
 	tFragmentShader fragmentShader;
 
+	// the winding on screen selects the fragment shader
+	bool TwoSided;
+
 	sScanConvertData scan;
 	sScanLineData line;
 
@@ -102,7 +105,7 @@ private:
 
 //! constructor
 CTRStencilShadow::CTRStencilShadow(CBurningVideoDriver* driver)
-: IBurningShader(driver)
+: IBurningShader(driver), fragmentShader(&CTRStencilShadow::fragment_zfail_incr), TwoSided(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTRStencilShadow");
@@ -120,11 +123,19 @@ void CTRStencilShadow::setParam ( u32 index, f32 value)
 	if ( index == 1 && val == 1 )
 	{
 		fragmentShader = &CTRStencilShadow::fragment_zfail_incr;
+		TwoSided = false;
 	}
 	else
 	if ( index == 1 && val == 2 )
 	{
 		fragmentShader = &CTRStencilShadow::fragment_zfail_decr;
+		TwoSided = false;
+	}
+	else
+	// glStencilOpSeparate, zfail increments on front faces and decrements on back faces
+	if ( index == 1 && val == 3 )
+	{
+		TwoSided = true;
 	}
 }
 
@@ -441,6 +452,21 @@ void CTRStencilShadow::fragment_zfail_incr()
 
 void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
 {
+	if ( TwoSided )
+	{
+		// same winding as the face culling of the driver
+		const f32 area = ( ( b->Pos.x - a->Pos.x ) * ( c->Pos.y - a->Pos.y ) ) -
+						( ( b->Pos.y - a->Pos.y ) * ( c->Pos.x - a->Pos.x ) );
+
+		if ( F32_GREATER_0 ( area ) )
+			fragmentShader = &CTRStencilShadow::fragment_zfail_incr;
+		else
+		if ( F32_LOWER_0 ( area ) )
+			fragmentShader = &CTRStencilShadow::fragment_zfail_decr;
+		else
+			return;
+	}
+
 	// sort on height, y
 	if ( F32_A_GREATER_B ( a->Pos.y , b->Pos.y ) ) swapVertexPointer(&a, &b);
 	if ( F32_A_GREATER_B ( b->Pos.y , c->Pos.y ) ) swapVertexPointer(&b, &c);
@@ -607,6 +633,7 @@ void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -648,7 +675,8 @@ void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( line.y >= ScanRowStart )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -815,6 +843,7 @@ void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -856,7 +885,8 @@ void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,cons
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( line.y >= ScanRowStart )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
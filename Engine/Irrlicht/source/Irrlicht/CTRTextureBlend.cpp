@@ -263,6 +263,12 @@ void CTRTextureBlend::fragment_dst_color_src_alpha ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -447,6 +453,12 @@ void CTRTextureBlend::fragment_src_color_src_alpha ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -627,6 +639,12 @@ void CTRTextureBlend::fragment_one_one_minus_src_alpha()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -824,6 +842,12 @@ void CTRTextureBlend::fragment_one_minus_dst_alpha_one ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -1020,6 +1044,12 @@ void CTRTextureBlend::fragment_src_alpha_one ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -1247,6 +1277,12 @@ void CTRTextureBlend::fragment_dst_color_one_minus_dst_alpha ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -1443,6 +1479,12 @@ void CTRTextureBlend::fragment_dst_color_zero ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -1637,6 +1679,12 @@ void CTRTextureBlend::fragment_dst_color_one ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -1834,6 +1882,12 @@ void CTRTextureBlend::fragment_zero_one_minus_scr_color ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -2130,6 +2184,7 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -2161,7 +2216,8 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( line.y >= ScanRowStart )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -2290,6 +2346,7 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -2321,7 +2378,8 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( line.y >= ScanRowStart )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
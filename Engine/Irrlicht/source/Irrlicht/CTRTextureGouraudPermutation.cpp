@@ -0,0 +1,743 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#include "IBurningShader.h"
+
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+#ifndef SOFTWARE_DRIVER_2_USE_WBUFFER
+	#error "the textured gouraud permutations only compare and write a w buffer"
+#endif
+
+namespace irr
+{
+
+namespace video
+{
+
+//! features a textured gouraud permutation is compiled with
+enum E_TEXTURE_GOURAUD_FEATURE
+{
+	//! draw pixels at or in front of the w buffer only
+	ETGF_ZCOMPARE = 0x01,
+
+	//! write the w buffer
+	ETGF_ZWRITE = 0x02,
+
+	//! interpolate the vertex color
+	ETGF_COLOR = 0x04,
+
+	//! filter the texture bilinear, else the nearest texel is taken
+	ETGF_BILINEAR = 0x08,
+
+	//! write the texture, modulated by the vertex color
+	ETGF_BLEND_SOLID = 0x00,
+
+	//! add the texture to the target
+	ETGF_BLEND_ADD = 0x10,
+
+	//! add half the texture to the target
+	ETGF_BLEND_ADD_HALF = 0x20,
+
+	//! skip texels at or below the alpha reference, blend the others by their alpha
+	ETGF_BLEND_ALPHA = 0x30,
+
+	//! add the texture scaled by the vertex color to the target
+	ETGF_BLEND_VERTEX_ALPHA = 0x40,
+
+	ETGF_BLEND_MASK = 0x70
+};
+
+//! the filter of the material types, unless the material turns it off
+#ifdef SOFTWARE_DRIVER_2_BILINEAR
+static const u32 ETGF_FILTER = ETGF_BILINEAR;
+#else
+static const u32 ETGF_FILTER = 0;
+#endif
+
+//! the vertex color of the material types, if the build interpolates colors
+#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
+static const u32 ETGF_VERTEX_COLOR = ETGF_COLOR;
+#else
+static const u32 ETGF_VERTEX_COLOR = 0;
+#endif
+
+
+//! samples the first texture to fixpoint, filtered or nearest
+template <u32 F>
+REALINLINE void getSample_permutation ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
+								const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty )
+{
+#ifdef SOFTWARE_DRIVER_2_BILINEAR
+	if ( F & ETGF_BILINEAR )
+	{
+		getSample_texture ( r, g, b, t, tx, ty );
+		return;
+	}
+#endif
+	getTexel_fix ( r, g, b, t, tx, ty );
+}
+
+//! samples the first texture with alpha to fixpoint, filtered or nearest
+template <u32 F>
+REALINLINE void getSample_permutation ( tFixPoint &a, tFixPoint &r, tFixPoint &g, tFixPoint &b,
+								const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty )
+{
+#ifdef SOFTWARE_DRIVER_2_BILINEAR
+	if ( F & ETGF_BILINEAR )
+	{
+		getSample_texture ( a, r, g, b, t, tx, ty );
+		return;
+	}
+#endif
+	getTexel_fix ( a, r, g, b, t, tx, ty );
+}
+
+
+//! textured gouraud triangle renderer, one class for each material type
+/** The material type fixes the blending and depth features, the texture
+filter of the material picks one of two compiled scanlines at runtime. */
+template <u32 Features>
+class CTRTextureGouraudPermutation : public IBurningShader
+{
+public:
+
+	//! constructor
+	CTRTextureGouraudPermutation(CBurningVideoDriver* driver);
+
+	//! draws an indexed triangle list
+	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
+
+	virtual void setParam ( u32 index, f32 value);
+	virtual void setMaterial ( const SBurningShaderMaterial &material );
+
+private:
+	template <u32 F> void drawTriangle_permutation ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
+	template <u32 F> void scanline_permutation ();
+
+	typedef void (CTRTextureGouraudPermutation::*tDrawTriangle) ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
+
+	//! the permutation picked by the current material
+	tDrawTriangle DrawTriangle;
+
+	sScanConvertData scan;
+	sScanLineData line;
+
+	u32 AlphaRef;
+};
+
+//! constructor
+template <u32 Features>
+CTRTextureGouraudPermutation<Features>::CTRTextureGouraudPermutation(CBurningVideoDriver* driver)
+: IBurningShader(driver), AlphaRef(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CTRTextureGouraudPermutation");
+	#endif
+
+	DrawTriangle = &CTRTextureGouraudPermutation::drawTriangle_permutation<Features>;
+}
+
+
+/*!
+*/
+template <u32 Features>
+void CTRTextureGouraudPermutation<Features>::setParam ( u32 index, f32 value)
+{
+#ifdef BURNINGVIDEO_RENDERER_FAST
+	AlphaRef = core::floor32 ( value * 256.f );
+#else
+	AlphaRef = u32_to_fixPoint ( core::floor32 ( value * 256.f ) );
+#endif
+}
+
+/*!
+	the texture filter of the material picks the scanline
+*/
+template <u32 Features>
+void CTRTextureGouraudPermutation<Features>::setMaterial ( const SBurningShaderMaterial &material )
+{
+	const SMaterialLayer &layer = material.org.TextureLayer[0];
+
+	if ( layer.BilinearFilter || layer.TrilinearFilter || layer.AnisotropicFilter )
+		DrawTriangle = &CTRTextureGouraudPermutation::drawTriangle_permutation<Features>;
+	else
+		DrawTriangle = &CTRTextureGouraudPermutation::drawTriangle_permutation<Features & ~ETGF_BILINEAR>;
+}
+
+template <u32 Features>
+void CTRTextureGouraudPermutation<Features>::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
+{
+	(this->*DrawTriangle) ( a, b, c );
+}
+
+
+/*!
+*/
+template <u32 Features>
+template <u32 F>
+void CTRTextureGouraudPermutation<Features>::scanline_permutation ()
+{
+	const u32 blend = F & ETGF_BLEND_MASK;
+
+	tVideoSample *dst;
+	fp24 *z = 0;
+
+	s32 xStart;
+	s32 xEnd;
+	s32 dx;
+
+	fp24 slopeW;
+	sVec4 slopeC;
+	sVec2 slopeT[BURNING_MATERIAL_MAX_TEXTURES];
+
+	// apply top-left fill-convention, left
+	xStart = core::ceil32( line.x[0] );
+	xEnd = core::ceil32( line.x[1] ) - 1;
+
+	dx = xEnd - xStart;
+
+	if ( dx < 0 )
+		return;
+
+	// skip spans hidden behind the depth tiles
+	if ( ( F & ETGF_ZCOMPARE ) && spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+
+	// slopes
+	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
+
+	slopeW = (line.w[1] - line.w[0]) * invDeltaX;
+	if ( F & ETGF_COLOR )
+		slopeC = (line.c[0][1] - line.c[0][0]) * invDeltaX;
+	slopeT[0] = (line.t[0][1] - line.t[0][0]) * invDeltaX;
+
+#ifdef SOFTWARE_DRIVER_2_SUBTEXEL
+	const f32 subPixel = ( (f32) xStart ) - line.x[0];
+	line.w[0] += slopeW * subPixel;
+	if ( F & ETGF_COLOR )
+		line.c[0][0] += slopeC * subPixel;
+	line.t[0][0] += slopeT[0] * subPixel;
+#endif
+
+	dst = (tVideoSample*)RenderTarget->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
+
+	if ( F & ( ETGF_ZCOMPARE | ETGF_ZWRITE ) )
+		z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
+
+#if defined ( SOFTWARE_DRIVER_2_SPAN_KERNELS )
+	if ( F == ( ETGF_ZCOMPARE | ETGF_ZWRITE | ETGF_COLOR | ETGF_BILINEAR ) )
+	{
+		const tBurningSpanKernel kernel = getBurningSpanKernel ( SpanISA, EBSK_TEXTURE_GOURAUD );
+		if ( kernel )
+		{
+			sBurningSpan span;
+			span.dst = dst;
+			span.z = z;
+			span.count = dx + 1;
+			span.w = line.w[0];
+			span.slopeW = slopeW;
+			span.c = line.c[0][0];
+			span.slopeC = slopeC;
+			span.t[0] = line.t[0][0];
+			span.slopeT[0] = slopeT[0];
+			span.texture[0] = &IT[0];
+			kernel ( span );
+			return;
+		}
+	}
+#endif
+
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+	f32 inversew;
+#endif
+
+	tFixPoint tx0;
+	tFixPoint ty0;
+
+	tFixPoint a0, r0, g0, b0;
+	tFixPoint r1, g1, b1;
+	tFixPoint r2, g2, b2;
+
+#ifdef BURNINGVIDEO_RENDERER_FAST
+	u32 dIndex = ( line.y & 3 ) << 2;
+#endif
+
+	for ( s32 i = 0; i <= dx; ++i )
+	{
+		if ( !( F & ETGF_ZCOMPARE ) || line.w[0] >= z[i] )
+		{
+			// alpha tested pixels write the w buffer once they pass
+			if ( ( F & ETGF_ZWRITE ) && blend != ETGF_BLEND_ALPHA )
+				z[i] = line.w[0];
+
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+			inversew = fix_inverse32 ( line.w[0] );
+			tx0 = tofix ( line.t[0][0].x, inversew );
+			ty0 = tofix ( line.t[0][0].y, inversew );
+#else
+			tx0 = tofix ( line.t[0][0].x );
+			ty0 = tofix ( line.t[0][0].y );
+#endif
+
+			if ( blend == ETGF_BLEND_SOLID )
+			{
+				if ( F & ETGF_COLOR )
+				{
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+					getSample_color ( r1, g1, b1, line.c[0][0], inversew );
+#else
+					getTexel_plain2 ( r1, g1, b1, line.c[0][0] );
+#endif
+					getSample_permutation<F> ( r0, g0, b0, &IT[0], tx0, ty0 );
+
+					dst[i] = fix_to_color ( imulFix ( r0, r1 ),
+											imulFix ( g0, g1 ),
+											imulFix ( b0, b1 )
+										);
+				}
+				else
+				if ( F & ETGF_BILINEAR )
+				{
+					getSample_permutation<F> ( r0, g0, b0, &IT[0], tx0, ty0 );
+					dst[i] = fix_to_color ( r0, g0, b0 );
+				}
+				else
+				{
+#ifdef BURNINGVIDEO_RENDERER_FAST
+					const tFixPointu d = dithermask [ dIndex | ( i ) & 3 ];
+					dst[i] = getTexel_plain ( &IT[0], d + tx0, d + ty0 );
+#else
+					dst[i] = getTexel_plain ( &IT[0], tx0, ty0 );
+#endif
+				}
+			}
+			else
+			if ( blend == ETGF_BLEND_ADD || blend == ETGF_BLEND_ADD_HALF )
+			{
+#ifdef BURNINGVIDEO_RENDERER_FAST
+				if ( blend == ETGF_BLEND_ADD )
+				{
+					const tFixPointu d = dithermask [ dIndex | ( i ) & 3 ];
+					dst[i] = PixelAdd32 ( dst[i], getTexel_plain ( &IT[0], d + tx0, d + ty0 ) );
+				}
+				else
+#endif
+				{
+					getSample_permutation<F> ( r0, g0, b0, &IT[0], tx0, ty0 );
+
+					if ( blend == ETGF_BLEND_ADD_HALF )
+					{
+						r0 >>= 1;
+						g0 >>= 1;
+						b0 >>= 1;
+					}
+
+					color_to_fix ( r1, g1, b1, dst[i] );
+
+					dst[i] = fix_to_color ( clampfix_maxcolor ( r1 + r0 ),
+											clampfix_maxcolor ( g1 + g0 ),
+											clampfix_maxcolor ( b1 + b0 )
+										);
+				}
+			}
+			else
+			if ( blend == ETGF_BLEND_ALPHA )
+			{
+#ifdef BURNINGVIDEO_RENDERER_FAST
+				const tFixPointu d = dithermask [ dIndex | ( i ) & 3 ];
+				const u32 argb = getTexel_plain ( &IT[0], d + tx0, d + ty0 );
+
+				const u32 alpha = ( argb >> 24 );
+				if ( alpha > AlphaRef )
+				{
+					if ( F & ETGF_ZWRITE )
+						z[i] = line.w[0];
+
+					dst[i] = PixelBlend32 ( dst[i], argb, alpha );
+				}
+#else
+				getSample_permutation<F> ( a0, r0, g0, b0, &IT[0], tx0, ty0 );
+
+				if ( (tFixPointu) a0 > AlphaRef )
+				{
+					if ( F & ETGF_ZWRITE )
+						z[i] = line.w[0];
+
+					if ( F & ETGF_COLOR )
+					{
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+						getSample_color ( r2, g2, b2, line.c[0][0], inversew );
+#else
+						getSample_color ( r2, g2, b2, line.c[0][0] );
+#endif
+						r0 = imulFix ( r0, r2 );
+						g0 = imulFix ( g0, g2 );
+						b0 = imulFix ( b0, b2 );
+					}
+
+					color_to_fix ( r1, g1, b1, dst[i] );
+
+					a0 >>= 8;
+
+					r2 = r1 + imulFix ( a0, r0 - r1 );
+					g2 = g1 + imulFix ( a0, g0 - g1 );
+					b2 = b1 + imulFix ( a0, b0 - b1 );
+					dst[i] = fix4_to_color ( a0, r2, g2, b2 );
+				}
+#endif
+			}
+			else
+			if ( blend == ETGF_BLEND_VERTEX_ALPHA )
+			{
+				getSample_permutation<F> ( r0, g0, b0, &IT[0], tx0, ty0 );
+				color_to_fix ( r1, g1, b1, dst[i] );
+
+				if ( F & ETGF_COLOR )
+				{
+					// the green channel of the vertex color scales the texture
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+					a0 = tofix ( line.c[0][0].y, inversew );
+#else
+					a0 = tofix ( line.c[0][0].y );
+#endif
+					r0 = imulFix ( r0, a0 );
+					g0 = imulFix ( g0, a0 );
+					b0 = imulFix ( b0, a0 );
+				}
+
+				dst[i] = fix_to_color ( clampfix_maxcolor ( r1 + r0 ),
+										clampfix_maxcolor ( g1 + g0 ),
+										clampfix_maxcolor ( b1 + b0 )
+									);
+			}
+		}
+
+		line.w[0] += slopeW;
+		if ( F & ETGF_COLOR )
+			line.c[0][0] += slopeC;
+		line.t[0][0] += slopeT[0];
+	}
+
+}
+
+template <u32 Features>
+template <u32 F>
+void CTRTextureGouraudPermutation<Features>::drawTriangle_permutation ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
+{
+	// sort on height, y
+	if ( F32_A_GREATER_B ( a->Pos.y , b->Pos.y ) ) swapVertexPointer(&a, &b);
+	if ( F32_A_GREATER_B ( b->Pos.y , c->Pos.y ) ) swapVertexPointer(&b, &c);
+	if ( F32_A_GREATER_B ( a->Pos.y , b->Pos.y ) ) swapVertexPointer(&a, &b);
+
+	const f32 ca = c->Pos.y - a->Pos.y;
+	const f32 ba = b->Pos.y - a->Pos.y;
+	const f32 cb = c->Pos.y - b->Pos.y;
+	// calculate delta y of the edges
+	scan.invDeltaY[0] = core::reciprocal( ca );
+	scan.invDeltaY[1] = core::reciprocal( ba );
+	scan.invDeltaY[2] = core::reciprocal( cb );
+
+	if ( F32_LOWER_EQUAL_0 ( scan.invDeltaY[0] ) )
+		return;
+
+	// find if the major edge is left or right aligned
+	f32 temp[4];
+
+	temp[0] = a->Pos.x - c->Pos.x;
+	temp[1] = -ca;
+	temp[2] = b->Pos.x - a->Pos.x;
+	temp[3] = ba;
+
+	scan.left = ( temp[0] * temp[3] - temp[1] * temp[2] ) > 0.f ? 0 : 1;
+	scan.right = 1 - scan.left;
+
+	// calculate slopes for the major edge
+	scan.slopeX[0] = (c->Pos.x - a->Pos.x) * scan.invDeltaY[0];
+	scan.x[0] = a->Pos.x;
+
+	scan.slopeW[0] = (c->Pos.w - a->Pos.w) * scan.invDeltaY[0];
+	scan.w[0] = a->Pos.w;
+
+	if ( F & ETGF_COLOR )
+	{
+		scan.slopeC[0][0] = (c->Color[0] - a->Color[0]) * scan.invDeltaY[0];
+		scan.c[0][0] = a->Color[0];
+	}
+
+	scan.slopeT[0][0] = (c->Tex[0] - a->Tex[0]) * scan.invDeltaY[0];
+	scan.t[0][0] = a->Tex[0];
+
+	// top left fill convention y run
+	s32 yStart;
+	s32 yEnd;
+
+#ifdef SOFTWARE_DRIVER_2_SUBTEXEL
+	f32 subPixel;
+#endif
+
+	// rasterize upper sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[1]  )
+	{
+		// calculate slopes for top edge
+		scan.slopeX[1] = (b->Pos.x - a->Pos.x) * scan.invDeltaY[1];
+		scan.x[1] = a->Pos.x;
+
+		scan.slopeW[1] = (b->Pos.w - a->Pos.w) * scan.invDeltaY[1];
+		scan.w[1] = a->Pos.w;
+
+		if ( F & ETGF_COLOR )
+		{
+			scan.slopeC[0][1] = (b->Color[0] - a->Color[0]) * scan.invDeltaY[1];
+			scan.c[0][1] = a->Color[0];
+		}
+
+		scan.slopeT[0][1] = (b->Tex[0] - a->Tex[0]) * scan.invDeltaY[1];
+		scan.t[0][1] = a->Tex[0];
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( a->Pos.y );
+		yEnd = core::ceil32( b->Pos.y ) - 1;
+
+#ifdef SOFTWARE_DRIVER_2_SUBTEXEL
+		subPixel = ( (f32) yStart ) - a->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;
+
+		scan.w[0] += scan.slopeW[0] * subPixel;
+		scan.w[1] += scan.slopeW[1] * subPixel;
+
+		if ( F & ETGF_COLOR )
+		{
+			scan.c[0][0] += scan.slopeC[0][0] * subPixel;
+			scan.c[0][1] += scan.slopeC[0][1] * subPixel;
+		}
+
+		scan.t[0][0] += scan.slopeT[0][0] * subPixel;
+		scan.t[0][1] += scan.slopeT[0][1] * subPixel;
+#endif
+
+		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+			line.w[scan.left] = scan.w[0];
+			line.w[scan.right] = scan.w[1];
+
+			if ( F & ETGF_COLOR )
+			{
+				line.c[0][scan.left] = scan.c[0][0];
+				line.c[0][scan.right] = scan.c[0][1];
+			}
+
+			line.t[0][scan.left] = scan.t[0][0];
+			line.t[0][scan.right] = scan.t[0][1];
+
+			// render a scanline
+			if ( line.y >= ScanRowStart )
+				scanline_permutation<F> ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+			scan.w[0] += scan.slopeW[0];
+			scan.w[1] += scan.slopeW[1];
+
+			if ( F & ETGF_COLOR )
+			{
+				scan.c[0][0] += scan.slopeC[0][0];
+				scan.c[0][1] += scan.slopeC[0][1];
+			}
+
+			scan.t[0][0] += scan.slopeT[0][0];
+			scan.t[0][1] += scan.slopeT[0][1];
+		}
+	}
+
+	// rasterize lower sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[2] )
+	{
+		// advance to middle point
+		if( (f32) 0.0 != scan.invDeltaY[1] )
+		{
+			temp[0] = b->Pos.y - a->Pos.y;	// dy
+
+			scan.x[0] = a->Pos.x + scan.slopeX[0] * temp[0];
+			scan.w[0] = a->Pos.w + scan.slopeW[0] * temp[0];
+			if ( F & ETGF_COLOR )
+				scan.c[0][0] = a->Color[0] + scan.slopeC[0][0] * temp[0];
+			scan.t[0][0] = a->Tex[0] + scan.slopeT[0][0] * temp[0];
+		}
+
+		// calculate slopes for bottom edge
+		scan.slopeX[1] = (c->Pos.x - b->Pos.x) * scan.invDeltaY[2];
+		scan.x[1] = b->Pos.x;
+
+		scan.slopeW[1] = (c->Pos.w - b->Pos.w) * scan.invDeltaY[2];
+		scan.w[1] = b->Pos.w;
+
+		if ( F & ETGF_COLOR )
+		{
+			scan.slopeC[0][1] = (c->Color[0] - b->Color[0]) * scan.invDeltaY[2];
+			scan.c[0][1] = b->Color[0];
+		}
+
+		scan.slopeT[0][1] = (c->Tex[0] - b->Tex[0]) * scan.invDeltaY[2];
+		scan.t[0][1] = b->Tex[0];
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( b->Pos.y );
+		yEnd = core::ceil32( c->Pos.y ) - 1;
+
+#ifdef SOFTWARE_DRIVER_2_SUBTEXEL
+		subPixel = ( (f32) yStart ) - b->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;
+
+		scan.w[0] += scan.slopeW[0] * subPixel;
+		scan.w[1] += scan.slopeW[1] * subPixel;
+
+		if ( F & ETGF_COLOR )
+		{
+			scan.c[0][0] += scan.slopeC[0][0] * subPixel;
+			scan.c[0][1] += scan.slopeC[0][1] * subPixel;
+		}
+
+		scan.t[0][0] += scan.slopeT[0][0] * subPixel;
+		scan.t[0][1] += scan.slopeT[0][1] * subPixel;
+#endif
+
+		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+			line.w[scan.left] = scan.w[0];
+			line.w[scan.right] = scan.w[1];
+
+			if ( F & ETGF_COLOR )
+			{
+				line.c[0][scan.left] = scan.c[0][0];
+				line.c[0][scan.right] = scan.c[0][1];
+			}
+
+			line.t[0][scan.left] = scan.t[0][0];
+			line.t[0][scan.right] = scan.t[0][1];
+
+			// render a scanline
+			if ( line.y >= ScanRowStart )
+				scanline_permutation<F> ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+			scan.w[0] += scan.slopeW[0];
+			scan.w[1] += scan.slopeW[1];
+
+			if ( F & ETGF_COLOR )
+			{
+				scan.c[0][0] += scan.slopeC[0][0];
+				scan.c[0][1] += scan.slopeC[0][1];
+			}
+
+			scan.t[0][0] += scan.slopeT[0][0];
+			scan.t[0][1] += scan.slopeT[0][1];
+		}
+	}
+
+}
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+namespace irr
+{
+namespace video
+{
+
+//! creates a textured gouraud triangle renderer
+IBurningShader* createTriangleRendererTextureGouraud2(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_ZWRITE | ETGF_VERTEX_COLOR | ETGF_FILTER > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates a textured gouraud triangle renderer without depth
+IBurningShader* createTRTextureGouraudNoZ2(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < 0 > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates an additive textured triangle renderer
+IBurningShader* createTRTextureGouraudAdd2(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_ZWRITE | ETGF_FILTER | ETGF_BLEND_ADD > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates an additive textured triangle renderer, which doesn't write depth
+IBurningShader* createTRTextureGouraudAddNoZ2(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_FILTER | ETGF_BLEND_ADD_HALF > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates an alpha tested and blended textured triangle renderer
+IBurningShader* createTRTextureGouraudAlpha(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_ZWRITE | ETGF_VERTEX_COLOR | ETGF_FILTER | ETGF_BLEND_ALPHA > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates an alpha tested and blended textured triangle renderer, which doesn't write depth
+IBurningShader* createTRTextureGouraudAlphaNoZ(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_VERTEX_COLOR | ETGF_FILTER | ETGF_BLEND_ALPHA > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+//! creates a textured triangle renderer, which adds the texture scaled by the vertex color
+IBurningShader* createTriangleRendererTextureVertexAlpha2(CBurningVideoDriver* driver)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRTextureGouraudPermutation < ETGF_ZCOMPARE | ETGF_VERTEX_COLOR | ETGF_FILTER | ETGF_BLEND_VERTEX_ALPHA > (driver);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+
+} // end namespace video
+} // end namespace irr
@@ -125,6 +125,12 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_mag ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -186,6 +192,27 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_mag ()
 	line.t[0][0] += line.t[0][1] * a;
 	line.t[1][0] += line.t[1][1] * a;
 
+#if defined ( SOFTWARE_DRIVER_2_SPAN_KERNELS ) && defined ( IPOL_W )
+	const tBurningSpanKernel kernel = getBurningSpanKernel ( SpanISA, EBSK_LIGHTMAP_M4_BILINEAR );
+	if ( kernel )
+	{
+		sBurningSpan span;
+		span.dst = dst + i;
+		span.z = z + i;
+		span.count = dx - i + 1;
+		span.w = line.w[0];
+		span.slopeW = line.w[1];
+		span.t[0] = line.t[0][0];
+		span.slopeT[0] = line.t[0][1];
+		span.t[1] = line.t[1][0];
+		span.slopeT[1] = line.t[1][1];
+		span.texture[0] = &IT[0];
+		span.texture[1] = &IT[1];
+		kernel ( span );
+		return;
+	}
+#endif
+
 
 #ifdef BURNINGVIDEO_RENDERER_FAST
 	u32 dIndex = ( line.y & 3 ) << 2;
@@ -270,6 +297,12 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_min ()
 	if ( dx < 0 )
 		return;
 
+#ifdef CMP_W
+	// skip spans hidden behind the depth tiles
+	if ( spanOccluded ( line.y, xStart, xEnd, line.w[0], line.w[1] ) )
+		return;
+#endif
+
 	// slopes
 	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
 
@@ -330,6 +363,27 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_min ()
 	line.t[0][0] += line.t[0][1] * a;
 	line.t[1][0] += line.t[1][1] * a;
 
+#if defined ( SOFTWARE_DRIVER_2_SPAN_KERNELS ) && defined ( IPOL_W )
+	const tBurningSpanKernel kernel = getBurningSpanKernel ( SpanISA, EBSK_LIGHTMAP_M4_NEAREST );
+	if ( kernel )
+	{
+		sBurningSpan span;
+		span.dst = dst + i;
+		span.z = z + i;
+		span.count = dx - i + 1;
+		span.w = line.w[0];
+		span.slopeW = line.w[1];
+		span.t[0] = line.t[0][0];
+		span.slopeT[0] = line.t[0][1];
+		span.t[1] = line.t[1][0];
+		span.slopeT[1] = line.t[1][1];
+		span.texture[0] = &IT[0];
+		span.texture[1] = &IT[1];
+		kernel ( span );
+		return;
+	}
+#endif
+
 
 	tFixPoint r0, g0, b0;
 	tFixPoint r1, g1, b1;
@@ -524,6 +578,7 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -555,7 +610,8 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 			// render a scanline
-			scanline_bilinear2_min ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear2_min ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -685,6 +741,7 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -716,7 +773,8 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 			// render a scanline
-			scanline_bilinear2_min ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear2_min ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -898,6 +956,7 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -929,7 +988,8 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 			// render a scanline
-			scanline_bilinear2_mag ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear2_mag ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -1059,6 +1119,7 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 		// rasterize the edge scanlines
+		yEnd = core::s32_min ( yEnd, ScanRowEnd );
 		for( line.y = yStart; line.y <= yEnd; ++line.y)
 		{
 			line.x[scan.left] = scan.x[0];
@@ -1090,7 +1151,8 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 			// render a scanline
-			scanline_bilinear2_mag ();
+			if ( line.y >= ScanRowStart )
+				scanline_bilinear2_mag ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -118,10 +118,14 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 	int pitch0 = RenderTarget->getDimension().Width << VIDEO_SAMPLE_GRANULARITY;
 	int pitch1 = RenderTarget->getDimension().Width << 2;
 
-	int aposx = (int) a->Pos.x;
-	int aposy = (int) a->Pos.y;
-	int bposx = (int) b->Pos.x;
-	int bposy = (int) b->Pos.y;
+	// an end clipped at the right or bottom frustum plane lands one pixel outside
+	const int maxx = RenderTarget->getDimension().Width - 1;
+	const int maxy = RenderTarget->getDimension().Height - 1;
+
+	int aposx = core::s32_clamp ( (int) a->Pos.x, 0, maxx );
+	int aposy = core::s32_clamp ( (int) a->Pos.y, 0, maxy );
+	int bposx = core::s32_clamp ( (int) b->Pos.x, 0, maxx );
+	int bposy = core::s32_clamp ( (int) b->Pos.y, 0, maxy );
 
 	int dx = bposx - aposx;
 	int dy = bposy - aposy;
@@ -72,6 +72,9 @@ namespace scene
 		//! sets the vertex positions etc
 		virtual void OnAnimate(u32 timeMs);
 
+		//! reads the active camera, which may be animated at the same time
+		virtual bool isAnimateThreadSafe() const { return false; }
+
 		//! registers the node into the transparent pass
 		virtual void OnRegisterSceneNode();
 
@@ -0,0 +1,156 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CThreadPool.h"
+#include "irrMath.h"
+
+namespace irr
+{
+
+namespace
+{
+	std::mutex SharedLock;
+	CThreadPool* SharedPool = 0;
+}
+
+
+//! returns the pool, with at least threadCount - 1 workers
+CThreadPool* CThreadPool::grabShared(u32 threadCount)
+{
+	std::lock_guard<std::mutex> lock(SharedLock);
+
+	if (!SharedPool)
+		SharedPool = new CThreadPool();
+
+	++SharedPool->Users;
+
+	// the calling thread is thread 0
+	if (threadCount > 1)
+		SharedPool->reserve(threadCount - 1);
+
+	return SharedPool;
+}
+
+
+//! releases a pool returned by grabShared()
+void CThreadPool::dropShared()
+{
+	std::lock_guard<std::mutex> lock(SharedLock);
+
+	if (0 == --Users)
+	{
+		SharedPool = 0;
+		delete this;
+	}
+}
+
+
+//! constructor
+CThreadPool::CThreadPool()
+: Users(0), CurrentTask(0), CurrentData(0), Participants(0),
+	Generation(0), Busy(0), Stop(false)
+{
+}
+
+
+//! destructor
+CThreadPool::~CThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stop = true;
+	}
+	Start.notify_all();
+
+	for (u32 i = 0; i != Workers.size(); ++i)
+		Workers[i].join();
+}
+
+
+//! starts workers until there are at least count
+void CThreadPool::reserve(u32 count)
+{
+	// not while a task runs, so the new workers wait for the next one
+	std::lock_guard<std::mutex> run(RunLock);
+
+	u32 generation;
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		generation = Generation;
+	}
+
+	while (Workers.size() < count)
+		Workers.push_back(std::thread(&CThreadPool::workerLoop, this, (u32) Workers.size() + 1, generation));
+}
+
+
+//! runs a task on threadCount threads and waits until all are done
+void CThreadPool::run(Task task, void* data, u32 threadCount)
+{
+	std::lock_guard<std::mutex> run(RunLock);
+
+	const u32 workers = core::min_(threadCount > 0 ? threadCount : 1,
+		(u32) Workers.size() + 1) - 1;
+
+	if (workers)
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			CurrentTask = task;
+			CurrentData = data;
+			Participants = workers;
+			Busy = workers;
+			++Generation;
+		}
+		Start.notify_all();
+	}
+
+	task(data, 0);
+
+	if (workers)
+	{
+		std::unique_lock<std::mutex> lock(Mutex);
+		while (Busy)
+			Done.wait(lock);
+	}
+}
+
+
+//! runs on each worker thread
+void CThreadPool::workerLoop(u32 thread, u32 generation)
+{
+	for (;;)
+	{
+		Task task;
+		void* data;
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			while (generation == Generation && !Stop)
+				Start.wait(lock);
+
+			if (Stop)
+				return;
+
+			generation = Generation;
+
+			// a task asking for fewer threads leaves the others asleep
+			if (thread > Participants)
+				continue;
+
+			task = CurrentTask;
+			data = CurrentData;
+		}
+
+		task(data, thread);
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			if (0 == --Busy)
+				Done.notify_one();
+		}
+	}
+}
+
+
+} // end namespace irr
@@ -0,0 +1,70 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_THREAD_POOL_H_INCLUDED__
+#define __C_THREAD_POOL_H_INCLUDED__
+
+#include "irrTypes.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+	//! Worker threads shared by everything in the engine which splits work over threads.
+	/** There is one pool per process, so the scene animation and the tile
+	rasterizer do not each keep their own idle threads. The workers sleep
+	while there is no work. A task is run on up to the requested number of
+	threads at once and the caller is thread 0, so the caller never waits on
+	a thread which is not working for it. Only one task runs at a time, so a
+	task must not run another task. */
+	class CThreadPool
+	{
+	public:
+
+		//! function run by each thread, with the index of the thread
+		typedef void (*Task)(void* data, u32 thread);
+
+		//! returns the pool, with at least threadCount - 1 workers
+		/** Each call must be paired with a call to dropShared(). */
+		static CThreadPool* grabShared(u32 threadCount);
+
+		//! releases a pool returned by grabShared(), the last user stops the workers
+		void dropShared();
+
+		//! runs a task on threadCount threads and waits until all are done
+		/** The threads get the indices 0 to threadCount - 1. */
+		void run(Task task, void* data, u32 threadCount);
+
+	private:
+
+		CThreadPool();
+		~CThreadPool();
+
+		//! starts workers until there are at least count
+		void reserve(u32 count);
+
+		//! runs on each worker thread, from the generation it was started in
+		void workerLoop(u32 thread, u32 generation);
+
+		u32 Users;
+
+		std::vector<std::thread> Workers;
+		std::mutex RunLock;
+		std::mutex Mutex;
+		std::condition_variable Start;
+		std::condition_variable Done;
+		Task CurrentTask;
+		void* CurrentData;
+		u32 Participants;
+		u32 Generation;
+		u32 Busy;
+		bool Stop;
+	};
+
+} // end namespace irr
+
+#endif
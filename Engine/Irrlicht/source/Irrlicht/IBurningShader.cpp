@@ -36,6 +36,10 @@ namespace video
 		Driver = driver;
 		RenderTarget = 0;
 		ColorMask = COLOR_BRIGHT_WHITE;
+		ScanRowStart = 0;
+		ScanRowEnd = 0x7fffffff;
+		SpanISA = driver->getSpanISA ();
+		DepthReject = false;
 		DepthBuffer = (CDepthBuffer*) driver->getDepthBuffer ();
 		if ( DepthBuffer )
 			DepthBuffer->grab();
@@ -101,15 +105,85 @@ namespace video
 			// select mignify and magnify ( lodLevel )
 			//SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS
 			it->lodLevel = lodLevel;
-			it->data = (tVideoSample*) it->Texture->lock(ETLM_READ_ONLY,
+			it->Texture->lock(ETLM_READ_ONLY,
 				core::s32_clamp ( lodLevel + SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS, 0, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1 ));
+			it->data = (tVideoSample*) it->Texture->getSampleData();
 
 			// prepare for optimal fixpoint
-			it->pitchlog2 = s32_log2_s32 ( it->Texture->getPitch() );
-
 			const core::dimension2d<u32> &dim = it->Texture->getSize();
 			it->textureXMask = s32_to_fixPoint ( dim.Width - 1 ) & FIX_POINT_UNSIGNED_MASK;
 			it->textureYMask = s32_to_fixPoint ( dim.Height - 1 ) & FIX_POINT_UNSIGNED_MASK;
+
+			if ( it->Texture->isSampleTiled() )
+			{
+				// a row of tiles is as many bytes as the rows of texels in it
+				it->pitchlog2 = s32_log2_s32 ( dim.Width ) + VIDEO_SAMPLE_GRANULARITY;
+				it->texelXShift = FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY - SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2;
+				it->tileYMask = ( 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 ) - 1;
+			}
+			else
+			{
+				it->pitchlog2 = s32_log2_s32 ( it->Texture->getPitch() );
+				it->texelXShift = FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY;
+				it->tileYMask = 0;
+			}
+		}
+	}
+
+
+	//! copies the sampling state of a texture stage from another shader
+	void IBurningShader::copyTextureParam( u32 stage, const sInternalTexture &source )
+	{
+		sInternalTexture *it = &IT[stage];
+
+		it->textureXMask = source.textureXMask;
+		it->textureYMask = source.textureYMask;
+		it->pitchlog2 = source.pitchlog2;
+		it->data = source.data;
+		it->texelXShift = source.texelXShift;
+		it->tileYMask = source.tileYMask;
+		it->lodLevel = source.lodLevel;
+	}
+
+
+	//! creates the shader for one fixed function shader type
+	IBurningShader* createBurningShader(EBurningFFShader shader, CBurningVideoDriver* driver)
+	{
+		switch ( shader )
+		{
+			//case ETR_FLAT: return createTRFlat2(driver);
+			//case ETR_FLAT_WIRE: return createTRFlatWire2(driver);
+			case ETR_GOURAUD: return createTriangleRendererGouraud2(driver);
+			case ETR_GOURAUD_ALPHA: return createTriangleRendererGouraudAlpha2(driver);
+			case ETR_GOURAUD_ALPHA_NOZ: return createTRGouraudAlphaNoZ2(driver);
+			//case ETR_GOURAUD_WIRE: return createTriangleRendererGouraudWire2(driver);
+			//case ETR_TEXTURE_FLAT: return createTriangleRendererTextureFlat2(driver);
+			//case ETR_TEXTURE_FLAT_WIRE: return createTriangleRendererTextureFlatWire2(driver);
+			case ETR_TEXTURE_GOURAUD: return createTriangleRendererTextureGouraud2(driver);
+			case ETR_TEXTURE_GOURAUD_LIGHTMAP_M1: return createTriangleRendererTextureLightMap2_M1(driver);
+			case ETR_TEXTURE_GOURAUD_LIGHTMAP_M2: return createTriangleRendererTextureLightMap2_M2(driver);
+			case ETR_TEXTURE_GOURAUD_LIGHTMAP_M4: return createTriangleRendererGTextureLightMap2_M4(driver);
+			case ETR_TEXTURE_LIGHTMAP_M4: return createTriangleRendererTextureLightMap2_M4(driver);
+			case ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD: return createTriangleRendererTextureLightMap2_Add(driver);
+			case ETR_TEXTURE_GOURAUD_DETAIL_MAP: return createTriangleRendererTextureDetailMap2(driver);
+
+			case ETR_TEXTURE_GOURAUD_WIRE: return createTriangleRendererTextureGouraudWire2(driver);
+			case ETR_TEXTURE_GOURAUD_NOZ: return createTRTextureGouraudNoZ2(driver);
+			case ETR_TEXTURE_GOURAUD_ADD: return createTRTextureGouraudAdd2(driver);
+			case ETR_TEXTURE_GOURAUD_ADD_NO_Z: return createTRTextureGouraudAddNoZ2(driver);
+			case ETR_TEXTURE_GOURAUD_VERTEX_ALPHA: return createTriangleRendererTextureVertexAlpha2(driver);
+
+			case ETR_TEXTURE_GOURAUD_ALPHA: return createTRTextureGouraudAlpha(driver);
+			case ETR_TEXTURE_GOURAUD_ALPHA_NOZ: return createTRTextureGouraudAlphaNoZ(driver);
+
+			case ETR_NORMAL_MAP_SOLID: return createTRNormalMap(driver);
+			case ETR_STENCIL_SHADOW: return createTRStencilShadow(driver);
+			case ETR_TEXTURE_BLEND: return createTRTextureBlend(driver);
+
+			case ETR_REFERENCE: return createTriangleRendererReference(driver);
+
+			default:
+				return 0;
 		}
 	}
 
@@ -13,6 +13,7 @@
 #include "rect.h"
 #include "CDepthBuffer.h"
 #include "S4DVertex.h"
+#include "CBurningSpanKernels.h"
 #include "irrArray.h"
 #include "SLight.h"
 #include "SMaterial.h"
@@ -144,8 +145,28 @@ namespace video
 
 		virtual void setMaterial ( const SBurningShaderMaterial &material ) {};
 
+		//! returns the sampling state of a texture stage
+		const sInternalTexture& getTextureParam ( u32 stage ) const { return IT[stage]; }
+
+		//! copies the sampling state of a texture stage from another shader.
+		/** The texture is not grabbed, this shader only reads through the copied
+		data pointer, so the source shader has to keep the texture alive. */
+		void copyTextureParam ( u32 stage, const sInternalTexture &source );
+
+		//! limits the scanlines drawn to the rows start to end, inclusive.
+		/** Rows outside are still stepped, so the rows that are drawn come out
+		exactly the same as when the whole triangle is drawn. */
+		void setScanRows ( s32 start, s32 end ) { ScanRowStart = start; ScanRowEnd = end; }
+
+		//! skips the spans that lie behind the farthest depth of the depth buffer tiles.
+		/** Only for shaders that draw nothing which fails a greater equal depth test. */
+		void setDepthReject ( bool reject ) { DepthReject = reject; }
+
 	protected:
 
+		//! returns true if no pixel of a span from depth w0 to w1 can pass the depth test
+		bool spanOccluded ( s32 y, s32 xStart, s32 xEnd, f32 w0, f32 w1 ) const;
+
 		CBurningVideoDriver *Driver;
 
 		video::CImage* RenderTarget;
@@ -153,12 +174,30 @@ namespace video
 		CStencilBuffer * Stencil;
 		tVideoSample ColorMask;
 
+		s32 ScanRowStart;
+		s32 ScanRowEnd;
+
+		//! instruction set of the span kernels, EBSI_SCALAR runs the scalar scanlines
+		E_BURNING_SPAN_ISA SpanISA;
+
+		bool DepthReject;
+
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
 		static const tFixPointu dithermask[ 4 * 4];
 	};
 
 
+	inline bool IBurningShader::spanOccluded ( s32 y, s32 xStart, s32 xEnd, f32 w0, f32 w1 ) const
+	{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+		return DepthReject && DepthBuffer->isOccluded ( xStart, y, xEnd, y, core::max_ ( w0, w1 ) );
+#else
+		return false;
+#endif
+	}
+
+
 	IBurningShader* createTriangleRendererTextureGouraud2(CBurningVideoDriver* driver);
 	IBurningShader* createTriangleRendererTextureLightMap2_M1(CBurningVideoDriver* driver);
 	IBurningShader* createTriangleRendererTextureLightMap2_M2(CBurningVideoDriver* driver);
@@ -192,6 +231,9 @@ namespace video
 
 	IBurningShader* createTriangleRendererReference(CBurningVideoDriver* driver);
 
+	//! creates the shader for one fixed function shader type, 0 if there is none
+	IBurningShader* createBurningShader(EBurningFFShader shader, CBurningVideoDriver* driver);
+
 
 
 } // end namespace video
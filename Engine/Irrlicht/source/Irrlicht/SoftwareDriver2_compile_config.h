@@ -93,6 +93,51 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (8/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// texels on each side of a tile of a tiled texture is 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2
+#define SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2	2
+
+// screen rows in one tile when rasterizing with more than one thread
+#define SOFTWARE_DRIVER_2_TILE_HEIGHT		16
+
+// draw calls with fewer triangles are rasterized on the calling thread
+#define SOFTWARE_DRIVER_2_TILE_MIN_TRIANGLES	32
+
+// draw calls with fewer vertices go through the vertex cache instead of a vertex batch
+#define SOFTWARE_DRIVER_2_BATCH_MIN_VERTICES	64
+
+// transform vertex batches four vertices at a time.
+// fast math projects with a reciprocal estimate, which would not match the vertex cache
+#if !defined ( IRRLICHT_FAST_MATH )
+	#if defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined ( __SSE__ )
+		#define SOFTWARE_DRIVER_2_SSE
+	#endif
+#endif
+
+// shade the spans of some shaders four or eight pixels at a time. the kernels are picked
+// at runtime from the cpu features. the scalar float math has to be sse to match them
+#if defined ( SOFTWARE_DRIVER_2_32BIT ) && defined ( SOFTWARE_DRIVER_2_BILINEAR ) && \
+	defined ( SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT ) && defined ( SOFTWARE_DRIVER_2_USE_WBUFFER ) && \
+	!defined ( BURNINGVIDEO_RENDERER_FAST ) && !defined ( __BIG_ENDIAN__ )
+	#if defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || \
+		defined ( __x86_64__ ) || ( defined ( __i386__ ) && defined ( __SSE2_MATH__ ) )
+		#define SOFTWARE_DRIVER_2_SPAN_KERNELS
+	#endif
+#endif
+
+// box filter the mip levels of 32 bit textures four channels at a time
+#if defined ( SOFTWARE_DRIVER_2_32BIT ) && !defined ( __BIG_ENDIAN__ )
+	#if defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined ( __SSE2__ )
+		#define SOFTWARE_DRIVER_2_MIPMAP_SSE2
+	#endif
+#endif
+
+// keep the farthest depth of each tile of the depth buffer to reject hidden triangles and
+// spans before they are shaded. tiles are 1 << SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2 pixels wide and high
+#if defined ( SOFTWARE_DRIVER_2_USE_WBUFFER )
+	#define SOFTWARE_DRIVER_2_HIERARCHICAL_DEPTH
+	#define SOFTWARE_DRIVER_2_DEPTH_TILE_LOG2	3
+#endif
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
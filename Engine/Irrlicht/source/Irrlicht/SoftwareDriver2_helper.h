@@ -711,10 +711,34 @@ struct sInternalTexture
 	u32 pitchlog2;
 	void *data;
 
+	// a tiled texture stores each column of a tile in a row. texelXShift takes x
+	// to its byte offset, tileYMask are the bits of y inside a tile, 0 if linear
+	u32 texelXShift;
+	u32 tileYMask;
+
 	video::CSoftwareTexture2 *Texture;
 	s32 lodLevel;
 };
 
+// byte offset of the column of tx, in a linear or tiled texture
+REALINLINE u32 getTexelOffsetX ( const sInternalTexture * t, const tFixPointu tx )
+{
+	return ( tx & t->textureXMask ) >> t->texelXShift;
+}
+
+// byte offset of the row of ty, in a linear or tiled texture
+REALINLINE u32 getTexelOffsetY ( const sInternalTexture * t, const tFixPointu ty )
+{
+	const u32 y = ( ty & t->textureYMask ) >> FIX_POINT_PRE;
+	return ( ( y & t->tileYMask ) << VIDEO_SAMPLE_GRANULARITY ) | ( ( y & ~t->tileYMask ) << t->pitchlog2 );
+}
+
+// byte offset of the texel at tx,ty
+REALINLINE u32 getTexelOffset ( const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty )
+{
+	return getTexelOffsetY ( t, ty ) | getTexelOffsetX ( t, tx );
+}
+
 
 
 // get video sample plain
@@ -722,8 +746,7 @@ inline tVideoSample getTexel_plain ( const sInternalTexture * t, const tFixPoint
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	return *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -736,8 +759,7 @@ inline void getTexel_fix ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	tVideoSample t00;
@@ -756,14 +778,32 @@ REALINLINE void getTexel_fix ( tFixPoint &a,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
+
+	// texel
+	tVideoSample t00;
+	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+
+	a	 =	(t00 & MASK_A) >> ( SHIFT_A - FIX_POINT_PRE);
+}
+
+// get video sample with alpha to fixpoint
+REALINLINE void getTexel_fix ( tFixPoint &a, tFixPoint &r, tFixPoint &g, tFixPoint &b,
+								const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
+								)
+{
+	u32 ofs;
+
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	tVideoSample t00;
 	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
 
 	a	 =	(t00 & MASK_A) >> ( SHIFT_A - FIX_POINT_PRE);
+	r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
+	g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
+	b	 =	(t00 & MASK_B) << ( FIX_POINT_PRE - SHIFT_B );
 }
 
 
@@ -782,12 +822,11 @@ inline void getSample_texture_dither (	tFixPoint &r, tFixPoint &g, tFixPoint &b,
 
 	const u32 index = (y & 3 ) << 2 | (x & 3);
 
-	const tFixPointu _ntx = (tx + dithermask [ index ] ) & t->textureXMask;
-	const tFixPointu _nty = (ty + dithermask [ index ] ) & t->textureYMask;
+	const tFixPointu _ntx = tx + dithermask [ index ];
+	const tFixPointu _nty = ty + dithermask [ index ];
 
 	u32 ofs;
-	ofs = ( ( _nty ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( _ntx ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, _ntx, _nty );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -811,8 +850,7 @@ inline void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -828,8 +866,7 @@ inline void getSample_texture ( tFixPointu &a, tFixPointu &r, tFixPointu &g, tFi
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -851,8 +888,7 @@ REALINLINE void getSample_linear ( tFixPointu &r, tFixPointu &g, tFixPointu &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	tVideoSample t00;
@@ -883,10 +919,10 @@ REALINLINE void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	u32 o0, o1,o2,o3;
 	tVideoSample t00;
 
-	o0 = ( ( (ty) & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	o1 = ( ( (ty+FIX_POINT_ONE) & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	o2 =   ( (tx) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-	o3 =   ( (tx+FIX_POINT_ONE) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	o0 = getTexelOffsetY ( t, ty );
+	o1 = getTexelOffsetY ( t, ty+FIX_POINT_ONE );
+	o2 = getTexelOffsetX ( t, tx );
+	o3 = getTexelOffsetX ( t, tx+FIX_POINT_ONE );
 
 	t00 = *((tVideoSample*)( (u8*) t->data + (o0 | o2 ) ));
 	r00	 =	(t00 & MASK_R) >> SHIFT_R; g00  =	(t00 & MASK_G) >> SHIFT_G; b00	 =	(t00 & MASK_B);
@@ -938,8 +974,7 @@ REALINLINE void getSample_linear ( tFixPointu &a, tFixPointu &r, tFixPointu &g,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = getTexelOffset ( t, tx, ty );
 
 	// texel
 	tVideoSample t00;
@@ -33,8 +33,16 @@
 
 #include "BIOEngineConfiguration.hpp"
 #include "Error.hpp"
+#include "FrameScheduler.hpp"
+#include "IFrameListener.hpp"
+#include "LevelCache.hpp"
+#include "LevelStreamer.hpp"
+#include "World.hpp"
+#include "../../Core/include/JobSystem.hpp"
 #include "../../Core/include/Logger.hpp"
 
+#include <memory>
+
 #if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
 #include "../../Xnelo-Testing/include/Testing.hpp"
 #endif
@@ -55,6 +63,52 @@ namespace BIO
 			*/
 			ErrorType _error;
 
+			/**
+			* The level that is running. Replaced in one step when a new level finishes loading
+			* so the old level keeps running until then. Only read and replaced with 
+			* std::atomic_load and std::atomic_store so other threads can take a reference.
+			*/
+			std::shared_ptr<World> _world;
+
+			/**
+			* Keeps loaded levels so loading them again skips parsing. Declared before the 
+			* streamer so it outlives the streamer's requests.
+			*/
+			LevelCache _levelCache;
+
+			/**
+			* Loads levels in the background.
+			*/
+			LevelStreamer _levelStreamer;
+
+			/**
+			* Microseconds each frame may spend finishing a background level load.
+			*/
+			unsigned int _levelUploadBudget;
+
+			/**
+			* Times the frames of RunLoop.
+			*/
+			FrameScheduler _scheduler;
+
+			/**
+			* Runs the engine's jobs on the worker threads.
+			*/
+			CORE::JobSystem * _jobs;
+
+			/**
+			* Is the engine rendering into memory without a window.
+			*/
+			bool _headless;
+
+			/**
+			* Draw one frame of the running level.
+			*
+			* @param listener The game code to get ready for the frame, or NULL for none.
+			* @param interpolation Passed on to the listener.
+			*/
+			BIO_ENGINE_API void _DrawFrame(IFrameListener * listener, float interpolation);
+
 			/**
 			* Initialize the Engine.
 			*
@@ -62,6 +116,13 @@ namespace BIO
 			*			engine.
 			*/
 			BIO_ENGINE_API void _InitEngine(BIOEngineConfiguration * config);
+
+			/**
+			* Make a world the running level. The old one is deleted once nothing holds it.
+			*
+			* @param world The new world. The engine owns it now.
+			*/
+			BIO_ENGINE_API void _SetWorld(World * world);
 		public:
 			/**
 			* Default Constructor
@@ -92,6 +153,56 @@ namespace BIO
 			*/
 			BIO_ENGINE_API ErrorType GetError();
 
+			/**
+			* Get the scheduler that times RunLoop. Use it to read the frame statistics or 
+			* change the target frame rate.
+			*
+			* @return Returns the engine's frame scheduler.
+			*/
+			BIO_ENGINE_API FrameScheduler & GetFrameScheduler();
+
+			/**
+			* Get the job system. Scene updates, animation, culling and loading submit their work
+			* here. Main thread jobs are run each time Run is called.
+			*
+			* @return Returns the engine's job system.
+			*/
+			BIO_ENGINE_API CORE::JobSystem & GetJobSystem();
+
+			/**
+			* Get the cache every level is loaded through. Use it to read the hit and miss 
+			* counts or to change the budget.
+			*
+			* @return Returns the engine's level cache.
+			*/
+			BIO_ENGINE_API LevelCache & GetLevelCache();
+
+			/**
+			* Get the level that is running.
+			*
+			* @return Returns the running World or NULL if no level is loaded. The World stays 
+			*			alive while the returned pointer is held, even after the next level is 
+			*			loaded.
+			*/
+			BIO_ENGINE_API std::shared_ptr<World> GetWorld();
+
+			/**
+			* Get the pixels of the last frame without copying them. Only frames rendered into 
+			* memory can be read, which are the frames of the headless mode and of 
+			* RD_BURNINGS_VIDEO.
+			*
+			* @return Returns a view of the last frame. Its pixels are NULL if the frame is on the
+			*			graphics card.
+			*/
+			BIO_ENGINE_API FrameView GetFrame();
+
+			/**
+			* Check if the engine renders into memory without a window.
+			*
+			* @return Returns true if the engine was configured as headless.
+			*/
+			BIO_ENGINE_API bool IsHeadless();
+
 			/**
 			* Check if the window is active.
 			*
@@ -111,13 +222,45 @@ namespace BIO
 			BIO_ENGINE_API bool LoadLevel(const char * filename);
 
 			/**
-			* Is the engine still ready to continue running?
+			* Start loading a level in the background. The running level keeps going until the
+			* new one is ready, then the new one replaces it during Run.
+			*
+			* @param filename The name of the file to load.
+			*
+			* @return Returns a handle to follow the progress of the load with.
+			*/
+			BIO_ENGINE_API LevelLoadHandle LoadLevelAsync(std::string filename);
+			BIO_ENGINE_API LevelLoadHandle LoadLevelAsync(const char * filename);
+
+			/**
+			* Is the engine still ready to continue running? This also does a slice of the work
+			* of any level loading in the background and runs the main thread jobs.
 			*
 			* @return Returns a boolean with true if the engine is ready, or false if the engine is
 			*			closed/in an error state/ or incapable of continuing.
 			*/
 			BIO_ENGINE_API bool Run();
 
+			/**
+			* Run the main loop until the engine stops. Each frame runs the listener's fixed 
+			* updates, draws the scene and then waits for the next frame as set up by the 
+			* BIOEngineConfiguration. While the window is not active the engine yields instead.
+			*
+			* @param listener The game code to run each frame.
+			*/
+			BIO_ENGINE_API void RunLoop(IFrameListener & listener);
+
+			/**
+			* Draw the running level once, outside of RunLoop. In headless mode read the frame 
+			* with GetFrame afterwards.
+			*/
+			BIO_ENGINE_API void DrawFrame();
+
+			/**
+			* Stop the engine. Run returns false and RunLoop returns after the current frame.
+			*/
+			BIO_ENGINE_API void Stop();
+
 			/**
 			* Yields the engine to the OS.
 			*/
@@ -160,24 +303,73 @@ inline BIO::ENGINE::ErrorType BIO::ENGINE::BIOEngine::GetError()
 	return _error;
 }
 
+inline bool BIO::ENGINE::BIOEngine::IsHeadless()
+{
+	return _headless;
+}
+
 inline bool BIO::ENGINE::BIOEngine::IsWindowActive()
 {
 	return _device->isWindowActive();
 }
 
+inline BIO::ENGINE::FrameScheduler & BIO::ENGINE::BIOEngine::GetFrameScheduler()
+{
+	return _scheduler;
+}
+
+inline BIO::CORE::JobSystem & BIO::ENGINE::BIOEngine::GetJobSystem()
+{
+	return *_jobs;
+}
+
+inline BIO::ENGINE::LevelCache & BIO::ENGINE::BIOEngine::GetLevelCache()
+{
+	return _levelCache;
+}
+
+inline std::shared_ptr<BIO::ENGINE::World> BIO::ENGINE::BIOEngine::GetWorld()
+{
+	return std::atomic_load(&_world);
+}
+
 inline bool BIO::ENGINE::BIOEngine::LoadLevel(std::string filename)
 {
 	return LoadLevel(filename.c_str());
 }
 
+inline BIO::ENGINE::LevelLoadHandle BIO::ENGINE::BIOEngine::LoadLevelAsync(std::string filename)
+{
+	return LoadLevelAsync(filename.c_str());
+}
+
 inline bool BIO::ENGINE::BIOEngine::Run()
 {
-	return _device->run();
+	if (!_device->run())
+		return false;
+
+	_jobs->RunMainThreadJobs();
+
+	World * loaded = _levelStreamer.Update(_device->getSceneManager(), _levelUploadBudget);
+	if (loaded)
+		_SetWorld(loaded);
+
+	return true;
+}
+
+inline void BIO::ENGINE::BIOEngine::DrawFrame()
+{
+	_DrawFrame(NULL, 0.0f);
+}
+
+inline void BIO::ENGINE::BIOEngine::Stop()
+{
+	_device->closeDevice();
 }
 
 inline void BIO::ENGINE::BIOEngine::Yield()
 {
-	BIO_LOG_DEBUG4("Yielding Engine.");
+	BIO_LOG_ENGINE(DEBUG4, "Yielding Engine.");
 	_device->yield();
 }
 
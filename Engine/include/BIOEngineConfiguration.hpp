@@ -30,6 +30,7 @@
 
 #include "Config.h"
 #include "EngineTypes.hpp"
+#include "LevelCache.hpp"
 
 namespace BIO
 {
@@ -44,6 +45,13 @@ namespace BIO
 			/**The driver type to use for rendering.*/
 			RENDERING_DRIVER renderingDriver;
 
+			/**
+			* Render into memory with Burning's Video and no window. Use it on machines without a
+			* display or graphics card and read the frames with BIOEngine::GetFrame. 
+			* renderingDriver, fullscreen and enableVeticalSync are ignored.
+			*/
+			bool headless;
+
 			/**The Width of the rendering screen.*/
 			unsigned int screenWidth;
 
@@ -62,6 +70,54 @@ namespace BIO
 			/**Enable Vertical Sync.*/
 			bool enableVeticalSync;
 
+			/**
+			* About how many microseconds each frame may spend creating the meshes of a level 
+			* that is loading in the background.
+			*/
+			unsigned int levelUploadBudget;
+
+			/**The most bytes of loaded levels to keep so they can be loaded again quickly.*/
+			unsigned int levelCacheBudget;
+
+			/**How the level cache decides a level file has changed.*/
+			LEVEL_CACHE_KEY levelCacheKey;
+
+			/**The number of fixed simulation updates a second in RunLoop.*/
+			double updateRate;
+
+			/**The number of frames a second RunLoop paces to. 0 for no pacing.*/
+			double targetFrameRate;
+
+			/**The most fixed updates one frame may run before time is dropped.*/
+			unsigned int maxUpdatesPerFrame;
+
+			/**Microseconds before a frame is due that pacing stops sleeping and spins.*/
+			unsigned int frameSpinTime;
+
+			/**The number of job system worker threads. 0 uses one less than the number of cores.*/
+			unsigned int jobWorkerCount;
+
+			/**Keep each job system worker on its own core.*/
+			bool pinJobWorkers;
+
+			/**
+			* The number of threads the Burning's Video software renderer rasterizes screen 
+			* tiles on. 0 or 1 rasterizes on the rendering thread only.
+			*/
+			unsigned int softwareRasterThreads;
+
+			/**
+			* The number of threads the scene graph is animated on each frame. The subtrees below 
+			* the root are split between them. 0 or 1 animates on the rendering thread only.
+			*/
+			unsigned int sceneAnimateThreads;
+
+			/**
+			* Keep a bounding volume tree of the scene nodes, which culls whole groups of nodes 
+			* at once and speeds up picking. Worth it for big scenes that mostly stand still.
+			*/
+			bool sceneBoundingVolumeTree;
+
 			/**
 			* Default Constructor
 			*/
@@ -77,12 +133,25 @@ namespace BIO
 
 inline BIO::ENGINE::BIOEngineConfiguration::BIOEngineConfiguration():
 renderingDriver(RD_OPEN_GL),
+headless(false),
 screenWidth(640),
 screenHeight(480),
 bits(32),
 fullscreen(false),
 enableStencilBuffer(false),
-enableVeticalSync(true)
+enableVeticalSync(true),
+levelUploadBudget(2000),
+levelCacheBudget(64 * 1024 * 1024),
+levelCacheKey(LEVEL_CACHE_KEY_TIMESTAMP),
+updateRate(60.0),
+targetFrameRate(60.0),
+maxUpdatesPerFrame(5),
+frameSpinTime(1500),
+jobWorkerCount(0),
+pinJobWorkers(false),
+softwareRasterThreads(0),
+sceneAnimateThreads(0),
+sceneBoundingVolumeTree(false)
 {
 	//Do Nothing
 }
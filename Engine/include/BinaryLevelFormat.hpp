@@ -0,0 +1,122 @@
+/**
+* @file BinaryLevelFormat.hpp
+* @author Spencer Hoffa
+*
+* The layout of a cooked (binary) level file.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_BINARYLEVELFORMAT_HPP__2015___
+#define ___BIO_ENGINE_BINARYLEVELFORMAT_HPP__2015___
+
+#include "../../Core/include/BasicTypes.hpp"
+
+/**The first four bytes of every binary level file.*/
+#define BIO_BINARY_LEVEL_MAGIC "BIOL"
+
+/**The version of the binary level format. Change this whenever the layout changes.*/
+#define BIO_BINARY_LEVEL_VERSION 1
+
+/**Every array in a binary level file starts on a multiple of this many bytes.*/
+#define BIO_BINARY_LEVEL_ALIGNMENT 16
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/*
+		* A binary level file is laid out as:
+		*
+		*   BinaryLevelHeader
+		*   BinaryLevelObject[ObjectCount]		at ObjectsOffset
+		*   BinaryLevelTransform[ObjectCount]	at TransformsOffset
+		*   string table						at StringsOffset
+		*
+		* Everything is little endian. Strings are stored as offsets into the string table, which 
+		* is a list of null terminated strings that starts with an empty string so offset 0 is "".
+		* The arrays are aligned so the file can be mapped into memory and used in place.
+		*/
+
+		/**
+		* The header at the start of a binary level file. Holds the LevelInfo and where the 
+		* arrays are.
+		*/
+		struct BinaryLevelHeader
+		{
+			char Magic[4];					/**< BIO_BINARY_LEVEL_MAGIC*/
+			CORE::uint32 Version;			/**< BIO_BINARY_LEVEL_VERSION*/
+			CORE::uint32 FileSize;			/**< The size of the whole file in bytes.*/
+			CORE::uint32 ObjectCount;		/**< The number of objects in the level.*/
+			CORE::uint32 ObjectsOffset;		/**< Where the BinaryLevelObject array starts.*/
+			CORE::uint32 TransformsOffset;	/**< Where the BinaryLevelTransform array starts.*/
+			CORE::uint32 StringsOffset;		/**< Where the string table starts.*/
+			CORE::uint32 StringsSize;		/**< The size of the string table in bytes.*/
+			//LevelInfo -------------------------------------------------------
+			CORE::uint32 Name;				/**< String offset of the level's name.*/
+			CORE::uint32 LevelFilename;		/**< String offset of the level geometry file.*/
+			CORE::uint32 ToFollow;			/**< String offset of the object the camera follows.*/
+			CORE::uint32 CameraType;		/**< A CAMERA_TYPE.*/
+			CORE::float32 Gravity[3];		/**< Direction and strength of gravity.*/
+			CORE::float32 Latitude;			/**< Latitude of the level in radians.*/
+			CORE::float32 AmbientLight[4];	/**< r, g, b, a of the ambient light.*/
+			CORE::float32 MinView;			/**< The minimum view range of the camera.*/
+			CORE::float32 MaxView;			/**< The maximum view range of the camera.*/
+			CORE::float32 FollowDistance;	/**< Distance from the object to follow at.*/
+			CORE::float32 FollowHeight;		/**< Height from the object to follow at.*/
+			CORE::float32 Position[3];		/**< The position of a default camera.*/
+			CORE::float32 LookAt[3];		/**< The point to look at for the default camera.*/
+			CORE::uint32 Reserved[2];		/**< Always 0. Pads the header to 128 bytes.*/
+		};
+
+		/**
+		* The parts of an object that are not used every frame.
+		*/
+		struct BinaryLevelObject
+		{
+			CORE::uint32 Name;				/**< String offset of the object's name.*/
+			CORE::uint32 Model;				/**< String offset of the object's model file.*/
+			CORE::uint32 Texture;			/**< String offset of the object's texture file.*/
+			CORE::uint32 Reserved;			/**< Always 0.*/
+			CORE::float32 Tint[4];			/**< r, g, b, a of the object's color.*/
+		};
+
+		/**
+		* Where an object is placed. Kept apart from BinaryLevelObject so code that only needs 
+		* the transforms only touches their pages.
+		*/
+		struct BinaryLevelTransform
+		{
+			CORE::float32 Position[3];		/**< Where the object is placed.*/
+			CORE::float32 Rotation[3];		/**< The rotation of the object in degrees.*/
+			CORE::float32 Scale[3];			/**< The scale of the object.*/
+			CORE::float32 Reserved[3];		/**< Always 0.*/
+		};
+
+		static_assert(sizeof(BinaryLevelHeader) == 128, "BinaryLevelHeader must be 128 bytes");
+		static_assert(sizeof(BinaryLevelObject) % BIO_BINARY_LEVEL_ALIGNMENT == 0, 
+			"BinaryLevelObject must keep the array aligned");
+		static_assert(sizeof(BinaryLevelTransform) % BIO_BINARY_LEVEL_ALIGNMENT == 0, 
+			"BinaryLevelTransform must keep the array aligned");
+	}//end namespace ENGINE
+}//end namespace BIO
+
+#endif //___BIO_ENGINE_BINARYLEVELFORMAT_HPP__2015___
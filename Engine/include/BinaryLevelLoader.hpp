@@ -0,0 +1,257 @@
+/**
+* @file BinaryLevelLoader.hpp
+* @author Spencer Hoffa
+*
+* A Level Loader for cooked (binary) level files.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_BINARYLEVELLOADER_HPP__2015___
+#define ___BIO_ENGINE_BINARYLEVELLOADER_HPP__2015___
+
+#include "Config.h"
+#include "ILevelLoader.hpp"
+#include "BinaryLevelFormat.hpp"
+#include "../../Core/include/MappedFile.hpp"
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* A Level Loader for level files made by the LevelCooker. The file is mapped into memory 
+		* and checked, but nothing is parsed or copied: the objects, transforms and strings are 
+		* read in place through GetObjects, GetTransforms and GetString for as long as the loader
+		* is alive. Only the pages that are touched are ever read from disk.
+		*
+		* LoadLevel still builds a World, which copies every object.
+		*/
+		class BinaryLevelLoader : public ILevelLoader
+		{
+		private:
+			/**
+			* The mapped level file.
+			*/
+			FILE::MappedFile _file;
+
+			/**
+			* The header at the start of the mapped file. NULL until parsed.
+			*/
+			const BinaryLevelHeader * _header;
+
+			/**
+			* The objects in the mapped file.
+			*/
+			const BinaryLevelObject * _objects;
+
+			/**
+			* The transforms in the mapped file.
+			*/
+			const BinaryLevelTransform * _transforms;
+
+			/**
+			* The string table in the mapped file.
+			*/
+			const char * _strings;
+
+			/**
+			* Check that the mapped file is a binary level this code can read and that every 
+			* offset in it is inside of the file.
+			*
+			* @return Returns true if the file can be used.
+			*/
+			bool _Validate() const;
+
+		public:
+			/**
+			* Constructor
+			*/
+			BIO_ENGINE_API BinaryLevelLoader();
+
+			/**
+			* Constructor
+			*
+			* @param filename The name of the file to load the level from.
+			*/
+			BIO_ENGINE_API BinaryLevelLoader(std::string filename);
+			BIO_ENGINE_API BinaryLevelLoader(const char * filename);
+
+			/**
+			* Destructor
+			*/
+			BIO_ENGINE_API virtual ~BinaryLevelLoader();
+
+			/**
+			* Clear any data previously loaded and unmap the file.
+			*/
+			BIO_ENGINE_API virtual void Clear();
+
+			/**
+			* Parses the data (if it wasn't already parsed) then creates a World object from the 
+			* mapped file and returns a pointer to it.
+			*
+			* @NOTE This function will create the World object on the heap so it is your
+			*		responsibility to make sure it is deleted, or passed into an object that will
+			*		delete it.
+			*
+			* @return Returns a pointer to a World object or NULL if the file could not be read.
+			*/
+			BIO_ENGINE_API virtual World * LoadLevel();
+
+			/**
+			* Map the level file, check it and fill in the LevelInfo from its header.
+			*/
+			BIO_ENGINE_API virtual void ParseLevel();
+
+			/**
+			* Get the number of objects in the level.
+			*
+			* @return Returns the number of objects or 0 if the level is not parsed.
+			*/
+			BIO_ENGINE_API CORE::uint32 GetObjectCount() const;
+
+			/**
+			* Get the objects stored in the level file.
+			*
+			* @return Returns a pointer to GetObjectCount objects in the mapped file, or NULL if 
+			*			the level is not parsed.
+			*/
+			BIO_ENGINE_API const BinaryLevelObject * GetObjects() const;
+
+			/**
+			* Get the transforms of the objects stored in the level file. The transform of an 
+			* object has the same index as the object.
+			*
+			* @return Returns a pointer to GetObjectCount transforms in the mapped file, or NULL 
+			*			if the level is not parsed.
+			*/
+			BIO_ENGINE_API const BinaryLevelTransform * GetTransforms() const;
+
+			/**
+			* Get a string from the level file's string table.
+			*
+			* @param offset The string offset stored in a header or object.
+			*
+			* @return Returns the null terminated string in the mapped file. Returns "" if the 
+			*			offset is not in the table.
+			*/
+			BIO_ENGINE_API const char * GetString(CORE::uint32 offset) const;
+
+			/**
+			* Check if a file is a binary level file by reading its magic number.
+			*
+			* @param filename The file to check.
+			*
+			* @return Returns true if the file starts with BIO_BINARY_LEVEL_MAGIC.
+			*/
+			BIO_ENGINE_API static bool IsBinaryLevel(const char * filename);
+
+			/**
+			* Write a level to a binary level file. Strings used more than once (such as model 
+			* files) are only stored once.
+			*
+			* @param filename The file to write.
+			* @param info The level's information.
+			* @param world The world holding the level's objects.
+			*
+			* @return Returns true if the file was written.
+			*/
+			BIO_ENGINE_API static bool WriteLevel(const char * filename, 
+				const LevelInfo & info, 
+				const World & world);
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+			BIO_ENGINE_API static bool Test(XNELO::TESTING::Test * test);
+#endif
+		};
+	}//end namespace ENGINE
+}//end namespace BIO
+
+inline BIO::ENGINE::BinaryLevelLoader::BinaryLevelLoader() : 
+	ILevelLoader(), 
+	_file(), 
+	_header(NULL), 
+	_objects(NULL), 
+	_transforms(NULL), 
+	_strings(NULL)
+{
+	BIO_LOG_LOADER(INFO, "BinaryLevelLoader Constructor");
+}
+
+inline BIO::ENGINE::BinaryLevelLoader::BinaryLevelLoader(std::string filename) : 
+	ILevelLoader(filename), 
+	_file(), 
+	_header(NULL), 
+	_objects(NULL), 
+	_transforms(NULL), 
+	_strings(NULL)
+{
+	BIO_LOG_LOADER(INFO, "BinaryLevelLoader Constructor. filename = %s", filename);
+}
+
+inline BIO::ENGINE::BinaryLevelLoader::BinaryLevelLoader(const char * filename) : 
+	ILevelLoader(filename), 
+	_file(), 
+	_header(NULL), 
+	_objects(NULL), 
+	_transforms(NULL), 
+	_strings(NULL)
+{
+	BIO_LOG_LOADER(INFO, "BinaryLevelLoader Constructor. filename = %s", filename);
+}
+
+inline BIO::ENGINE::BinaryLevelLoader::~BinaryLevelLoader()
+{
+	BIO_LOG_LOADER(INFO, "BinaryLevelLoader Destructor");
+
+	//the base destructor can only call the base Clear
+	Clear();
+}
+
+inline BIO::CORE::uint32 BIO::ENGINE::BinaryLevelLoader::GetObjectCount() const
+{
+	return _header ? _header->ObjectCount : 0;
+}
+
+inline const BIO::ENGINE::BinaryLevelObject * BIO::ENGINE::BinaryLevelLoader::GetObjects() const
+{
+	return _objects;
+}
+
+inline const BIO::ENGINE::BinaryLevelTransform * BIO::ENGINE::BinaryLevelLoader::GetTransforms() const
+{
+	return _transforms;
+}
+
+inline const char * BIO::ENGINE::BinaryLevelLoader::GetString(CORE::uint32 offset) const
+{
+	if ((_header == NULL) || (offset >= _header->StringsSize))
+		return "";
+
+	return _strings + offset;
+}
+
+#endif //___BIO_ENGINE_BINARYLEVELLOADER_HPP__2015___
@@ -47,7 +47,9 @@ namespace BIO
 			/**DirectX 9. Available on Windows.*/
 			RD_DIRECT_3D9,
 			/**Open GL. Available on most platforms. Open source specification.*/
-			RD_OPEN_GL
+			RD_OPEN_GL,
+			/**Burning's software renderer. Available everywhere, needs no graphics card.*/
+			RD_BURNINGS_VIDEO
 		};
 
 		/**
@@ -61,8 +63,31 @@ namespace BIO
 			CAMERA_FOLLOW
 		};
 
+		/**
+		* A view of the pixels of the last frame rendered into memory. It does not own or copy 
+		* the pixels. They are valid until the next frame is drawn or the screen is resized.
+		*/
+		struct FrameView
+		{
+			/**The first pixel of the top row. NULL if the frame is not rendered into memory.*/
+			const void * pixels;
+
+			/**The width of the frame in pixels.*/
+			unsigned int width;
+
+			/**The height of the frame in pixels.*/
+			unsigned int height;
+
+			/**The number of bytes from the start of one row to the start of the next.*/
+			unsigned int pitch;
+
+			/**The layout of each pixel.*/
+			irr::video::ECOLOR_FORMAT format;
+		};
+
 		typedef irr::core::vector3df Vector3;
 		typedef irr::core::vector2df Vector2;
+		typedef irr::video::SColorf Color;
 	}//end namespace Engine
 }//end namespace BIO
 
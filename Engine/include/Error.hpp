@@ -41,6 +41,8 @@ namespace BIO
 		const ErrorType ERROR_CREATING_RENDERING_DEVICE = 1;
 		const ErrorType ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS = 2;
 		const ErrorType ERROR_NOT_IMPLEMENTED = 3;
+		const ErrorType ERROR_LOADLEVEL__PARSE_FAILED = 4;
+		const ErrorType ERROR_LOADLEVEL__INVALID_BINARY = 5;
 
 		char * GetErrorString(ErrorType error);
 	}//end namespace ENGINE
@@ -52,6 +54,14 @@ inline char * BIO::ENGINE::GetErrorString(ErrorType error)
 	{
 	case ERROR_CREATING_RENDERING_DEVICE:
 		return "Error Creating Rendering Device.";
+	case ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS:
+		return "Level File Does Not Exist.";
+	case ERROR_NOT_IMPLEMENTED:
+		return "Not Implemented.";
+	case ERROR_LOADLEVEL__PARSE_FAILED:
+		return "Error Parsing Level File.";
+	case ERROR_LOADLEVEL__INVALID_BINARY:
+		return "Invalid Binary Level File.";
 	default:
 		return "Unrecognized Error.";
 	}
@@ -0,0 +1,255 @@
+/**
+* @file FrameScheduler.hpp
+* @author Spencer Hoffa
+*
+* Runs the simulation at a fixed rate and paces frames to a target frame rate.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_FRAMESCHEDULER_HPP__2015___
+#define ___BIO_ENGINE_FRAMESCHEDULER_HPP__2015___
+
+#include "Config.h"
+#include "../../Core/include/BasicTypes.hpp"
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+/**The number of frames the frame time statistics are taken over.*/
+#define BIO_FRAME_STATS_WINDOW 120
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* Frame time statistics. All times are in seconds and are taken over the last 
+		* BIO_FRAME_STATS_WINDOW frames unless noted.
+		*/
+		struct FrameStats
+		{
+			CORE::uint64 FrameCount;		/**< Frames since the scheduler was reset.*/
+			CORE::uint64 UpdateCount;		/**< Fixed updates since the scheduler was reset.*/
+			CORE::uint64 DroppedUpdates;	/**< Updates skipped because a frame took too long.*/
+			double LastFrameTime;			/**< The time between the last two frames.*/
+			double AverageFrameTime;		/**< The average time between frames.*/
+			double MinFrameTime;			/**< The shortest time between frames.*/
+			double MaxFrameTime;			/**< The longest time between frames.*/
+			double AverageWorkTime;			/**< The average time a frame spent before pacing.*/
+		};
+
+		/**
+		* Decides how many fixed simulation updates each frame runs and how long to wait before
+		* the next frame.
+		*
+		* Each frame call BeginFrame, run the returned number of updates with GetFixedDelta as 
+		* the time step, render using GetInterpolation to blend between the last two updates, 
+		* then call EndFrame. The simulation always moves by the same step so its cost and 
+		* results do not depend on the frame rate.
+		*
+		* EndFrame sleeps until shortly before the next frame is due and then spins the rest 
+		* of the way, since a sleep can wake up late by more than a millisecond.
+		*/
+		class FrameScheduler
+		{
+		private:
+			/**
+			* The time step of one update in seconds.
+			*/
+			double _fixedDelta;
+
+			/**
+			* The time a frame should take in seconds. 0 for no pacing.
+			*/
+			double _targetFrameTime;
+
+			/**
+			* The most updates one frame may run.
+			*/
+			unsigned int _maxUpdates;
+
+			/**
+			* How long before a frame is due to stop sleeping and start spinning, in seconds.
+			*/
+			double _spinTime;
+
+			/**
+			* Time that has passed but not been simulated yet.
+			*/
+			double _accumulator;
+
+			/**
+			* When the current frame started. 0 before the first frame.
+			*/
+			double _frameStart;
+
+			/**
+			* The statistics.
+			*/
+			FrameStats _stats;
+
+			/**
+			* The last frame times, used for the statistics.
+			*/
+			double _frameTimes[BIO_FRAME_STATS_WINDOW];
+
+			/**
+			* The last work times, used for the statistics.
+			*/
+			double _workTimes[BIO_FRAME_STATS_WINDOW];
+
+			/**
+			* Update the statistics over the window.
+			*/
+			void _UpdateStats();
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param updateRate The number of fixed updates a second.
+			* @param targetFrameRate The number of frames a second to pace to. 0 for no pacing.
+			* @param maxUpdates The most updates one frame may run. Time beyond that is dropped
+			*			so a slow frame does not make the next one slower.
+			* @param spinTime Microseconds before a frame is due to stop sleeping and spin.
+			*/
+			BIO_ENGINE_API FrameScheduler(double updateRate = 60.0, 
+				double targetFrameRate = 0.0, 
+				unsigned int maxUpdates = 5, 
+				unsigned int spinTime = 1500);
+
+			/**
+			* Start a frame. Measures the time since the last frame and works out how many 
+			* updates to run.
+			*
+			* @return Returns the number of fixed updates to run this frame.
+			*/
+			BIO_ENGINE_API unsigned int BeginFrame();
+
+			/**
+			* Start a frame with a known frame time instead of measuring it.
+			*
+			* @param frameTime The seconds since the last frame.
+			*
+			* @return Returns the number of fixed updates to run this frame.
+			*/
+			BIO_ENGINE_API unsigned int Advance(double frameTime);
+
+			/**
+			* End a frame. Waits until the next frame is due if there is a target frame rate.
+			*/
+			BIO_ENGINE_API void EndFrame();
+
+			/**
+			* Get the time step of one fixed update.
+			*
+			* @return Returns the step in seconds.
+			*/
+			BIO_ENGINE_API double GetFixedDelta() const;
+
+			/**
+			* Get how far the current time is between the last update and the next one. Render
+			* objects at previous + (current - previous) * GetInterpolation().
+			*
+			* @return Returns a value from 0.0 to 1.0.
+			*/
+			BIO_ENGINE_API float GetInterpolation() const;
+
+			/**
+			* Get the frame time statistics.
+			*
+			* @return Returns the statistics.
+			*/
+			BIO_ENGINE_API const FrameStats & GetStats() const;
+
+			/**
+			* Get the frame rate being paced to.
+			*
+			* @return Returns frames a second or 0 if frames are not paced.
+			*/
+			BIO_ENGINE_API double GetTargetFrameRate() const;
+
+			/**
+			* Forget all time that has passed and reset the statistics.
+			*/
+			BIO_ENGINE_API void Reset();
+
+			/**
+			* Forget all time that has passed but keep the statistics. Call this after a pause 
+			* so the simulation does not try to catch up.
+			*/
+			BIO_ENGINE_API void Resync();
+
+			/**
+			* Set the frame rate to pace to.
+			*
+			* @param targetFrameRate Frames a second or 0 for no pacing.
+			*/
+			BIO_ENGINE_API void SetTargetFrameRate(double targetFrameRate);
+
+			/**
+			* Get a high resolution time.
+			*
+			* @return Returns seconds since an unspecified point.
+			*/
+			BIO_ENGINE_API static double GetTime();
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+			BIO_ENGINE_API static bool Test(XNELO::TESTING::Test * test);
+#endif
+		};
+	}//end namespace ENGINE
+}//end namespace BIO
+
+inline double BIO::ENGINE::FrameScheduler::GetFixedDelta() const
+{
+	return _fixedDelta;
+}
+
+inline float BIO::ENGINE::FrameScheduler::GetInterpolation() const
+{
+	return (float)(_accumulator / _fixedDelta);
+}
+
+inline const BIO::ENGINE::FrameStats & BIO::ENGINE::FrameScheduler::GetStats() const
+{
+	return _stats;
+}
+
+inline double BIO::ENGINE::FrameScheduler::GetTargetFrameRate() const
+{
+	return (_targetFrameTime > 0.0) ? (1.0 / _targetFrameTime) : 0.0;
+}
+
+inline void BIO::ENGINE::FrameScheduler::Resync()
+{
+	_accumulator = 0.0;
+	_frameStart = 0.0;
+}
+
+inline void BIO::ENGINE::FrameScheduler::SetTargetFrameRate(double targetFrameRate)
+{
+	_targetFrameTime = (targetFrameRate > 0.0) ? (1.0 / targetFrameRate) : 0.0;
+}
+
+#endif //___BIO_ENGINE_FRAMESCHEDULER_HPP__2015___
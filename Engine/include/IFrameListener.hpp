@@ -0,0 +1,71 @@
+/**
+* @file IFrameListener.hpp
+* @author Spencer Hoffa
+*
+* An interface for code that runs every frame of the engine's main loop.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_IFRAMELISTENER_HPP__2015___
+#define ___BIO_ENGINE_IFRAMELISTENER_HPP__2015___
+
+#include "Config.h"
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		class BIOEngine;
+
+		/**
+		* An abstract interface for the game code run by BIOEngine::RunLoop.
+		*/
+		class IFrameListener
+		{
+		public:
+			/**
+			* Destructor
+			*/
+			virtual ~IFrameListener() {}
+
+			/**
+			* Move the simulation forward by one fixed step. Called zero or more times a frame.
+			*
+			* @param engine The engine running the loop.
+			* @param delta The time step in seconds. Always the same.
+			*/
+			virtual void OnFixedUpdate(BIOEngine & engine, double delta) = 0;
+
+			/**
+			* Get ready to draw a frame. Called once a frame before the scene is drawn.
+			*
+			* @param engine The engine running the loop.
+			* @param interpolation How far the frame is between the last fixed update and the 
+			*			next one, from 0.0 to 1.0. Blend between the last two simulation states 
+			*			by this much for smooth motion.
+			*/
+			virtual void OnRender(BIOEngine & engine, float interpolation) = 0;
+		};
+	}//end namespace ENGINE
+}//end namespace BIO
+
+#endif //___BIO_ENGINE_IFRAMELISTENER_HPP__2015___
@@ -47,8 +47,11 @@ namespace BIO
 		struct LevelInfo
 		{
 		public:
+			std::string Name;			/**< The name of the level.*/
 			std::string LevelFilename;	/**< The file that hold level geometry.*/
 			Vector3 Gravity;			/**< Direction and strength of gravity.*/
+			float Latitude;				/**< Latitude of the level in radians.*/
+			Color AmbientLight;			/**< The light that reaches every part of the level.*/
 			//Camera Data -----------------------------------------------------
 			CAMERA_TYPE CameraType;		/**< The type of camera to create.*/
 			float MinView;				/**< The minimum view range of the camera.*/
@@ -64,8 +67,11 @@ namespace BIO
 			* Constructor
 			*/
 			LevelInfo() :
+				Name(""),
 				LevelFilename(""),
 				Gravity(0.0f, -9.8f, 0.0f),
+				Latitude(0.0f),
+				AmbientLight(1.0f, 1.0f, 1.0f, 1.0f),
 				CameraType(CAMERA_DEFAULT),
 				MinView(0.1f),
 				MaxView(1000.0f),
@@ -92,8 +98,11 @@ namespace BIO
 
 			void Clear()
 			{
+				Name = "";
 				LevelFilename = "";
 				Gravity.set(0.0f, -9.8f, 0.0f);
+				Latitude = 0.0f;
+				AmbientLight = Color(1.0f, 1.0f, 1.0f, 1.0f);
 				CameraType = CAMERA_DEFAULT;
 				MinView = 0.1f;
 				MaxView = 1000.0f;
@@ -107,8 +116,11 @@ namespace BIO
 		private:
 			void _DeepCopy(const LevelInfo & other)
 			{
+				Name = other.Name;
 				LevelFilename = other.LevelFilename;
 				Gravity = other.Gravity;
+				Latitude = other.Latitude;
+				AmbientLight = other.AmbientLight;
 				CameraType = other.CameraType;
 				MinView = other.MinView;
 				MaxView = other.MaxView;
@@ -261,22 +273,22 @@ namespace BIO
 
 inline BIO::ENGINE::ILevelLoader::ILevelLoader() : _error(OK), _filename(), _isParsed(false), _levelInfo()
 {
-	BIO_LOG_INFO("ILevelLoader Constructed");
+	BIO_LOG_LOADER(INFO, "ILevelLoader Constructed");
 }
 
 inline BIO::ENGINE::ILevelLoader::ILevelLoader(std::string filename) : _error(OK), _filename(filename), _isParsed(false), _levelInfo()
 {
-	BIO_LOG_INFO("ILevelLoader Constructed");
+	BIO_LOG_LOADER(INFO, "ILevelLoader Constructed");
 }
 
 inline BIO::ENGINE::ILevelLoader::ILevelLoader(const char * filename) : _error(OK), _filename(filename), _isParsed(false), _levelInfo()
 {
-	BIO_LOG_INFO("ILevelLoader Constructed");
+	BIO_LOG_LOADER(INFO, "ILevelLoader Constructed");
 }
 
 inline BIO::ENGINE::ILevelLoader::~ILevelLoader()
 {
-	BIO_LOG_INFO("Destroying ILevelLoader");
+	BIO_LOG_LOADER(INFO, "Destroying ILevelLoader");
 	Clear();
 	_filename = "";
 }
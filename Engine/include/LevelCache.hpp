@@ -0,0 +1,271 @@
+/**
+* @file LevelCache.hpp
+* @author Spencer Hoffa
+*
+* Keeps recently loaded levels in memory so loading them again skips parsing.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_LEVELCACHE_HPP__2015___
+#define ___BIO_ENGINE_LEVELCACHE_HPP__2015___
+
+#include "Config.h"
+#include "Error.hpp"
+#include "ILevelLoader.hpp"
+#include "World.hpp"
+#include "../../Core/include/BasicTypes.hpp"
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* How the LevelCache decides a level file has not changed.
+		*/
+		enum LEVEL_CACHE_KEY
+		{
+			/**The file's modification time and size must match. Costs one stat.*/
+			LEVEL_CACHE_KEY_TIMESTAMP = 0,
+			/**The file's size and a hash of its contents must match. Reads the whole file.*/
+			LEVEL_CACHE_KEY_CONTENT
+		};
+
+		/**
+		* A cache in front of the level loaders. Levels are kept by filename along with what the
+		* file looked like when it was loaded, so loading an unchanged file again copies the 
+		* cached World instead of parsing the file. When the cache uses more memory than its 
+		* budget the least recently used levels are thrown away.
+		*
+		* The cache may be used from any thread. Files are parsed outside of the lock.
+		*/
+		class LevelCache
+		{
+		private:
+			/**
+			* A level kept in the cache.
+			*/
+			struct _Entry
+			{
+				std::string Filename;		/**< The file the level was loaded from.*/
+				CORE::uint64 Size;			/**< The size of the file.*/
+				CORE::uint64 Stamp;			/**< The modification time or content hash.*/
+				LevelInfo Info;				/**< The parsed level information.*/
+				World Level;				/**< The loaded world.*/
+				CORE::uint64 Memory;		/**< About how many bytes the entry uses.*/
+			};
+
+			/**
+			* The entries, most recently used first.
+			*/
+			std::list<_Entry> _entries;
+
+			/**
+			* Finds the entry for a filename.
+			*/
+			std::unordered_map<std::string, std::list<_Entry>::iterator> _lookup;
+
+			/**
+			* Guards everything in the cache.
+			*/
+			mutable std::mutex _mutex;
+
+			/**
+			* The most bytes the cache may use. 0 turns the cache off.
+			*/
+			CORE::uint64 _budget;
+
+			/**
+			* The bytes used by all of the entries.
+			*/
+			CORE::uint64 _memory;
+
+			/**
+			* How files are checked for changes.
+			*/
+			LEVEL_CACHE_KEY _key;
+
+			/**
+			* The number of loads that used a cached level.
+			*/
+			CORE::uint64 _hits;
+
+			/**
+			* The number of loads that had to parse the file.
+			*/
+			CORE::uint64 _misses;
+
+			/**
+			* The number of levels thrown away to stay in the budget.
+			*/
+			CORE::uint64 _evictions;
+
+			/**
+			* Get what a file looks like now.
+			*
+			* @param[in] key How to check the file.
+			* @param[in] filename The file.
+			* @param[out] size The size of the file.
+			* @param[out] stamp The modification time or content hash of the file.
+			*
+			* @return Returns false if the file could not be read.
+			*/
+			static bool _GetStamp(LEVEL_CACHE_KEY key, 
+				const char * filename, 
+				CORE::uint64 & size, 
+				CORE::uint64 & stamp);
+
+			/**
+			* Throw away the least recently used entries until the cache is in its budget.
+			* The caller must hold the lock.
+			*/
+			void _Trim();
+
+			/**Do not allow copying.*/
+			LevelCache(const LevelCache & other);
+			LevelCache & operator = (const LevelCache & other);
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param budget The most bytes the cache may use. 0 turns the cache off.
+			* @param key How files are checked for changes.
+			*/
+			BIO_ENGINE_API LevelCache(CORE::uint64 budget = 64 * 1024 * 1024, 
+				LEVEL_CACHE_KEY key = LEVEL_CACHE_KEY_TIMESTAMP);
+
+			/**
+			* Throw away every cached level. The counters are not reset.
+			*/
+			BIO_ENGINE_API void Clear();
+
+			/**
+			* Get the most bytes the cache may use.
+			*/
+			BIO_ENGINE_API CORE::uint64 GetBudget() const;
+
+			/**
+			* Get the number of levels in the cache.
+			*/
+			BIO_ENGINE_API unsigned int GetEntryCount() const;
+
+			/**
+			* Get the number of levels thrown away to stay in the budget.
+			*/
+			BIO_ENGINE_API CORE::uint64 GetEvictionCount() const;
+
+			/**
+			* Get the number of loads that used a cached level.
+			*/
+			BIO_ENGINE_API CORE::uint64 GetHitCount() const;
+
+			/**
+			* Get about how many bytes the cached levels use.
+			*/
+			BIO_ENGINE_API CORE::uint64 GetMemoryUsed() const;
+
+			/**
+			* Get the number of loads that had to parse the file.
+			*/
+			BIO_ENGINE_API CORE::uint64 GetMissCount() const;
+
+			/**
+			* Load a level, from the cache if the file has not changed since it was cached. 
+			* Binary levels use the BinaryLevelLoader and everything else the XMLLevelLoader.
+			*
+			* @param[in] filename The level file to load.
+			* @param[out] error Set to OK or the error from loading the level.
+			* @param[out] info If not NULL set to the level's information.
+			*
+			* @return Returns a new World that the caller owns or NULL if the level could not be
+			*			loaded.
+			*/
+			BIO_ENGINE_API World * Load(const char * filename, ErrorType & error, LevelInfo * info = NULL);
+
+			/**
+			* Set the most bytes the cache may use. Levels are thrown away if the cache is over 
+			* the new budget.
+			*
+			* @param budget The new budget. 0 turns the cache off.
+			*/
+			BIO_ENGINE_API void SetBudget(CORE::uint64 budget);
+
+			/**
+			* Set how files are checked for changes. Every cached level is thrown away.
+			*
+			* @param key The new way to check files.
+			*/
+			BIO_ENGINE_API void SetKey(LEVEL_CACHE_KEY key);
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+			BIO_ENGINE_API static bool Test(XNELO::TESTING::Test * test);
+#endif
+		};
+	}//end namespace ENGINE
+}//end namespace BIO
+
+inline BIO::CORE::uint64 BIO::ENGINE::LevelCache::GetBudget() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _budget;
+}
+
+inline unsigned int BIO::ENGINE::LevelCache::GetEntryCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return (unsigned int)_entries.size();
+}
+
+inline BIO::CORE::uint64 BIO::ENGINE::LevelCache::GetEvictionCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _evictions;
+}
+
+inline BIO::CORE::uint64 BIO::ENGINE::LevelCache::GetHitCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _hits;
+}
+
+inline BIO::CORE::uint64 BIO::ENGINE::LevelCache::GetMemoryUsed() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _memory;
+}
+
+inline BIO::CORE::uint64 BIO::ENGINE::LevelCache::GetMissCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _misses;
+}
+
+#endif //___BIO_ENGINE_LEVELCACHE_HPP__2015___
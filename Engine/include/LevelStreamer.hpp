@@ -0,0 +1,374 @@
+/**
+* @file LevelStreamer.hpp
+* @author Spencer Hoffa
+*
+* Loads levels in the background while the current level keeps running.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ___BIO_ENGINE_LEVELSTREAMER_HPP__2015___
+#define ___BIO_ENGINE_LEVELSTREAMER_HPP__2015___
+
+#include "Config.h"
+#include "../Irrlicht/include/irrlicht.h"
+
+#include "Error.hpp"
+#include "LevelCache.hpp"
+#include "World.hpp"
+#include "../../Core/include/Logger.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include "../../Xnelo-Testing/include/Testing.hpp"
+#endif
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* The steps a level goes through while it is loaded in the background.
+		*/
+		enum LEVEL_LOAD_STATE
+		{
+			/**The request has not started yet.*/
+			LEVEL_LOAD_PENDING = 0,
+			/**A worker thread is parsing the level file.*/
+			LEVEL_LOAD_PARSING,
+			/**A worker thread is reading and decoding the level's model and texture files.*/
+			LEVEL_LOAD_READING_ASSETS,
+			/**The main thread is adding the meshes and textures to the scene, a slice each frame.*/
+			LEVEL_LOAD_UPLOADING,
+			/**The level is loaded and has been made the current world.*/
+			LEVEL_LOAD_COMPLETE,
+			/**The level could not be loaded. See GetError.*/
+			LEVEL_LOAD_FAILED,
+			/**The request was cancelled before it finished.*/
+			LEVEL_LOAD_CANCELLED
+		};
+
+		/**
+		* A model or texture file read by a worker thread and waiting for the main thread to add
+		* it to the scene. Files the worker could decode are handed over as a mesh or an image, 
+		* the rest are kept as bytes for the main thread to decode.
+		*/
+		struct LevelAsset
+		{
+			std::string Filename;				/**< The name of the file. Used as the mesh's or texture's name.*/
+			bool IsTexture;						/**< True if the file is a texture, false if it is a model.*/
+			std::vector<char> Data;				/**< The contents of the file if it was not decoded.*/
+			irr::scene::IAnimatedMesh * Mesh;	/**< The decoded model or NULL. Holds a reference.*/
+			irr::video::IImage * Image;			/**< The decoded texture or NULL. Holds a reference.*/
+
+			/**
+			* Constructor
+			*/
+			LevelAsset() : Filename(), IsTexture(false), Data(), Mesh(NULL), Image(NULL) {}
+		};
+
+		/**
+		* One level being loaded in the background. The state, progress and error may be read
+		* from any thread.
+		*/
+		class LevelLoadRequest
+		{
+			friend class LevelStreamer;
+
+		private:
+			/**
+			* The level file to load.
+			*/
+			std::string _filename;
+
+			/**
+			* The LEVEL_LOAD_STATE of the request.
+			*/
+			std::atomic<int> _state;
+
+			/**
+			* How much of the level is loaded, from 0.0 to 1.0.
+			*/
+			std::atomic<float> _progress;
+
+			/**
+			* The error if the load failed.
+			*/
+			std::atomic<ErrorType> _error;
+
+			/**
+			* Set when the request should stop.
+			*/
+			std::atomic<bool> _cancel;
+
+			/**
+			* The cache to load the level through. May be NULL.
+			*/
+			LevelCache * _cache;
+
+			/**
+			* The loaded world. Owned by the request until it is handed to the engine.
+			*/
+			World * _world;
+
+			/**
+			* A scene manager of the request's own whose loaders the worker thread decodes with,
+			* so it never touches the running scene. NULL to only read the files. Owned by the 
+			* request.
+			*/
+			irr::scene::ISceneManager * _decoder;
+
+			/**
+			* The model and texture files read by the worker thread.
+			*/
+			std::vector<LevelAsset> _assets;
+
+			/**
+			* The number of assets the main thread has finished with.
+			*/
+			size_t _uploaded;
+
+			/**
+			* The worker thread parsing the level and reading its files.
+			*/
+			std::thread _thread;
+
+			/**
+			* The work done on the worker thread. Parses the level, then reads and decodes the
+			* model and texture files.
+			* Sets the state to LEVEL_LOAD_UPLOADING, LEVEL_LOAD_FAILED or LEVEL_LOAD_CANCELLED
+			* as the very last thing it does.
+			*/
+			void _Run();
+
+			/**
+			* Wait for the worker thread to finish.
+			*/
+			void _Join();
+
+			/**
+			* Delete the world if it was not handed over and drop the assets and the decoder. 
+			* Only call after _Join.
+			*/
+			void _Release();
+
+			/**Do not allow copying.*/
+			LevelLoadRequest(const LevelLoadRequest & other);
+			LevelLoadRequest & operator = (const LevelLoadRequest & other);
+
+		public:
+			/**
+			* Constructor
+			*
+			* @param filename The level file to load.
+			* @param cache The cache to load the level through. May be NULL.
+			* @param decoder The scene manager the worker thread decodes files with. The request
+			*			owns it. May be NULL.
+			*/
+			BIO_ENGINE_API LevelLoadRequest(const char * filename, LevelCache * cache = NULL, 
+				irr::scene::ISceneManager * decoder = NULL);
+
+			/**
+			* Destructor. Stops and waits for the worker thread if it is still running.
+			*/
+			BIO_ENGINE_API ~LevelLoadRequest();
+
+			/**
+			* Ask the request to stop. The level will not be made the current world.
+			*/
+			BIO_ENGINE_API void Cancel();
+
+			/**
+			* Get the error of a failed request.
+			*
+			* @return Returns OK unless the state is LEVEL_LOAD_FAILED.
+			*/
+			BIO_ENGINE_API ErrorType GetError() const;
+
+			/**
+			* Get the level file being loaded.
+			*
+			* @return Returns the filename.
+			*/
+			BIO_ENGINE_API const std::string & GetFilename() const;
+
+			/**
+			* Get how much of the level is loaded.
+			*
+			* @return Returns a value from 0.0 to 1.0.
+			*/
+			BIO_ENGINE_API float GetProgress() const;
+
+			/**
+			* Get the step the request is on.
+			*
+			* @return Returns the LEVEL_LOAD_STATE of the request.
+			*/
+			BIO_ENGINE_API LEVEL_LOAD_STATE GetState() const;
+
+			/**
+			* Check if the request is finished.
+			*
+			* @return Returns true if the request is complete, failed or was cancelled.
+			*/
+			BIO_ENGINE_API bool IsDone() const;
+		};
+
+		/**
+		* A handle to a level being loaded in the background. The handle can be kept after the
+		* load is finished.
+		*/
+		typedef std::shared_ptr<LevelLoadRequest> LevelLoadHandle;
+
+		/**
+		* Loads levels without blocking the main thread. Each level is parsed and its model and 
+		* texture files are read and decoded on a worker thread. The meshes and textures are 
+		* then added to the scene on the main thread a little at a time in Update so no frame 
+		* takes much longer than the others. Requests finish in the order they were made.
+		*
+		* Only OBJ, STL and PLY models are decoded on the worker thread because the other mesh 
+		* loaders load textures through the video driver while they parse. Their material 
+		* files are ignored, the level's textures are used instead. Other models are decoded in
+		* Update.
+		*
+		* Everything except the requests' state is only used from the main thread.
+		*/
+		class LevelStreamer
+		{
+		private:
+			/**
+			* The requests that are not finished yet, oldest first.
+			*/
+			std::deque<LevelLoadHandle> _requests;
+
+			/**Do not allow copying.*/
+			LevelStreamer(const LevelStreamer & other);
+			LevelStreamer & operator = (const LevelStreamer & other);
+
+		public:
+			/**
+			* Constructor
+			*/
+			BIO_ENGINE_API LevelStreamer();
+
+			/**
+			* Destructor. Cancels every request that is not finished.
+			*/
+			BIO_ENGINE_API ~LevelStreamer();
+
+			/**
+			* Cancel every request that is not finished and wait for their worker threads.
+			*/
+			BIO_ENGINE_API void CancelAll();
+
+			/**
+			* Get the number of requests that are not finished.
+			*
+			* @return Returns the number of requests.
+			*/
+			BIO_ENGINE_API unsigned int GetPendingCount() const;
+
+			/**
+			* Start loading a level in the background.
+			*
+			* @param filename The level file to load. Binary and XML levels are both supported.
+			* @param cache The cache to load the level through. If NULL the level is always 
+			*			parsed. The cache must outlive the request.
+			* @param sceneManager The scene manager Update will add the meshes and textures to. 
+			*			If NULL the files are read but not decoded.
+			*
+			* @return Returns a handle to follow the load with.
+			*/
+			BIO_ENGINE_API LevelLoadHandle Load(const char * filename, LevelCache * cache = NULL, 
+				irr::scene::ISceneManager * sceneManager = NULL);
+
+			/**
+			* Do the main thread's part of loading. Call this once a frame.
+			*
+			* @param sceneManager The scene manager to add the meshes and textures to. If NULL 
+			*			they are thrown away.
+			* @param budget About how many microseconds to spend adding assets. At least one 
+			*			asset is added each call so loading always moves forward.
+			*
+			* @return Returns the World of a request that just finished or NULL. The caller owns 
+			*			the World.
+			*/
+			BIO_ENGINE_API World * Update(irr::scene::ISceneManager * sceneManager, unsigned int budget);
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+			BIO_ENGINE_API static bool Test(XNELO::TESTING::Test * test);
+#endif
+		};
+	}//end namespace ENGINE
+}//end namespace BIO
+
+inline void BIO::ENGINE::LevelLoadRequest::Cancel()
+{
+	_cancel.store(true, std::memory_order_release);
+}
+
+inline BIO::ENGINE::ErrorType BIO::ENGINE::LevelLoadRequest::GetError() const
+{
+	return _error.load(std::memory_order_acquire);
+}
+
+inline const std::string & BIO::ENGINE::LevelLoadRequest::GetFilename() const
+{
+	return _filename;
+}
+
+inline float BIO::ENGINE::LevelLoadRequest::GetProgress() const
+{
+	return _progress.load(std::memory_order_relaxed);
+}
+
+inline BIO::ENGINE::LEVEL_LOAD_STATE BIO::ENGINE::LevelLoadRequest::GetState() const
+{
+	return (LEVEL_LOAD_STATE)_state.load(std::memory_order_acquire);
+}
+
+inline bool BIO::ENGINE::LevelLoadRequest::IsDone() const
+{
+	return GetState() >= LEVEL_LOAD_COMPLETE;
+}
+
+inline BIO::ENGINE::LevelStreamer::LevelStreamer() : _requests()
+{
+	//Do Nothing
+}
+
+inline BIO::ENGINE::LevelStreamer::~LevelStreamer()
+{
+	CancelAll();
+}
+
+inline unsigned int BIO::ENGINE::LevelStreamer::GetPendingCount() const
+{
+	return (unsigned int)_requests.size();
+}
+
+#endif //___BIO_ENGINE_LEVELSTREAMER_HPP__2015___
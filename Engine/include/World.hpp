@@ -29,23 +29,213 @@
 #define ___BIO_ENGINE_WORLD_HPP__2015___
 
 #include "Config.h"
+#include "EngineTypes.hpp"
+#include "../../Core/include/StringUtils.hpp"
+
+#include <string>
+#include <vector>
 
 namespace BIO
 {
 	namespace ENGINE
 	{
+		/**
+		* An object placed in the world by a level.
+		*/
+		struct WorldObject
+		{
+		public:
+			std::string Name;			/**< The name used to find the object (case insensitive).*/
+			std::string Model;			/**< The file holding the object's geometry.*/
+			std::string Texture;		/**< The image drawn on the object's model. May be empty.*/
+			Vector3 Position;			/**< Where the object is placed.*/
+			Vector3 Rotation;			/**< The rotation of the object in degrees.*/
+			Vector3 Scale;				/**< The scale of the object.*/
+			Color Tint;					/**< The color of the object.*/
+
+			/**
+			* Constructor
+			*/
+			WorldObject() :
+				Name(),
+				Model(),
+				Texture(),
+				Position(0.0f, 0.0f, 0.0f),
+				Rotation(0.0f, 0.0f, 0.0f),
+				Scale(1.0f, 1.0f, 1.0f),
+				Tint(1.0f, 1.0f, 1.0f, 1.0f)
+			{}
+		};
+
 		/**
 		* A World. This holds all the information for the world.
 		*/
 		class World
 		{
+		private:
+			/**
+			* All of the objects in the world.
+			*/
+			std::vector<WorldObject> _objects;
+
+			/**
+			* Direction and strength of gravity.
+			*/
+			Vector3 _gravity;
+
+			/**
+			* The light that reaches every part of the world.
+			*/
+			Color _ambientLight;
+
 		public:
-			World(){}
-			~World(){}
+			/**
+			* Constructor
+			*/
+			World();
+
+			/**
+			* Destructor
+			*/
+			~World();
+
+			/**
+			* Add a new object to the world.
+			*
+			* @NOTE The reference is only valid until the next object is added.
+			*
+			* @return Returns the new object so it can be filled in.
+			*/
+			WorldObject & AddObject();
+
+			/**
+			* Find an object by its name. Names are case insensitive.
+			*
+			* @param name The name of the object.
+			*
+			* @return Returns the first object with the name or NULL if there isn't one.
+			*/
+			WorldObject * FindObject(const char * name);
+
+			/**
+			* Get the light that reaches every part of the world.
+			*
+			* @return Returns the ambient light color.
+			*/
+			const Color & GetAmbientLight() const;
+
+			/**
+			* Get the direction and strength of gravity.
+			*
+			* @return Returns gravity in m/s2.
+			*/
+			const Vector3 & GetGravity() const;
+
+			/**
+			* Get an object in the world.
+			*
+			* @param index Which object. Must be less than GetObjectCount.
+			*
+			* @return Returns the object.
+			*/
+			WorldObject & GetObjectAt(unsigned int index);
+			const WorldObject & GetObjectAt(unsigned int index) const;
+
+			/**
+			* Get the number of objects in the world.
+			*
+			* @return Returns the number of objects.
+			*/
+			unsigned int GetObjectCount() const;
+
+			/**
+			* Make room for a number of objects so adding them doesn't need to grow the storage.
+			*
+			* @param count The number of objects to make room for.
+			*/
+			void ReserveObjects(unsigned int count);
+
+			/**
+			* Set the light that reaches every part of the world.
+			*
+			* @param color The ambient light color.
+			*/
+			void SetAmbientLight(const Color & color);
+
+			/**
+			* Set the direction and strength of gravity.
+			*
+			* @param gravity Gravity in m/s2.
+			*/
+			void SetGravity(const Vector3 & gravity);
 		};
 	}//end namespace ENGINE
 }//end namespace BIO
 
-#endif //___BIO_ENGINE_WORLD_HPP__2015___
+inline BIO::ENGINE::World::World() :
+	_objects(),
+	_gravity(0.0f, -9.8f, 0.0f),
+	_ambientLight(1.0f, 1.0f, 1.0f, 1.0f)
+{}
 
+inline BIO::ENGINE::World::~World()
+{}
 
+inline BIO::ENGINE::WorldObject & BIO::ENGINE::World::AddObject()
+{
+	_objects.push_back(WorldObject());
+	return _objects.back();
+}
+
+inline BIO::ENGINE::WorldObject * BIO::ENGINE::World::FindObject(const char * name)
+{
+	for (size_t i = 0; i < _objects.size(); i++)
+	{
+		if (STRING::strcmpCI(_objects[i].Name.c_str(), name) == 0)
+			return &_objects[i];
+	}
+
+	return NULL;
+}
+
+inline const BIO::ENGINE::Color & BIO::ENGINE::World::GetAmbientLight() const
+{
+	return _ambientLight;
+}
+
+inline const BIO::ENGINE::Vector3 & BIO::ENGINE::World::GetGravity() const
+{
+	return _gravity;
+}
+
+inline BIO::ENGINE::WorldObject & BIO::ENGINE::World::GetObjectAt(unsigned int index)
+{
+	return _objects[index];
+}
+
+inline const BIO::ENGINE::WorldObject & BIO::ENGINE::World::GetObjectAt(unsigned int index) const
+{
+	return _objects[index];
+}
+
+inline unsigned int BIO::ENGINE::World::GetObjectCount() const
+{
+	return (unsigned int)_objects.size();
+}
+
+inline void BIO::ENGINE::World::ReserveObjects(unsigned int count)
+{
+	_objects.reserve(count);
+}
+
+inline void BIO::ENGINE::World::SetAmbientLight(const Color & color)
+{
+	_ambientLight = color;
+}
+
+inline void BIO::ENGINE::World::SetGravity(const Vector3 & gravity)
+{
+	_gravity = gravity;
+}
+
+#endif //___BIO_ENGINE_WORLD_HPP__2015___
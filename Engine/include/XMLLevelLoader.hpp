@@ -40,10 +40,17 @@ namespace BIO
 	namespace ENGINE
 	{
 		/**
-		* A Level Loader that parses an XML based level file.
+		* A Level Loader that parses an XML based level file. The file is parsed in place with 
+		* rapidxml and the LevelInfo and World are filled in with a single walk over the tree.
 		*/
 		class XMLLevelLoader : public ILevelLoader
 		{
+		private:
+			/**
+			* The world built by ParseLevel. Handed to the caller by LoadLevel.
+			*/
+			World * _world;
+
 		public:
 			/**
 			* Constructor
@@ -104,24 +111,27 @@ namespace BIO
 	}//end namespace ENGINE
 }//end namespace BIO
 
-inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader() : ILevelLoader()
+inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader() : ILevelLoader(), _world(NULL)
 {
-	BIO_LOG_INFO("XMLLevelLoader Constructor");
+	BIO_LOG_LOADER(INFO, "XMLLevelLoader Constructor");
 }
 
-inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader(std::string filename) : ILevelLoader(filename)
+inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader(std::string filename) : ILevelLoader(filename), _world(NULL)
 {
-	BIO_LOG_INFO("XMLLevelLoader Constructor. filename = %s", filename);
+	BIO_LOG_LOADER(INFO, "XMLLevelLoader Constructor. filename = %s", filename);
 }
 
-inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader(const char * filename) : ILevelLoader(filename)
+inline BIO::ENGINE::XMLLevelLoader::XMLLevelLoader(const char * filename) : ILevelLoader(filename), _world(NULL)
 {
-	BIO_LOG_INFO("XMLLevelLoader Constructor. filename = %s", filename);
+	BIO_LOG_LOADER(INFO, "XMLLevelLoader Constructor. filename = %s", filename);
 }
 
 inline BIO::ENGINE::XMLLevelLoader::~XMLLevelLoader()
 {
-	BIO_LOG_INFO("XMLLevelLoader Destructor");
+	BIO_LOG_LOADER(INFO, "XMLLevelLoader Destructor");
+
+	//the base destructor can only call the base Clear
+	Clear();
 }
 
 #endif //___BIO_ENGINE_XMLLEVELLOADER_HPP__2015___
@@ -30,10 +30,16 @@
 #include "BIOEngineClass.hpp"
 #include "EngineTypes.hpp"
 #include "../../Core/include/FileUtils.hpp"
-#include "XMLLevelLoader.hpp"
 
 #include <iostream>
 
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#endif
+
 namespace BIO
 {
 	namespace ENGINE
@@ -53,6 +59,8 @@ namespace BIO
 				return irr::video::EDT_DIRECT3D8;
 			case RD_DIRECT_3D9:
 				return irr::video::EDT_DIRECT3D9;
+			case RD_BURNINGS_VIDEO:
+				return irr::video::EDT_BURNINGSVIDEO;
 			case RD_OPEN_GL:
 			default:
 				return irr::video::EDT_OPENGL;
@@ -61,7 +69,19 @@ namespace BIO
 
 		BIOEngine::~BIOEngine()
 		{
-			BIO_LOG_INFO("BIOEngine Destructor Called");
+			BIO_LOG_ENGINE(INFO, "BIOEngine Destructor Called");
+
+			//stop background loads before the device they upload to goes away
+			_levelStreamer.CancelAll();
+
+			//jobs may still be using the world
+			if (_jobs)
+			{
+				delete _jobs;
+				_jobs = NULL;
+			}
+
+			_SetWorld(NULL);
 
 			if (_device)
 			{
@@ -74,56 +94,165 @@ namespace BIO
 		{
 			if (!FILE::FileExists(filename))
 			{
-				BIO_LOG_WARNING("File does not exist: filename='%s'", filename);
+				BIO_LOG_ENGINE(WARNING, "File does not exist: filename='%s'", filename);
 				_error = ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS;
 				return false;
 			}
 
-			XMLLevelLoader loader;
+			ErrorType error = OK;
+			World * returnWorld = _levelCache.Load(filename, error);
 
-			loader.SetFilename(filename);
-			World * returnWorld = loader.LoadLevel();
-
-			//FOR RIGHT NOW !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-			if (returnWorld)
-				delete returnWorld;
-
-			if (loader.GetError() != OK)
+			if (returnWorld == NULL)
 			{
-				BIO_LOG_ERROR("Error Loading Level. Error code '%i' returned from level loader.", loader.GetError());
+				BIO_LOG_ENGINE(ERROR, "Error Loading Level. Error code '%i' returned from level loader.", error);
 
-				_error = loader.GetError();
+				_error = error;
 
 				return false;
 			}
 
+			_SetWorld(returnWorld);
+
 			_error = OK;
 			return true;
 		}
 
+		LevelLoadHandle BIOEngine::LoadLevelAsync(const char * filename)
+		{
+			BIO_LOG_ENGINE(INFO, "Loading level in the background: filename='%s'", filename);
+
+			return _levelStreamer.Load(filename, &_levelCache, _device->getSceneManager());
+		}
+
+		void BIOEngine::RunLoop(IFrameListener & listener)
+		{
+			BIO_LOG_ENGINE(INFO, "BIOEngine Main Loop Starting");
+
+			bool paused = false;
+			_scheduler.Resync();
+
+			while (Run())
+			{
+				if (!IsWindowActive())
+				{
+					paused = true;
+					Yield();
+					continue;
+				}
+
+				//do not try to catch up on the time spent paused
+				if (paused)
+				{
+					_scheduler.Resync();
+					paused = false;
+				}
+
+				unsigned int updates = _scheduler.BeginFrame();
+				for (unsigned int i = 0; i < updates; i++)
+					listener.OnFixedUpdate(*this, _scheduler.GetFixedDelta());
+
+				_DrawFrame(&listener, _scheduler.GetInterpolation());
+
+				_scheduler.EndFrame();
+			}
+
+			BIO_LOG_ENGINE(INFO, "BIOEngine Main Loop Stopped");
+		}
+
+		FrameView BIOEngine::GetFrame()
+		{
+			FrameView frame;
+			frame.pixels = NULL;
+			frame.width = 0;
+			frame.height = 0;
+			frame.pitch = 0;
+			frame.format = irr::video::ECF_UNKNOWN;
+
+			irr::video::IImage * backBuffer = _device->getVideoDriver()->getBackBuffer();
+
+			if (backBuffer == NULL)
+				return frame;
+
+			//the software drivers' images are plain memory, lock only returns the pointer
+			frame.pixels = backBuffer->lock();
+			backBuffer->unlock();
+			frame.width = backBuffer->getDimension().Width;
+			frame.height = backBuffer->getDimension().Height;
+			frame.pitch = backBuffer->getPitch();
+			frame.format = backBuffer->getColorFormat();
+
+			return frame;
+		}
+
+		void BIOEngine::_DrawFrame(IFrameListener * listener, float interpolation)
+		{
+			irr::video::IVideoDriver * driver = _device->getVideoDriver();
+			driver->beginScene(true, true, irr::video::SColor(255, 0, 0, 0));
+
+			if (listener)
+				listener->OnRender(*this, interpolation);
+
+			_device->getSceneManager()->drawAll();
+			driver->endScene();
+		}
+
+		void BIOEngine::_SetWorld(World * world)
+		{
+			//whoever still holds the old world keeps it alive
+			std::atomic_store(&_world, std::shared_ptr<World>(world));
+		}
+
 		void BIOEngine::_InitEngine(BIOEngineConfiguration * config)
 		{
-			BIO_LOG_INFO("BIOEngine Initializing");
+			BIO_LOG_ENGINE(INFO, "BIOEngine Initializing");
 
 			//Set all the variable to default values --------------------------
 			_device = NULL;
 			_error = OK;
+			_headless = config->headless;
+			std::atomic_store(&_world, std::shared_ptr<World>());
+			_levelUploadBudget = config->levelUploadBudget;
+			_levelCache.SetBudget(config->levelCacheBudget);
+			_levelCache.SetKey(config->levelCacheKey);
+			_scheduler = FrameScheduler(config->updateRate, 
+										config->targetFrameRate, 
+										config->maxUpdatesPerFrame, 
+										config->frameSpinTime);
+			_jobs = new CORE::JobSystem(config->jobWorkerCount, config->pinJobWorkers);
 			//-----------------------------------------------------------------
 
 			//initialize the device
-			_device = irr::createDevice(_RenderingDriverToGraphicsType(config->renderingDriver),
-										irr::core::dimension2du(config->screenWidth, config->screenHeight), 
-										config->bits, 
-										config->fullscreen, 
-										config->enableStencilBuffer, 
-										config->enableVeticalSync);
+			irr::SIrrlichtCreationParameters params;
+			params.DriverType = _RenderingDriverToGraphicsType(config->renderingDriver);
+			params.WindowSize = irr::core::dimension2du(config->screenWidth, config->screenHeight);
+			params.Bits = (irr::u8)config->bits;
+			params.Fullscreen = config->fullscreen;
+			params.Stencilbuffer = config->enableStencilBuffer;
+			params.Vsync = config->enableVeticalSync;
+			params.SoftwareRasterThreads = config->softwareRasterThreads;
+
+			if (_headless)
+			{
+				//the console device opens no window and Burning's Video renders into memory
+				BIO_LOG_ENGINE(INFO, "Rendering headless with Burning's Video.");
+				params.DeviceType = irr::EIDT_CONSOLE;
+				params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+				params.Fullscreen = false;
+				params.Vsync = false;
+				params.ConsoleOutput = false;
+			}
+
+			_device = irr::createDeviceEx(params);
 
 			if (_device == NULL)
 			{
-				BIO_LOG_CRITICAL("Error Creating Irrlicht Engine... Returning.");
+				BIO_LOG_ENGINE(CRITICAL, "Error Creating Irrlicht Engine... Returning.");
 				_error = ERROR_CREATING_RENDERING_DEVICE;
 				return;
 			}
+
+			_device->getSceneManager()->setAnimateThreads(config->sceneAnimateThreads);
+			_device->getSceneManager()->setBoundingVolumeTree(config->sceneBoundingVolumeTree);
 		}
 
 #if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
@@ -131,6 +260,61 @@ namespace BIO
 		{
 			test->SetName("BIOEngine Class Tests");
 
+			//headless
+			BIOEngineConfiguration config;
+			config.headless = true;
+			config.screenWidth = 64;
+			config.screenHeight = 48;
+			config.jobWorkerCount = 1;
+
+			BIOEngine engine(config);
+			test->UnitTest(engine.GetError() == OK, "Headless engine created");
+			test->UnitTest(engine.IsHeadless(), "Headless engine is headless");
+
+			if (engine.GetError() != OK)
+				return test->GetSuccess();
+
+			test->UnitTest(engine.Run(), "Headless engine runs");
+
+			engine.DrawFrame();
+			FrameView frame = engine.GetFrame();
+			test->UnitTest(frame.pixels != NULL, "Headless frame is in memory");
+			test->UnitTest(frame.width == 64 && frame.height == 48, "Headless frame size");
+			test->UnitTest(frame.pitch >= 64 * irr::video::IImage::getBitsPerPixelFromFormat(frame.format) / 8,
+				"Headless frame pitch");
+
+			if (frame.pixels && frame.format == irr::video::ECF_A8R8G8B8)
+			{
+				const unsigned int * last = (const unsigned int *)((const char *)frame.pixels + 47 * frame.pitch) + 63;
+				test->UnitTest(*(const unsigned int *)frame.pixels == 0xFF000000 && *last == 0xFF000000, 
+					"Headless frame is cleared");
+			}
+
+			engine.DrawFrame();
+			test->UnitTest(engine.GetFrame().pixels == frame.pixels, "Headless frame is not copied");
+
+			//level handover
+			const char * levelFile = "TESTENGINELEVEL.level";
+			std::ofstream file(levelFile);
+			file << "<LEVEL name=\"Engine\"><OBJECTS><OBJECT name=\"a\"></OBJECT></OBJECTS></LEVEL>";
+			file.close();
+
+			LevelLoadHandle request = engine.LoadLevelAsync(levelFile);
+			for (int i = 0; i < 5000 && !request->IsDone(); i++)
+			{
+				engine.Run();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			std::shared_ptr<World> first = engine.GetWorld();
+			test->UnitTest(request->GetState() == LEVEL_LOAD_COMPLETE && first != NULL, "Async level is running");
+			test->UnitTest(engine.LoadLevel(levelFile) && engine.GetWorld() != first, "Level is replaced");
+			test->UnitTest(first.use_count() == 1 && first->GetObjectCount() == 1, "Replaced level stays alive while held");
+			remove(levelFile);
+
+			engine.Stop();
+			test->UnitTest(!engine.Run(), "Stopped engine does not run");
+
 			return test->GetSuccess();
 		}
 #endif
@@ -0,0 +1,467 @@
+/**
+* @file BinaryLevelLoader.cpp
+* @author Spencer Hoffa
+*
+* Implementation of BinaryLevelLoader.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "BinaryLevelLoader.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include <cmath>
+#include <cstdio>
+#endif
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* Round a size up to the alignment of the arrays in a binary level file.
+		*/
+		inline CORE::uint64 _AlignLevelOffset(CORE::uint64 offset)
+		{
+			return (offset + (BIO_BINARY_LEVEL_ALIGNMENT - 1)) & ~(CORE::uint64)(BIO_BINARY_LEVEL_ALIGNMENT - 1);
+		}
+
+		/**
+		* Builds the string table of a binary level file. Each string is only stored once.
+		*/
+		class _LevelStringTable
+		{
+		private:
+			/**
+			* The table. Starts with the empty string.
+			*/
+			std::vector<char> _table;
+
+			/**
+			* The offset of every string already in the table.
+			*/
+			std::unordered_map<std::string, CORE::uint32> _offsets;
+
+		public:
+			/**
+			* Constructor
+			*/
+			_LevelStringTable() : _table(1, '\0'), _offsets()
+			{
+				_offsets[""] = 0;
+			}
+
+			/**
+			* Add a string to the table.
+			*
+			* @return Returns the offset of the string.
+			*/
+			CORE::uint32 Add(const std::string & text)
+			{
+				std::unordered_map<std::string, CORE::uint32>::iterator found = _offsets.find(text);
+				if (found != _offsets.end())
+					return found->second;
+
+				CORE::uint32 offset = (CORE::uint32)_table.size();
+				_table.insert(_table.end(), text.c_str(), text.c_str() + text.size() + 1);
+				_offsets[text] = offset;
+
+				return offset;
+			}
+
+			/**
+			* Get the table.
+			*/
+			const std::vector<char> & GetTable() const
+			{
+				return _table;
+			}
+		};
+
+		bool BinaryLevelLoader::_Validate() const
+		{
+			const char * data = _file.GetData();
+			CORE::uint64 size = _file.GetSize();
+
+			if (size < sizeof(BinaryLevelHeader))
+			{
+				BIO_LOG_LOADER(ERROR, "'%s' is too small to be a binary level", _filename);
+				return false;
+			}
+
+			const BinaryLevelHeader * header = (const BinaryLevelHeader *)data;
+
+			if (memcmp(header->Magic, BIO_BINARY_LEVEL_MAGIC, 4) != 0)
+			{
+				BIO_LOG_LOADER(ERROR, "'%s' is not a binary level", _filename);
+				return false;
+			}
+
+			if (header->Version != BIO_BINARY_LEVEL_VERSION)
+			{
+				BIO_LOG_LOADER(ERROR, "'%s' is binary level version %i. Version %i is needed.", 
+					_filename, header->Version, BIO_BINARY_LEVEL_VERSION);
+				return false;
+			}
+
+			CORE::uint64 objectsEnd = (CORE::uint64)header->ObjectsOffset + 
+				(CORE::uint64)header->ObjectCount * sizeof(BinaryLevelObject);
+			CORE::uint64 transformsEnd = (CORE::uint64)header->TransformsOffset + 
+				(CORE::uint64)header->ObjectCount * sizeof(BinaryLevelTransform);
+			CORE::uint64 stringsEnd = (CORE::uint64)header->StringsOffset + header->StringsSize;
+
+			bool valid = (header->FileSize == size) && 
+				(header->ObjectsOffset % BIO_BINARY_LEVEL_ALIGNMENT == 0) && 
+				(header->TransformsOffset % BIO_BINARY_LEVEL_ALIGNMENT == 0) && 
+				(header->ObjectsOffset >= sizeof(BinaryLevelHeader)) && 
+				(header->TransformsOffset >= sizeof(BinaryLevelHeader)) && 
+				(header->StringsOffset >= sizeof(BinaryLevelHeader)) && 
+				(objectsEnd <= size) && 
+				(transformsEnd <= size) && 
+				(stringsEnd <= size) && 
+				(header->StringsSize > 0) && 
+				//every string must end inside of the table
+				(data[header->StringsOffset + header->StringsSize - 1] == '\0');
+
+			if (!valid)
+			{
+				BIO_LOG_LOADER(ERROR, "'%s' is a damaged binary level", _filename);
+				return false;
+			}
+
+			return true;
+		}
+
+		void BinaryLevelLoader::Clear()
+		{
+			ILevelLoader::Clear();
+
+			_header = NULL;
+			_objects = NULL;
+			_transforms = NULL;
+			_strings = NULL;
+			_file.Close();
+		}
+
+		void BinaryLevelLoader::ParseLevel()
+		{
+			BIO_LOG_LOADER(INFO, "Parse Binary Level");
+
+			Clear();
+
+			if (!_file.Open(_filename.c_str()))
+			{
+				BIO_LOG_LOADER(ERROR, "Unable to map '%s'", _filename);
+				_error = ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS;
+				return;
+			}
+
+			if (!_Validate())
+			{
+				Clear();
+				_error = ERROR_LOADLEVEL__INVALID_BINARY;
+				return;
+			}
+
+			const char * data = _file.GetData();
+			_header = (const BinaryLevelHeader *)data;
+			_objects = (const BinaryLevelObject *)(data + _header->ObjectsOffset);
+			_transforms = (const BinaryLevelTransform *)(data + _header->TransformsOffset);
+			_strings = data + _header->StringsOffset;
+
+			//only the header is read here
+			_levelInfo.Name = GetString(_header->Name);
+			_levelInfo.LevelFilename = GetString(_header->LevelFilename);
+			_levelInfo.Gravity.set(_header->Gravity[0], _header->Gravity[1], _header->Gravity[2]);
+			_levelInfo.Latitude = _header->Latitude;
+			_levelInfo.AmbientLight = Color(_header->AmbientLight[0], 
+				_header->AmbientLight[1], 
+				_header->AmbientLight[2], 
+				_header->AmbientLight[3]);
+			_levelInfo.CameraType = (_header->CameraType == CAMERA_FOLLOW) ? CAMERA_FOLLOW : CAMERA_DEFAULT;
+			_levelInfo.MinView = _header->MinView;
+			_levelInfo.MaxView = _header->MaxView;
+			_levelInfo.ToFollow = GetString(_header->ToFollow);
+			_levelInfo.FollowDistance = _header->FollowDistance;
+			_levelInfo.FollowHeight = _header->FollowHeight;
+			_levelInfo.Position.set(_header->Position[0], _header->Position[1], _header->Position[2]);
+			_levelInfo.LookAt.set(_header->LookAt[0], _header->LookAt[1], _header->LookAt[2]);
+
+			_isParsed = true;
+			_error = OK;
+		}
+
+		World * BinaryLevelLoader::LoadLevel()
+		{
+			BIO_LOG_LOADER(INFO, "Loading Binary Level");
+			if (_isParsed == false)
+			{
+				BIO_LOG_LOADER(DEBUG, "Level not parsed... parse level");
+				ParseLevel();
+			}
+
+			if (_error != OK)
+				return NULL;
+
+			World * world = new World();
+			world->SetGravity(_levelInfo.Gravity);
+			world->SetAmbientLight(_levelInfo.AmbientLight);
+			world->ReserveObjects(_header->ObjectCount);
+
+			for (CORE::uint32 i = 0; i < _header->ObjectCount; i++)
+			{
+				const BinaryLevelObject & source = _objects[i];
+				const BinaryLevelTransform & transform = _transforms[i];
+				WorldObject & object = world->AddObject();
+
+				object.Name = GetString(source.Name);
+				object.Model = GetString(source.Model);
+				object.Texture = GetString(source.Texture);
+				object.Position.set(transform.Position[0], transform.Position[1], transform.Position[2]);
+				object.Rotation.set(transform.Rotation[0], transform.Rotation[1], transform.Rotation[2]);
+				object.Scale.set(transform.Scale[0], transform.Scale[1], transform.Scale[2]);
+				object.Tint = Color(source.Tint[0], source.Tint[1], source.Tint[2], source.Tint[3]);
+			}
+
+			return world;
+		}
+
+		bool BinaryLevelLoader::IsBinaryLevel(const char * filename)
+		{
+			std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+			if (!file.is_open())
+				return false;
+
+			char magic[4];
+			file.read(magic, 4);
+
+			return (file.gcount() == 4) && (memcmp(magic, BIO_BINARY_LEVEL_MAGIC, 4) == 0);
+		}
+
+		bool BinaryLevelLoader::WriteLevel(const char * filename, const LevelInfo & info, const World & world)
+		{
+			CORE::uint32 count = world.GetObjectCount();
+			_LevelStringTable strings;
+
+			BinaryLevelHeader header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.Magic, BIO_BINARY_LEVEL_MAGIC, 4);
+			header.Version = BIO_BINARY_LEVEL_VERSION;
+			header.ObjectCount = count;
+			header.Name = strings.Add(info.Name);
+			header.LevelFilename = strings.Add(info.LevelFilename);
+			header.ToFollow = strings.Add(info.ToFollow);
+			header.CameraType = (CORE::uint32)info.CameraType;
+			header.Gravity[0] = info.Gravity.X;
+			header.Gravity[1] = info.Gravity.Y;
+			header.Gravity[2] = info.Gravity.Z;
+			header.Latitude = info.Latitude;
+			header.AmbientLight[0] = info.AmbientLight.r;
+			header.AmbientLight[1] = info.AmbientLight.g;
+			header.AmbientLight[2] = info.AmbientLight.b;
+			header.AmbientLight[3] = info.AmbientLight.a;
+			header.MinView = info.MinView;
+			header.MaxView = info.MaxView;
+			header.FollowDistance = info.FollowDistance;
+			header.FollowHeight = info.FollowHeight;
+			header.Position[0] = info.Position.X;
+			header.Position[1] = info.Position.Y;
+			header.Position[2] = info.Position.Z;
+			header.LookAt[0] = info.LookAt.X;
+			header.LookAt[1] = info.LookAt.Y;
+			header.LookAt[2] = info.LookAt.Z;
+
+			std::vector<BinaryLevelObject> objects(count);
+			std::vector<BinaryLevelTransform> transforms(count);
+
+			for (CORE::uint32 i = 0; i < count; i++)
+			{
+				const WorldObject & object = world.GetObjectAt(i);
+				BinaryLevelObject & destination = objects[i];
+				BinaryLevelTransform & transform = transforms[i];
+
+				memset(&destination, 0, sizeof(destination));
+				memset(&transform, 0, sizeof(transform));
+
+				destination.Name = strings.Add(object.Name);
+				destination.Model = strings.Add(object.Model);
+				destination.Texture = strings.Add(object.Texture);
+				destination.Tint[0] = object.Tint.r;
+				destination.Tint[1] = object.Tint.g;
+				destination.Tint[2] = object.Tint.b;
+				destination.Tint[3] = object.Tint.a;
+
+				transform.Position[0] = object.Position.X;
+				transform.Position[1] = object.Position.Y;
+				transform.Position[2] = object.Position.Z;
+				transform.Rotation[0] = object.Rotation.X;
+				transform.Rotation[1] = object.Rotation.Y;
+				transform.Rotation[2] = object.Rotation.Z;
+				transform.Scale[0] = object.Scale.X;
+				transform.Scale[1] = object.Scale.Y;
+				transform.Scale[2] = object.Scale.Z;
+			}
+
+			const std::vector<char> & table = strings.GetTable();
+
+			CORE::uint64 objectsOffset = _AlignLevelOffset(sizeof(BinaryLevelHeader));
+			CORE::uint64 transformsOffset = _AlignLevelOffset(objectsOffset + (CORE::uint64)count * sizeof(BinaryLevelObject));
+			CORE::uint64 stringsOffset = _AlignLevelOffset(transformsOffset + (CORE::uint64)count * sizeof(BinaryLevelTransform));
+			CORE::uint64 fileSize = _AlignLevelOffset(stringsOffset + table.size());
+
+			if (fileSize > 0xFFFFFFFFu)
+			{
+				BIO_LOG_LOADER(ERROR, "Level is too big for a binary level file");
+				return false;
+			}
+
+			header.ObjectsOffset = (CORE::uint32)objectsOffset;
+			header.TransformsOffset = (CORE::uint32)transformsOffset;
+			header.StringsOffset = (CORE::uint32)stringsOffset;
+			header.StringsSize = (CORE::uint32)table.size();
+			header.FileSize = (CORE::uint32)fileSize;
+
+			std::ofstream file(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+
+			if (!file.is_open())
+			{
+				BIO_LOG_LOADER(ERROR, "Unable to write '%s'", filename);
+				return false;
+			}
+
+			const char padding[BIO_BINARY_LEVEL_ALIGNMENT] = { 0 };
+
+			file.write((const char *)&header, sizeof(header));
+			file.write(padding, (std::streamsize)(objectsOffset - sizeof(header)));
+			if (count > 0)
+				file.write((const char *)&objects[0], (std::streamsize)(count * sizeof(BinaryLevelObject)));
+			file.write(padding, (std::streamsize)(transformsOffset - objectsOffset - count * sizeof(BinaryLevelObject)));
+			if (count > 0)
+				file.write((const char *)&transforms[0], (std::streamsize)(count * sizeof(BinaryLevelTransform)));
+			file.write(padding, (std::streamsize)(stringsOffset - transformsOffset - count * sizeof(BinaryLevelTransform)));
+			file.write(&table[0], (std::streamsize)table.size());
+			file.write(padding, (std::streamsize)(fileSize - stringsOffset - table.size()));
+
+			return file.good();
+		}
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+		bool BinaryLevelLoader::Test(XNELO::TESTING::Test * test)
+		{
+			test->SetName("Testing BinaryLevelLoader class");
+
+			const char * filename = "TESTLEVEL.blevel";
+
+			LevelInfo info;
+			info.Name = "Binary Level";
+			info.LevelFilename = "level.obj";
+			info.Gravity.set(0.0f, -3.5f, 0.0f);
+			info.Latitude = 0.75f;
+			info.AmbientLight = Color(0.25f, 0.5f, 0.75f, 1.0f);
+			info.CameraType = CAMERA_FOLLOW;
+			info.ToFollow = "tank2";
+			info.FollowDistance = 12.0f;
+
+			World world;
+			for (int i = 0; i < 3; i++)
+			{
+				WorldObject & object = world.AddObject();
+				object.Name = (i == 2) ? "tank2" : ((i == 1) ? "tank1" : "crate");
+				object.Model = (i == 0) ? "crate.obj" : "tank.obj";
+				object.Texture = (i == 0) ? "" : "tank.png";
+				object.Position.set((float)i, 2.0f, -(float)i);
+				object.Rotation.set(0.0f, 45.0f * i, 0.0f);
+				object.Tint = Color(1.0f, 0.5f, 0.25f, 1.0f);
+			}
+
+			test->UnitTest(WriteLevel(filename, info, world), "Write binary level");
+			test->UnitTest(IsBinaryLevel(filename), "File is a binary level");
+
+			BinaryLevelLoader loader(filename);
+			loader.ParseLevel();
+			test->UnitTest(loader.GetError() == OK && loader.IsParsed(), "Parse binary level");
+
+			LevelInfo parsed = loader.GetLevelInfo();
+			test->UnitTest(parsed.Name == "Binary Level" && parsed.LevelFilename == "level.obj", "Level strings");
+			test->UnitTest(parsed.Gravity.Y == -3.5f && parsed.Latitude == 0.75f, "Level settings");
+			test->UnitTest(parsed.AmbientLight.g == 0.5f, "Level ambient light");
+			test->UnitTest(parsed.CameraType == CAMERA_FOLLOW && parsed.ToFollow == "tank2" && 
+				parsed.FollowDistance == 12.0f, "Level camera");
+
+			//in place access
+			test->UnitTest(loader.GetObjectCount() == 3, "Object count");
+			test->UnitTest(((size_t)loader.GetObjects() % BIO_BINARY_LEVEL_ALIGNMENT) == 0 && 
+				((size_t)loader.GetTransforms() % BIO_BINARY_LEVEL_ALIGNMENT) == 0, "Arrays are aligned");
+			test->UnitTest(strcmp(loader.GetString(loader.GetObjects()[1].Name), "tank1") == 0, "Object name in place");
+			test->UnitTest(loader.GetObjects()[1].Model == loader.GetObjects()[2].Model, "Strings are stored once");
+			test->UnitTest(loader.GetTransforms()[2].Rotation[1] == 90.0f, "Transform in place");
+			test->UnitTest(strcmp(loader.GetString(0xFFFFFF), "") == 0, "Bad string offset");
+
+			World * loaded = loader.LoadLevel();
+			test->UnitTest(loaded != NULL, "LoadLevel returns a world");
+
+			if (loaded != NULL)
+			{
+				test->UnitTest(loaded->GetObjectCount() == 3, "World object count");
+				WorldObject * tank = loaded->FindObject("tank2");
+				test->UnitTest(tank != NULL && tank->Model == "tank.obj" && tank->Texture == "tank.png" && 
+					tank->Position.X == 2.0f && tank->Scale.Z == 1.0f && tank->Tint.b == 0.25f, "World object");
+				test->UnitTest(loaded->GetGravity().Y == -3.5f, "World gravity");
+				delete loaded;
+			}
+
+			loader.Clear();
+
+			//damaged files
+			std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+			file.seekp(4);
+			CORE::uint32 badVersion = BIO_BINARY_LEVEL_VERSION + 1;
+			file.write((const char *)&badVersion, 4);
+			file.close();
+
+			loader.ParseLevel();
+			test->UnitTest(loader.GetError() == ERROR_LOADLEVEL__INVALID_BINARY, "Wrong version");
+			test->UnitTest(loader.LoadLevel() == NULL, "Wrong version returns no world");
+
+			std::ofstream truncated(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+			truncated.write(BIO_BINARY_LEVEL_MAGIC, 4);
+			truncated.close();
+
+			loader.ParseLevel();
+			test->UnitTest(loader.GetError() == ERROR_LOADLEVEL__INVALID_BINARY, "Truncated file");
+
+			remove(filename);
+
+			loader.ParseLevel();
+			test->UnitTest(loader.GetError() == ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS, "Missing file");
+			test->UnitTest(IsBinaryLevel(filename) == false, "Missing file is not a binary level");
+
+			return test->GetSuccess();
+		}
+#endif
+	}//end namespace ENGINE
+}//end namespace BIO
@@ -0,0 +1,233 @@
+/**
+* @file FrameScheduler.cpp
+* @author Spencer Hoffa
+*
+* Implementation of FrameScheduler.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "FrameScheduler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if BIO_ENGINE_PLATFORM == BIO_ENGINE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+//The longest frame that is simulated. Anything longer (a breakpoint, a window drag) is cut.
+#define BIO_FRAME_MAX_TIME 0.25
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		FrameScheduler::FrameScheduler(double updateRate, 
+			double targetFrameRate, 
+			unsigned int maxUpdates, 
+			unsigned int spinTime) :
+			_fixedDelta((updateRate > 0.0) ? (1.0 / updateRate) : (1.0 / 60.0)),
+			_targetFrameTime(0.0),
+			_maxUpdates((maxUpdates > 0) ? maxUpdates : 1),
+			_spinTime(spinTime / 1000000.0),
+			_accumulator(0.0),
+			_frameStart(0.0)
+		{
+			SetTargetFrameRate(targetFrameRate);
+			Reset();
+		}
+
+		double FrameScheduler::GetTime()
+		{
+#if BIO_ENGINE_PLATFORM == BIO_ENGINE_WINDOWS
+			//the standard clocks are only accurate to a few milliseconds in older compilers
+			LARGE_INTEGER frequency;
+			LARGE_INTEGER counter;
+			QueryPerformanceFrequency(&frequency);
+			QueryPerformanceCounter(&counter);
+
+			return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+			return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		void FrameScheduler::Reset()
+		{
+			Resync();
+			memset(&_stats, 0, sizeof(_stats));
+			memset(_frameTimes, 0, sizeof(_frameTimes));
+			memset(_workTimes, 0, sizeof(_workTimes));
+		}
+
+		unsigned int FrameScheduler::BeginFrame()
+		{
+			double now = GetTime();
+			double frameTime = (_frameStart > 0.0) ? (now - _frameStart) : 0.0;
+			_frameStart = now;
+
+			return Advance(frameTime);
+		}
+
+		unsigned int FrameScheduler::Advance(double frameTime)
+		{
+			if (frameTime < 0.0)
+				frameTime = 0.0;
+
+			_stats.FrameCount++;
+			_stats.LastFrameTime = frameTime;
+			_frameTimes[_stats.FrameCount % BIO_FRAME_STATS_WINDOW] = frameTime;
+
+			if (frameTime > BIO_FRAME_MAX_TIME)
+				frameTime = BIO_FRAME_MAX_TIME;
+
+			_accumulator += frameTime;
+
+			unsigned int updates = (unsigned int)(_accumulator / _fixedDelta);
+
+			if (updates > _maxUpdates)
+			{
+				//drop the time that can not be caught up
+				_stats.DroppedUpdates += updates - _maxUpdates;
+				updates = _maxUpdates;
+				_accumulator = 0.0;
+			}
+			else
+			{
+				_accumulator -= updates * _fixedDelta;
+			}
+
+			_stats.UpdateCount += updates;
+			_UpdateStats();
+
+			return updates;
+		}
+
+		void FrameScheduler::EndFrame()
+		{
+			if (_frameStart <= 0.0)
+				return;
+
+			double now = GetTime();
+			_workTimes[_stats.FrameCount % BIO_FRAME_STATS_WINDOW] = now - _frameStart;
+
+			if (_targetFrameTime <= 0.0)
+				return;
+
+			double deadline = _frameStart + _targetFrameTime;
+
+			//sleep most of the way, a sleep can wake up late
+			if (deadline - now > _spinTime)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(
+					(long long)((deadline - now - _spinTime) * 1000000.0)));
+			}
+
+			//then spin the rest
+			while (GetTime() < deadline)
+				std::this_thread::yield();
+		}
+
+		void FrameScheduler::_UpdateStats()
+		{
+			CORE::uint64 count = (_stats.FrameCount < BIO_FRAME_STATS_WINDOW) ? 
+				_stats.FrameCount : BIO_FRAME_STATS_WINDOW;
+			double total = 0.0;
+			double work = 0.0;
+			double minimum = 0.0;
+			double maximum = 0.0;
+
+			for (CORE::uint64 i = 0; i < count; i++)
+			{
+				unsigned int slot = (unsigned int)((_stats.FrameCount - i) % BIO_FRAME_STATS_WINDOW);
+				double time = _frameTimes[slot];
+
+				total += time;
+				work += _workTimes[slot];
+
+				if ((i == 0) || (time < minimum))
+					minimum = time;
+				if ((i == 0) || (time > maximum))
+					maximum = time;
+			}
+
+			_stats.AverageFrameTime = (count > 0) ? (total / count) : 0.0;
+			_stats.AverageWorkTime = (count > 0) ? (work / count) : 0.0;
+			_stats.MinFrameTime = minimum;
+			_stats.MaxFrameTime = maximum;
+		}
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+		bool FrameScheduler::Test(XNELO::TESTING::Test * test)
+		{
+			test->SetName("Testing FrameScheduler class");
+
+			FrameScheduler scheduler(50.0, 0.0, 4);
+			test->UnitTest(scheduler.GetFixedDelta() == 0.02, "Fixed delta");
+			test->UnitTest(scheduler.GetTargetFrameRate() == 0.0, "No target frame rate");
+
+			test->UnitTest(scheduler.Advance(0.04) == 2, "Two updates in two steps");
+			test->UnitTest(scheduler.GetInterpolation() < 0.001f, "No time left over");
+
+			test->UnitTest(scheduler.Advance(0.01) == 0, "No update in half a step");
+			test->UnitTest(std::fabs(scheduler.GetInterpolation() - 0.5f) < 0.001f, "Half way to the next update");
+
+			test->UnitTest(scheduler.Advance(0.015) == 1, "Left over time is kept");
+			test->UnitTest(std::fabs(scheduler.GetInterpolation() - 0.25f) < 0.001f, "Interpolation after left over time");
+
+			test->UnitTest(scheduler.Advance(0.2) == 4, "Updates are limited");
+			test->UnitTest(scheduler.GetStats().DroppedUpdates == 6, "Dropped updates");
+			test->UnitTest(scheduler.GetInterpolation() == 0.0f, "Dropped time is forgotten");
+
+			const FrameStats & stats = scheduler.GetStats();
+			test->UnitTest(stats.FrameCount == 4 && stats.UpdateCount == 7, "Frame and update counts");
+			test->UnitTest(stats.MinFrameTime == 0.01 && stats.MaxFrameTime == 0.2, "Min and max frame time");
+			test->UnitTest(std::fabs(stats.AverageFrameTime - 0.06625) < 0.00001, "Average frame time");
+
+			scheduler.Advance(0.01);
+			scheduler.Resync();
+			test->UnitTest(scheduler.GetInterpolation() == 0.0f && scheduler.GetStats().FrameCount == 5, "Resync keeps stats");
+
+			scheduler.Reset();
+			test->UnitTest(scheduler.GetStats().FrameCount == 0 && scheduler.GetInterpolation() == 0.0f, "Reset");
+
+			//pacing
+			FrameScheduler paced(60.0, 200.0);
+			double start = GetTime();
+			for (int i = 0; i < 11; i++)
+			{
+				paced.BeginFrame();
+				paced.EndFrame();
+			}
+			double elapsed = GetTime() - start;
+			test->UnitTest(elapsed >= 0.0495, "Frames are paced to the target");
+			test->UnitTest(std::fabs(paced.GetStats().AverageFrameTime - 0.005) < 0.002, "Paced frame time");
+			test->UnitTest(paced.GetStats().UpdateCount >= 2, "Paced updates");
+
+			return test->GetSuccess();
+		}
+#endif
+	}//end namespace ENGINE
+}//end namespace BIO
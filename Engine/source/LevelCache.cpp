@@ -0,0 +1,342 @@
+/**
+* @file LevelCache.cpp
+* @author Spencer Hoffa
+*
+* Implementation of LevelCache.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "LevelCache.hpp"
+#include "BinaryLevelLoader.hpp"
+#include "XMLLevelLoader.hpp"
+#include "../../Core/include/MappedFile.hpp"
+
+#include <sys/stat.h>
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include <cstdio>
+#include <fstream>
+#endif
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* Get about how many bytes a level uses in memory.
+		*/
+		CORE::uint64 _GetLevelMemory(const LevelInfo & info, const World & world)
+		{
+			CORE::uint64 memory = sizeof(LevelInfo) + sizeof(World) + 
+				info.Name.capacity() + info.LevelFilename.capacity() + info.ToFollow.capacity();
+
+			for (unsigned int i = 0; i < world.GetObjectCount(); i++)
+			{
+				const WorldObject & object = world.GetObjectAt(i);
+				memory += sizeof(WorldObject) + object.Name.capacity() + object.Model.capacity() + 
+					object.Texture.capacity();
+			}
+
+			return memory;
+		}
+
+		LevelCache::LevelCache(CORE::uint64 budget, LEVEL_CACHE_KEY key) :
+			_entries(),
+			_lookup(),
+			_mutex(),
+			_budget(budget),
+			_memory(0),
+			_key(key),
+			_hits(0),
+			_misses(0),
+			_evictions(0)
+		{
+			//Do Nothing
+		}
+
+		bool LevelCache::_GetStamp(LEVEL_CACHE_KEY key, 
+			const char * filename, 
+			CORE::uint64 & size, 
+			CORE::uint64 & stamp)
+		{
+			if (key == LEVEL_CACHE_KEY_CONTENT)
+			{
+				FILE::MappedFile file;
+
+				if (!file.Open(filename))
+					return false;
+
+				//FNV-1a
+				const unsigned char * data = (const unsigned char *)file.GetData();
+				CORE::uint64 hash = 14695981039346656037ull;
+
+				for (size_t i = 0; i < file.GetSize(); i++)
+				{
+					hash ^= data[i];
+					hash *= 1099511628211ull;
+				}
+
+				size = file.GetSize();
+				stamp = hash;
+
+				return true;
+			}
+
+			struct stat info;
+
+			if (stat(filename, &info) != 0)
+				return false;
+
+			size = (CORE::uint64)info.st_size;
+			stamp = (CORE::uint64)info.st_mtime;
+
+			return true;
+		}
+
+		void LevelCache::_Trim()
+		{
+			while ((_memory > _budget) && !_entries.empty())
+			{
+				_Entry & oldest = _entries.back();
+
+				BIO_LOG_LOADER(DEBUG, "Level cache evicting '%s'", oldest.Filename);
+
+				_memory -= oldest.Memory;
+				_lookup.erase(oldest.Filename);
+				_entries.pop_back();
+				_evictions++;
+			}
+		}
+
+		void LevelCache::Clear()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_entries.clear();
+			_lookup.clear();
+			_memory = 0;
+		}
+
+		void LevelCache::SetBudget(CORE::uint64 budget)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_budget = budget;
+			_Trim();
+		}
+
+		void LevelCache::SetKey(LEVEL_CACHE_KEY key)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_key = key;
+			_entries.clear();
+			_lookup.clear();
+			_memory = 0;
+		}
+
+		World * LevelCache::Load(const char * filename, ErrorType & error, LevelInfo * info)
+		{
+			CORE::uint64 size = 0;
+			CORE::uint64 stamp = 0;
+			LEVEL_CACHE_KEY key;
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				key = _key;
+			}
+
+			if (!_GetStamp(key, filename, size, stamp))
+			{
+				BIO_LOG_LOADER(WARNING, "File does not exist: filename='%s'", filename);
+				error = ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS;
+				return NULL;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				std::unordered_map<std::string, std::list<_Entry>::iterator>::iterator found = 
+					_lookup.find(filename);
+
+				if (found != _lookup.end())
+				{
+					std::list<_Entry>::iterator entry = found->second;
+
+					if ((entry->Size == size) && (entry->Stamp == stamp))
+					{
+						BIO_LOG_LOADER(DEBUG, "Level cache hit '%s'", filename);
+
+						//move to the front of the list
+						_entries.splice(_entries.begin(), _entries, entry);
+						_hits++;
+
+						if (info)
+							*info = entry->Info;
+
+						error = OK;
+						return new World(entry->Level);
+					}
+
+					//the file changed
+					_memory -= entry->Memory;
+					_entries.erase(entry);
+					_lookup.erase(found);
+				}
+
+				_misses++;
+			}
+
+			//parse outside of the lock so other levels can load at the same time
+			XMLLevelLoader xmlLoader;
+			BinaryLevelLoader binaryLoader;
+			ILevelLoader & loader = BinaryLevelLoader::IsBinaryLevel(filename) ?
+				(ILevelLoader &)binaryLoader : (ILevelLoader &)xmlLoader;
+
+			loader.SetFilename(filename);
+			loader.ParseLevel();
+			World * world = loader.LoadLevel();
+
+			error = loader.GetError();
+
+			if (world == NULL)
+				return NULL;
+
+			LevelInfo levelInfo = loader.GetLevelInfo();
+
+			if (info)
+				*info = levelInfo;
+
+			CORE::uint64 memory = _GetLevelMemory(levelInfo, *world);
+
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			//too big to keep, another thread cached it first or the key changed
+			if ((memory > _budget) || (_key != key) || (_lookup.find(filename) != _lookup.end()))
+				return world;
+
+			_entries.push_front(_Entry());
+			_Entry & entry = _entries.front();
+			entry.Filename = filename;
+			entry.Size = size;
+			entry.Stamp = stamp;
+			entry.Info = levelInfo;
+			entry.Level = *world;
+			entry.Memory = memory;
+
+			_lookup[entry.Filename] = _entries.begin();
+			_memory += memory;
+			_Trim();
+
+			return world;
+		}
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+		/**
+		* Write a test level file.
+		*/
+		void _WriteCacheTestLevel(const char * filename, const char * name, int objects)
+		{
+			std::ofstream file(filename, std::ios::out | std::ios::trunc);
+			file << "<LEVEL name=\"" << name << "\"><OBJECTS>";
+
+			for (int i = 0; i < objects; i++)
+				file << "<OBJECT name=\"object" << i << "\"><MODEL>model.obj</MODEL></OBJECT>";
+
+			file << "</OBJECTS></LEVEL>";
+		}
+
+		bool LevelCache::Test(XNELO::TESTING::Test * test)
+		{
+			test->SetName("Testing LevelCache class");
+
+			const char * first = "TESTCACHE1.level";
+			const char * second = "TESTCACHE2.level";
+			_WriteCacheTestLevel(first, "First", 3);
+			_WriteCacheTestLevel(second, "Second", 5);
+
+			LevelCache cache;
+			ErrorType error = OK;
+			LevelInfo info;
+
+			World * world = cache.Load(first, error, &info);
+			test->UnitTest(world != NULL && error == OK, "Load level");
+			test->UnitTest(cache.GetMissCount() == 1 && cache.GetHitCount() == 0, "First load is a miss");
+			test->UnitTest(cache.GetEntryCount() == 1 && cache.GetMemoryUsed() > 0, "Level is cached");
+			delete world;
+
+			info.Clear();
+			world = cache.Load(first, error, &info);
+			test->UnitTest(cache.GetHitCount() == 1 && cache.GetMissCount() == 1, "Second load is a hit");
+			test->UnitTest(world != NULL && world->GetObjectCount() == 3 && 
+				world->GetObjectAt(2).Name == "object2", "Cached world");
+			test->UnitTest(info.Name == "First", "Cached level info");
+			delete world;
+
+			//a changed file is parsed again
+			_WriteCacheTestLevel(first, "First", 4);
+			world = cache.Load(first, error);
+			test->UnitTest(cache.GetMissCount() == 2, "Changed file is a miss");
+			test->UnitTest(world != NULL && world->GetObjectCount() == 4, "Changed file is loaded");
+			test->UnitTest(cache.GetEntryCount() == 1, "Changed file replaces the old entry");
+			delete world;
+
+			//least recently used levels are evicted
+			CORE::uint64 firstMemory = cache.GetMemoryUsed();
+			delete cache.Load(second, error);
+			test->UnitTest(cache.GetEntryCount() == 2, "Two levels cached");
+			delete cache.Load(first, error);
+			cache.SetBudget(firstMemory);
+			test->UnitTest(cache.GetEntryCount() == 1 && cache.GetEvictionCount() == 1, "Evict to budget");
+			delete cache.Load(first, error);
+			test->UnitTest(cache.GetHitCount() == 3, "Most recently used level is kept");
+
+			//errors
+			world = cache.Load("TESTCACHEMISSING.level", error);
+			test->UnitTest(world == NULL && error == ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS, "Missing file");
+
+			//an empty budget turns the cache off
+			LevelCache off(0);
+			delete off.Load(first, error);
+			delete off.Load(first, error);
+			test->UnitTest(off.GetMissCount() == 2 && off.GetEntryCount() == 0, "Cache off");
+
+			//content keys
+			LevelCache content(1024 * 1024, LEVEL_CACHE_KEY_CONTENT);
+			delete content.Load(second, error);
+			delete content.Load(second, error);
+			test->UnitTest(content.GetHitCount() == 1, "Content key hit");
+			_WriteCacheTestLevel(second, "Other!", 5);
+			delete content.Load(second, error);
+			test->UnitTest(content.GetMissCount() == 2, "Same size different content is a miss");
+
+			cache.Clear();
+			test->UnitTest(cache.GetEntryCount() == 0 && cache.GetMemoryUsed() == 0, "Clear");
+
+			remove(first);
+			remove(second);
+
+			return test->GetSuccess();
+		}
+#endif
+	}//end namespace ENGINE
+}//end namespace BIO
@@ -0,0 +1,605 @@
+/**
+* @file LevelStreamer.cpp
+* @author Spencer Hoffa
+*
+* Implementation of LevelStreamer.
+*/
+/*
+* Copyright (c)
+* 2015
+* Spencer Hoffa
+*
+* This software is provided 'as-is', without any express or implied warranty. In no event will the
+* authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+* applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+*    original software. If you use this software in a product, an acknowledgement in the product
+*    documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+*    being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "LevelStreamer.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <set>
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include <cstdio>
+#endif
+
+//How much of the progress each step is worth.
+#define BIO_LEVEL_LOAD_PARSE_PROGRESS 0.4f
+#define BIO_LEVEL_LOAD_READ_PROGRESS 0.3f
+#define BIO_LEVEL_LOAD_UPLOAD_PROGRESS 0.3f
+
+namespace BIO
+{
+	namespace ENGINE
+	{
+		/**
+		* Read a whole file into memory.
+		*
+		* @param[in] filename The file to read.
+		* @param[out] data Set to the contents of the file.
+		*
+		* @return Returns true if the file was read.
+		*/
+		static bool ReadLevelFile(const std::string & filename, std::vector<char> & data)
+		{
+			std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+
+			if (!file.is_open())
+				return false;
+
+			std::streamoff size = file.tellg();
+			if (size <= 0)
+				return false;
+
+			data.resize((size_t)size);
+			file.seekg(0);
+			file.read(&data[0], size);
+
+			return file.good();
+		}
+
+		/**
+		* Check if a model's loader only builds the mesh and never touches the video driver, so
+		* it may run on a worker thread.
+		*
+		* @param filename The model file.
+		*
+		* @return Returns true for OBJ, STL and PLY files.
+		*/
+		static bool CanDecodeModelOffThread(const std::string & filename)
+		{
+			std::string::size_type dot = filename.find_last_of('.');
+			if (dot == std::string::npos)
+				return false;
+
+			std::string extension = filename.substr(dot + 1);
+			for (std::string::size_type i = 0; i < extension.size(); i++)
+				extension[i] = (char)tolower((unsigned char)extension[i]);
+
+			return extension == "obj" || extension == "stl" || extension == "ply";
+		}
+
+		/**
+		* Decode a file that was read on the worker thread. If the file is decoded its bytes 
+		* are freed, otherwise they are kept for the main thread.
+		*
+		* @param decoder The request's own scene manager.
+		* @param asset The file to decode.
+		*/
+		static void DecodeLevelAsset(irr::scene::ISceneManager * decoder, LevelAsset & asset)
+		{
+			if (!asset.IsTexture && !CanDecodeModelOffThread(asset.Filename))
+				return;
+
+			irr::io::IReadFile * file = decoder->getFileSystem()->createMemoryReadFile(
+				&asset.Data[0], (irr::s32)asset.Data.size(), asset.Filename.c_str(), false);
+
+			if (asset.IsTexture)
+			{
+				//the image loaders keep no state so sharing the driver's is safe
+				asset.Image = decoder->getVideoDriver()->createImageFromFile(file);
+			}
+			else
+			{
+				//same order as ISceneManager::getMesh, the newest loader first
+				for (irr::s32 i = (irr::s32)decoder->getMeshLoaderCount() - 1; i >= 0 && !asset.Mesh; i--)
+				{
+					irr::scene::IMeshLoader * loader = decoder->getMeshLoader((irr::u32)i);
+
+					if (loader->isALoadableFileExtension(file->getFileName()))
+					{
+						file->seek(0);
+						asset.Mesh = loader->createMesh(file);
+					}
+				}
+			}
+
+			file->drop();
+
+			if (asset.Mesh || asset.Image)
+				std::vector<char>().swap(asset.Data);
+		}
+
+		/**
+		* Add a file to the scene. Decodes it first if the worker thread could not.
+		*
+		* @param sceneManager The scene manager to add the file to.
+		* @param asset The file to add.
+		*/
+		static void UploadLevelAsset(irr::scene::ISceneManager * sceneManager, LevelAsset & asset)
+		{
+			irr::video::IVideoDriver * driver = sceneManager->getVideoDriver();
+			irr::scene::IMeshCache * meshCache = sceneManager->getMeshCache();
+
+			//an earlier level may have added the file already
+			if (asset.Image)
+			{
+				if ((driver->findTexture(asset.Filename.c_str()) == NULL) && 
+					(driver->addTexture(asset.Filename.c_str(), asset.Image) == NULL))
+					BIO_LOG_LOADER(WARNING, "Unable to create a texture from '%s'", asset.Filename);
+
+				return;
+			}
+
+			if (asset.Mesh)
+			{
+				if (meshCache->getMeshByName(asset.Filename.c_str()) == NULL)
+					meshCache->addMesh(asset.Filename.c_str(), asset.Mesh);
+
+				return;
+			}
+
+			if (asset.Data.empty())
+				return;
+
+			irr::io::IReadFile * file = sceneManager->getFileSystem()->createMemoryReadFile(
+				&asset.Data[0], (irr::s32)asset.Data.size(), asset.Filename.c_str(), false);
+
+			//the mesh cache and the driver keep the result under the file's name
+			if (asset.IsTexture)
+			{
+				if (driver->getTexture(file) == NULL)
+					BIO_LOG_LOADER(WARNING, "Unable to create a texture from '%s'", asset.Filename);
+			}
+			else if (sceneManager->getMesh(file) == NULL)
+			{
+				BIO_LOG_LOADER(WARNING, "Unable to create a mesh from '%s'", asset.Filename);
+			}
+
+			file->drop();
+		}
+
+		/**
+		* Free a file's bytes and drop its mesh and image.
+		*
+		* @param asset The file to free.
+		*/
+		static void ReleaseLevelAsset(LevelAsset & asset)
+		{
+			std::vector<char>().swap(asset.Data);
+
+			if (asset.Mesh)
+			{
+				asset.Mesh->drop();
+				asset.Mesh = NULL;
+			}
+
+			if (asset.Image)
+			{
+				asset.Image->drop();
+				asset.Image = NULL;
+			}
+		}
+
+		//---------------------------------------------------------------------------------------
+		// LevelLoadRequest
+		//---------------------------------------------------------------------------------------
+		LevelLoadRequest::LevelLoadRequest(const char * filename, LevelCache * cache, 
+			irr::scene::ISceneManager * decoder) :
+			_filename(filename),
+			_state(LEVEL_LOAD_PENDING),
+			_progress(0.0f),
+			_error(OK),
+			_cancel(false),
+			_cache(cache),
+			_world(NULL),
+			_decoder(decoder),
+			_assets(),
+			_uploaded(0),
+			_thread()
+		{
+			//Do Nothing
+		}
+
+		LevelLoadRequest::~LevelLoadRequest()
+		{
+			Cancel();
+			_Join();
+			_Release();
+		}
+
+		void LevelLoadRequest::_Join()
+		{
+			if (_thread.joinable())
+				_thread.join();
+		}
+
+		void LevelLoadRequest::_Release()
+		{
+			if (_world)
+			{
+				delete _world;
+				_world = NULL;
+			}
+
+			for (size_t i = 0; i < _assets.size(); i++)
+				ReleaseLevelAsset(_assets[i]);
+
+			_assets.clear();
+
+			if (_decoder)
+			{
+				_decoder->drop();
+				_decoder = NULL;
+			}
+		}
+
+		void LevelLoadRequest::_Run()
+		{
+			BIO_LOG_LOADER(INFO, "Loading '%s' in the background", _filename);
+
+			_state.store(LEVEL_LOAD_PARSING, std::memory_order_release);
+
+			//without a cache every load is a miss
+			LevelCache uncached(0);
+			LevelCache & cache = _cache ? *_cache : uncached;
+
+			ErrorType error = OK;
+			_world = cache.Load(_filename.c_str(), error);
+
+			if (_world == NULL)
+			{
+				_error.store(error, std::memory_order_release);
+				_state.store(LEVEL_LOAD_FAILED, std::memory_order_release);
+				return;
+			}
+
+			_progress.store(BIO_LEVEL_LOAD_PARSE_PROGRESS, std::memory_order_relaxed);
+			_state.store(LEVEL_LOAD_READING_ASSETS, std::memory_order_release);
+
+			//many objects share a model or a texture so only read each file once
+			std::set<std::string> models;
+			std::set<std::string> textures;
+			for (unsigned int i = 0; i < _world->GetObjectCount(); i++)
+			{
+				const WorldObject & object = _world->GetObjectAt(i);
+
+				if (!object.Model.empty())
+					models.insert(object.Model);
+
+				if (!object.Texture.empty())
+					textures.insert(object.Texture);
+			}
+
+			std::vector<LevelAsset> files(models.size() + textures.size());
+			std::vector<LevelAsset>::iterator file = files.begin();
+
+			for (std::set<std::string>::const_iterator model = models.begin(); model != models.end(); ++model, ++file)
+				file->Filename = *model;
+
+			for (std::set<std::string>::const_iterator texture = textures.begin(); texture != textures.end(); ++texture, ++file)
+			{
+				file->Filename = *texture;
+				file->IsTexture = true;
+			}
+
+			_assets.reserve(files.size());
+
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				if (_cancel.load(std::memory_order_acquire))
+				{
+					_state.store(LEVEL_LOAD_CANCELLED, std::memory_order_release);
+					return;
+				}
+
+				LevelAsset & asset = files[i];
+
+				if (ReadLevelFile(asset.Filename, asset.Data))
+				{
+					if (_decoder)
+						DecodeLevelAsset(_decoder, asset);
+
+					_assets.push_back(asset);
+				}
+				else
+				{
+					BIO_LOG_LOADER(WARNING, "Unable to read '%s'", asset.Filename);
+				}
+
+				_progress.store(BIO_LEVEL_LOAD_PARSE_PROGRESS + 
+					BIO_LEVEL_LOAD_READ_PROGRESS * (i + 1) / files.size(), std::memory_order_relaxed);
+			}
+
+			_progress.store(BIO_LEVEL_LOAD_PARSE_PROGRESS + BIO_LEVEL_LOAD_READ_PROGRESS, 
+				std::memory_order_relaxed);
+			_state.store(LEVEL_LOAD_UPLOADING, std::memory_order_release);
+		}
+
+		//---------------------------------------------------------------------------------------
+		// LevelStreamer
+		//---------------------------------------------------------------------------------------
+		void LevelStreamer::CancelAll()
+		{
+			while (!_requests.empty())
+			{
+				LevelLoadRequest & request = *_requests.front();
+				request.Cancel();
+				request._Join();
+				request._Release();
+
+				if (!request.IsDone())
+					request._state.store(LEVEL_LOAD_CANCELLED, std::memory_order_release);
+
+				_requests.pop_front();
+			}
+		}
+
+		LevelLoadHandle LevelStreamer::Load(const char * filename, LevelCache * cache, 
+			irr::scene::ISceneManager * sceneManager)
+		{
+			irr::scene::ISceneManager * decoder = NULL;
+
+			if (sceneManager)
+			{
+				//the worker gets loaders of its own so it never shares state with the running scene
+				decoder = sceneManager->createNewSceneManager(false);
+				decoder->getParameters()->setAttribute(irr::scene::OBJ_LOADER_IGNORE_MATERIAL_FILES, true);
+			}
+
+			LevelLoadHandle request(new LevelLoadRequest(filename, cache, decoder));
+			request->_thread = std::thread(&LevelLoadRequest::_Run, request.get());
+			_requests.push_back(request);
+
+			return request;
+		}
+
+		World * LevelStreamer::Update(irr::scene::ISceneManager * sceneManager, unsigned int budget)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			bool uploadedAny = false;
+
+			while (!_requests.empty())
+			{
+				LevelLoadRequest & request = *_requests.front();
+				int state = request._state.load(std::memory_order_acquire);
+
+				if ((state == LEVEL_LOAD_UPLOADING) && request._cancel.load(std::memory_order_acquire))
+				{
+					state = LEVEL_LOAD_CANCELLED;
+					request._state.store(state, std::memory_order_release);
+				}
+
+				if ((state == LEVEL_LOAD_FAILED) || (state == LEVEL_LOAD_CANCELLED))
+				{
+					BIO_LOG_LOADER(INFO, "Background load of '%s' stopped", request._filename);
+					request._Join();
+					request._Release();
+					_requests.pop_front();
+					continue;
+				}
+
+				//the worker thread is still going
+				if (state != LEVEL_LOAD_UPLOADING)
+					return NULL;
+
+				//the worker set the state as its last step so this does not wait long
+				request._Join();
+
+				while (request._uploaded < request._assets.size())
+				{
+					if (uploadedAny)
+					{
+						std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+						if (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() >= budget)
+							return NULL;
+					}
+
+					LevelAsset & asset = request._assets[request._uploaded];
+
+					if (sceneManager)
+						UploadLevelAsset(sceneManager, asset);
+
+					ReleaseLevelAsset(asset);
+					request._uploaded++;
+					uploadedAny = true;
+
+					request._progress.store(BIO_LEVEL_LOAD_PARSE_PROGRESS + BIO_LEVEL_LOAD_READ_PROGRESS + 
+						BIO_LEVEL_LOAD_UPLOAD_PROGRESS * request._uploaded / request._assets.size(), 
+						std::memory_order_relaxed);
+				}
+
+				BIO_LOG_LOADER(INFO, "Background load of '%s' finished", request._filename);
+
+				World * world = request._world;
+				request._world = NULL;
+				request._Release();
+				request._progress.store(1.0f, std::memory_order_relaxed);
+				request._state.store(LEVEL_LOAD_COMPLETE, std::memory_order_release);
+				_requests.pop_front();
+
+				return world;
+			}
+
+			return NULL;
+		}
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+		/**
+		* Call Update until a request is done or too much time has passed.
+		*
+		* @return Returns the world from Update.
+		*/
+		static World * UpdateUntilDone(LevelStreamer & streamer, LevelLoadRequest & request, 
+			irr::scene::ISceneManager * sceneManager = NULL)
+		{
+			for (int i = 0; i < 5000; i++)
+			{
+				World * world = streamer.Update(sceneManager, 0);
+
+				if (world || request.IsDone())
+					return world;
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			return NULL;
+		}
+
+		bool LevelStreamer::Test(XNELO::TESTING::Test * test)
+		{
+			test->SetName("Testing LevelStreamer class");
+
+			const char * levelFile = "TESTSTREAMLEVEL.level";
+			std::ofstream file(levelFile);
+			file << "<LEVEL name=\"Streamed\"><OBJECTS>"
+				<< "<OBJECT name=\"a\"><MODEL>TESTSTREAMA.obj</MODEL><TEXTURE>TESTSTREAM.tga</TEXTURE></OBJECT>"
+				<< "<OBJECT name=\"b\"><MODEL>TESTSTREAMB.obj</MODEL></OBJECT>"
+				<< "<OBJECT name=\"c\"><MODEL>TESTSTREAMA.obj</MODEL><TEXTURE>TESTSTREAM.tga</TEXTURE></OBJECT>"
+				<< "<OBJECT name=\"d\"><MODEL>TESTSTREAMMISSING.obj</MODEL></OBJECT>"
+				<< "</OBJECTS></LEVEL>";
+			file.close();
+
+			file.open("TESTSTREAMA.obj");
+			file << "v 0 0 0" << std::endl << "v 1 0 0" << std::endl << "v 0 1 0" << std::endl << "f 1 2 3" << std::endl;
+			file.close();
+			file.open("TESTSTREAMB.obj");
+			file << "v 1 1 1" << std::endl << "v 2 1 1" << std::endl << "v 1 2 1" << std::endl << "f 1 2 3" << std::endl;
+			file.close();
+
+			//a 1x1 uncompressed 32 bit targa
+			const unsigned char targa[22] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 32, 8, 
+				0x40, 0x80, 0xC0, 0xFF };
+			file.open("TESTSTREAM.tga", std::ios::out | std::ios::binary);
+			file.write((const char *)targa, sizeof(targa));
+			file.close();
+
+			LevelStreamer streamer;
+			test->UnitTest(streamer.Update(NULL, 0) == NULL, "Update with nothing to load");
+
+			LevelLoadHandle request = streamer.Load(levelFile);
+			test->UnitTest(request->GetFilename() == levelFile, "Request filename");
+			test->UnitTest(streamer.GetPendingCount() == 1, "Request is pending");
+
+			World * world = UpdateUntilDone(streamer, *request);
+			test->UnitTest(world != NULL, "Streamed world is returned");
+			test->UnitTest(request->GetState() == LEVEL_LOAD_COMPLETE, "Request is complete");
+			test->UnitTest(request->GetProgress() == 1.0f, "Request progress is finished");
+			test->UnitTest(request->GetError() == OK, "Request has no error");
+			test->UnitTest(streamer.GetPendingCount() == 0, "Finished request is removed");
+			test->UnitTest(request->_assets.empty() && request->_uploaded == 3, "Each model and texture is read once");
+
+			if (world)
+			{
+				test->UnitTest(world->GetObjectCount() == 4, "Streamed world objects");
+				delete world;
+			}
+
+			//decoding on the worker thread
+			irr::SIrrlichtCreationParameters params;
+			params.DeviceType = irr::EIDT_CONSOLE;
+			params.DriverType = irr::video::EDT_NULL;
+			params.ConsoleOutput = false;
+			params.LoggingLevel = irr::ELL_NONE;
+			irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+			test->UnitTest(device != NULL, "Null device created");
+
+			if (device)
+			{
+				irr::scene::ISceneManager * sceneManager = device->getSceneManager();
+				request = streamer.Load(levelFile, NULL, sceneManager);
+
+				for (int i = 0; i < 5000 && request->GetState() < LEVEL_LOAD_UPLOADING; i++)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+				bool decoded = request->GetState() == LEVEL_LOAD_UPLOADING && request->_assets.size() == 3;
+				for (size_t i = 0; decoded && i < request->_assets.size(); i++)
+				{
+					const LevelAsset & asset = request->_assets[i];
+					decoded = asset.Data.empty() && (asset.IsTexture ? 
+						(asset.Image != NULL && asset.Image->getDimension() == irr::core::dimension2du(1, 1)) : 
+						(asset.Mesh != NULL && asset.Mesh->getMeshBufferCount() == 1));
+				}
+				test->UnitTest(decoded, "Models and textures are decoded by the worker");
+
+				world = UpdateUntilDone(streamer, *request, sceneManager);
+				test->UnitTest(world != NULL && request->_decoder == NULL, "Decoded world is returned");
+				test->UnitTest(sceneManager->getMeshCache()->getMeshByName("TESTSTREAMA.obj") != NULL && 
+					sceneManager->getMeshCache()->getMeshByName("TESTSTREAMB.obj") != NULL, "Meshes are added to the scene");
+
+				test->UnitTest(device->getVideoDriver()->findTexture("TESTSTREAM.tga") != NULL, 
+					"Texture is added to the scene");
+				delete world;
+
+				//cancelled requests drop what they decoded
+				request = streamer.Load(levelFile, NULL, sceneManager);
+				request->Cancel();
+				world = UpdateUntilDone(streamer, *request, sceneManager);
+				test->UnitTest(world == NULL && request->_assets.empty() && request->_decoder == NULL, 
+					"Cancelled decode is released");
+
+				device->drop();
+			}
+
+			//failure
+			request = streamer.Load("TESTSTREAMNOTAFILE.level");
+			world = UpdateUntilDone(streamer, *request);
+			test->UnitTest(world == NULL, "Missing level returns no world");
+			test->UnitTest(request->GetState() == LEVEL_LOAD_FAILED, "Missing level fails");
+			test->UnitTest(request->GetError() == ERROR_LOADLEVEL__FILE_DOES_NOT_EXISTS, "Missing level error");
+
+			//cancel
+			request = streamer.Load(levelFile);
+			request->Cancel();
+			world = UpdateUntilDone(streamer, *request);
+			test->UnitTest(world == NULL, "Cancelled level returns no world");
+			test->UnitTest(request->GetState() == LEVEL_LOAD_CANCELLED, "Request is cancelled");
+
+			//requests finish in order
+			LevelLoadHandle first = streamer.Load(levelFile);
+			LevelLoadHandle second = streamer.Load(levelFile);
+			world = UpdateUntilDone(streamer, *first);
+			test->UnitTest(world != NULL && !second->IsDone(), "First request finishes first");
+			delete world;
+			world = UpdateUntilDone(streamer, *second);
+			test->UnitTest(world != NULL, "Second request finishes");
+			delete world;
+
+			//cancel everything
+			request = streamer.Load(levelFile);
+			streamer.CancelAll();
+			test->UnitTest(request->IsDone() && streamer.GetPendingCount() == 0, "Cancel all");
+
+			remove(levelFile);
+			remove("TESTSTREAMA.obj");
+			remove("TESTSTREAMB.obj");
+			remove("TESTSTREAM.tga");
+
+			return test->GetSuccess();
+		}
+#endif
+	}//end namespace ENGINE
+}//end namespace BIO
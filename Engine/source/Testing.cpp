@@ -32,6 +32,10 @@
 //include all of the objects to test
 #include "BIOEngineClass.hpp"
 #include "XMLLevelLoader.hpp"
+#include "BinaryLevelLoader.hpp"
+#include "FrameScheduler.hpp"
+#include "LevelCache.hpp"
+#include "LevelStreamer.hpp"
 
 bool BIO::ENGINE::TestEngine()
 {
@@ -43,6 +47,10 @@ bool BIO::ENGINE::TestEngine()
 	//add the test functions
 	testSuite.AddTestFunction(BIOEngine::Test);
 	testSuite.AddTestFunction(XMLLevelLoader::Test);
+	testSuite.AddTestFunction(BinaryLevelLoader::Test);
+	testSuite.AddTestFunction(FrameScheduler::Test);
+	testSuite.AddTestFunction(LevelCache::Test);
+	testSuite.AddTestFunction(LevelStreamer::Test);
 
 	//run tests and print out results
 	testSuite.ExecuteTests();
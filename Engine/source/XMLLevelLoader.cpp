@@ -30,63 +30,758 @@
 #include "../rapidxml-1.13/rapidxml_utils.hpp"
 #include "../rapidxml-1.13/rapidxml.hpp"
 
+#include <cstdlib>
+#include <exception>
+
 #if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #endif
 
+//The rapidxml flags used to parse level files. Data nodes are not needed because the text of an 
+//element is stored as the element's value.
+#define BIO_LEVEL_PARSE_FLAGS (rapidxml::parse_no_data_nodes | rapidxml::parse_trim_whitespace)
+
+//The number of slots in the keyword hash table. Must be a power of two bigger than KEYWORD_COUNT.
+#define BIO_LEVEL_KEYWORD_TABLE_SIZE 128
+
 namespace BIO
 {
 	namespace ENGINE
 	{
+		/**
+		* Every tag, attribute and attribute value that has a meaning in a level file.
+		*/
+		enum LEVEL_KEYWORD
+		{
+			KEYWORD_UNKNOWN = 0,
+			//structure
+			KEYWORD_LEVEL,
+			KEYWORD_SETTINGS,
+			KEYWORD_CAMERA,
+			KEYWORD_OBJECTS,
+			KEYWORD_OBJECT,
+			//settings
+			KEYWORD_LEVELFILE,
+			KEYWORD_GRAVITY,
+			KEYWORD_LATITUDE,
+			KEYWORD_AMBIENTLIGHT,
+			//camera
+			KEYWORD_CAMERAFOLLOW,
+			KEYWORD_FOLLOWDISTANCE,
+			KEYWORD_FOLLOWHEIGHT,
+			KEYWORD_POSITION,
+			KEYWORD_LOOKAT,
+			//objects
+			KEYWORD_MODEL,
+			KEYWORD_TEXTURE,
+			KEYWORD_ROTATION,
+			KEYWORD_SCALE,
+			//basic types
+			KEYWORD_VECTOR3,
+			KEYWORD_VECTOR,
+			KEYWORD_COLOR,
+			KEYWORD_ANGLE,
+			//attributes
+			KEYWORD_NAME,
+			KEYWORD_TYPE,
+			KEYWORD_VALUE,
+			KEYWORD_MINVIEW,
+			KEYWORD_MAXVIEW,
+			KEYWORD_X,
+			KEYWORD_Y,
+			KEYWORD_Z,
+			KEYWORD_R,
+			KEYWORD_G,
+			KEYWORD_B,
+			KEYWORD_A,
+			//attribute values
+			KEYWORD_INT,
+			KEYWORD_FLOAT,
+			KEYWORD_DEGREES,
+			KEYWORD_RADIANS,
+			KEYWORD_DEFAULT,
+			KEYWORD_FOLLOWING,
+			KEYWORD_COUNT
+		};
+
+		/**
+		* The text of each LEVEL_KEYWORD. This must be in the same order as the enum.
+		*/
+		const char * const _keywordNames[KEYWORD_COUNT] = 
+		{
+			"",
+			"LEVEL", "SETTINGS", "CAMERA", "OBJECTS", "OBJECT",
+			"LEVELFILE", "GRAVITY", "LATITUDE", "AMBIENTLIGHT",
+			"CAMERAFOLLOW", "FOLLOWDISTANCE", "FOLLOWHEIGHT", "POSITION", "LOOKAT",
+			"MODEL", "TEXTURE", "ROTATION", "SCALE",
+			"VECTOR3", "VECTOR", "COLOR", "ANGLE",
+			"NAME", "TYPE", "VALUE", "MINVIEW", "MAXVIEW", "X", "Y", "Z", "R", "G", "B", "A",
+			"INT", "FLOAT", "DEGREES", "RADIANS", "DEFAULT", "FOLLOWING"
+		};
+
+		/**
+		* Turn an ASCII letter into upper case. Level files are case insensitive.
+		*/
+		inline char _ToUpper(char c)
+		{
+			return ((c >= 'a') && (c <= 'z')) ? (char)(c - ('a' - 'A')) : c;
+		}
+
+		/**
+		* Hash a name ignoring case (FNV-1a).
+		*
+		* @param name The name to hash. Does not need to be null terminated.
+		* @param size The number of chars in name.
+		*
+		* @return Returns the hash of the name.
+		*/
+		inline CORE::uint32 _HashCI(const char * name, size_t size)
+		{
+			CORE::uint32 hash = 2166136261u;
+
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= (unsigned char)_ToUpper(name[i]);
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		/**
+		* Check if a name is the same as a keyword ignoring case.
+		*/
+		inline bool _EqualsKeyword(const char * name, size_t size, LEVEL_KEYWORD keyword)
+		{
+			const char * text = _keywordNames[keyword];
+
+			for (size_t i = 0; i < size; i++)
+			{
+				if ((text[i] == '\0') || (_ToUpper(name[i]) != text[i]))
+					return false;
+			}
+
+			return text[size] == '\0';
+		}
+
+		/**
+		* An open addressed hash table that turns names into LEVEL_KEYWORDs. It is built once 
+		* when the library is loaded so looking up a tag is one hash and one compare instead of 
+		* comparing against every tag the parser knows.
+		*/
+		class _KeywordTable
+		{
+		private:
+			/**
+			* One slot in the table.
+			*/
+			struct _Entry
+			{
+				CORE::uint32 hash;			/**< The hash of the keyword's name.*/
+				LEVEL_KEYWORD keyword;		/**< The keyword. KEYWORD_UNKNOWN if empty.*/
+			};
+
+			/**
+			* The slots.
+			*/
+			_Entry _entries[BIO_LEVEL_KEYWORD_TABLE_SIZE];
+
+		public:
+			/**
+			* Constructor. Fills in the table.
+			*/
+			_KeywordTable()
+			{
+				for (int i = 0; i < BIO_LEVEL_KEYWORD_TABLE_SIZE; i++)
+				{
+					_entries[i].hash = 0;
+					_entries[i].keyword = KEYWORD_UNKNOWN;
+				}
+
+				for (int keyword = KEYWORD_UNKNOWN + 1; keyword < KEYWORD_COUNT; keyword++)
+				{
+					const char * name = _keywordNames[keyword];
+					CORE::uint32 hash = _HashCI(name, strlen(name));
+					CORE::uint32 slot = hash & (BIO_LEVEL_KEYWORD_TABLE_SIZE - 1);
+
+					while (_entries[slot].keyword != KEYWORD_UNKNOWN)
+						slot = (slot + 1) & (BIO_LEVEL_KEYWORD_TABLE_SIZE - 1);
+
+					_entries[slot].hash = hash;
+					_entries[slot].keyword = (LEVEL_KEYWORD)keyword;
+				}
+			}
+
+			/**
+			* Find the keyword for a name.
+			*
+			* @param name The name to look up. Does not need to be null terminated.
+			* @param size The number of chars in name.
+			*
+			* @return Returns the keyword or KEYWORD_UNKNOWN.
+			*/
+			LEVEL_KEYWORD Find(const char * name, size_t size) const
+			{
+				CORE::uint32 hash = _HashCI(name, size);
+				CORE::uint32 slot = hash & (BIO_LEVEL_KEYWORD_TABLE_SIZE - 1);
+
+				while (_entries[slot].keyword != KEYWORD_UNKNOWN)
+				{
+					if ((_entries[slot].hash == hash) && 
+						_EqualsKeyword(name, size, _entries[slot].keyword))
+						return _entries[slot].keyword;
+
+					slot = (slot + 1) & (BIO_LEVEL_KEYWORD_TABLE_SIZE - 1);
+				}
+
+				return KEYWORD_UNKNOWN;
+			}
+		};
+
+		/**
+		* The keywords of the level file format.
+		*/
+		const _KeywordTable _keywords;
+
+		/**
+		* Get the keyword of a tag or attribute name.
+		*/
+		inline LEVEL_KEYWORD _GetNameKeyword(const rapidxml::xml_base<> * item)
+		{
+			return _keywords.Find(item->name(), item->name_size());
+		}
+
+		/**
+		* Get the keyword of a tag or attribute value.
+		*/
+		inline LEVEL_KEYWORD _GetValueKeyword(const rapidxml::xml_base<> * item)
+		{
+			return _keywords.Find(item->value(), item->value_size());
+		}
+
+		/**
+		* Parse a floating point number. White space is allowed after the sign.
+		*
+		* @param text The null terminated text of the number.
+		* @param defaultValue The value to use if text is not a number.
+		*
+		* @return Returns the number.
+		*/
+		inline float _ParseFloat(const char * text, float defaultValue)
+		{
+			const char * c = text;
+			bool negative = false;
+
+			while ((*c == ' ') || (*c == '\t'))
+				c++;
+
+			if ((*c == '-') || (*c == '+'))
+			{
+				negative = (*c == '-');
+				c++;
+
+				while ((*c == ' ') || (*c == '\t'))
+					c++;
+			}
+
+			char * end;
+			double value = strtod(c, &end);
+
+			if (end == c)
+				return defaultValue;
+
+			return (float)(negative ? -value : value);
+		}
+
+		/**
+		* Log a tag that has no meaning where it was found.
+		*/
+		inline void _LogUnknownTag(const rapidxml::xml_node<> * node)
+		{
+			BIO_LOG_LOADER(DEBUG2, "Ignoring unknown tag <%s> in <%s>", 
+				node->name(), 
+				node->parent()->name());
+		}
+
+		/**
+		* Parse a VECTOR3 tag. Missing attributes are 0.
+		*/
+		Vector3 _ParseVector3(const rapidxml::xml_node<> * node)
+		{
+			Vector3 vector(0.0f, 0.0f, 0.0f);
+
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				switch (_GetNameKeyword(attribute))
+				{
+				case KEYWORD_X:
+					vector.X = _ParseFloat(attribute->value(), 0.0f);
+					break;
+				case KEYWORD_Y:
+					vector.Y = _ParseFloat(attribute->value(), 0.0f);
+					break;
+				case KEYWORD_Z:
+					vector.Z = _ParseFloat(attribute->value(), 0.0f);
+					break;
+				default:
+					break;
+				}
+			}
+
+			return vector;
+		}
+
+		/**
+		* Parse a COLOR tag. Missing channels are fully on.
+		*/
+		Color _ParseColor(const rapidxml::xml_node<> * node)
+		{
+			float channels[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+			bool given[4] = { false, false, false, false };
+			bool isFloat = false;
+
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				int channel = -1;
+
+				switch (_GetNameKeyword(attribute))
+				{
+				case KEYWORD_TYPE:
+					isFloat = (_GetValueKeyword(attribute) == KEYWORD_FLOAT);
+					break;
+				case KEYWORD_R:
+					channel = 0;
+					break;
+				case KEYWORD_G:
+					channel = 1;
+					break;
+				case KEYWORD_B:
+					channel = 2;
+					break;
+				case KEYWORD_A:
+					channel = 3;
+					break;
+				default:
+					break;
+				}
+
+				if (channel >= 0)
+				{
+					channels[channel] = _ParseFloat(attribute->value(), channels[channel]);
+					given[channel] = true;
+				}
+			}
+
+			//the type can come after the channels so scale them at the end
+			for (int i = 0; i < 4; i++)
+			{
+				if (!given[i])
+					channels[i] = 1.0f;
+				else if (!isFloat)
+					channels[i] /= 255.0f;
+			}
+
+			return Color(channels[0], channels[1], channels[2], channels[3]);
+		}
+
+		/**
+		* Parse an ANGLE tag. Returns the angle in radians.
+		*/
+		float _ParseAngle(const rapidxml::xml_node<> * node)
+		{
+			bool degrees = false;
+			float value = 0.0f;
+
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				switch (_GetNameKeyword(attribute))
+				{
+				case KEYWORD_TYPE:
+					degrees = (_GetValueKeyword(attribute) == KEYWORD_DEGREES);
+					break;
+				case KEYWORD_VALUE:
+					value = _ParseFloat(attribute->value(), 0.0f);
+					break;
+				default:
+					break;
+				}
+			}
+
+			return degrees ? (value * irr::core::DEGTORAD) : value;
+		}
+
+		/**
+		* Find the first child element of a node that is a VECTOR3 tag and parse it.
+		*
+		* @param[in] node The node holding the vector.
+		* @param[out] vector Set to the parsed vector. Not changed if there is no VECTOR3 tag.
+		*/
+		void _ParseVector3Child(const rapidxml::xml_node<> * node, Vector3 & vector)
+		{
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				LEVEL_KEYWORD keyword = _GetNameKeyword(child);
+
+				if ((keyword == KEYWORD_VECTOR3) || (keyword == KEYWORD_VECTOR))
+				{
+					vector = _ParseVector3(child);
+					return;
+				}
+			}
+		}
+
+		/**
+		* Find the first child element of a node that is an ANGLE tag and parse it.
+		*
+		* @param[in] node The node holding the angle.
+		* @param[out] angle Set to the parsed angle. Not changed if there is no ANGLE tag.
+		*/
+		void _ParseAngleChild(const rapidxml::xml_node<> * node, float & angle)
+		{
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				if (_GetNameKeyword(child) == KEYWORD_ANGLE)
+				{
+					angle = _ParseAngle(child);
+					return;
+				}
+			}
+		}
+
+		/**
+		* Find the first child element of a node that is a COLOR tag and parse it.
+		*
+		* @param[in] node The node holding the color.
+		* @param[out] color Set to the parsed color. Not changed if there is no COLOR tag.
+		*/
+		void _ParseColorChild(const rapidxml::xml_node<> * node, Color & color)
+		{
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				if (_GetNameKeyword(child) == KEYWORD_COLOR)
+				{
+					color = _ParseColor(child);
+					return;
+				}
+			}
+		}
+
+		/**
+		* Parse the SETTINGS tag.
+		*/
+		void _ParseSettings(const rapidxml::xml_node<> * node, LevelInfo & info)
+		{
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				switch (_GetNameKeyword(child))
+				{
+				case KEYWORD_LEVELFILE:
+					info.LevelFilename.assign(child->value(), child->value_size());
+					break;
+				case KEYWORD_GRAVITY:
+					_ParseVector3Child(child, info.Gravity);
+					break;
+				case KEYWORD_LATITUDE:
+					_ParseAngleChild(child, info.Latitude);
+					break;
+				case KEYWORD_AMBIENTLIGHT:
+					_ParseColorChild(child, info.AmbientLight);
+					break;
+				default:
+					_LogUnknownTag(child);
+					break;
+				}
+			}
+		}
+
+		/**
+		* Parse the CAMERA tag.
+		*/
+		void _ParseCamera(const rapidxml::xml_node<> * node, LevelInfo & info)
+		{
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				switch (_GetNameKeyword(attribute))
+				{
+				case KEYWORD_TYPE:
+					info.CameraType = (_GetValueKeyword(attribute) == KEYWORD_FOLLOWING) ? 
+						CAMERA_FOLLOW : CAMERA_DEFAULT;
+					break;
+				case KEYWORD_MINVIEW:
+					info.MinView = _ParseFloat(attribute->value(), info.MinView);
+					break;
+				case KEYWORD_MAXVIEW:
+					info.MaxView = _ParseFloat(attribute->value(), info.MaxView);
+					break;
+				default:
+					break;
+				}
+			}
+
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				switch (_GetNameKeyword(child))
+				{
+				case KEYWORD_CAMERAFOLLOW:
+					info.ToFollow.assign(child->value(), child->value_size());
+					break;
+				case KEYWORD_FOLLOWDISTANCE:
+					info.FollowDistance = _ParseFloat(child->value(), info.FollowDistance);
+					break;
+				case KEYWORD_FOLLOWHEIGHT:
+					info.FollowHeight = _ParseFloat(child->value(), info.FollowHeight);
+					break;
+				case KEYWORD_POSITION:
+					_ParseVector3Child(child, info.Position);
+					break;
+				case KEYWORD_LOOKAT:
+					_ParseVector3Child(child, info.LookAt);
+					break;
+				default:
+					_LogUnknownTag(child);
+					break;
+				}
+			}
+		}
+
+		/**
+		* Parse one OBJECT tag.
+		*/
+		void _ParseObject(const rapidxml::xml_node<> * node, WorldObject & object)
+		{
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				if (_GetNameKeyword(attribute) == KEYWORD_NAME)
+					object.Name.assign(attribute->value(), attribute->value_size());
+			}
+
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				switch (_GetNameKeyword(child))
+				{
+				case KEYWORD_MODEL:
+					object.Model.assign(child->value(), child->value_size());
+					break;
+				case KEYWORD_TEXTURE:
+					object.Texture.assign(child->value(), child->value_size());
+					break;
+				case KEYWORD_POSITION:
+					_ParseVector3Child(child, object.Position);
+					break;
+				case KEYWORD_ROTATION:
+					_ParseVector3Child(child, object.Rotation);
+					break;
+				case KEYWORD_SCALE:
+					_ParseVector3Child(child, object.Scale);
+					break;
+				case KEYWORD_COLOR:
+					object.Tint = _ParseColor(child);
+					break;
+				default:
+					_LogUnknownTag(child);
+					break;
+				}
+			}
+		}
+
+		/**
+		* Parse the OBJECTS tag.
+		*/
+		void _ParseObjects(const rapidxml::xml_node<> * node, World & world)
+		{
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				if (_GetNameKeyword(child) == KEYWORD_OBJECT)
+					_ParseObject(child, world.AddObject());
+				else
+					_LogUnknownTag(child);
+			}
+		}
+
+		/**
+		* Parse the LEVEL tag and everything in it.
+		*/
+		void _ParseLevel(const rapidxml::xml_node<> * node, LevelInfo & info, World & world)
+		{
+			for (rapidxml::xml_attribute<> * attribute = node->first_attribute(); 
+				attribute != NULL; 
+				attribute = attribute->next_attribute())
+			{
+				if (_GetNameKeyword(attribute) == KEYWORD_NAME)
+					info.Name.assign(attribute->value(), attribute->value_size());
+			}
+
+			for (rapidxml::xml_node<> * child = node->first_node(); 
+				child != NULL; 
+				child = child->next_sibling())
+			{
+				switch (_GetNameKeyword(child))
+				{
+				case KEYWORD_SETTINGS:
+					_ParseSettings(child, info);
+					break;
+				case KEYWORD_CAMERA:
+					_ParseCamera(child, info);
+					break;
+				case KEYWORD_OBJECTS:
+					_ParseObjects(child, world);
+					break;
+				default:
+					_LogUnknownTag(child);
+					break;
+				}
+			}
+
+			world.SetGravity(info.Gravity);
+			world.SetAmbientLight(info.AmbientLight);
+		}
+
 		void XMLLevelLoader::Clear()
 		{
-			_isParsed = false;
-			_error = OK;
+			ILevelLoader::Clear();
+
+			if (_world)
+			{
+				delete _world;
+				_world = NULL;
+			}
 		}
 
 		void XMLLevelLoader::ParseLevel()
 		{
-			BIO_LOG_INFO("Parse Level");
+			BIO_LOG_LOADER(INFO, "Parse Level");
 
-			//parse the xml level file
-			rapidxml::file<> xmlFile(_filename.c_str());
-			rapidxml::xml_document<> doc;
-			doc.parse<0>(xmlFile.data());
+			Clear();
 
-			_isParsed = true;
+			try
+			{
+				//parse the xml level file in place
+				rapidxml::file<> xmlFile(_filename.c_str());
+				rapidxml::xml_document<> doc;
+				doc.parse<BIO_LEVEL_PARSE_FLAGS>(xmlFile.data());
+
+				//anything outside of the LEVEL tag is ignored
+				rapidxml::xml_node<> * level = doc.first_node();
+				while ((level != NULL) && (_GetNameKeyword(level) != KEYWORD_LEVEL))
+					level = level->next_sibling();
+
+				if (level == NULL)
+				{
+					BIO_LOG_LOADER(ERROR, "No LEVEL tag in '%s'", _filename);
+					_error = ERROR_LOADLEVEL__PARSE_FAILED;
+					return;
+				}
+
+				_world = new World();
+				_ParseLevel(level, _levelInfo, *_world);
+			}
+			catch (rapidxml::parse_error & e)
+			{
+				BIO_LOG_LOADER(ERROR, "Error parsing '%s': %s", _filename, e.what());
+				Clear();
+				_error = ERROR_LOADLEVEL__PARSE_FAILED;
+				return;
+			}
+			catch (std::exception & e)
+			{
+				BIO_LOG_LOADER(ERROR, "Error reading '%s': %s", _filename, e.what());
+				Clear();
+				_error = ERROR_LOADLEVEL__PARSE_FAILED;
+				return;
+			}
 
-			_error = ERROR_NOT_IMPLEMENTED;
+			_isParsed = true;
+			_error = OK;
 		}
 
 		World * XMLLevelLoader::LoadLevel()
 		{
-			BIO_LOG_INFO("Loading Level");
-			if (_isParsed == false)
+			BIO_LOG_LOADER(INFO, "Loading Level");
+			if ((_isParsed == false) || (_world == NULL))
 			{
-				BIO_LOG_DEBUG("Level not parsed... parse level");
+				BIO_LOG_LOADER(DEBUG, "Level not parsed... parse level");
 				ParseLevel();
 			}
 
-			_error = ERROR_NOT_IMPLEMENTED;
+			if (_error != OK)
+				return NULL;
 
-			//now load the level
-			return NULL;
+			//the caller owns the world now
+			World * world = _world;
+			_world = NULL;
+
+			return world;
+		}
+
+#if BIOENGINE_TESTING_IS_ENABLED == BIOENGINE_TESTING_ON
+		/**
+		* Check if two floats are close enough to be called equal.
+		*/
+		inline bool _TestNear(float a, float b)
+		{
+			return fabs(a - b) < 0.0001f;
 		}
 
 		bool XMLLevelLoader::Test(XNELO::TESTING::Test * test)
 		{
 			test->SetName("Tsting XMLLevelLoader class");
 
+			//keywords
+			bool allFound = true;
+			for (int keyword = KEYWORD_UNKNOWN + 1; keyword < KEYWORD_COUNT; keyword++)
+			{
+				const char * name = _keywordNames[keyword];
+				if (_keywords.Find(name, strlen(name)) != keyword)
+					allFound = false;
+			}
+			test->UnitTest(allFound, "Every keyword is in the keyword table");
+			test->UnitTest(_keywords.Find("vEcToR3", 7) == KEYWORD_VECTOR3, "Keywords are case insensitive");
+			test->UnitTest(_keywords.Find("VECTOR3X", 7) == KEYWORD_VECTOR3, "Keywords use the given size");
+			test->UnitTest(_keywords.Find("VECTOR", 6) == KEYWORD_VECTOR, "Keyword prefix of another keyword");
+			test->UnitTest(_keywords.Find("LATITUD", 7) == KEYWORD_UNKNOWN, "Unknown keyword");
+			test->UnitTest(_keywords.Find("", 0) == KEYWORD_UNKNOWN, "Empty keyword");
+
+			//numbers
+			test->UnitTest(_TestNear(_ParseFloat("- 9.8", 0.0f), -9.8f), "Parse float with space after sign");
+			test->UnitTest(_TestNear(_ParseFloat("abc", 2.0f), 2.0f), "Parse float default");
+
 			//write the tests level
 			std::string testFileName = "TESTLEVEL.level";
 			std::ofstream testFile;
 			testFile.open(testFileName);
 			testFile << "<?xml version=\"1.0\" encoding=\"utf-8\" ?>" << std::endl
-				<< "<LEVEL>" << std::endl
+				<< "<LEVEL name=\"Test Level\">" << std::endl
 				<< "   <SETTINGS>" << std::endl
 				<< "      <LEVELFILE>mainScreen.obj</LEVELFILE>" << std::endl
 				<< "      <GRAVITY><VECTOR x=\"0.0\" y=\"- 9.8\" z=\"0.0\"/></GRAVITY>" << std::endl
 				<< "      <LATITUDE><ANGLE type=\"DEGREES\" value=\"41\" /></LATITUDE>" << std::endl
+				<< "      <AmbientLight><COLOR r=\"128\" b=\"64\" /></AmbientLight>" << std::endl
 				<< "   </SETTINGS>" << std::endl
 				<< "   <!--" << std::endl
 				<< "   <CAMERA type=\"Following\">" << std::endl
@@ -95,22 +790,113 @@ namespace BIO
 				<< "   <FOLLOWHEIGHT>5</FOLLOWHEIGHT>" << std::endl
 				<< "   </CAMERA>" << std::endl
 				<< "   -->" << std::endl
-				<< "   <CAMERA type=\"Default\" minview=\"0.1\" maxview=\"1000.0\">" << std::endl
+				<< "   <objects>" << std::endl
+				<< "      <Object name=\"tank1\">" << std::endl
+				<< "         <MODEL>tank.obj</MODEL>" << std::endl
+				<< "         <TEXTURE>tank.png</TEXTURE>" << std::endl
+				<< "         <POSITION><VECTOR3 x=\"1.5\" z=\"-2\" /></POSITION>" << std::endl
+				<< "         <ROTATION><VECTOR3 y=\"90\" /></ROTATION>" << std::endl
+				<< "         <COLOR type=\"float\" g=\"0.5\" />" << std::endl
+				<< "      </Object>" << std::endl
+				<< "      <OBJECT name=\"crate\"><SCALE><VECTOR3 x=\"2\" y=\"2\" z=\"2\" /></SCALE></OBJECT>" << std::endl
+				<< "   </objects>" << std::endl
+				<< "   <CAMERA type=\"Default\" minview=\"0.5\" maxview=\"500.0\">" << std::endl
 				<< "   <POSITION><VECTOR x=\"0.0\" y=\"3.0\" z=\"0.0\" /></POSITION>" << std::endl
-				<< "   <LOOKAT><VECTOR x=\"0.0\" y=\"0.0\" z=\"0.0\" /></LOOKAT>" << std::endl
+				<< "   <LOOKAT><vector3 x=\"1.0\" y=\"0.0\" z=\"0.0\" /></LOOKAT>" << std::endl
 				<< "   </CAMERA>" << std::endl
 				<< "</LEVEL>" << std::endl;
 			testFile.close();
 
-
 			XMLLevelLoader levelLoader;
 			levelLoader.SetFilename(testFileName);
 			levelLoader.ParseLevel();
 
 			test->UnitTest(levelLoader.IsParsed() == true, "Test isParsed set correctly");
+			test->UnitTest(levelLoader.GetError() == OK, "Level parsed without error");
+
+			LevelInfo info = levelLoader.GetLevelInfo();
+			test->UnitTest(info.Name == "Test Level", "Level name");
+			test->UnitTest(info.LevelFilename == "mainScreen.obj", "Level file");
+			test->UnitTest(_TestNear(info.Gravity.Y, -9.8f) && _TestNear(info.Gravity.X, 0.0f), "Gravity");
+			test->UnitTest(_TestNear(info.Latitude, 41.0f * irr::core::DEGTORAD), "Latitude in radians");
+			test->UnitTest(_TestNear(info.AmbientLight.r, 128.0f / 255.0f) && 
+				_TestNear(info.AmbientLight.g, 1.0f) && 
+				_TestNear(info.AmbientLight.b, 64.0f / 255.0f) && 
+				_TestNear(info.AmbientLight.a, 1.0f), "Ambient light int color");
+			test->UnitTest(info.CameraType == CAMERA_DEFAULT, "Commented out camera is ignored");
+			test->UnitTest(_TestNear(info.MinView, 0.5f) && _TestNear(info.MaxView, 500.0f), "Camera view range");
+			test->UnitTest(_TestNear(info.Position.Y, 3.0f), "Camera position");
+			test->UnitTest(_TestNear(info.LookAt.X, 1.0f), "Camera look at");
+
+			World * world = levelLoader.LoadLevel();
+			test->UnitTest(world != NULL, "LoadLevel returns a world");
+
+			if (world != NULL)
+			{
+				test->UnitTest(world->GetObjectCount() == 2, "World object count");
+				test->UnitTest(_TestNear(world->GetGravity().Y, -9.8f), "World gravity");
+
+				WorldObject * tank = world->FindObject("TANK1");
+				test->UnitTest(tank != NULL, "Find object ignoring case");
+
+				if (tank != NULL)
+				{
+					test->UnitTest(tank->Model == "tank.obj", "Object model");
+					test->UnitTest(tank->Texture == "tank.png", "Object texture");
+					test->UnitTest(_TestNear(tank->Position.X, 1.5f) && 
+						_TestNear(tank->Position.Y, 0.0f) && 
+						_TestNear(tank->Position.Z, -2.0f), "Object position");
+					test->UnitTest(_TestNear(tank->Rotation.Y, 90.0f), "Object rotation");
+					test->UnitTest(_TestNear(tank->Scale.X, 1.0f), "Object default scale");
+					test->UnitTest(_TestNear(tank->Tint.g, 0.5f) && _TestNear(tank->Tint.r, 1.0f), "Object float color");
+				}
+
+				test->UnitTest(_TestNear(world->GetObjectAt(1).Scale.Z, 2.0f), "Object scale");
+
+				delete world;
+			}
+
+			//a following camera
+			testFile.open(testFileName);
+			testFile << "<LEVEL><CAMERA TYPE=\"following\">"
+				<< "<CAMERAFOLLOW>tank1</CAMERAFOLLOW><FOLLOWDISTANCE>11.23</FOLLOWDISTANCE>"
+				<< "<FOLLOWHEIGHT>5.6</FOLLOWHEIGHT></CAMERA></LEVEL>";
+			testFile.close();
+
+			levelLoader.SetFilename(testFileName);
+			levelLoader.ParseLevel();
+			info = levelLoader.GetLevelInfo();
+			test->UnitTest(info.CameraType == CAMERA_FOLLOW, "Following camera");
+			test->UnitTest(info.ToFollow == "tank1", "Camera follow");
+			test->UnitTest(_TestNear(info.FollowDistance, 11.23f) && _TestNear(info.FollowHeight, 5.6f), 
+				"Camera follow distance and height");
+
+			//errors
+			testFile.open(testFileName);
+			testFile << "<NOTALEVEL></NOTALEVEL>";
+			testFile.close();
+
+			levelLoader.SetFilename(testFileName);
+			test->UnitTest(levelLoader.LoadLevel() == NULL, "No LEVEL tag returns no world");
+			test->UnitTest(levelLoader.GetError() == ERROR_LOADLEVEL__PARSE_FAILED, "No LEVEL tag error");
+
+			testFile.open(testFileName);
+			testFile << "<LEVEL><SETTINGS></LEVEL>";
+			testFile.close();
+
+			levelLoader.SetFilename(testFileName);
+			levelLoader.ParseLevel();
+			test->UnitTest(levelLoader.GetError() == ERROR_LOADLEVEL__PARSE_FAILED, "Bad XML error");
+			test->UnitTest(levelLoader.IsParsed() == false, "Bad XML is not parsed");
+
+			remove(testFileName.c_str());
+
+			levelLoader.SetFilename(testFileName);
+			levelLoader.ParseLevel();
+			test->UnitTest(levelLoader.GetError() == ERROR_LOADLEVEL__PARSE_FAILED, "Missing file error");
 
 			return test->GetSuccess();
 		}
+#endif
 	}//end namespace ENGINE
 }//end namespace BIO
-
@@ -0,0 +1,241 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <irrlicht.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Get the seconds between two times.
+*/
+double Seconds(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration_cast<std::chrono::duration<double> >(end - start).count();
+}
+
+/**
+* The image operations that are timed, each one goes through the color converter or a blitter.
+*/
+enum Operation
+{
+	CONVERT_32_TO_16,
+	CONVERT_24_TO_32,
+	CONVERT_16_TO_32,
+	BLIT_32_TO_16,
+	BLIT_24_TO_32,
+	BLIT_32_TO_24,
+	BLEND_32,
+	BLEND_COLOR_32,
+	OPERATION_COUNT
+};
+
+const char * OperationNames[OPERATION_COUNT] =
+{
+	"convert 32->16",
+	"convert 24->32",
+	"convert 16->32",
+	"blit 32->16",
+	"blit 24->32",
+	"blit 32->24",
+	"blend 32",
+	"blend color 32"
+};
+
+/**
+* Fill an image with noise, with alpha that is clear, opaque or in between.
+*/
+void FillImage(irr::video::IImage * image)
+{
+	irr::u8 * data = (irr::u8 *)image->lock();
+	const irr::u32 bytes = image->getImageDataSizeInBytes();
+
+	for (irr::u32 i = 0; i < bytes; i++)
+		data[i] = (irr::u8)rand();
+
+	image->unlock();
+}
+
+/**
+* Run an operation on size by size images over and over and get the pixels a second.
+*/
+double BenchmarkImage(irr::video::IVideoDriver * driver, Operation operation, unsigned int size, double seconds)
+{
+	irr::video::ECOLOR_FORMAT source = irr::video::ECF_A8R8G8B8;
+	irr::video::ECOLOR_FORMAT target = irr::video::ECF_A8R8G8B8;
+
+	switch (operation)
+	{
+	case CONVERT_32_TO_16:
+		target = irr::video::ECF_R5G6B5;
+		break;
+	case CONVERT_24_TO_32:
+	case BLIT_24_TO_32:
+		source = irr::video::ECF_R8G8B8;
+		break;
+	case CONVERT_16_TO_32:
+		source = irr::video::ECF_A1R5G5B5;
+		break;
+	case BLIT_32_TO_16:
+		target = irr::video::ECF_A1R5G5B5;
+		break;
+	case BLIT_32_TO_24:
+		target = irr::video::ECF_R8G8B8;
+		break;
+	default:
+		break;
+	}
+
+	const irr::core::dimension2du dimension(size, size);
+	irr::video::IImage * from = driver->createImage(source, dimension);
+	irr::video::IImage * to = driver->createImage(target, dimension);
+	FillImage(from);
+	FillImage(to);
+
+	const irr::core::recti rect(0, 0, size, size);
+
+	//copyToScaling on an image of the same size goes to copyTo, so convert into the memory directly
+	void * toData = to->lock();
+
+	//small images are timed in batches, so reading the clock does not show up
+	const unsigned int batch = 1 + 65536 / (size * size);
+	unsigned long long pixels = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		for (unsigned int i = 0; i < batch; i++)
+		{
+			switch (operation)
+			{
+			case CONVERT_32_TO_16:
+			case CONVERT_24_TO_32:
+			case CONVERT_16_TO_32:
+				from->copyToScaling(toData, size, size, target);
+				break;
+			case BLEND_32:
+				from->copyToWithAlpha(to, irr::core::position2di(0, 0), rect, irr::video::SColor(255, 255, 255, 255));
+				break;
+			case BLEND_COLOR_32:
+				from->copyToWithAlpha(to, irr::core::position2di(0, 0), rect, irr::video::SColor(255, 200, 150, 100));
+				break;
+			default:
+				from->copyTo(to);
+				break;
+			}
+		}
+
+		pixels += (unsigned long long)batch * size * size;
+		end = Clock::now();
+	}
+
+	to->unlock();
+	from->drop();
+	to->drop();
+
+	return pixels / Seconds(start, end);
+}
+
+/**
+* Draw translucent size by size rectangles, or size long flat lines, on the Burning's Video
+* back buffer and get the pixels a second. Nothing is presented, only the blitter is timed.
+*/
+double BenchmarkDraw(bool lines, unsigned int size, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(1024, 1024);
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	const irr::video::SColor color(128, 250, 120, 30);
+
+	const unsigned int batch = 1 + 65536 / (lines ? size : size * size);
+	unsigned long long pixels = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	driver->beginScene(true, true, irr::video::SColor(255, 0, 0, 0));
+
+	while (Seconds(start, end) < seconds)
+	{
+		for (unsigned int i = 0; i < batch; i++)
+		{
+			const int offset = i & 511;
+
+			if (lines)
+				driver->draw2DLine(irr::core::position2di(0, offset), irr::core::position2di(size - 1, offset + size / 32), color);
+			else
+				driver->draw2DRectangle(color, irr::core::recti(0, offset, size, offset + size));
+		}
+
+		pixels += (unsigned long long)batch * (lines ? size : size * size);
+		end = Clock::now();
+	}
+
+	device->drop();
+
+	return pixels / Seconds(start, end);
+}
+
+int main(int argc, char ** argv)
+{
+	double seconds = 0.5;
+
+	if (argc > 1)
+		seconds = atof(argv[1]);
+
+	const unsigned int sizes[] = { 16, 64, 256, 1024 };
+	double image[OPERATION_COUNT][4];
+	double rectangles[4];
+	double lines[4];
+
+	irr::IrrlichtDevice * device = irr::createDevice(irr::video::EDT_NULL);
+
+	if (device == NULL)
+		return 1;
+
+	device->getLogger()->setLogLevel(irr::ELL_NONE);
+
+	for (int o = 0; o < OPERATION_COUNT; o++)
+	{
+		for (int s = 0; s < 4; s++)
+			image[o][s] = BenchmarkImage(device->getVideoDriver(), (Operation)o, sizes[s], seconds);
+	}
+
+	device->drop();
+
+	//the console device resets the terminal, so print once every device is gone
+	for (int s = 0; s < 4; s++)
+	{
+		rectangles[s] = BenchmarkDraw(false, sizes[s], seconds);
+		lines[s] = BenchmarkDraw(true, sizes[s], seconds);
+	}
+
+	printf("Mpixels/sec          %8u  %8u  %8u  %8u\n", sizes[0], sizes[1], sizes[2], sizes[3]);
+
+	for (int o = 0; o < OPERATION_COUNT; o++)
+	{
+		printf("%-18s  %8.1f  %8.1f  %8.1f  %8.1f\n",
+			OperationNames[o],
+			image[o][0] / 1e6,
+			image[o][1] / 1e6,
+			image[o][2] / 1e6,
+			image[o][3] / 1e6);
+	}
+
+	printf("%-18s  %8.1f  %8.1f  %8.1f  %8.1f\n", "rectangle alpha",
+		rectangles[0] / 1e6, rectangles[1] / 1e6, rectangles[2] / 1e6, rectangles[3] / 1e6);
+	printf("%-18s  %8.1f  %8.1f  %8.1f  %8.1f\n", "line alpha",
+		lines[0] / 1e6, lines[1] / 1e6, lines[2] / 1e6, lines[3] / 1e6);
+
+	return 0;
+}
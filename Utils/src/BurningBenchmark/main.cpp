@@ -0,0 +1,701 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <irrlicht.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Get the seconds between two times.
+*/
+double Seconds(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration_cast<std::chrono::duration<double> >(end - start).count();
+}
+
+/**
+* Build a flat grid of size by size quads, one unit apart, facing the camera.
+*/
+irr::scene::SMeshBuffer * CreateGrid(unsigned int size)
+{
+	irr::scene::SMeshBuffer * buffer = new irr::scene::SMeshBuffer();
+
+	buffer->Vertices.reallocate((size + 1) * (size + 1));
+	buffer->Indices.reallocate(size * size * 6);
+
+	for (unsigned int y = 0; y <= size; y++)
+	{
+		for (unsigned int x = 0; x <= size; x++)
+		{
+			buffer->Vertices.push_back(irr::video::S3DVertex(
+				(float)x - size * 0.5f, (float)y - size * 0.5f, 0.0f,
+				0.0f, 0.0f, -1.0f,
+				irr::video::SColor(255, 255, x * 255 / size, y * 255 / size),
+				(float)x / size, (float)y / size));
+		}
+	}
+
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++)
+		{
+			irr::u16 corner = (irr::u16)(y * (size + 1) + x);
+			buffer->Indices.push_back(corner);
+			buffer->Indices.push_back(corner + (irr::u16)(size + 1));
+			buffer->Indices.push_back(corner + 1);
+			buffer->Indices.push_back(corner + 1);
+			buffer->Indices.push_back(corner + (irr::u16)(size + 1));
+			buffer->Indices.push_back(corner + (irr::u16)(size + 2));
+		}
+	}
+
+	buffer->recalculateBoundingBox();
+	buffer->Material.Lighting = false;
+
+	return buffer;
+}
+
+/**
+* Draw a grid over and over and get the triangles a second. Nothing is presented, only the 
+* Burning's Video front end and rasterizer are timed.
+*/
+double BenchmarkGrid(bool batch, unsigned int size, bool visible, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(320, 240);
+	params.SoftwareVertexBatch = batch;
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::SMeshBuffer * grid = CreateGrid(size);
+
+	//fill the screen with the grid, or put it behind the camera so every triangle is rejected
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 320.0f / 240.0f, 1.0f, 1000.0f);
+	irr::core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(irr::core::vector3df(0.0f, 0.0f, visible ? -0.4f * size : 0.4f * size),
+		irr::core::vector3df(0.0f, 0.0f, visible ? 0.0f : 2.0f * size),
+		irr::core::vector3df(0.0f, 1.0f, 0.0f));
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, view);
+	driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+	driver->setMaterial(grid->Material);
+
+	unsigned long long triangles = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(true, true, irr::video::SColor(255, 0, 0, 0));
+
+		for (int i = 0; i < 10; i++)
+			driver->drawMeshBuffer(grid);
+
+		triangles += grid->getIndexCount() / 3 * 10;
+		end = Clock::now();
+	}
+
+	grid->drop();
+	device->drop();
+
+	return triangles / Seconds(start, end);
+}
+
+/**
+* Draw a textured grid over the whole screen over and over and get the pixels a second. This
+* times the scanlines of the textured gouraud shader, with or without the span kernels, and
+* with the bilinear or the nearest texel permutation.
+*/
+double BenchmarkFill(bool spanKernels, bool bilinear, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.SoftwareSpanKernels = spanKernels;
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::SMeshBuffer * grid = CreateGrid(8);
+
+	irr::video::IImage * image = driver->createImage(irr::video::ECF_A8R8G8B8, irr::core::dimension2du(256, 256));
+	for (irr::u32 y = 0; y < 256; y++)
+	{
+		for (irr::u32 x = 0; x < 256; x++)
+			image->setPixel(x, y, irr::video::SColor(255, x, y, (x ^ y) & 0xFF));
+	}
+	grid->Material.setTexture(0, driver->addTexture("fill", image));
+	grid->Material.setFlag(irr::video::EMF_BILINEAR_FILTER, bilinear);
+	image->drop();
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+	irr::core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(irr::core::vector3df(0.0f, 0.0f, -2.0f),
+		irr::core::vector3df(0.0f, 0.0f, 0.0f),
+		irr::core::vector3df(0.0f, 1.0f, 0.0f));
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, view);
+	driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+	driver->setMaterial(grid->Material);
+
+	unsigned long long frames = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	//clear the depth buffer every frame so every pixel is shaded
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(false, true);
+		driver->drawMeshBuffer(grid);
+		frames++;
+		end = Clock::now();
+	}
+
+	grid->drop();
+	device->drop();
+
+	return frames * 640.0 * 480.0 / Seconds(start, end);
+}
+
+/**
+* Draw a grid with a large texture over the whole screen over and over and get the texels
+* sampled a second. Rotated turns the camera so the scanlines walk down the columns of the
+* texture, minified repeats the texture eight times so neighbouring pixels sample texels far
+* apart. This times the texture fetches, from the rows or from the tiles of the texture.
+*/
+double BenchmarkSampling(bool tiled, bool rotated, bool minified, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.SoftwareTiledTextures = tiled;
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::SMeshBuffer * grid = CreateGrid(8);
+
+	if (minified)
+	{
+		for (irr::u32 i = 0; i < grid->Vertices.size(); i++)
+			grid->Vertices[i].TCoords *= 8.0f;
+	}
+
+	//sample the full size texture, a mip level would fit in the cache either way
+	driver->setTextureCreationFlag(irr::video::ETCF_CREATE_MIP_MAPS, false);
+
+	irr::video::IImage * image = driver->createImage(irr::video::ECF_A8R8G8B8, irr::core::dimension2du(1024, 1024));
+	for (irr::u32 y = 0; y < 1024; y++)
+	{
+		for (irr::u32 x = 0; x < 1024; x++)
+			image->setPixel(x, y, irr::video::SColor(255, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF));
+	}
+	grid->Material.setTexture(0, driver->addTexture("sampling", image));
+	image->drop();
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+	irr::core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(irr::core::vector3df(0.0f, 0.0f, -2.0f),
+		irr::core::vector3df(0.0f, 0.0f, 0.0f),
+		rotated ? irr::core::vector3df(1.0f, 0.0f, 0.0f) : irr::core::vector3df(0.0f, 1.0f, 0.0f));
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, view);
+	driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+	driver->setMaterial(grid->Material);
+
+	unsigned long long frames = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(false, true);
+		driver->drawMeshBuffer(grid);
+		frames++;
+		end = Clock::now();
+	}
+
+	grid->drop();
+	device->drop();
+
+	return frames * 640.0 * 480.0 / Seconds(start, end);
+}
+
+/**
+* Draw a wall over the whole screen and then grids hidden behind it, over and over, and get the
+* frames a second. This times how much of the hidden grids is shaded, with or without the
+* hierarchical depth buffer.
+*/
+double BenchmarkOcclusion(bool hierarchicalDepth, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.SoftwareHierarchicalDepth = hierarchicalDepth;
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::SMeshBuffer * grid = CreateGrid(8);
+
+	irr::video::IImage * image = driver->createImage(irr::video::ECF_A8R8G8B8, irr::core::dimension2du(256, 256));
+	for (irr::u32 y = 0; y < 256; y++)
+	{
+		for (irr::u32 x = 0; x < 256; x++)
+			image->setPixel(x, y, irr::video::SColor(255, x, y, (x ^ y) & 0xFF));
+	}
+	grid->Material.setTexture(0, driver->addTexture("occlusion", image));
+	image->drop();
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+	irr::core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(irr::core::vector3df(0.0f, 0.0f, -2.0f),
+		irr::core::vector3df(0.0f, 0.0f, 0.0f),
+		irr::core::vector3df(0.0f, 1.0f, 0.0f));
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, view);
+	driver->setMaterial(grid->Material);
+
+	unsigned long long frames = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(false, true);
+
+		//the wall, then the same grid further and further behind it
+		for (int i = 0; i <= 20; i++)
+		{
+			irr::core::matrix4 world;
+			world.setTranslation(irr::core::vector3df(0.0f, 0.0f, i * 0.5f));
+			driver->setTransform(irr::video::ETS_WORLD, world);
+			driver->drawMeshBuffer(grid);
+		}
+
+		frames++;
+		end = Clock::now();
+	}
+
+	grid->drop();
+	device->drop();
+
+	return frames / Seconds(start, end);
+}
+
+/**
+* Draw 10000 particles of 8 pixels over and over and get the particles a second. Sprites
+* draws one point sprite a particle, else the camera facing quads are built every frame
+* and drawn as two triangles, as CParticleSystemSceneNode does.
+*/
+double BenchmarkParticles(bool sprites, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	const unsigned int count = 10000;
+
+	irr::video::IImage * image = driver->createImage(irr::video::ECF_A8R8G8B8, irr::core::dimension2du(16, 16));
+	for (irr::u32 y = 0; y < 16; y++)
+	{
+		for (irr::u32 x = 0; x < 16; x++)
+			image->setPixel(x, y, irr::video::SColor(255, x * 16, y * 16, 128));
+	}
+
+	irr::video::SMaterial material;
+	material.Lighting = false;
+	material.MaterialType = irr::video::EMT_TRANSPARENT_ADD_COLOR;
+	material.ZWriteEnable = false;
+	material.BackfaceCulling = false;
+	material.Thickness = 8.0f;
+	material.setTexture(0, driver->addTexture("particle", image));
+	image->drop();
+
+	//at a distance of 7.5 a unit is 32 pixels, so 0.25 units are 8 pixels
+	irr::core::array<irr::core::vector3df> positions(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		positions.push_back(irr::core::vector3df((rand() % 1000) * 0.02f - 10.0f,
+			(rand() % 1000) * 0.015f - 7.5f,
+			7.0f + (rand() % 1000) * 0.001f));
+	}
+
+	irr::core::array<irr::video::S3DVertex> vertices(count * 4);
+	irr::core::array<irr::u16> indices(count * 6);
+	vertices.set_used(sprites ? count : count * 4);
+	indices.set_used(count * 6);
+
+	for (unsigned int i = 0; i < count * 6; i += 6)
+	{
+		const irr::u16 v = (irr::u16)(i / 6 * 4);
+		indices[i + 0] = v + 0;
+		indices[i + 1] = v + 2;
+		indices[i + 2] = v + 1;
+		indices[i + 3] = v + 0;
+		indices[i + 4] = v + 3;
+		indices[i + 5] = v + 2;
+	}
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, irr::core::IdentityMatrix);
+	driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+	driver->setMaterial(material);
+
+	const irr::video::SColor color(255, 200, 160, 120);
+	const irr::core::vector3df horizontal(0.125f, 0.0f, 0.0f);
+	const irr::core::vector3df vertical(0.0f, 0.125f, 0.0f);
+
+	unsigned long long particles = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(false, true);
+
+		if (sprites)
+		{
+			for (unsigned int i = 0; i < count; i++)
+				vertices[i] = irr::video::S3DVertex(positions[i], irr::core::vector3df(0.0f, 0.0f, -1.0f), color, irr::core::vector2df(0.0f, 0.0f));
+
+			driver->drawVertexPrimitiveList(vertices.const_pointer(), count, 0, count,
+				irr::video::EVT_STANDARD, irr::scene::EPT_POINT_SPRITES, irr::video::EIT_16BIT);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				irr::video::S3DVertex * v = &vertices[i * 4];
+				v[0] = irr::video::S3DVertex(positions[i] + horizontal + vertical, irr::core::vector3df(0.0f, 0.0f, -1.0f), color, irr::core::vector2df(0.0f, 0.0f));
+				v[1] = irr::video::S3DVertex(positions[i] + horizontal - vertical, irr::core::vector3df(0.0f, 0.0f, -1.0f), color, irr::core::vector2df(0.0f, 1.0f));
+				v[2] = irr::video::S3DVertex(positions[i] - horizontal - vertical, irr::core::vector3df(0.0f, 0.0f, -1.0f), color, irr::core::vector2df(1.0f, 1.0f));
+				v[3] = irr::video::S3DVertex(positions[i] - horizontal + vertical, irr::core::vector3df(0.0f, 0.0f, -1.0f), color, irr::core::vector2df(1.0f, 0.0f));
+			}
+
+			driver->drawVertexPrimitiveList(vertices.const_pointer(), count * 4, indices.const_pointer(), count * 2,
+				irr::video::EVT_STANDARD, irr::scene::EPT_TRIANGLES, irr::video::EIT_16BIT);
+		}
+
+		particles += count;
+		end = Clock::now();
+	}
+
+	device->drop();
+
+	return particles / Seconds(start, end);
+}
+
+/**
+* Draw 10000 random lines over and over and get the lines a second. List draws them with one
+* EPT_LINES call, else every line is a draw3DLine call, as debug drawing does.
+*/
+double BenchmarkLines(bool list, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	const unsigned int count = 10000;
+
+	irr::core::array<irr::video::S3DVertex> vertices(count * 2);
+	for (unsigned int i = 0; i < count * 2; i++)
+	{
+		vertices.push_back(irr::video::S3DVertex((rand() % 1000) * 0.03f - 15.0f,
+			(rand() % 1000) * 0.022f - 11.0f,
+			5.0f + (rand() % 1000) * 0.01f,
+			0.0f, 0.0f, -1.0f,
+			irr::video::SColor(255, rand() & 0xFF, rand() & 0xFF, rand() & 0xFF),
+			0.0f, 0.0f));
+	}
+
+	irr::video::SMaterial material;
+	material.Lighting = false;
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, irr::core::IdentityMatrix);
+	driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+	driver->setMaterial(material);
+
+	unsigned long long lines = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(false, true);
+
+		if (list)
+		{
+			driver->drawVertexPrimitiveList(vertices.const_pointer(), count * 2, 0, count,
+				irr::video::EVT_STANDARD, irr::scene::EPT_LINES, irr::video::EIT_16BIT);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count * 2; i += 2)
+				driver->draw3DLine(vertices[i].Pos, vertices[i + 1].Pos, vertices[i].Color);
+		}
+
+		lines += count;
+		end = Clock::now();
+	}
+
+	device->drop();
+
+	return lines / Seconds(start, end);
+}
+
+/**
+* Draw a wall, then eight sphere shadow volumes cutting through it into the stencil buffer and the
+* shadow color over them, over and over, and get the frames a second. The volumes cover a small part
+* of the screen, as the shadows of a few objects do.
+*/
+double BenchmarkShadows(unsigned int threads, double seconds)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(640, 480);
+	params.Stencilbuffer = true;
+	params.SoftwareRasterThreads = threads;
+	params.LoggingLevel = irr::ELL_NONE;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+	{
+		return 0.0;
+	}
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::SMeshBuffer * grid = CreateGrid(8);
+
+	//the shadow volume is a closed sphere, as a triangle list
+	irr::scene::IMesh * sphere = device->getSceneManager()->getGeometryCreator()->createSphereMesh(0.6f, 24, 24);
+	irr::scene::IMeshBuffer * buffer = sphere->getMeshBuffer(0);
+	const irr::video::S3DVertex * sphereVertices = (const irr::video::S3DVertex *)buffer->getVertices();
+	const irr::u16 * sphereIndices = buffer->getIndices();
+
+	irr::core::array<irr::core::vector3df> volume(buffer->getIndexCount());
+	for (irr::u32 i = 0; i < buffer->getIndexCount(); i++)
+		volume.push_back(sphereVertices[sphereIndices[i]].Pos);
+
+	sphere->drop();
+
+	irr::core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(irr::core::PI / 2.0f, 640.0f / 480.0f, 1.0f, 1000.0f);
+	irr::core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(irr::core::vector3df(0.0f, 0.0f, -4.0f),
+		irr::core::vector3df(0.0f, 0.0f, 0.0f),
+		irr::core::vector3df(0.0f, 1.0f, 0.0f));
+
+	driver->setTransform(irr::video::ETS_PROJECTION, projection);
+	driver->setTransform(irr::video::ETS_VIEW, view);
+
+	unsigned long long frames = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		driver->beginScene(true, true, irr::video::SColor(255, 0, 0, 0));
+
+		driver->setTransform(irr::video::ETS_WORLD, irr::core::IdentityMatrix);
+		driver->setMaterial(grid->Material);
+		driver->drawMeshBuffer(grid);
+
+		for (int i = 0; i < 8; i++)
+		{
+			irr::core::matrix4 world;
+			world.setTranslation(irr::core::vector3df((i & 3) * 1.2f - 1.8f, (i >> 2) * 1.5f - 0.75f, 0.0f));
+			driver->setTransform(irr::video::ETS_WORLD, world);
+			driver->drawStencilShadowVolume(volume);
+		}
+
+		driver->drawStencilShadow(true, irr::video::SColor(150, 0, 0, 0));
+
+		frames++;
+		end = Clock::now();
+	}
+
+	grid->drop();
+	device->drop();
+
+	return frames / Seconds(start, end);
+}
+
+int main(int argc, char ** argv)
+{
+	double seconds = 1.0;
+
+	if (argc > 1)
+		seconds = atof(argv[1]);
+
+	const unsigned int sizes[] = { 8, 32, 128 };
+	double cache[3][2];
+	double batch[3][2];
+
+	//the console device resets the terminal, so print once every device is gone
+	for (int s = 0; s < 3; s++)
+	{
+		for (int visible = 0; visible < 2; visible++)
+		{
+			cache[s][visible] = BenchmarkGrid(false, sizes[s], visible != 0, seconds);
+			batch[s][visible] = BenchmarkGrid(true, sizes[s], visible != 0, seconds);
+		}
+	}
+
+	double scalarFill = BenchmarkFill(false, true, seconds);
+	double spanFill = BenchmarkFill(true, true, seconds);
+	double nearestFill = BenchmarkFill(false, false, seconds);
+
+	const char * surfaces[] = { "upright", "rotated", "minified", "rot+min" };
+	double linearSampling[4];
+	double tiledSampling[4];
+
+	for (int s = 0; s < 4; s++)
+	{
+		linearSampling[s] = BenchmarkSampling(false, (s & 1) != 0, (s & 2) != 0, seconds);
+		tiledSampling[s] = BenchmarkSampling(true, (s & 1) != 0, (s & 2) != 0, seconds);
+	}
+
+	double flatOcclusion = BenchmarkOcclusion(false, seconds);
+	double tiledOcclusion = BenchmarkOcclusion(true, seconds);
+
+	double quadParticles = BenchmarkParticles(false, seconds);
+	double spriteParticles = BenchmarkParticles(true, seconds);
+
+	double singleLines = BenchmarkLines(false, seconds);
+	double listLines = BenchmarkLines(true, seconds);
+
+	double mainShadows = BenchmarkShadows(0, seconds);
+	double tiledShadows = BenchmarkShadows(4, seconds);
+
+	printf("Grid      View       Vertex cache tri/sec  Vertex batch tri/sec  Speedup\n");
+
+	for (int s = 0; s < 3; s++)
+	{
+		for (int visible = 1; visible >= 0; visible--)
+		{
+			printf("%4ux%-4u %-9s %20.0f  %20.0f  %6.2fx\n", 
+				sizes[s], sizes[s], 
+				visible ? "visible" : "culled", 
+				cache[s][visible], 
+				batch[s][visible], 
+				cache[s][visible] > 0.0 ? batch[s][visible] / cache[s][visible] : 0.0);
+		}
+	}
+
+	printf("\nTextured fill    Scalar pixels/sec     Span kernel pixels/sec  Speedup\n");
+	printf("640x480       %20.0f  %22.0f  %6.2fx\n",
+		scalarFill,
+		spanFill,
+		scalarFill > 0.0 ? spanFill / scalarFill : 0.0);
+
+	printf("\nTexture filter   Bilinear pixels/sec      Nearest pixels/sec  Speedup\n");
+	printf("640x480       %20.0f  %22.0f  %6.2fx\n",
+		scalarFill,
+		nearestFill,
+		scalarFill > 0.0 ? nearestFill / scalarFill : 0.0);
+
+	printf("\nTexture 1024   Linear texels/sec       Tiled texels/sec  Speedup\n");
+
+	for (int s = 0; s < 4; s++)
+	{
+		printf("%-9s  %20.0f  %21.0f  %6.2fx\n",
+			surfaces[s],
+			linearSampling[s],
+			tiledSampling[s],
+			linearSampling[s] > 0.0 ? tiledSampling[s] / linearSampling[s] : 0.0);
+	}
+
+	printf("\nHidden grids     Flat depth frames/sec  Hierarchical frames/sec  Speedup\n");
+	printf("640x480 x20   %22.1f  %23.1f  %6.2fx\n",
+		flatOcclusion,
+		tiledOcclusion,
+		flatOcclusion > 0.0 ? tiledOcclusion / flatOcclusion : 0.0);
+
+	printf("\nParticles        Quads particles/sec    Sprites particles/sec  Speedup\n");
+	printf("10000 8x8     %22.0f  %23.0f  %6.2fx\n",
+		quadParticles,
+		spriteParticles,
+		quadParticles > 0.0 ? spriteParticles / quadParticles : 0.0);
+
+	printf("\nLines            draw3DLine lines/sec     Line list lines/sec  Speedup\n");
+	printf("10000         %22.0f  %23.0f  %6.2fx\n",
+		singleLines,
+		listLines,
+		singleLines > 0.0 ? listLines / singleLines : 0.0);
+
+	printf("\nShadow volumes   Main thread frames/sec  4 threads frames/sec  Speedup\n");
+	printf("640x480 x8    %22.1f  %20.1f  %6.2fx\n",
+		mainShadows,
+		tiledShadows,
+		mainShadows > 0.0 ? tiledShadows / mainShadows : 0.0);
+
+	return 0;
+}
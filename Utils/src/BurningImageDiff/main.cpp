@@ -0,0 +1,311 @@
+#include <cstdio>
+#include <cstring>
+#include <irrlicht.h>
+
+/**
+* The optimizations of the Burning's Video driver that can be turned on and off when the device
+* is created. Every one of them promises the same image as the plain driver.
+*/
+struct Mode
+{
+	const char * Name;
+	irr::u32 RasterThreads;
+	bool Fast;
+};
+
+const Mode Modes[] =
+{
+	{ "reference", 0, false },
+	{ "fast", 0, true },
+	{ "fast 4 threads", 4, true },
+	{ "fast 3 threads", 3, true }
+};
+
+const unsigned int ModeCount = sizeof(Modes) / sizeof(Modes[0]);
+
+/**
+* A fixed scene: a row of spheres drawn with one material, inside a big sphere drawn with
+* the same texture.
+*/
+struct Scene
+{
+	const char * Name;
+	irr::video::E_MATERIAL_TYPE Material;
+	bool Lighting;
+	bool Bilinear;
+	irr::u32 TextureSize;
+
+	//a light casting stencil shadows from the spheres
+	bool Shadow;
+
+	//2D images blitted and blended over the frame, from textures in other color formats
+	bool Overlay;
+};
+
+const Scene Scenes[] =
+{
+	{ "solid", irr::video::EMT_SOLID, false, true, 64, false, false },
+	{ "solid nearest", irr::video::EMT_SOLID, false, false, 64, false, false },
+	{ "solid lit mipmapped", irr::video::EMT_SOLID, true, true, 512, false, false },
+	{ "alpha channel", irr::video::EMT_TRANSPARENT_ALPHA_CHANNEL, false, true, 64, false, false },
+	{ "alpha channel lit mipmapped", irr::video::EMT_TRANSPARENT_ALPHA_CHANNEL, true, true, 512, false, false },
+	{ "add color", irr::video::EMT_TRANSPARENT_ADD_COLOR, true, true, 64, false, false },
+	{ "vertex alpha", irr::video::EMT_TRANSPARENT_VERTEX_ALPHA, false, true, 512, false, false },
+	{ "lightmap m4", irr::video::EMT_LIGHTMAP_M4, false, true, 64, false, false },
+	{ "lightmap m4 nearest mipmapped", irr::video::EMT_LIGHTMAP_M4, true, false, 512, false, false },
+	{ "stencil shadows", irr::video::EMT_SOLID, true, true, 64, true, false },
+	{ "2d overlay", irr::video::EMT_SOLID, false, true, 64, false, true }
+};
+
+const unsigned int SceneCount = sizeof(Scenes) / sizeof(Scenes[0]);
+
+/**
+* Make a texture with a pattern in every channel, and an alpha that is clear, opaque or in
+* between, from an image in the given color format.
+*/
+irr::video::ITexture * CreateTexture(irr::video::IVideoDriver * driver, const char * name, irr::video::ECOLOR_FORMAT format, irr::u32 size)
+{
+	irr::video::IImage * image = driver->createImage(format, irr::core::dimension2du(size, size));
+
+	for (irr::u32 y = 0; y < size; y++)
+	{
+		for (irr::u32 x = 0; x < size; x++)
+			image->setPixel(x, y, irr::video::SColor(128 + (x & 1) * 127, (x * 4) & 255, (y * 4) & 255, ((x ^ y) & 8) ? 255 : 0));
+	}
+
+	irr::video::ITexture * texture = driver->addTexture(name, image);
+	image->drop();
+
+	return texture;
+}
+
+/**
+* Draw a scene once and take a screenshot of it. Returns NULL if the device can't be made.
+*/
+irr::video::IImage * Render(const Scene & scene, const Mode & mode)
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DeviceType = irr::EIDT_CONSOLE;
+	params.DriverType = irr::video::EDT_BURNINGSVIDEO;
+	params.WindowSize = irr::core::dimension2du(320, 240);
+	params.Stencilbuffer = scene.Shadow;
+	params.ConsoleOutput = false;
+	params.LoggingLevel = irr::ELL_NONE;
+	params.SoftwareRasterThreads = mode.RasterThreads;
+	params.SoftwareVertexBatch = mode.Fast;
+	params.SoftwareSpanKernels = mode.Fast;
+	params.SoftwareHierarchicalDepth = mode.Fast;
+	params.SoftwareTiledTextures = mode.Fast;
+
+	irr::IrrlichtDevice * device = irr::createDeviceEx(params);
+
+	if (device == NULL)
+		return NULL;
+
+	irr::video::IVideoDriver * driver = device->getVideoDriver();
+	irr::scene::ISceneManager * smgr = device->getSceneManager();
+	irr::video::ITexture * texture = CreateTexture(driver, "texture", irr::video::ECF_A8R8G8B8, scene.TextureSize);
+
+	for (int i = 0; i < 6; i++)
+	{
+		//the lightmap materials read the second texture coordinates
+		irr::scene::IMesh * sphere = smgr->getGeometryCreator()->createSphereMesh(10.0f + i * 3.0f, 32, 32);
+		irr::scene::IMesh * mesh = smgr->getMeshManipulator()->createMeshWith2TCoords(sphere);
+		sphere->drop();
+
+		irr::scene::SAnimatedMesh * animated = new irr::scene::SAnimatedMesh(mesh);
+		mesh->drop();
+
+		irr::scene::IAnimatedMeshSceneNode * node = smgr->addAnimatedMeshSceneNode(animated, 0, -1,
+			irr::core::vector3df(i * 7.0f - 18.0f, (i % 3) * 5.0f - 5.0f, 40.0f + i * 6.0f),
+			irr::core::vector3df(i * 17.0f, i * 31.0f, 0.0f));
+		animated->drop();
+
+		node->setMaterialTexture(0, texture);
+		node->setMaterialTexture(1, texture);
+		node->setMaterialFlag(irr::video::EMF_LIGHTING, scene.Lighting);
+		node->setMaterialFlag(irr::video::EMF_BILINEAR_FILTER, scene.Bilinear);
+		node->setMaterialType(scene.Material);
+
+		if (scene.Shadow)
+			node->addShadowVolumeSceneNode();
+	}
+
+	irr::scene::ISceneNode * room = smgr->addSphereSceneNode(120.0f, 24, 0, -1, irr::core::vector3df(5.0f, 0.0f, 40.0f));
+	room->setMaterialTexture(0, texture);
+	room->setMaterialFlag(irr::video::EMF_LIGHTING, scene.Lighting);
+	room->setMaterialFlag(irr::video::EMF_BILINEAR_FILTER, scene.Bilinear);
+	room->setMaterialFlag(irr::video::EMF_BACK_FACE_CULLING, false);
+
+	if (scene.Lighting)
+		smgr->addLightSceneNode(0, irr::core::vector3df(10.0f, 20.0f, 0.0f), irr::video::SColorf(1.0f, 0.8f, 0.6f), 80.0f);
+
+	smgr->addCameraSceneNode(0, irr::core::vector3df(0.0f, 0.0f, 0.0f), irr::core::vector3df(0.0f, 0.0f, 50.0f));
+
+	driver->beginScene(true, true, irr::video::SColor(255, 20, 30, 40));
+	smgr->drawAll();
+
+	if (scene.Overlay)
+	{
+		//the blitter has no copy from R5G6B5, such a texture would be left uninitialized
+		irr::video::ITexture * overlays[] =
+		{
+			CreateTexture(driver, "overlay16", irr::video::ECF_A1R5G5B5, 64),
+			CreateTexture(driver, "overlay24", irr::video::ECF_R8G8B8, 64),
+			texture
+		};
+
+		for (int i = 0; i < 3; i++)
+		{
+			const irr::core::position2di position(10 + i * 100, 20 + (i & 1) * 100);
+			driver->draw2DImage(overlays[i], position);
+			driver->draw2DImage(overlays[i], position + irr::core::position2di(30, 50),
+				irr::core::recti(0, 0, 64, 64), 0, irr::video::SColor(255, 255, 255, 255), true);
+			driver->draw2DImage(overlays[i], position + irr::core::position2di(10, 80),
+				irr::core::recti(0, 0, 64, 64), 0, irr::video::SColor(160, 255, 128, 64), true);
+		}
+
+		driver->draw2DRectangle(irr::video::SColor(96, 255, 255, 0), irr::core::recti(40, 40, 280, 200));
+	}
+
+	driver->endScene();
+
+	irr::video::IImage * shot = driver->createScreenShot();
+	device->drop();
+
+	return shot;
+}
+
+/**
+* Count the pixels that differ between two images, and the largest difference of a channel.
+*/
+irr::u32 Compare(irr::video::IImage * a, irr::video::IImage * b, irr::u32 & largest)
+{
+	largest = 0;
+
+	if (a->getDimension() != b->getDimension())
+		return a->getDimension().getArea() + b->getDimension().getArea();
+
+	irr::u32 count = 0;
+
+	for (irr::u32 y = 0; y < a->getDimension().Height; y++)
+	{
+		for (irr::u32 x = 0; x < a->getDimension().Width; x++)
+		{
+			const irr::video::SColor p = a->getPixel(x, y);
+			const irr::video::SColor q = b->getPixel(x, y);
+
+			//the alpha of the frame is never shown
+			const irr::u32 d = irr::core::max_(
+				(irr::u32)irr::core::abs_((irr::s32)p.getRed() - (irr::s32)q.getRed()),
+				(irr::u32)irr::core::abs_((irr::s32)p.getGreen() - (irr::s32)q.getGreen()),
+				(irr::u32)irr::core::abs_((irr::s32)p.getBlue() - (irr::s32)q.getBlue()));
+
+			if (d)
+			{
+				count++;
+				largest = irr::core::max_(largest, d);
+			}
+		}
+	}
+
+	return count;
+}
+
+/**
+* Print how an image compares with the one it should be the same as, and return if it is.
+*/
+bool Report(const char * scene, const char * name, irr::video::IImage * image, irr::video::IImage * expected)
+{
+	if (image == NULL || expected == NULL)
+	{
+		printf("%-30s %-16s  missing\n", scene, name);
+		return false;
+	}
+
+	irr::u32 largest;
+	const irr::u32 count = Compare(image, expected, largest);
+
+	if (count)
+		printf("%-30s %-16s  %6u pixels differ, by up to %u\n", scene, name, count, largest);
+	else
+		printf("%-30s %-16s  same\n", scene, name);
+
+	return count == 0;
+}
+
+/**
+* Render every scene with the plain driver and with its optimizations, and compare the pixels.
+* The SIMD blitter and the shader permutations are picked when Irrlicht is compiled, so to
+* check them write the reference images with one build and compare them with another:
+*
+*     BurningImageDiff -write images
+*     BurningImageDiff -compare images
+*
+* Returns the number of images that differ.
+*/
+int main(int argc, char ** argv)
+{
+	const char * writeDir = NULL;
+	const char * compareDir = NULL;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "-write"))
+			writeDir = argv[i + 1];
+		else if (!strcmp(argv[i], "-compare"))
+			compareDir = argv[i + 1];
+	}
+
+	//only reads and writes the image files
+	irr::IrrlichtDevice * files = irr::createDevice(irr::video::EDT_NULL);
+
+	if (files == NULL)
+		return 1;
+
+	files->getLogger()->setLogLevel(irr::ELL_NONE);
+	irr::video::IVideoDriver * driver = files->getVideoDriver();
+
+	int failed = 0;
+
+	for (unsigned int s = 0; s < SceneCount; s++)
+	{
+		irr::video::IImage * reference = Render(Scenes[s], Modes[0]);
+
+		for (unsigned int m = 1; m < ModeCount; m++)
+		{
+			irr::video::IImage * image = Render(Scenes[s], Modes[m]);
+			failed += !Report(Scenes[s].Name, Modes[m].Name, image, reference);
+
+			if (image)
+				image->drop();
+		}
+
+		char filename[256];
+		sprintf(filename, "%s/scene%02u.tga", writeDir ? writeDir : compareDir, s);
+
+		if (writeDir && reference && !driver->writeImageToFile(reference, filename))
+		{
+			printf("%-30s could not write %s\n", Scenes[s].Name, filename);
+			failed++;
+		}
+
+		if (compareDir)
+		{
+			irr::video::IImage * image = driver->createImageFromFile(filename);
+			failed += !Report(Scenes[s].Name, "other build", reference, image);
+
+			if (image)
+				image->drop();
+		}
+
+		if (reference)
+			reference->drop();
+	}
+
+	files->drop();
+
+	printf("\n%d images differ\n", failed);
+
+	return failed;
+}
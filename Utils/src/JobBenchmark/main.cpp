@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "JobSystem.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Get the nanoseconds between two times.
+*/
+double Nanoseconds(Clock::time_point start, Clock::time_point end)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+* A job that does nothing.
+*/
+void EmptyJob(void * data)
+{
+	//Do Nothing
+}
+
+/**
+* A job that records when it started.
+*/
+void StampJob(void * data)
+{
+	((std::atomic<Clock::rep> *)data)->store(Clock::now().time_since_epoch().count());
+}
+
+/**
+* Square roots a range of floats.
+*/
+void SqrtRange(void * data, BIO::CORE::uint32 begin, BIO::CORE::uint32 end)
+{
+	std::vector<float> & values = *(std::vector<float> *)data;
+
+	for (BIO::CORE::uint32 i = begin; i < end; i++)
+		values[i] = std::sqrt(values[i] + (float)i);
+}
+
+/**
+* Time submitting empty jobs from the main thread and waiting for them.
+*/
+void BenchmarkSubmit(BIO::CORE::JobSystem & jobs, int count, int iterations)
+{
+	double bestSubmit = 0.0;
+	double bestTotal = 0.0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		BIO::CORE::JobCounter counter;
+
+		Clock::time_point start = Clock::now();
+		for (int j = 0; j < count; j++)
+			jobs.Submit(EmptyJob, NULL, &counter);
+		Clock::time_point submitted = Clock::now();
+		jobs.Wait(counter);
+		Clock::time_point end = Clock::now();
+
+		double submit = Nanoseconds(start, submitted) / count;
+		double total = Nanoseconds(start, end) / count;
+
+		if (i == 0 || submit < bestSubmit)
+			bestSubmit = submit;
+
+		if (i == 0 || total < bestTotal)
+			bestTotal = total;
+	}
+
+	printf("Submit:       %8.1f ns/job submit, %8.1f ns/job submit and run (%i jobs)\n", 
+		bestSubmit, bestTotal, count);
+}
+
+/**
+* Time how long a job waits in the main thread's queue before a worker steals it. The main 
+* thread does not help so the job has to be stolen.
+*/
+void BenchmarkSteal(BIO::CORE::JobSystem & jobs, int iterations)
+{
+	std::vector<double> latencies;
+	latencies.reserve(iterations);
+
+	for (int i = 0; i < iterations; i++)
+	{
+		std::atomic<Clock::rep> started(0);
+		BIO::CORE::JobCounter counter;
+
+		Clock::time_point submitted = Clock::now();
+		jobs.Submit(StampJob, &started, &counter);
+
+		while (!counter.IsDone())
+			std::this_thread::yield();
+
+		jobs.Wait(counter);
+		latencies.push_back(Nanoseconds(submitted, Clock::time_point(Clock::duration(started.load()))));
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	printf("Steal:        %8.1f ns median, %8.1f ns 99th percentile (%i jobs)\n", 
+		latencies[latencies.size() / 2], 
+		latencies[latencies.size() * 99 / 100], 
+		iterations);
+}
+
+/**
+* Time a ParallelFor against the same loop on one thread.
+*/
+void BenchmarkParallelFor(BIO::CORE::JobSystem & jobs, unsigned int count, int iterations)
+{
+	std::vector<float> values(count, 1.0f);
+	double bestSerial = 0.0;
+	double bestParallel = 0.0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		Clock::time_point start = Clock::now();
+		SqrtRange(&values, 0, count);
+		Clock::time_point serial = Clock::now();
+		jobs.ParallelFor(count, 0, SqrtRange, &values);
+		Clock::time_point end = Clock::now();
+
+		double serialTime = Nanoseconds(start, serial) / 1000000.0;
+		double parallelTime = Nanoseconds(serial, end) / 1000000.0;
+
+		if (i == 0 || serialTime < bestSerial)
+			bestSerial = serialTime;
+
+		if (i == 0 || parallelTime < bestParallel)
+			bestParallel = parallelTime;
+	}
+
+	printf("ParallelFor:  %8.3f ms serial, %8.3f ms parallel (%u items)\n", 
+		bestSerial, bestParallel, count);
+}
+
+int main(int argc, char ** argv)
+{
+	unsigned int workers = 0;
+	bool pin = false;
+
+	if (argc > 1)
+		workers = (unsigned int)atoi(argv[1]);
+
+	if (argc > 2)
+		pin = atoi(argv[2]) != 0;
+
+	BIO::CORE::JobSystem jobs(workers, pin);
+
+	printf("Job system with %u workers%s\n", jobs.GetWorkerCount(), pin ? " (pinned)" : "");
+
+	BenchmarkSubmit(jobs, 100000, 10);
+	BenchmarkSteal(jobs, 10000);
+	BenchmarkParallelFor(jobs, 4000000, 10);
+
+	printf("Executed %llu jobs, %llu stolen\n", 
+		jobs.GetExecutedCount(), 
+		jobs.GetStolenCount());
+
+	return 0;
+}
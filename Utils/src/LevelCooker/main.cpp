@@ -0,0 +1,66 @@
+#include <iostream>
+#include <string>
+#include "XMLLevelLoader.hpp"
+#include "BinaryLevelLoader.hpp"
+
+/**
+* Cooks an XML level file into a binary level file that the BinaryLevelLoader can map.
+*
+* Usage: LevelCooker <level file> [output file]
+*
+* If no output file is given the extension of the level file is replaced with .blevel.
+*/
+int main(int argc, char * argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: LevelCooker <level file> [output file]" << std::endl;
+		return 1;
+	}
+
+	std::string output;
+
+	if (argc > 2)
+	{
+		output = argv[2];
+	}
+	else
+	{
+		output = argv[1];
+		size_t dot = output.find_last_of('.');
+		size_t slash = output.find_last_of("/\\");
+
+		if ((dot != std::string::npos) && ((slash == std::string::npos) || (dot > slash)))
+			output.erase(dot);
+
+		output += ".blevel";
+	}
+
+	BIO_LOGGING_SET_LOGGING_LEVEL(BIO_LOGGER_LEVEL_WARNING);
+
+	BIO::ENGINE::XMLLevelLoader loader(argv[1]);
+	loader.ParseLevel();
+	BIO::ENGINE::LevelInfo info = loader.GetLevelInfo();
+	BIO::ENGINE::World * world = loader.LoadLevel();
+
+	if (world == NULL)
+	{
+		std::cerr << "Unable to load " << argv[1] << ": " 
+			<< BIO::ENGINE::GetErrorString(loader.GetError()) << std::endl;
+		return 1;
+	}
+
+	bool written = BIO::ENGINE::BinaryLevelLoader::WriteLevel(output.c_str(), info, *world);
+	unsigned int count = world->GetObjectCount();
+	delete world;
+
+	if (!written)
+	{
+		std::cerr << "Unable to write " << output << std::endl;
+		return 1;
+	}
+
+	std::cout << "Cooked " << argv[1] << " (" << count << " objects) to " << output << std::endl;
+
+	return 0;
+}
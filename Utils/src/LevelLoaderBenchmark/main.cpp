@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "XMLLevelLoader.hpp"
+#include "BinaryLevelLoader.hpp"
+
+/**
+* Write a level file with a number of objects in it.
+*
+* @param filename The file to write.
+* @param objectCount The number of OBJECT tags to write.
+*
+* @return Returns true if the file was written.
+*/
+bool WriteLevel(const char * filename, int objectCount)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::trunc);
+
+	if (!file.is_open())
+		return false;
+
+	file << "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+		<< "<LEVEL name=\"Benchmark\">\n"
+		<< "\t<SETTINGS>\n"
+		<< "\t\t<LEVELFILE>benchmark.obj</LEVELFILE>\n"
+		<< "\t\t<GRAVITY><VECTOR3 x=\"0\" y=\"-9.8\" z=\"0\"/></GRAVITY>\n"
+		<< "\t\t<LATITUDE><ANGLE type=\"Degrees\" value=\"41.7\"/></LATITUDE>\n"
+		<< "\t\t<AMBIENTLIGHT><COLOR r=\"64\" g=\"64\" b=\"80\"/></AMBIENTLIGHT>\n"
+		<< "\t</SETTINGS>\n"
+		<< "\t<CAMERA type=\"Following\" minview=\"0.5\" maxview=\"1000\">\n"
+		<< "\t\t<CAMERAFOLLOW>object0</CAMERAFOLLOW>\n"
+		<< "\t\t<FOLLOWDISTANCE>10</FOLLOWDISTANCE>\n"
+		<< "\t\t<FOLLOWHEIGHT>5</FOLLOWHEIGHT>\n"
+		<< "\t</CAMERA>\n"
+		<< "\t<OBJECTS>\n";
+
+	for (int i = 0; i < objectCount; i++)
+	{
+		file << "\t\t<OBJECT name=\"object" << i << "\">\n"
+			<< "\t\t\t<MODEL>crate.obj</MODEL>\n"
+			<< "\t\t\t<POSITION><VECTOR3 x=\"" << (i % 100) << ".5\" y=\"0\" z=\"" << (i / 100) << ".25\"/></POSITION>\n"
+			<< "\t\t\t<ROTATION><VECTOR3 y=\"" << (i % 360) << "\"/></ROTATION>\n"
+			<< "\t\t\t<SCALE><VECTOR3 x=\"1\" y=\"1\" z=\"1\"/></SCALE>\n"
+			<< "\t\t\t<COLOR r=\"255\" g=\"" << (i % 256) << "\" b=\"128\"/>\n"
+			<< "\t\t</OBJECT>\n";
+	}
+
+	file << "\t</OBJECTS>\n"
+		<< "</LEVEL>\n";
+
+	return file.good();
+}
+
+/**
+* Load a level a number of times and print how long it took.
+*
+* @param loader The loader to time. Its filename must already be set.
+* @param label The name printed with the results.
+* @param objectCount The number of objects the level should have.
+* @param iterations The number of times to load the level.
+*
+* @return Returns true if every load worked.
+*/
+bool Benchmark(BIO::ENGINE::ILevelLoader & loader, const char * label, int objectCount, int iterations)
+{
+	double bestParse = 0.0;
+	double best = 0.0;
+	double total = 0.0;
+	bool success = true;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		loader.ParseLevel();
+		std::chrono::high_resolution_clock::time_point parsed = std::chrono::high_resolution_clock::now();
+		BIO::ENGINE::World * world = loader.LoadLevel();
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		double parseMs = std::chrono::duration<double, std::milli>(parsed - start).count();
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+		if ((world == NULL) || (world->GetObjectCount() != (unsigned int)objectCount))
+		{
+			std::cerr << label << " loading failed: " << BIO::ENGINE::GetErrorString(loader.GetError()) << std::endl;
+			success = false;
+		}
+
+		delete world;
+		loader.Clear();
+
+		if ((i == 0) || (ms < best))
+			best = ms;
+		if ((i == 0) || (parseMs < bestParse))
+			bestParse = parseMs;
+		total += ms;
+	}
+
+	std::cout << label << ": best " << best << " ms (" << (objectCount / (best / 1000.0)) << " objects/s), "
+		<< "mean " << (total / iterations) << " ms, "
+		<< "best ParseLevel " << bestParse << " ms" << std::endl;
+
+	return success;
+}
+
+/**
+* Times how long the level loaders take to load a large level: the XMLLevelLoader on the XML 
+* file and the BinaryLevelLoader on the same level after it is cooked.
+*
+* Usage: LevelLoaderBenchmark [object count] [iterations]
+*
+* The object count defaults to 100000 and the iterations to 5.
+*/
+int main(int argc, char * argv[])
+{
+	int objectCount = (argc > 1) ? atoi(argv[1]) : 100000;
+	int iterations = (argc > 2) ? atoi(argv[2]) : 5;
+	const char * filename = "LevelLoaderBenchmark.level";
+	const char * binaryFilename = "LevelLoaderBenchmark.blevel";
+
+	if ((objectCount < 0) || (iterations < 1))
+	{
+		std::cerr << "Usage: LevelLoaderBenchmark [object count] [iterations]" << std::endl;
+		return 1;
+	}
+
+	BIO_LOGGING_SET_LOGGING_LEVEL(BIO_LOGGER_LEVEL_WARNING);
+
+	if (!WriteLevel(filename, objectCount))
+	{
+		std::cerr << "Unable to write " << filename << std::endl;
+		return 1;
+	}
+
+	std::cout << objectCount << " objects, " << iterations << " runs" << std::endl;
+
+	BIO::ENGINE::XMLLevelLoader xmlLoader(filename);
+	bool success = Benchmark(xmlLoader, "XML", objectCount, iterations);
+
+	//cook the level the same way the LevelCooker does
+	xmlLoader.ParseLevel();
+	BIO::ENGINE::LevelInfo info = xmlLoader.GetLevelInfo();
+	BIO::ENGINE::World * world = xmlLoader.LoadLevel();
+
+	if ((world == NULL) || !BIO::ENGINE::BinaryLevelLoader::WriteLevel(binaryFilename, info, *world))
+	{
+		std::cerr << "Unable to write " << binaryFilename << std::endl;
+		success = false;
+	}
+	else
+	{
+		BIO::ENGINE::BinaryLevelLoader binaryLoader(binaryFilename);
+		success = Benchmark(binaryLoader, "Binary", objectCount, iterations) && success;
+	}
+
+	delete world;
+
+	remove(filename);
+	remove(binaryFilename);
+
+	return success ? 0 : 1;
+}
@@ -2,24 +2,39 @@
 #include <iostream>
 #include "BIOEngine.hpp"
 
-int MainLoop(BIO::ENGINE::BIOEngine * engine)
+/**
+* The viewer's code run each frame. Prints the frame statistics once a second.
+*/
+class LevelViewer : public BIO::ENGINE::IFrameListener
 {
-	std::cout << "Running Main Loop" << std::endl;
+private:
+	double _sinceReport;
 
-	while (engine->Run())
+public:
+	LevelViewer() : _sinceReport(0.0) {}
+
+	virtual void OnFixedUpdate(BIO::ENGINE::BIOEngine & engine, double delta)
 	{
-		if (engine->IsWindowActive())
-		{
-			std::cout << "Running Loop" << std::endl;
-		}
-		else
+		_sinceReport += delta;
+
+		if (_sinceReport >= 1.0)
 		{
-			engine->Yield();
+			const BIO::ENGINE::FrameStats & stats = engine.GetFrameScheduler().GetStats();
+
+			std::cout << "Frame: " << (stats.AverageFrameTime * 1000.0) << " ms"
+				<< " (min " << (stats.MinFrameTime * 1000.0)
+				<< ", max " << (stats.MaxFrameTime * 1000.0)
+				<< ", work " << (stats.AverageWorkTime * 1000.0) << ")" << std::endl;
+
+			_sinceReport -= 1.0;
 		}
 	}
 
-	return 0;
-}
+	virtual void OnRender(BIO::ENGINE::BIOEngine & engine, float interpolation)
+	{
+		//Nothing to draw yet
+	}
+};
 
 int main(int argc, char * argv)
 {
@@ -30,10 +45,13 @@ int main(int argc, char * argv)
 
 	if (tmp->GetError() == BIO::ENGINE::OK)
 	{
-		int err = MainLoop(tmp);
+		std::cout << "Running Main Loop" << std::endl;
+
+		LevelViewer viewer;
+		tmp->RunLoop(viewer);
 	}
 
 	delete tmp;
 
 	return 0;
-}
\ No newline at end of file
+}
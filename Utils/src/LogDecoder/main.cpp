@@ -0,0 +1,54 @@
+#include <fstream>
+#include <iostream>
+#include "Logger.hpp"
+
+/**
+* Decodes a binary log written by the BIO Logger into readable text.
+*
+* Usage: LogDecoder <binary log> [output file]
+*
+* If no output file is given the text is written to the console.
+*/
+int main(int argc, char * argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: LogDecoder <binary log> [output file]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1], std::ios::in | std::ios::binary);
+
+	if (!input.is_open())
+	{
+		std::cerr << "Unable to open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::ofstream file;
+	std::ostream * output = &std::cout;
+
+	if (argc > 2)
+	{
+		file.open(argv[2], std::ios::out | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			std::cerr << "Unable to open " << argv[2] << std::endl;
+			return 1;
+		}
+
+		output = &file;
+	}
+
+	if (!BIO::LOGGING::DecodeBinaryLog(input, *output))
+	{
+		output->flush();
+		std::cerr << argv[1] << " is not a valid binary log or is damaged." << std::endl;
+		return 2;
+	}
+
+	output->flush();
+
+	return 0;
+}
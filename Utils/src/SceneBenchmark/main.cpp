@@ -0,0 +1,414 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <irrlicht.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Get the seconds between two times.
+*/
+double Seconds(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration_cast<std::chrono::duration<double> >(end - start).count();
+}
+
+/**
+* Add groups of nodes below the root, each group is a subtree that can be animated on its own
+* thread. In the first animatedGroups groups every node turns and every fourth one also flies 
+* in a circle, the other groups stand still like level geometry.
+*/
+void BuildScene(irr::scene::ISceneManager * smgr, unsigned int groups, unsigned int nodesPerGroup, unsigned int animatedGroups)
+{
+	for (unsigned int g = 0; g < groups; g++)
+	{
+		const bool animated = g < animatedGroups;
+
+		irr::scene::ISceneNode * group = smgr->addEmptySceneNode(0, -1);
+		group->setPosition(irr::core::vector3df((irr::f32)(g % 32) * 10.0f, 0.0f, (irr::f32)(g / 32) * 10.0f));
+
+		if (animated)
+		{
+			irr::scene::ISceneNodeAnimator * turn = smgr->createRotationAnimator(irr::core::vector3df(0.0f, 0.1f, 0.0f));
+			group->addAnimator(turn);
+			turn->drop();
+		}
+
+		irr::scene::ISceneNode * parent = group;
+
+		for (unsigned int n = 0; n < nodesPerGroup; n++)
+		{
+			//a few levels deep, so the transforms are chained
+			irr::scene::ISceneNode * node = smgr->addEmptySceneNode(parent, -1);
+			node->setPosition(irr::core::vector3df(1.0f, (irr::f32)n, 0.0f));
+
+			if (animated)
+			{
+				irr::scene::ISceneNodeAnimator * animator = (n & 3) ?
+					smgr->createRotationAnimator(irr::core::vector3df(0.3f, 0.2f, (irr::f32)n * 0.01f)) :
+					smgr->createFlyCircleAnimator(irr::core::vector3df(0.0f, (irr::f32)n, 0.0f), 2.0f, 0.001f);
+				node->addAnimator(animator);
+				animator->drop();
+			}
+
+			if ((n & 7) == 7)
+				parent = node;
+		}
+	}
+}
+
+/**
+* Animate the scene over and over and get the frames a second.
+*/
+double BenchmarkAnimate(irr::scene::ISceneManager * smgr, unsigned int threads, bool deterministic, double seconds)
+{
+	irr::scene::ISceneNode * root = smgr->getRootSceneNode();
+	smgr->setAnimateThreads(threads, deterministic);
+
+	unsigned int frames = 0;
+	irr::u32 time = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		time += 16;
+		root->OnAnimate(time);
+		frames++;
+		end = Clock::now();
+	}
+
+	smgr->setAnimateThreads(1);
+
+	return frames / Seconds(start, end);
+}
+
+/**
+* Add the nodes below a node to a list, parents before their children.
+*/
+void ListNodes(irr::scene::ISceneNode * node, irr::core::array<irr::scene::ISceneNode *> & nodes)
+{
+	nodes.push_back(node);
+
+	const irr::core::list<irr::scene::ISceneNode *> & children = node->getChildren();
+	irr::core::list<irr::scene::ISceneNode *>::ConstIterator it = children.begin();
+
+	for (; it != children.end(); ++it)
+		ListNodes(*it, nodes);
+}
+
+/**
+* Animate the same scene on one thread and on several, and check every node ends up with the
+* same absolute transformation. Some groups have a texture animator, which is not thread safe,
+* so those are animated after the others on the calling thread.
+*/
+bool CheckAnimateThreads(irr::IrrlichtDevice * device, unsigned int threads, bool deterministic)
+{
+	irr::scene::ISceneManager * smgr[2];
+	irr::core::array<irr::scene::ISceneNode *> nodes[2];
+	irr::core::array<irr::video::ITexture *> textures;
+	textures.push_back(device->getVideoDriver()->addTexture(irr::core::dimension2du(1, 1), "check0"));
+	textures.push_back(device->getVideoDriver()->addTexture(irr::core::dimension2du(1, 1), "check1"));
+
+	for (int i = 0; i < 2; i++)
+	{
+		smgr[i] = device->getSceneManager()->createNewSceneManager();
+		BuildScene(smgr[i], 64, 40, 64);
+
+		const irr::core::list<irr::scene::ISceneNode *> & groups = smgr[i]->getRootSceneNode()->getChildren();
+		irr::core::list<irr::scene::ISceneNode *>::ConstIterator it = groups.begin();
+
+		for (unsigned int g = 0; it != groups.end(); ++it, g++)
+		{
+			if (g % 5)
+				continue;
+
+			irr::scene::ISceneNode * cube = smgr[i]->addCubeSceneNode(1.0f, *it);
+			irr::scene::ISceneNodeAnimator * animator = smgr[i]->createTextureAnimator(textures, 20);
+			cube->addAnimator(animator);
+			animator->drop();
+		}
+
+		smgr[i]->setAnimateThreads(i ? threads : 1, deterministic);
+
+		for (irr::u32 time = 16; time <= 16 * 60; time += 16)
+			smgr[i]->getRootSceneNode()->OnAnimate(time);
+
+		ListNodes(smgr[i]->getRootSceneNode(), nodes[i]);
+	}
+
+	bool same = nodes[0].size() == nodes[1].size();
+
+	for (irr::u32 n = 0; same && n < nodes[0].size(); n++)
+	{
+		same = nodes[0][n]->getAbsoluteTransformation() == nodes[1][n]->getAbsoluteTransformation() &&
+			nodes[0][n]->getMaterial(0).getTexture(0) == nodes[1][n]->getMaterial(0).getTexture(0);
+	}
+
+	smgr[0]->drop();
+	smgr[1]->drop();
+	device->getVideoDriver()->removeTexture(textures[0]);
+	device->getVideoDriver()->removeTexture(textures[1]);
+
+	return same;
+}
+
+/**
+* Check the absolute transformation of a node and the nodes below it against one calculated
+* from scratch, from the relative transformations down from the root.
+*/
+bool CheckAbsolute(irr::scene::ISceneNode * node, const irr::core::matrix4 & parent)
+{
+	const irr::core::matrix4 absolute = parent * node->getRelativeTransformation();
+
+	if (!(node->getAbsoluteTransformation() == absolute))
+		return false;
+
+	const irr::core::list<irr::scene::ISceneNode *> & children = node->getChildren();
+	irr::core::list<irr::scene::ISceneNode *>::ConstIterator it = children.begin();
+
+	for (; it != children.end(); ++it)
+	{
+		if (!CheckAbsolute(*it, absolute))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+* Move, turn and reparent random nodes and change the matrices of dummy transformation nodes
+* through the reference they hand out, then animate the scene, which updates only the nodes
+* marked as moved. Every node has to end up where a full update of the scene would put it.
+*/
+bool CheckMovedNodes(irr::IrrlichtDevice * device)
+{
+	irr::scene::ISceneManager * smgr = device->getSceneManager()->createNewSceneManager();
+	irr::scene::ISceneNode * root = smgr->getRootSceneNode();
+	irr::core::array<irr::scene::ISceneNode *> nodes;
+	irr::core::array<irr::scene::IDummyTransformationSceneNode *> dummies;
+
+	srand(1);
+
+	for (unsigned int n = 0; n < 2000; n++)
+	{
+		irr::scene::ISceneNode * parent = nodes.size() && (rand() % 8) ? nodes[rand() % nodes.size()] : root;
+
+		if (n % 3)
+		{
+			irr::scene::ISceneNode * node = smgr->addEmptySceneNode(parent, -1);
+			node->setPosition(irr::core::vector3df((irr::f32)(rand() % 20) - 10.0f, (irr::f32)(rand() % 20) - 10.0f, 0.0f));
+			nodes.push_back(node);
+		}
+		else
+		{
+			irr::scene::IDummyTransformationSceneNode * dummy = smgr->addDummyTransformationSceneNode(parent, -1);
+			dummy->getRelativeTransformationMatrix().setRotationDegrees(irr::core::vector3df(0.0f, (irr::f32)(rand() % 360), 0.0f));
+			nodes.push_back(dummy);
+			dummies.push_back(dummy);
+		}
+	}
+
+	bool same = true;
+
+	for (irr::u32 frame = 1; same && frame <= 100; frame++)
+	{
+		for (int i = 0; i < 20; i++)
+		{
+			irr::scene::ISceneNode * node = nodes[rand() % nodes.size()];
+
+			switch (rand() % 4)
+			{
+			case 0:
+				node->setPosition(node->getPosition() + irr::core::vector3df(1.0f, 0.0f, 0.5f));
+				break;
+			case 1:
+				node->setRotation(irr::core::vector3df((irr::f32)(rand() % 360), 0.0f, 0.0f));
+				break;
+			case 2:
+			{
+				//not below the node itself
+				irr::scene::ISceneNode * parent = nodes[rand() % nodes.size()];
+				irr::scene::ISceneNode * above = parent;
+
+				while (above && above != node)
+					above = above->getParent();
+
+				node->setParent(above ? root : parent);
+				break;
+			}
+			default:
+				dummies[rand() % dummies.size()]->getRelativeTransformationMatrix().setTranslation(
+					irr::core::vector3df(0.0f, (irr::f32)(rand() % 20), 0.0f));
+				break;
+			}
+		}
+
+		root->OnAnimate(frame * 16);
+		same = CheckAbsolute(root, irr::core::IdentityMatrix);
+	}
+
+	smgr->drop();
+
+	return same;
+}
+
+/**
+* Add cubes at random places around the origin, turned every way.
+*/
+void BuildCubes(irr::scene::ISceneManager * smgr, irr::scene::E_CULLING_TYPE culling, unsigned int nodes)
+{
+	srand(1);
+
+	for (unsigned int n = 0; n < nodes; n++)
+	{
+		const irr::core::vector3df position((irr::f32)(rand() % 800) - 400.0f, (irr::f32)(rand() % 800) - 400.0f, (irr::f32)(rand() % 800) - 400.0f);
+		const irr::core::vector3df rotation((irr::f32)(rand() % 360), (irr::f32)(rand() % 360), 0.0f);
+		irr::scene::ISceneNode * node = smgr->addCubeSceneNode(1.0f + (irr::f32)(rand() % 10), 0, -1, position, rotation);
+		node->setAutomaticCulling(culling);
+	}
+
+	smgr->addCameraSceneNode(0, irr::core::vector3df(0.0f, 0.0f, 0.0f), irr::core::vector3df(0.0f, 0.0f, 100.0f));
+}
+
+/**
+* Draw a scene of cubes around the camera with the null driver and get the frames a second. 
+* Most of the cubes are outside of the view, so the time goes to registering and culling them.
+*/
+double BenchmarkCulling(irr::scene::ISceneManager * smgr, irr::scene::E_CULLING_TYPE culling, bool tree, unsigned int nodes, double seconds)
+{
+	smgr->setBoundingVolumeTree(tree);
+	BuildCubes(smgr, culling, nodes);
+
+	unsigned int frames = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		smgr->drawAll();
+		frames++;
+		end = Clock::now();
+	}
+
+	return frames / Seconds(start, end);
+}
+
+/**
+* Pick the cubes with rays through the scene and get the rays a second.
+*/
+double BenchmarkPicking(irr::scene::ISceneManager * smgr, bool tree, unsigned int nodes, double seconds)
+{
+	smgr->setBoundingVolumeTree(tree);
+	BuildCubes(smgr, irr::scene::EAC_BOX, nodes);
+
+	//the tree holds the nodes drawn by the last frame
+	smgr->drawAll();
+
+	irr::scene::ISceneCollisionManager * collision = smgr->getSceneCollisionManager();
+	unsigned int rays = 0;
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start;
+
+	while (Seconds(start, end) < seconds)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			const irr::core::vector3df from((irr::f32)(rand() % 800) - 400.0f, (irr::f32)(rand() % 800) - 400.0f, -500.0f);
+			const irr::core::vector3df to((irr::f32)(rand() % 800) - 400.0f, (irr::f32)(rand() % 800) - 400.0f, 500.0f);
+			collision->getSceneNodeFromRayBB(irr::core::line3df(from, to));
+		}
+
+		rays += 16;
+		end = Clock::now();
+	}
+
+	return rays / Seconds(start, end);
+}
+
+int main(int argc, char ** argv)
+{
+	double seconds = 1.0;
+
+	if (argc > 1)
+		seconds = atof(argv[1]);
+
+	irr::IrrlichtDevice * device = irr::createDevice(irr::video::EDT_NULL);
+
+	if (device == NULL)
+		return 1;
+
+	device->getLogger()->setLogLevel(irr::ELL_NONE);
+
+	//the numbers are only worth something if the threads animate the scene right
+	const bool animateSame = CheckAnimateThreads(device, 4, false);
+	const bool animateFixedSame = CheckAnimateThreads(device, 4, true);
+
+	const bool movedSame = CheckMovedNodes(device);
+
+	printf("Animate 4 threads like 1 thread: %s, fixed: %s\n", animateSame ? "OK" : "FAILED", animateFixedSame ? "OK" : "FAILED");
+	printf("Moved nodes like a full update: %s\n\n", movedSame ? "OK" : "FAILED");
+
+	if (!animateSame || !animateFixedSame || !movedSame)
+	{
+		device->drop();
+		return 1;
+	}
+
+	const unsigned int groups[] = { 16, 256, 1024 };
+	const unsigned int nodes = 20000;
+	const unsigned int threads[] = { 1, 2, 4, 8 };
+
+	printf("Animate frames/sec      %8s  %8s  %8s  %8s  %8s\n", "1", "2", "4", "8", "4 fixed");
+
+	for (int g = 0; g < 4; g++)
+	{
+		//the last scene is the biggest one again with only 1 in 128 groups moving
+		const bool moving = g < 3;
+		const unsigned int count = moving ? groups[g] : groups[2];
+
+		irr::scene::ISceneManager * smgr = device->getSceneManager()->createNewSceneManager();
+		BuildScene(smgr, count, nodes / count, moving ? count : count / 128);
+
+		double fps[5];
+
+		for (int t = 0; t < 4; t++)
+			fps[t] = BenchmarkAnimate(smgr, threads[t], false, seconds);
+
+		fps[4] = BenchmarkAnimate(smgr, 4, true, seconds);
+
+		smgr->drop();
+
+		printf("%5u %-16s  %8.1f  %8.1f  %8.1f  %8.1f  %8.1f\n",
+			count, moving ? "subtrees" : "static subtrees", fps[0], fps[1], fps[2], fps[3], fps[4]);
+	}
+
+	const irr::scene::E_CULLING_TYPE cullings[] = { irr::scene::EAC_BOX, irr::scene::EAC_FRUSTUM_BOX, irr::scene::EAC_FRUSTUM_SPHERE };
+	double cull[2][3];
+	double pick[2];
+
+	for (int tree = 0; tree < 2; tree++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			irr::scene::ISceneManager * smgr = device->getSceneManager()->createNewSceneManager();
+			cull[tree][c] = BenchmarkCulling(smgr, cullings[c], tree != 0, nodes, seconds);
+			smgr->drop();
+		}
+
+		irr::scene::ISceneManager * smgr = device->getSceneManager()->createNewSceneManager();
+		pick[tree] = BenchmarkPicking(smgr, tree != 0, nodes, seconds);
+		smgr->drop();
+	}
+
+	printf("\nCull frames/sec         %8s  %8s  %8s\n", "box", "frustum", "sphere");
+	printf("%5u cubes             %8.1f  %8.1f  %8.1f\n", nodes, cull[0][0], cull[0][1], cull[0][2]);
+	printf("%5u cubes in a tree   %8.1f  %8.1f  %8.1f\n", nodes, cull[1][0], cull[1][1], cull[1][2]);
+
+	printf("\nPick rays/sec           %8s  %8s\n", "walk", "tree");
+	printf("%5u cubes             %8.1f  %8.1f\n", nodes, pick[0], pick[1]);
+
+	device->drop();
+
+	return 0;
+}